@@ -0,0 +1,251 @@
+// Copyright (c) 2015-2017, RAPtor Developer Team
+// License: Simplified BSD, http://opensource.org/licenses/BSD-2-Clause
+#include <mpi.h>
+#include <math.h>
+#include <stdlib.h>
+#include <iostream>
+
+#include "raptor.hpp"
+
+// Times the setup kernels that map global indices to local ones
+// (finalize, CLJP splitting, interpolation, SpGEMM, candidate fitting)
+// and the total Ruge-Stuben and smoothed aggregation setup, on a 3D
+// 27-point Laplacian with n^3 rows per process.  The global-to-local
+// maps themselves are timed on the global columns of every nonzero of
+// A*P, comparing std::map, IntMap, and sorted_find.  Matrix sorts are
+// timed on the local block of A*P, as CSR with each row reversed and as
+// COO with entries in reverse order, followed by remove_duplicates.
+//
+// Usage: benchmark_setup_kernels [n] [n_tests]
+
+// Maximum time across processes of the fastest of n_tests runs
+double max_time(double t)
+{
+    double t_max;
+    MPI_Allreduce(&t, &t_max, 1, MPI_DOUBLE, MPI_MAX, MPI_COMM_WORLD);
+    return t_max;
+}
+
+void print_time(const char* label, double t)
+{
+    int rank;
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    if (rank == 0) printf("%-28s %e\n", label, t);
+}
+
+int main(int argc, char *argv[])
+{
+    MPI_Init(&argc, &argv);
+    int rank, num_procs;
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &num_procs);
+
+    int n = 20;
+    int n_tests = 5;
+    if (argc > 1) n = atoi(argv[1]);
+    if (argc > 2) n_tests = atoi(argv[2]);
+
+    // Processes are laid out along the last dimension
+    int grid[3] = {n, n, n * num_procs};
+    double* stencil = laplace_stencil_27pt();
+
+    double t0, t;
+    double t_finalize = 1e10, t_split = 1e10, t_mod = 1e10, t_ext = 1e10;
+    double t_AP = 1e10, t_PTAP = 1e10, t_rs = 1e10, t_sa = 1e10;
+    double t_std_map = 1e10, t_int_map = 1e10, t_sorted = 1e10;
+    double t_csr_sort = 1e10, t_coo_sort = 1e10;
+    long sum_std_map = 0, sum_int_map = 0, sum_sorted = 0;
+
+    ParCSRMatrix* A;
+    ParCSRMatrix* S;
+    ParCSRMatrix* P;
+    ParCSRMatrix* AP;
+    ParCSRMatrix* Ac;
+    ParMultilevel* ml;
+    std::vector<int> states;
+    std::vector<int> off_proc_states;
+    std::vector<double> weights;
+
+    for (int test = 0; test < n_tests; test++)
+    {
+        // Global off_proc columns condensed in finalize
+        MPI_Barrier(MPI_COMM_WORLD);
+        t0 = MPI_Wtime();
+        A = par_stencil_grid(stencil, grid, 3);
+        t = MPI_Wtime() - t0;
+        if (t < t_finalize) t_finalize = t;
+
+        S = A->strength(Classical, 0.25);
+        weights.resize(A->local_num_rows);
+        srand(2448422 + rank);
+        for (int i = 0; i < A->local_num_rows; i++)
+        {
+            weights[i] = double(rand())/RAND_MAX;
+        }
+
+        MPI_Barrier(MPI_COMM_WORLD);
+        t0 = MPI_Wtime();
+        split_cljp(S, states, off_proc_states, false, weights.data());
+        t = MPI_Wtime() - t0;
+        if (t < t_split) t_split = t;
+
+        MPI_Barrier(MPI_COMM_WORLD);
+        t0 = MPI_Wtime();
+        P = mod_classical_interpolation(A, S, states, off_proc_states);
+        t = MPI_Wtime() - t0;
+        if (t < t_mod) t_mod = t;
+        delete P;
+
+        MPI_Barrier(MPI_COMM_WORLD);
+        t0 = MPI_Wtime();
+        P = extended_interpolation(A, S, states, off_proc_states, 0.3);
+        t = MPI_Wtime() - t0;
+        if (t < t_ext) t_ext = t;
+
+        MPI_Barrier(MPI_COMM_WORLD);
+        t0 = MPI_Wtime();
+        AP = A->mult(P);
+        t = MPI_Wtime() - t0;
+        if (t < t_AP) t_AP = t;
+
+        MPI_Barrier(MPI_COMM_WORLD);
+        t0 = MPI_Wtime();
+        Ac = AP->mult_T(P);
+        t = MPI_Wtime() - t0;
+        if (t < t_PTAP) t_PTAP = t;
+
+        // Global column of each nonzero of A*P, and the sorted columns
+        std::vector<index_t> global_cols;
+        global_cols.reserve(AP->local_nnz);
+        for (int i = 0; i < AP->on_proc->nnz; i++)
+        {
+            global_cols.emplace_back(AP->on_proc_column_map[AP->on_proc->idx2[i]]);
+        }
+        for (int i = 0; i < AP->off_proc->nnz; i++)
+        {
+            global_cols.emplace_back(AP->off_proc_column_map[AP->off_proc->idx2[i]]);
+        }
+
+        t0 = MPI_Wtime();
+        std::vector<index_t> map_cols(global_cols);
+        sort_unique(map_cols);
+        int n_cols = map_cols.size();
+        std::map<index_t, int> std_map;
+        for (int i = 0; i < n_cols; i++)
+        {
+            std_map[map_cols[i]] = i;
+        }
+        sum_std_map = 0;
+        for (size_t i = 0; i < global_cols.size(); i++)
+        {
+            sum_std_map += std_map[global_cols[i]];
+        }
+        t = MPI_Wtime() - t0;
+        if (t < t_std_map) t_std_map = t;
+
+        t0 = MPI_Wtime();
+        map_cols = global_cols;
+        sort_unique(map_cols);
+        IntMap<index_t> int_map(n_cols);
+        for (int i = 0; i < n_cols; i++)
+        {
+            int_map.insert(map_cols[i], i);
+        }
+        sum_int_map = 0;
+        for (size_t i = 0; i < global_cols.size(); i++)
+        {
+            sum_int_map += int_map.find(global_cols[i]);
+        }
+        t = MPI_Wtime() - t0;
+        if (t < t_int_map) t_int_map = t;
+
+        t0 = MPI_Wtime();
+        map_cols = global_cols;
+        sort_unique(map_cols);
+        sum_sorted = 0;
+        for (size_t i = 0; i < global_cols.size(); i++)
+        {
+            sum_sorted += sorted_find(map_cols, global_cols[i]);
+        }
+        t = MPI_Wtime() - t0;
+        if (t < t_sorted) t_sorted = t;
+
+        // Sort the local block of A*P after reversing each row
+        CSRMatrix* AP_csr = (CSRMatrix*) AP->on_proc->copy();
+        for (int i = 0; i < AP_csr->n_rows; i++)
+        {
+            std::reverse(AP_csr->idx2.begin() + AP_csr->idx1[i],
+                    AP_csr->idx2.begin() + AP_csr->idx1[i+1]);
+            std::reverse(AP_csr->vals.begin() + AP_csr->idx1[i],
+                    AP_csr->vals.begin() + AP_csr->idx1[i+1]);
+        }
+        AP_csr->sorted = false;
+        t0 = MPI_Wtime();
+        AP_csr->sort();
+        AP_csr->remove_duplicates();
+        t = MPI_Wtime() - t0;
+        if (t < t_csr_sort) t_csr_sort = t;
+
+        // And as COO, with all entries in reverse order
+        COOMatrix* AP_coo = new COOMatrix(AP_csr->n_rows, AP_csr->n_cols, 0);
+        for (int i = AP_csr->n_rows - 1; i >= 0; i--)
+        {
+            for (int j = AP_csr->idx1[i+1] - 1; j >= AP_csr->idx1[i]; j--)
+            {
+                AP_coo->add_value(i, AP_csr->idx2[j], AP_csr->vals[j]);
+            }
+        }
+        t0 = MPI_Wtime();
+        AP_coo->sort();
+        AP_coo->remove_duplicates();
+        t = MPI_Wtime() - t0;
+        if (t < t_coo_sort) t_coo_sort = t;
+        delete AP_coo;
+        delete AP_csr;
+
+        delete Ac;
+        delete AP;
+        delete P;
+        delete S;
+
+        MPI_Barrier(MPI_COMM_WORLD);
+        t0 = MPI_Wtime();
+        ml = new ParRugeStubenSolver(0.25, Falgout, ModClassical, Classical, SOR);
+        ml->setup(A);
+        t = MPI_Wtime() - t0;
+        if (t < t_rs) t_rs = t;
+        delete ml;
+
+        MPI_Barrier(MPI_COMM_WORLD);
+        t0 = MPI_Wtime();
+        ml = new ParSmoothedAggregationSolver(0.0);
+        ml->setup(A);
+        t = MPI_Wtime() - t0;
+        if (t < t_sa) t_sa = t;
+        delete ml;
+
+        delete A;
+    }
+    delete[] stencil;
+
+    print_time("Stencil + finalize", max_time(t_finalize));
+    print_time("CLJP splitting", max_time(t_split));
+    print_time("Mod. classical interp", max_time(t_mod));
+    print_time("Extended interp", max_time(t_ext));
+    print_time("A*P", max_time(t_AP));
+    print_time("P^T*(AP)", max_time(t_PTAP));
+    print_time("Ruge-Stuben setup", max_time(t_rs));
+    print_time("Smoothed aggregation setup", max_time(t_sa));
+    print_time("A*P columns: std::map", max_time(t_std_map));
+    print_time("A*P columns: IntMap", max_time(t_int_map));
+    print_time("A*P columns: sorted_find", max_time(t_sorted));
+    print_time("A*P local sort: CSR", max_time(t_csr_sort));
+    print_time("A*P local sort: COO", max_time(t_coo_sort));
+    if (sum_std_map != sum_int_map || sum_std_map != sum_sorted)
+    {
+        printf("Rank %d: global-to-local maps differ\n", rank);
+    }
+
+    MPI_Finalize();
+    return 0;
+}
@@ -52,7 +52,8 @@ int aggregate(ParCSRMatrix* A, ParCSRMatrix* S, std::vector<int>& states,
         }
     }
     std::vector<double>& rands = comm->communicate(r);
-    std::copy(rands.begin(), rands.end(), off_proc_r.begin());
+    std::copy(rands.begin(), rands.begin() + S->off_proc_num_cols, 
+            off_proc_r.begin());
 
     if (S->off_proc_num_cols)
     {
@@ -125,7 +126,8 @@ int aggregate(ParCSRMatrix* A, ParCSRMatrix* S, std::vector<int>& states,
     // Communicate aggregates (global rows)
     std::vector<int>& recvbuf = comm->communicate(aggregates);
 
-    std::copy(recvbuf.begin(), recvbuf.end(), off_proc_aggregates.begin());
+    std::copy(recvbuf.begin(), recvbuf.begin() + S->off_proc_num_cols, 
+            off_proc_aggregates.begin());
 
     // Pass 2 : add remaining aggregate to that of strongest neighbor
     for (int i = 0; i < S->local_num_rows; i++)
@@ -2,18 +2,276 @@
 // License: Simplified BSD, http://opensource.org/licenses/BSD-2-Clause
 #include "aggregation/par_candidates.hpp"
 
-// TODO -- currently assumes B with single candidate
+/**************************************************************
+*****   Fit Multiple Candidates
+**************************************************************
+***** Tentative interpolation for more than one candidate.  The
+***** rows of B in each aggregate are factored as B_agg = Q*R, and
+***** the columns of Q are the columns of T for that aggregate.
+***** Aggregates can span processes, so the Gram matrix
+***** B_agg^T*B_agg is summed on the process holding the aggregate
+***** root.  Its Cholesky factor is R, and each row of Q is found
+***** with a triangular solve on the process holding that row.
+***** Candidates that are dependent on an aggregate are dropped,
+***** so an aggregate has at most num_candidates columns.  Columns
+***** are numbered contiguously across processes, in order of
+***** aggregate root.
+**************************************************************/
+ParCSRMatrix* fit_multiple_candidates(ParCSRMatrix* A, 
+        const std::vector<int>& aggregates, 
+        const std::vector<double>& B, std::vector<double>& R,
+        int num_candidates, bool tap_comm, double tol)
+{
+    int rank, num_procs;
+    RAPtor_MPI_Comm_rank(RAPtor_MPI_COMM_WORLD, &rank);
+    RAPtor_MPI_Comm_size(RAPtor_MPI_COMM_WORLD, &num_procs);
+
+    int k = num_candidates;
+    int k2 = k * k;
+    int global_col, idx, kept;
+    int n_coarse = 0;
+    int first_coarse = 0;
+    index_t global_coarse = 0;
+    double val, threshold;
+    const double* b;
+    double* G;
+    double* Rf;
+    CommPkg* comm;
+
+    // The Gram form squares the conditioning of B_agg, so dependence
+    // below sqrt(eps) cannot be resolved
+    tol = std::max(tol, sqrt(DBL_EPSILON));
+
+    // Aggregate roots held by other processes
+    std::vector<index_t> off_proc_column_map;
+    for (std::vector<int>::const_iterator it = aggregates.begin();
+            it != aggregates.end(); ++it)
+    {
+        if (*it < 0) continue;
+        if (*it < A->partition->first_local_col || *it > A->partition->last_local_col)
+        {
+            off_proc_column_map.emplace_back(*it);
+        }
+    }
+    std::sort(off_proc_column_map.begin(), off_proc_column_map.end());
+    off_proc_column_map.erase(std::unique(off_proc_column_map.begin(),
+                off_proc_column_map.end()), off_proc_column_map.end());
+    int off_proc_num_cols = off_proc_column_map.size();
+
+    if (tap_comm)
+    {
+        comm = new TAPComm(A->partition, off_proc_column_map,
+                A->on_proc_column_map, true, A->comm->mpi_comm);
+    }
+    else
+    {
+        comm = new ParComm(A->partition, off_proc_column_map,
+                A->on_proc_column_map, A->comm->key, A->comm->mpi_comm);
+    }
+
+    // Aggregate of each row, as a local column of A, or as
+    // on_proc_num_cols + the position of an off-process root
+    int* on_proc_partition_to_col = A->map_partition_to_local();
+    std::vector<int> row_aggs(A->local_num_rows, -1);
+    std::vector<int> roots(A->on_proc_num_cols, 0);
+    for (int i = 0; i < A->local_num_rows; i++)
+    {
+        global_col = aggregates[i];
+        if (global_col < 0) continue;
+
+        if (global_col >= A->partition->first_local_col &&
+                global_col <= A->partition->last_local_col)
+        {
+            idx = on_proc_partition_to_col[global_col - A->partition->first_local_col];
+            roots[idx] = 1;
+        }
+        else
+        {
+            idx = A->on_proc_num_cols + (std::lower_bound(off_proc_column_map.begin(),
+                    off_proc_column_map.end(), global_col) - off_proc_column_map.begin());
+        }
+        row_aggs[i] = idx;
+    }
+    delete[] on_proc_partition_to_col;
+
+    // Sum Gram matrices of each aggregate on the root process
+    std::vector<double> gram((A->on_proc_num_cols + off_proc_num_cols) * k2, 0.0);
+    for (int i = 0; i < A->local_num_rows; i++)
+    {
+        if (row_aggs[i] < 0) continue;
+
+        b = &B[i*k];
+        G = &gram[row_aggs[i] * k2];
+        for (int a = 0; a < k; a++)
+        {
+            for (int j = 0; j < k; j++)
+            {
+                G[a*k + j] += b[a] * b[j];
+            }
+        }
+    }
+    std::vector<double> off_proc_gram(gram.begin() + A->on_proc_num_cols * k2,
+            gram.end());
+    gram.resize(A->on_proc_num_cols * k2);
+    comm->communicate_T(off_proc_gram, gram, k2);
+
+    // Cholesky factor of each Gram matrix (upper triangular, row-major),
+    // with zero rows for dependent candidates
+    std::vector<double> factors(A->on_proc_num_cols * k2, 0.0);
+    std::vector<int> first_cols(A->on_proc_num_cols, -1);
+    for (int l = 0; l < A->on_proc_num_cols; l++)
+    {
+        if (!roots[l]) continue;
+
+        G = &gram[l * k2];
+        Rf = &factors[l * k2];
+        first_cols[l] = n_coarse;
+        for (int j = 0; j < k; j++)
+        {
+            threshold = tol * tol * G[j*k + j];
+            for (int a = 0; a < j; a++)
+            {
+                if (Rf[a*k + a] == 0.0) continue;
+
+                val = G[a*k + j];
+                for (int c = 0; c < a; c++)
+                {
+                    val -= Rf[c*k + a] * Rf[c*k + j];
+                }
+                Rf[a*k + j] = val / Rf[a*k + a];
+            }
+
+            val = G[j*k + j];
+            for (int a = 0; a < j; a++)
+            {
+                val -= Rf[a*k + j] * Rf[a*k + j];
+            }
+            if (val > threshold && val > 0.0)
+            {
+                Rf[j*k + j] = sqrt(val);
+                n_coarse++;
+            }
+        }
+    }
+
+    // Number coarse columns contiguously across processes
+    std::vector<int> proc_sizes(num_procs);
+    RAPtor_MPI_Allgather(&n_coarse, 1, RAPtor_MPI_INT, proc_sizes.data(), 1,
+            RAPtor_MPI_INT, RAPtor_MPI_COMM_WORLD);
+    for (int i = 0; i < num_procs; i++)
+    {
+        if (i < rank) first_coarse += proc_sizes[i];
+        global_coarse += proc_sizes[i];
+    }
+
+    // Coarse candidates are the rows of R for the retained candidates
+    R.clear();
+    R.reserve(n_coarse * k);
+    for (int l = 0; l < A->on_proc_num_cols; l++)
+    {
+        if (!roots[l]) continue;
+
+        first_cols[l] += first_coarse;
+        Rf = &factors[l * k2];
+        for (int a = 0; a < k; a++)
+        {
+            if (Rf[a*k + a] == 0.0) continue;
+            R.insert(R.end(), Rf + a*k, Rf + (a+1)*k);
+        }
+    }
+
+    std::vector<double> off_proc_factors = comm->communicate(factors, k2);
+    std::vector<int> off_proc_first_cols = comm->communicate(first_cols);
+    comm->delete_comm();
+
+    // Each row of T solves q*R = b with the factor of its aggregate
+    Partition* part = new Partition(A->global_num_rows, global_coarse,
+            A->local_num_rows, n_coarse, A->partition->first_local_row,
+            first_coarse, A->partition->topology);
+    CSRMatrix* on_proc = new CSRMatrix(A->local_num_rows, n_coarse, 
+            A->local_num_rows * k);
+    CSRMatrix* off_proc = new CSRMatrix(A->local_num_rows, global_coarse,
+            A->local_num_rows * k);
+    std::vector<double> q(k);
+    on_proc->idx1[0] = 0;
+    off_proc->idx1[0] = 0;
+    for (int i = 0; i < A->local_num_rows; i++)
+    {
+        idx = row_aggs[i];
+        if (idx >= 0)
+        {
+            b = &B[i*k];
+            if (idx < A->on_proc_num_cols)
+            {
+                Rf = &factors[idx * k2];
+                global_col = first_cols[idx];
+            }
+            else
+            {
+                idx -= A->on_proc_num_cols;
+                Rf = &off_proc_factors[idx * k2];
+                global_col = off_proc_first_cols[idx];
+            }
+
+            kept = 0;
+            for (int j = 0; j < k; j++)
+            {
+                q[j] = 0.0;
+                if (Rf[j*k + j] == 0.0) continue;
+
+                val = b[j];
+                for (int a = 0; a < j; a++)
+                {
+                    val -= q[a] * Rf[a*k + j];
+                }
+                q[j] = val / Rf[j*k + j];
+
+                if (global_col >= first_coarse && global_col < first_coarse + n_coarse)
+                {
+                    on_proc->idx2.emplace_back(global_col + kept - first_coarse);
+                    on_proc->vals.emplace_back(q[j]);
+                }
+                else
+                {
+                    off_proc->idx2.emplace_back(global_col + kept);
+                    off_proc->vals.emplace_back(q[j]);
+                }
+                kept++;
+            }
+        }
+        on_proc->idx1[i+1] = on_proc->idx2.size();
+        off_proc->idx1[i+1] = off_proc->idx2.size();
+    }
+    on_proc->nnz = on_proc->idx2.size();
+    off_proc->nnz = off_proc->idx2.size();
+
+    // finalize() condenses the global off_proc columns and forms the
+    // communication package
+    ParCSRMatrix* T = new ParCSRMatrix(part, on_proc, off_proc);
+    part->num_shared = 0;
+    if (tap_comm)
+    {
+        T->tap_comm = new TAPComm(T->partition, T->off_proc_column_map,
+                T->on_proc_column_map, true, A->comm->mpi_comm);
+    }
+
+    return T;
+}
+
 ParCSRMatrix* fit_candidates(ParCSRMatrix* A, 
         const int n_aggs, const std::vector<int>& aggregates, 
         const std::vector<double>& B, std::vector<double>& R,
         int num_candidates, bool tap_comm, double tol)
 {
+    if (num_candidates > 1)
+    {
+        return fit_multiple_candidates(A, aggregates, B, R, num_candidates,
+                tap_comm, tol);
+    }
+
     int rank;
     RAPtor_MPI_Comm_rank(RAPtor_MPI_COMM_WORLD, &rank);
 
-    // Currently only implemented for this
-    assert(num_candidates == 1);
-    
     int col_start, col_end, row;
     int global_col, local_col;
     double val, scale;
@@ -21,7 +279,6 @@ ParCSRMatrix* fit_candidates(ParCSRMatrix* A,
 
     // Calculate off_proc_column_map and num off_proc cols
     int off_proc_num_cols;
-    std::set<int> off_proc_col_set;
     std::vector<int> off_proc_column_map;
     for (std::vector<int>::const_iterator it = aggregates.begin();
             it != aggregates.end(); ++it)
@@ -30,17 +287,16 @@ ParCSRMatrix* fit_candidates(ParCSRMatrix* A,
 
         if (*it < A->partition->first_local_col || *it > A->partition->last_local_col)
         {
-            off_proc_col_set.insert(*it);
+            off_proc_column_map.emplace_back(*it);
         }
     } 
-    std::map<int, int> global_to_local;
-    for (std::set<int>::iterator it = off_proc_col_set.begin();
-            it != off_proc_col_set.end(); ++it)
+    sort_unique(off_proc_column_map);
+    off_proc_num_cols = off_proc_column_map.size();
+    IntMap<int> global_to_local(off_proc_num_cols);
+    for (int i = 0; i < off_proc_num_cols; i++)
     {
-        global_to_local[*it] = off_proc_column_map.size();
-        off_proc_column_map.emplace_back(*it);
+        global_to_local.insert(off_proc_column_map[i], i);
     }
-    off_proc_num_cols = off_proc_column_map.size();
 
     std::vector<int> on_proc_cols(A->on_proc_num_cols, 0);
     // Create AggOp matrices
@@ -64,7 +320,7 @@ ParCSRMatrix* fit_candidates(ParCSRMatrix* A,
             }
             else
             {
-                AggOp_off->idx2.emplace_back(global_to_local[global_col]);
+                AggOp_off->idx2.emplace_back(global_to_local.find(global_col));
                 AggOp_off->vals.emplace_back(1.0);
             }
         }
@@ -76,8 +332,9 @@ ParCSRMatrix* fit_candidates(ParCSRMatrix* A,
     delete[] on_proc_partition_to_col;
 
     // Initialize CSC Matrix for tentative interpolation
-    int global_num_cols;
-    RAPtor_MPI_Allreduce(&n_aggs, &global_num_cols, 1, RAPtor_MPI_INT, RAPtor_MPI_SUM, RAPtor_MPI_COMM_WORLD);
+    index_t local_num_cols = n_aggs;
+    index_t global_num_cols;
+    RAPtor_MPI_Allreduce(&local_num_cols, &global_num_cols, 1, RAPtor_MPI_INDEX_T, RAPtor_MPI_SUM, RAPtor_MPI_COMM_WORLD);
     ParCSCMatrix* T_csc = new ParCSCMatrix(A->partition, A->global_num_rows, global_num_cols, 
             A->local_num_rows, n_aggs, off_proc_num_cols);
         
@@ -206,8 +463,42 @@ ParCSRMatrix* fit_candidates(ParCSRMatrix* A,
     return T;
 }
 
+int rigid_body_modes(int dim, int n_nodes, const double* coords,
+        std::vector<double>& B)
+{
+    int num_candidates = (dim == 3) ? 6 : (dim == 2) ? 3 : 1;
+    int row;
+    const double* x;
 
+    B.resize(n_nodes * dim * num_candidates);
+    std::fill(B.begin(), B.end(), 0.0);
+    for (int i = 0; i < n_nodes; i++)
+    {
+        x = &coords[i*dim];
 
+        // Translations
+        for (int d = 0; d < dim; d++)
+        {
+            row = i*dim + d;
+            B[row*num_candidates + d] = 1.0;
+        }
 
+        // Rotations
+        if (dim == 2)
+        {
+            B[(i*dim)*num_candidates + 2] = -x[1];
+            B[(i*dim + 1)*num_candidates + 2] = x[0];
+        }
+        else if (dim == 3)
+        {
+            B[(i*dim + 1)*num_candidates + 3] = -x[2];
+            B[(i*dim + 2)*num_candidates + 3] = x[1];
+            B[(i*dim)*num_candidates + 4] = x[2];
+            B[(i*dim + 2)*num_candidates + 4] = -x[0];
+            B[(i*dim)*num_candidates + 5] = -x[1];
+            B[(i*dim + 1)*num_candidates + 5] = x[0];
+        }
+    }
 
-
+    return num_candidates;
+}
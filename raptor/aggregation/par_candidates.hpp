@@ -8,9 +8,17 @@
 
 using namespace raptor;
 
-// TODO -- currently only accepts constant vector
+// B holds num_candidates values for each row (row-major).  R returns
+// the coarse candidates, in the same layout, for each column of T.
 ParCSRMatrix* fit_candidates(ParCSRMatrix* A, const int n_aggs, 
         const std::vector<int>& aggregates, 
         const std::vector<double>& B, std::vector<double>& R,
         int num_candidates, bool tag_comm = false, double tol = 1e-10);
+
+// Rigid body modes of n_nodes local nodes with dim displacements each
+// (dofs ordered by node), given dim coordinates per node.  B is set to
+// num_candidates values per dof, and num_candidates (3 in 2D, 6 in 3D)
+// is returned.
+int rigid_body_modes(int dim, int n_nodes, const double* coords,
+        std::vector<double>& B);
 #endif
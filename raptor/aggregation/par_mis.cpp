@@ -22,7 +22,8 @@ void comm_states(const ParCSRMatrix* A, CommPkg* comm,
     if (first_pass)
     {
         std::vector<int>& recvbuf = comm->communicate(states);
-        std::copy(recvbuf.begin(), recvbuf.end(), off_proc_states.begin());
+        std::copy(recvbuf.begin(), recvbuf.begin() + A->off_proc_num_cols, 
+                off_proc_states.begin());
     }
     else
     {
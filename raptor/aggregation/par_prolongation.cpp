@@ -3,15 +3,102 @@
 
 #include "aggregation/par_prolongation.hpp"
 
-// Assuming weighting = local (not getting approx spectral radius)
-ParCSRMatrix* jacobi_prolongation(ParCSRMatrix* A, ParCSRMatrix* T, bool tap_comm,
-        double omega, int num_smooth_steps)
+/**************************************************************
+*****   Smooth Prolongation
+**************************************************************
+***** Applies num_smooth_steps steps of P = P - diag(scale)*A*P
+***** to the tentative interpolation T.  The row scaling is
+***** applied to each product A*P, as (scale_i*A_i)*P is
+***** scale_i*(A_i*P), so A is not copied.
+*****
+***** Parameters
+***** -------------
+***** A : ParCSRMatrix*
+*****    Matrix being coarsened
+***** T : ParCSRMatrix*
+*****    Tentative interpolation (not modified)
+***** scale : std::vector<double>&
+*****    Weight of each local row of A
+***** tap_comm : bool
+*****    Whether to use node-aware communication
+***** num_smooth_steps : int
+*****    Number of smoothing steps
+**************************************************************/
+ParCSRMatrix* smooth_prolongation(ParCSRMatrix* A, ParCSRMatrix* T,
+        const std::vector<double>& scale, bool tap_comm, int num_smooth_steps)
 {
     ParCSRMatrix* AP_tmp;
     ParCSRMatrix* P_tmp;
-    ParCSRMatrix* P = T->copy();
-    ParCSRMatrix* scaled_A = A->copy();
+    ParCSRMatrix* P = T;
+
+    // P = P - (scale*(A*P))
+    for (int i = 0; i < num_smooth_steps; i++)
+    {
+        if (tap_comm)
+        {
+            if (A->tap_mat_comm == NULL)
+            {
+                A->tap_mat_comm = new TAPComm(A->partition,
+                        A->off_proc_column_map,
+                        A->on_proc_column_map,
+                        false, RAPtor_MPI_COMM_WORLD);
+            }
+            AP_tmp = A->tap_mult(P);
+        }
+        else
+        {
+            if (A->comm == NULL)
+            {
+                A->comm = new ParComm(A->partition,
+                        A->off_proc_column_map,
+                        A->on_proc_column_map,
+                        9283, RAPtor_MPI_COMM_WORLD);
+            }
+
+            AP_tmp = A->mult(P);
+        }
+
+        for (int row = 0; row < AP_tmp->local_num_rows; row++)
+        {
+            for (int j = AP_tmp->on_proc->idx1[row]; j < AP_tmp->on_proc->idx1[row+1]; j++)
+            {
+                AP_tmp->on_proc->vals[j] *= scale[row];
+            }
+            for (int j = AP_tmp->off_proc->idx1[row]; j < AP_tmp->off_proc->idx1[row+1]; j++)
+            {
+                AP_tmp->off_proc->vals[j] *= scale[row];
+            }
+        }
+
+        P_tmp = P->subtract(AP_tmp);
+        delete AP_tmp;
+        if (P != T) delete P;
+        P = P_tmp;
+        P_tmp = NULL;
+    }
+
+    if (P == T)
+    {
+        P = T->copy();
+    }
+
+    if (tap_comm)
+    {
+        P->init_tap_communicators();
+    }
+    else
+    {
+        P->comm = new ParComm(P->partition, P->off_proc_column_map,
+                P->on_proc_column_map, 9283, RAPtor_MPI_COMM_WORLD);
+    }
+
+    return P;
+}
 
+// Assuming weighting = local (not getting approx spectral radius)
+ParCSRMatrix* jacobi_prolongation(ParCSRMatrix* A, ParCSRMatrix* T, bool tap_comm,
+        double omega, int num_smooth_steps)
+{
     // Get absolute row sum for each row
     int row_start_on, row_end_on;
     int row_start_off, row_end_off;
@@ -42,63 +129,56 @@ ParCSRMatrix* jacobi_prolongation(ParCSRMatrix* A, ParCSRMatrix* T, bool tap_com
         {
             inv_sums[row] = (1.0 / fabs(row_sum)) * omega;
         }
-
-        for (int j = row_start_on; j < row_end_on; j++)
-        {
-            scaled_A->on_proc->vals[j] *= inv_sums[row];
-        }
-        for (int j = row_start_off; j < row_end_off; j++)
-        {
-            scaled_A->off_proc->vals[j] *= inv_sums[row];
-        }
     }
 
-    // P = P - (scaled_A*P)
-    for (int i = 0; i < num_smooth_steps; i++)
-    {
-        if (tap_comm)
-        {
-            if (scaled_A->tap_mat_comm == NULL)
-            {
-                scaled_A->tap_mat_comm = new TAPComm(scaled_A->partition, 
-                        scaled_A->off_proc_column_map,
-                        scaled_A->on_proc_column_map, 
-                        false, RAPtor_MPI_COMM_WORLD);
-            }
-            AP_tmp = scaled_A->tap_mult(P);
-        }
-        else
-        {
-            if (P->comm == NULL)
-            {
-                scaled_A->comm = new ParComm(scaled_A->partition, 
-                        scaled_A->off_proc_column_map,
-                        scaled_A->on_proc_column_map, 
-                        9283, RAPtor_MPI_COMM_WORLD);
-            }
-
-            AP_tmp = scaled_A->mult(P);
-        }
+    return smooth_prolongation(A, T, inv_sums, tap_comm, num_smooth_steps);
+}
 
-        P_tmp = P->subtract(AP_tmp);
-        delete AP_tmp;
-        delete P;
-        P = P_tmp;
-        P_tmp = NULL;
-    }
+/**************************************************************
+*****   Spectral Jacobi Prolongation
+**************************************************************
+***** Jacobi smoothing of T with the weight omega / rho, where
+***** rho is a Lanczos estimate of the spectral radius of
+***** D^{-1}A (see spectral_radius):
+*****    P = (I - (omega / rho) * D^{-1}A)^s * T
+*****
+***** Parameters
+***** -------------
+***** A : ParCSRMatrix*
+*****    Symmetric matrix with positive diagonal
+***** T : ParCSRMatrix*
+*****    Tentative interpolation
+***** tap_comm : bool
+*****    Whether to use node-aware communication
+***** omega : double
+*****    Weight relative to 1 / rho (default 4/3)
+***** num_smooth_steps : int
+*****    Number of smoothing steps
+***** num_iterations : int
+*****    Number of Lanczos iterations estimating rho
+**************************************************************/
+ParCSRMatrix* spectral_jacobi_prolongation(ParCSRMatrix* A, ParCSRMatrix* T,
+        bool tap_comm, double omega, int num_smooth_steps, int num_iterations)
+{
+    // Moves the diagonal to the start of each row
+    double rho = spectral_radius(A, num_iterations);
 
-    if (tap_comm)
+    int start;
+    std::vector<double> inv_diag;
+    if (A->local_num_rows)
     {
-        P->init_tap_communicators();
+        inv_diag.resize(A->local_num_rows, 0);
     }
-    else
+    for (int row = 0; row < A->local_num_rows; row++)
     {
-        P->comm = new ParComm(P->partition, P->off_proc_column_map, 
-                P->on_proc_column_map, 9283, RAPtor_MPI_COMM_WORLD);
+        start = A->on_proc->idx1[row];
+        if (rho > 0 && start < A->on_proc->idx1[row+1]
+                && A->on_proc->idx2[start] == row
+                && fabs(A->on_proc->vals[start]) > zero_tol)
+        {
+            inv_diag[row] = omega / (rho * A->on_proc->vals[start]);
+        }
     }
 
-    delete scaled_A;
-    
-    return P;
+    return smooth_prolongation(A, T, inv_diag, tap_comm, num_smooth_steps);
 }
-
@@ -6,10 +6,16 @@
 #include "core/types.hpp"
 #include "core/par_matrix.hpp"
 #include "core/par_vector.hpp"
+#include "util/linalg/par_relax.hpp"
 
 using namespace raptor;
 
 ParCSRMatrix* jacobi_prolongation(ParCSRMatrix* A, ParCSRMatrix* T, bool tap_comm = false,
         double omega = 4.0/3, int num_smooth_steps = 1);
+
+// Weighted by omega / rho(D^{-1}A) rather than by local row sums
+ParCSRMatrix* spectral_jacobi_prolongation(ParCSRMatrix* A, ParCSRMatrix* T,
+        bool tap_comm = false, double omega = 4.0/3, int num_smooth_steps = 1,
+        int num_iterations = 10);
 #endif
 
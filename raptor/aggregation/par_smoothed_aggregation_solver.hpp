@@ -26,6 +26,7 @@ namespace raptor
             agg_type = _agg_type;
             prolong_type = _prolong_type;
             num_candidates = 1;
+            num_fine_candidates = 1;
             interp_tol = 1e-10;
             prolong_smooth_steps = _prolong_smooth_steps;
             prolong_weight = _prolong_weight;
@@ -37,17 +38,62 @@ namespace raptor
 
         void setup(ParCSRMatrix* Af) 
         {
-            // TODO -- add option for B to be passed as variable
-            num_candidates = 1;
-            B.resize(Af->local_num_rows);
-            for (int i = 0; i < Af->local_num_rows; i++)
-            {
-                B[i] = 1.0;
-            }
+            candidates.clear();
+            num_fine_candidates = 1;
+            init_candidates(Af);
+            setup_helper(Af);
+        }
 
+        /**************************************************************
+        *****   Setup (with Candidates)
+        **************************************************************
+        ***** Sets up the hierarchy with _num_candidates near-nullspace
+        ***** vectors, such as the rigid body modes of elasticity.
+        ***** Each aggregate then holds up to _num_candidates coarse
+        ***** points.  The candidates are kept for resetup.
+        *****
+        ***** Parameters
+        ***** -------------
+        ***** Af : ParCSRMatrix*
+        *****    Fine-level matrix
+        ***** _candidates : std::vector<double>&
+        *****    _num_candidates values for each local row (row-major)
+        ***** _num_candidates : int
+        *****    Number of candidate vectors
+        **************************************************************/
+        void setup(ParCSRMatrix* Af, const std::vector<double>& _candidates,
+                int _num_candidates)
+        {
+            candidates = _candidates;
+            num_fine_candidates = _num_candidates;
+            init_candidates(Af);
             setup_helper(Af);
         }
 
+        void resetup(ParCSRMatrix* Af)
+        {
+            init_candidates(Af);
+            resetup_helper(Af);
+        }
+
+        // Candidates on the finest level, constant if none were given
+        void init_candidates(ParCSRMatrix* Af)
+        {
+            num_candidates = num_fine_candidates;
+            if (candidates.size())
+            {
+                B = candidates;
+            }
+            else
+            {
+                B.resize(Af->local_num_rows);
+                for (int i = 0; i < Af->local_num_rows; i++)
+                {
+                    B[i] = 1.0;
+                }
+            }
+        }
+
         void extend_hierarchy()
         {
             int level_ctr = levels.size() - 1;
@@ -57,7 +103,6 @@ namespace raptor
             ParCSRMatrix* S;
             ParCSRMatrix* T;
             ParCSRMatrix* P = NULL;
-            ParCSRMatrix* AP;
 
             std::vector<int> states;
             std::vector<int> off_proc_states;
@@ -89,25 +134,17 @@ namespace raptor
                     num_candidates, false, interp_tol);
             
 
-            switch (prolong_type)
-            {
-                case JacobiProlongation:
-                    P = jacobi_prolongation(A, T, tap_level, 
-                            prolong_weight, prolong_smooth_steps);
-                    break;
-                default:
-                    P = jacobi_prolongation(A, T, tap_level, 
-                            prolong_weight, prolong_smooth_steps);
-                    break;
-            }
+            P = form_prolongation(A, T, tap_level);
             levels[level_ctr]->P = P;
 
+            // Keep aggregates for resetup
+            levels[level_ctr]->aggregates.swap(aggregates);
+            levels[level_ctr]->n_aggs = n_aggs;
+
             // Form coarse grid operator
             levels.emplace_back(new ParLevel());
 
-            AP = A->mult(levels[level_ctr]->P, tap_level);
-
-            A = AP->mult_T(P, tap_level);
+            A = A->rap(P, tap_level);
 
             level_ctr++;
             levels[level_ctr]->A = A;
@@ -130,22 +167,81 @@ namespace raptor
                         true, A->comm->mpi_comm);
             }
 
-            std::copy(R.begin(), R.end(), B.begin());
+            B.swap(R);
 
-            delete AP;
             delete T;
             delete S;
         }    
 
+        bool reextend_level(int level)
+        {
+            bool tap_level = tap_amg >= 0 && tap_amg <= level;
+
+            ParCSRMatrix* A = levels[level]->A;
+            ParCSRMatrix* T;
+            ParCSRMatrix* P;
+            std::vector<double> R;
+
+            T = fit_candidates(A, levels[level]->n_aggs, levels[level]->aggregates,
+                    B, R, num_candidates, false, interp_tol);
+            P = form_prolongation(A, T, tap_level);
+            delete T;
+            P = agglomerate_interpolation(level, P);
+
+            // Agglomerated matrices are sorted by repartition_matrix
+            if (!reform_coarse_operator(level, P, tap_level, 
+                        levels[level+1]->agglomerated))
+            {
+                return false;
+            }
+
+            B.swap(R);
+            if (levels[level+1]->agglomerated)
+            {
+                agglomerate_row_data(B.size() / num_candidates, 
+                        levels[level+1]->A->local_num_rows);
+            }
+
+            return true;
+        }
+
+        // Candidates of coarse rows move with agglomerated rows
+        void agglomerate_row_data(int local_n, int agg_local_n)
+        {
+            B.resize(local_n * num_candidates);
+            redistribute_rows(B, local_n, agg_local_n, num_candidates, 
+                    RAPtor_MPI_DOUBLE);
+        }
+
+        ParCSRMatrix* form_prolongation(ParCSRMatrix* A, ParCSRMatrix* T,
+                bool tap_level)
+        {
+            switch (prolong_type)
+            {
+                case JacobiProlongation:
+                    return jacobi_prolongation(A, T, tap_level, 
+                            prolong_weight, prolong_smooth_steps);
+                case SpectralJacobiProlongation:
+                    return spectral_jacobi_prolongation(A, T, tap_level,
+                            prolong_weight, prolong_smooth_steps,
+                            spectral_radius_iterations);
+                default:
+                    return jacobi_prolongation(A, T, tap_level, 
+                            prolong_weight, prolong_smooth_steps);
+            }
+        }
+
 
         agg_t agg_type;
         prolong_t prolong_type;
         std::vector<double> B;
+        std::vector<double> candidates;
 
         double interp_tol;
         double prolong_weight;
         int prolong_smooth_steps;
         int num_candidates;
+        int num_fine_candidates;
 
     };
 }
@@ -91,3 +91,100 @@ TEST(TestParCandidates, TestsInAggregation)
 
 
 
+
+TEST(TestParMultipleCandidates, TestsInAggregation)
+{ 
+    int dim = 3;
+    int grid[3] = {12, 10, 10};
+    int num_candidates, iter;
+    double h = 0.1;
+    index_t node;
+
+    double* stencil = laplace_stencil_27pt();
+    ParCSRMatrix* A = par_stencil_grid(stencil, grid, dim);
+    delete[] stencil;
+
+    // Three displacements per node, so each process holds whole nodes
+    int n_nodes = A->local_num_rows / dim;
+    std::vector<double> coords(n_nodes * dim);
+    for (int i = 0; i < n_nodes; i++)
+    {
+        node = A->partition->first_local_row / dim + i;
+        coords[i*dim] = h * (node % 4);
+        coords[i*dim + 1] = h * ((node / 4) % 10);
+        coords[i*dim + 2] = h * (node / 40);
+    }
+    std::vector<double> B;
+    num_candidates = rigid_body_modes(dim, n_nodes, coords.data(), B);
+    ASSERT_EQ(num_candidates, 6);
+
+    std::vector<int> states;
+    std::vector<int> off_proc_states;
+    std::vector<int> aggregates;
+    std::vector<double> weights(A->local_num_rows);
+    for (int i = 0; i < A->local_num_rows; i++)
+    {
+        weights[i] = ((A->partition->first_local_row + i) * 7 % 13) / 13.0;
+    }
+    ParCSRMatrix* S = A->strength(Symmetric, 0.0);
+    mis2(S, states, off_proc_states, false, weights.data());
+    int n_aggs = aggregate(A, S, states, off_proc_states, aggregates, 
+            false, weights.data());
+
+    std::vector<double> R;
+    ParCSRMatrix* T = fit_candidates(A, n_aggs, aggregates, B, R, num_candidates, 
+            false, 1e-10);
+    ASSERT_EQ((int) R.size(), T->on_proc_num_cols * num_candidates);
+    ASSERT_LE(T->on_proc_num_cols, n_aggs * num_candidates);
+
+    // T reproduces the candidates from the coarse candidates
+    ParVector r(T->global_num_cols, T->on_proc_num_cols);
+    ParVector b(T->global_num_rows, T->local_num_rows);
+    for (int m = 0; m < num_candidates; m++)
+    {
+        for (int i = 0; i < T->on_proc_num_cols; i++)
+        {
+            r.local[i] = R[i*num_candidates + m];
+        }
+        T->mult(r, b);
+        for (int i = 0; i < T->local_num_rows; i++)
+        {
+            ASSERT_NEAR(b.local[i], B[i*num_candidates + m], 1e-8);
+        }
+    }
+
+    // Columns of T are orthonormal
+    ParVector c(T->global_num_cols, T->on_proc_num_cols);
+    for (int i = 0; i < T->on_proc_num_cols; i++)
+    {
+        r.local[i] = sin(T->partition->first_local_col + i);
+    }
+    T->mult(r, b);
+    T->mult_T(b, c);
+    for (int i = 0; i < T->on_proc_num_cols; i++)
+    {
+        ASSERT_NEAR(c.local[i], r.local[i], 1e-8);
+    }
+
+    // Smoothed aggregation with the candidates, and resetup reusing them
+    ParSmoothedAggregationSolver* ml = new ParSmoothedAggregationSolver(0.0);
+    ml->setup(A, B, num_candidates);
+    ASSERT_GT(ml->num_levels, 1);
+    ParVector x(A->global_num_rows, A->local_num_rows);
+    x.set_const_value(1.0);
+    A->mult(x, b);
+    x.set_const_value(0.0);
+    iter = ml->solve(x, b);
+    ASSERT_LT(iter, ml->max_iterations);
+
+    ml->resetup(A);
+    ASSERT_EQ(ml->num_candidates, num_candidates);
+    x.set_const_value(0.0);
+    ASSERT_EQ(ml->solve(x, b), iter);
+    delete ml;
+
+    delete T;
+    delete S;
+    delete A;
+
+} // end of TEST(TestParMultipleCandidates, TestsInAggregation) //
@@ -41,7 +41,35 @@ TEST(TestParProlongation, TestsInAggregation)
     ParCSRMatrix* P = jacobi_prolongation(A, T);
 
     compare(P, P_py);
+    delete P;
 
+    // Weighting by the spectral radius matches smoothing with an 
+    // explicitly scaled copy of A
+    double omega = 4.0 / 3;
+    double rho = spectral_radius(A, 10);
+    ParCSRMatrix* scaled_A = A->copy();
+    for (int i = 0; i < A->local_num_rows; i++)
+    {
+        double scale = omega / (rho * A->on_proc->vals[A->on_proc->idx1[i]]);
+        for (int j = A->on_proc->idx1[i]; j < A->on_proc->idx1[i+1]; j++)
+        {
+            scaled_A->on_proc->vals[j] *= scale;
+        }
+        for (int j = A->off_proc->idx1[i]; j < A->off_proc->idx1[i+1]; j++)
+        {
+            scaled_A->off_proc->vals[j] *= scale;
+        }
+    }
+    scaled_A->comm = new ParComm(scaled_A->partition, scaled_A->off_proc_column_map,
+            scaled_A->on_proc_column_map);
+    ParCSRMatrix* AT = scaled_A->mult(T);
+    ParCSRMatrix* P_rho = T->subtract(AT);
+    P = spectral_jacobi_prolongation(A, T, false, omega, 1, 10);
+    compare(P, P_rho);
+
+    delete P_rho;
+    delete AT;
+    delete scaled_A;
     delete P;
     delete P_py;
     delete A;
@@ -0,0 +1,180 @@
+// Copyright (c) 2015-2017, RAPtor Developer Team
+// License: Simplified BSD, http://opensource.org/licenses/BSD-2-Clause
+#ifndef RAPTOR_CORE_BLOCK_ARRAY_HPP
+#define RAPTOR_CORE_BLOCK_ARRAY_HPP
+
+#include "types.hpp"
+#include <new>
+
+namespace raptor
+{
+    // Alignment (in bytes) of block matrix value storage
+    constexpr int block_alignment = 64;
+}
+
+/**************************************************************
+ *****   AlignedAllocator
+ **************************************************************
+ ***** Minimal allocator returning memory aligned to
+ ***** block_alignment bytes, so that block values start on a
+ ***** cache line boundary
+ **************************************************************/
+namespace raptor
+{
+template <typename T>
+struct AlignedAllocator
+{
+    typedef T value_type;
+
+    AlignedAllocator() {}
+    template <typename U> AlignedAllocator(const AlignedAllocator<U>& other) {}
+
+    T* allocate(std::size_t n)
+    {
+        void* ptr = NULL;
+        if (n == 0) return NULL;
+        if (posix_memalign(&ptr, block_alignment, n * sizeof(T)))
+            throw std::bad_alloc();
+        return (T*) ptr;
+    }
+    void deallocate(T* ptr, std::size_t n)
+    {
+        free(ptr);
+    }
+};
+template <typename T, typename U>
+bool operator==(const AlignedAllocator<T>&, const AlignedAllocator<U>&) { return true; }
+template <typename T, typename U>
+bool operator!=(const AlignedAllocator<T>&, const AlignedAllocator<U>&) { return false; }
+
+/**************************************************************
+ *****   BlockArray Class
+ **************************************************************
+ ***** Stores the values of a block matrix in one contiguous,
+ ***** aligned array.  Block j occupies positions
+ ***** [j*b_size, (j+1)*b_size), and operator[] returns a
+ ***** pointer to the first value of block j.  Blocks are copied
+ ***** in and out, never owned individually.
+ *****
+ ***** Attributes
+ ***** -------------
+ ***** b_size : int
+ *****    Number of values in each block
+ ***** n_blocks : int
+ *****    Number of blocks stored
+ ***** values : aligned std::vector<double>
+ *****    All block values, block after block
+ **************************************************************/
+class BlockArray
+{
+  public:
+    BlockArray(int _b_size = 1)
+    {
+        b_size = _b_size;
+        n_blocks = 0;
+    }
+
+    double* operator[](int j)
+    {
+        return values.data() + (std::size_t) j * b_size;
+    }
+    const double* operator[](int j) const
+    {
+        return values.data() + (std::size_t) j * b_size;
+    }
+
+    int size() const
+    {
+        return n_blocks;
+    }
+
+    double* data()
+    {
+        return values.data();
+    }
+    const double* data() const
+    {
+        return values.data();
+    }
+
+    // Changes the number of values per block (existing values are
+    // reinterpreted, so only call on an empty array)
+    void set_block_size(int _b_size)
+    {
+        b_size = _b_size;
+        values.resize((std::size_t) n_blocks * b_size, 0.0);
+    }
+
+    void resize(int n)
+    {
+        values.resize((std::size_t) n * b_size, 0.0);
+        n_blocks = n;
+    }
+
+    void reserve(int n)
+    {
+        values.reserve((std::size_t) n * b_size);
+    }
+
+    void clear()
+    {
+        values.clear();
+        n_blocks = 0;
+    }
+
+    void shrink_to_fit()
+    {
+        values.shrink_to_fit();
+    }
+
+    // Appends a copy of block (which must not point into this array)
+    void emplace_back(const double* block)
+    {
+        values.insert(values.end(), block, block + b_size);
+        n_blocks++;
+    }
+    void push_back(const double* block)
+    {
+        emplace_back(block);
+    }
+
+    // Copies block into position j
+    void set(int j, const double* block)
+    {
+        double* dest = (*this)[j];
+        if (dest != block)
+            std::copy(block, block + b_size, dest);
+    }
+
+    // Sets every value of block j to zero
+    void zero(int j)
+    {
+        std::fill((*this)[j], (*this)[j] + b_size, 0.0);
+    }
+
+    void swap(int i, int j)
+    {
+        std::swap_ranges((*this)[i], (*this)[i] + b_size, (*this)[j]);
+    }
+
+    // Rotates blocks [first, last) so that block middle becomes first
+    void rotate(int first, int middle, int last)
+    {
+        std::rotate((*this)[first], (*this)[middle], (*this)[last]);
+    }
+
+    int b_size;
+    int n_blocks;
+    std::vector<double, AlignedAllocator<double>> values;
+};
+
+// Swap positions i and j of a value list (called from the
+// templated sorts in core/utilities.hpp)
+inline void swap_vals(BlockArray& vals, int i, int j)
+{
+    vals.swap(i, j);
+}
+
+}
+
+#endif
@@ -117,16 +117,10 @@ public:
 
     virtual void send(char* send_buffer,
             const int* rowptr, 
-            const int* col_indices,
+            const index_t* col_indices,
             const double* values, 
             int key, RAPtor_MPI_Comm mpi_comm, 
             const int block_size = 1) = 0;
-    virtual void send(char* send_buffer,
-            const int* rowptr, 
-            const int* col_indices,
-            double const* const* values, 
-            int key, RAPtor_MPI_Comm mpi_comm, 
-            const int block_size = 1) = 0;
     virtual int get_msg_size(const int* rowptr, 
             const bool has_vals, RAPtor_MPI_Comm mpi_comm, 
             const int block_size = 1) = 0;
@@ -167,6 +161,7 @@ public:
             std::function<bool(int)> compare_func,
             int* s_recv_ptr, int* n_recv_ptr, const int block_size = 1) = 0;
 
+    // Received rows keep their global columns, in recv_mat->global_idx2
     void recv(CSRMatrix* recv_mat, int key, RAPtor_MPI_Comm mpi_comm, const int block_size = 1,
             const bool vals = true)
     {
@@ -207,9 +202,10 @@ public:
                         mpi_comm);
                 recv_mat->idx1[row_count + 1] = recv_size + row_size;
                 row_count++;
-                recv_mat->idx2.resize(recv_size + row_size);
-                RAPtor_MPI_Unpack(recv_buffer.data(), count, &ctr, &recv_mat->idx2[recv_size],
-                        row_size, RAPtor_MPI_INT, mpi_comm);
+                recv_mat->global_idx2.resize(recv_size + row_size);
+                RAPtor_MPI_Unpack(recv_buffer.data(), count, &ctr, 
+                        &recv_mat->global_idx2[recv_size], row_size, 
+                        RAPtor_MPI_INDEX_T, mpi_comm);
                 
                 if (vals)
                 {
@@ -217,13 +213,9 @@ public:
                     {
                         BSRMatrix* recv_mat_bsr = (BSRMatrix*) recv_mat;
                         recv_mat_bsr->block_vals.resize(recv_size + row_size);
-                        for (int k = 0; k < row_size; k++)
-                        {
-                            recv_mat_bsr->block_vals[recv_size + k] = new double[block_size];
-                            RAPtor_MPI_Unpack(recv_buffer.data(), count, &ctr, 
-                                    recv_mat_bsr->block_vals[recv_size + k],
-                                    block_size, RAPtor_MPI_DOUBLE, mpi_comm);
-                        }
+                        RAPtor_MPI_Unpack(recv_buffer.data(), count, &ctr, 
+                                recv_mat_bsr->block_vals[recv_size],
+                                row_size * block_size, RAPtor_MPI_DOUBLE, mpi_comm);
                     }
                     else
                     {
@@ -235,7 +227,7 @@ public:
                 recv_size += row_size;
             }
         }
-        recv_mat->nnz = recv_mat->idx2.size();
+        recv_mat->nnz = recv_mat->global_idx2.size();
     }
 
  
@@ -254,20 +246,13 @@ public:
         }
     }
 
+    // Block values are stored contiguously, so the values of 
+    // positions [row_start, row_start + size) are packed at once
     void pack_values(const double* values, int row_start, int size, char* send_buffer,
            int bytes, int* ctr, RAPtor_MPI_Comm mpi_comm, int block_size)
     {
-        RAPtor_MPI_Pack(&(values[row_start]), size, RAPtor_MPI_DOUBLE, send_buffer, 
-                bytes, ctr, mpi_comm);
-    }
-    void pack_values(double const* const* values, int row_start, int size, 
-            char* send_buffer, int bytes, int* ctr, RAPtor_MPI_Comm mpi_comm, int block_size)
-    {
-        for (int i = 0; i < size; i++)
-        {
-            RAPtor_MPI_Pack(values[row_start + i], block_size, RAPtor_MPI_DOUBLE, send_buffer,
-                    bytes, ctr, mpi_comm);
-        }
+        RAPtor_MPI_Pack(&(values[row_start * block_size]), size * block_size, 
+                RAPtor_MPI_DOUBLE, send_buffer, bytes, ctr, mpi_comm);
     }
 
     template <typename T>
@@ -498,7 +483,7 @@ public:
 
     void send(char* send_buffer,
             const int* rowptr, 
-            const int* col_indices,
+            const index_t* col_indices,
             const double* values, 
             int key, RAPtor_MPI_Comm mpi_comm, 
             const int block_size = 1)
@@ -507,33 +492,26 @@ public:
                 mpi_comm, block_size);
     }
 
-    void send(char* send_buffer,
-        const int* rowptr,
-        const int* col_indices,
-        double const* const* values,
-        int key, RAPtor_MPI_Comm mpi_comm,
-        const int block_size = 1)     
-    {
-        send_helper(send_buffer, rowptr, col_indices, values, key,
-                mpi_comm, block_size);
-    }
 
     int get_msg_size(const int* rowptr, const bool has_vals, RAPtor_MPI_Comm mpi_comm, 
             const int block_size = 1)
     {
         int start, end;
         int row_start, row_end;
-        int num_ints, num_doubles;
-        int double_bytes, bytes;
+        int num_ints, num_indices, num_doubles;
+        int index_bytes, double_bytes, bytes;
 
-        // Calculate total msg size
+        // Calculate total msg size (row sizes, global columns, values)
         start = indptr[0];
         end = indptr[num_msgs];
         row_start = rowptr[start];
         row_end = rowptr[end];
-        num_ints = (row_end - row_start) + (end - start);
+        num_ints = end - start;
+        num_indices = row_end - row_start;
         num_doubles = (row_end - row_start) * block_size;
         RAPtor_MPI_Pack_size(num_ints, RAPtor_MPI_INT, mpi_comm, &bytes);
+        RAPtor_MPI_Pack_size(num_indices, RAPtor_MPI_INDEX_T, mpi_comm, &index_bytes);
+        bytes += index_bytes;
 
         if (has_vals)
         {
@@ -544,11 +522,11 @@ public:
         return bytes;
     }
 
-    // values can be double* (CSRMatrix) or double** (BSRMatrix)
+    // values are double* for both CSRMatrix and BSRMatrix (contiguous blocks)
     template <typename T>
     void send_helper(char* send_buffer,
         const int* rowptr,
-        const int* col_indices,
+        const index_t* col_indices,
         const T& values,
         int key, RAPtor_MPI_Comm mpi_comm,
         const int block_size = 1)
@@ -576,7 +554,7 @@ public:
                 size = row_end - row_start;
                 RAPtor_MPI_Pack(&size, 1, RAPtor_MPI_INT, send_buffer, bytes, 
                         &ctr, mpi_comm);
-                RAPtor_MPI_Pack(&(col_indices[row_start]), size, RAPtor_MPI_INT,
+                RAPtor_MPI_Pack(&(col_indices[row_start]), size, RAPtor_MPI_INDEX_T,
                         send_buffer, bytes, &ctr, mpi_comm);
                 if (values)
                 {
@@ -766,6 +744,107 @@ public:
         finalize();
     }
 
+    // Probe for global indices, returned in global_indices (indices are
+    // resized but left for the caller to map to local)
+    void probe(int size, int key, RAPtor_MPI_Comm mpi_comm,
+            std::vector<index_t>& global_indices)
+    {
+        int proc, count;
+        int size_recvd;
+        RAPtor_MPI_Status recv_status;
+
+        size_msgs = size;
+        indices.resize(size_msgs);
+        global_indices.resize(size_msgs);
+        indptr[0] = 0;
+        size_recvd = 0;
+        while (size_recvd < size_msgs)
+        {
+            RAPtor_MPI_Probe(RAPtor_MPI_ANY_SOURCE, key, mpi_comm, &recv_status);
+            proc = recv_status.RAPtor_MPI_SOURCE;
+            RAPtor_MPI_Get_count(&recv_status, RAPtor_MPI_INDEX_T, &count);
+            RAPtor_MPI_Recv(&(global_indices[size_recvd]), count, RAPtor_MPI_INDEX_T, 
+                    proc, key, mpi_comm, &recv_status);
+            size_recvd += count;
+            procs.emplace_back(proc);
+            indptr.emplace_back(size_recvd);
+        }
+        num_msgs = procs.size();
+        finalize();
+    }
+
+    // Receive messages when the number of senders is not known (NBX).
+    // Each process has posted its messages with synchronous sends
+    // (send_requests), so the sends complete only once matched.  A
+    // process enters a non-blocking barrier when its own sends are
+    // complete, and all messages are received once the barrier completes.
+    void nbx_probe(int key, RAPtor_MPI_Comm mpi_comm, int n_sends,
+            RAPtor_MPI_Request* send_requests)
+    {
+        nbx_recv(key, mpi_comm, n_sends, send_requests, indices, RAPtor_MPI_INT);
+    }
+
+    // NBX probe for global indices, returned in global_indices
+    void nbx_probe(int key, RAPtor_MPI_Comm mpi_comm, int n_sends,
+            RAPtor_MPI_Request* send_requests, std::vector<index_t>& global_indices)
+    {
+        nbx_recv(key, mpi_comm, n_sends, send_requests, global_indices,
+                RAPtor_MPI_INDEX_T);
+        indices.resize(size_msgs);
+    }
+
+    template <typename T>
+    void nbx_recv(int key, RAPtor_MPI_Comm mpi_comm, int n_sends,
+            RAPtor_MPI_Request* send_requests, std::vector<T>& values,
+            RAPtor_MPI_Datatype datatype)
+    {
+        int proc, count, flag;
+        bool barrier_active = false;
+        RAPtor_MPI_Request barrier_request;
+        RAPtor_MPI_Status recv_status;
+
+        size_msgs = 0;
+        indptr[0] = 0;
+        values.clear();
+        while (true)
+        {
+            RAPtor_MPI_Iprobe(RAPtor_MPI_ANY_SOURCE, key, mpi_comm, &flag, &recv_status);
+            if (flag)
+            {
+                proc = recv_status.RAPtor_MPI_SOURCE;
+                RAPtor_MPI_Get_count(&recv_status, datatype, &count);
+                values.resize(size_msgs + count);
+                RAPtor_MPI_Recv(values.data() + size_msgs, count, datatype, proc,
+                        key, mpi_comm, &recv_status);
+                size_msgs += count;
+                procs.emplace_back(proc);
+                indptr.emplace_back(size_msgs);
+            }
+            else if (barrier_active)
+            {
+                RAPtor_MPI_Test(&barrier_request, &flag, RAPtor_MPI_STATUS_IGNORE);
+                if (flag) break;
+            }
+            else
+            {
+                RAPtor_MPI_Testall(n_sends, send_requests, &flag,
+                        RAPtor_MPI_STATUSES_IGNORE);
+                if (flag)
+                {
+                    RAPtor_MPI_Ibarrier(mpi_comm, &barrier_request);
+                    barrier_active = true;
+                }
+            }
+        }
+        num_msgs = procs.size();
+        finalize();
+
+        // A process may leave the loop while others are still probing.
+        // Without this barrier, messages of the next exchange with the same
+        // key could be received by the exchange still in progress.
+        RAPtor_MPI_Barrier(mpi_comm);
+    }
+
     void int_send(const int* values, int key, RAPtor_MPI_Comm mpi_comm, const int block_size,
             std::function<int(int, int)> init_result_func,
             int init_result_func_val)
@@ -893,7 +972,7 @@ public:
 
     void send(char* send_buffer,
             const int* rowptr, 
-            const int* col_indices,
+            const index_t* col_indices,
             const double* values, 
             int key, RAPtor_MPI_Comm mpi_comm, 
             const int block_size = 1)
@@ -902,24 +981,14 @@ public:
                 mpi_comm, block_size);
     }
 
-    void send(char* send_buffer,
-        const int* rowptr,
-        const int* col_indices,
-        double const* const* values,
-        int key, RAPtor_MPI_Comm mpi_comm,
-        const int block_size = 1)     
-    {
-        send_helper(send_buffer, rowptr, col_indices, values, key,
-                mpi_comm, block_size);
-    }
 
     int get_msg_size(const int* rowptr, const bool has_vals, RAPtor_MPI_Comm mpi_comm,
             const int block_size = 1)
     {
-        int num_ints, num_doubles;
-        int double_bytes, bytes;
+        int num_ints, num_indices, num_doubles;
+        int index_bytes, double_bytes, bytes;
 
-        // Calculate message size
+        // Calculate message size (row sizes, global columns, values)
         num_ints = indptr[num_msgs] - indptr[0];
         num_doubles = 0;
         for (std::vector<int>::iterator it = indices.begin();
@@ -927,8 +996,10 @@ public:
         {
             num_doubles += (rowptr[*it+1] - rowptr[*it]);
         }
-        num_ints += num_doubles;
+        num_indices = num_doubles;
         RAPtor_MPI_Pack_size(num_ints, RAPtor_MPI_INT, mpi_comm, &bytes);
+        RAPtor_MPI_Pack_size(num_indices, RAPtor_MPI_INDEX_T, mpi_comm, &index_bytes);
+        bytes += index_bytes;
 
         if (has_vals)
         {
@@ -942,7 +1013,7 @@ public:
     template <typename T>
     void send_helper(char* send_buffer,
         const int* rowptr,
-        const int* col_indices,
+        const index_t* col_indices,
         const T& values,
         int key, RAPtor_MPI_Comm mpi_comm,
         const int block_size = 1)     
@@ -972,7 +1043,7 @@ public:
                 size = (row_end - row_start);
                 RAPtor_MPI_Pack(&size, 1, RAPtor_MPI_INT, send_buffer, bytes, 
                         &ctr, mpi_comm);
-                RAPtor_MPI_Pack(&(col_indices[row_start]), size, RAPtor_MPI_INT, 
+                RAPtor_MPI_Pack(&(col_indices[row_start]), size, RAPtor_MPI_INDEX_T, 
                         send_buffer, bytes, &ctr, mpi_comm);
                 if (values)
                 {                    
@@ -1216,24 +1287,14 @@ public:
 
     }
 
-    void append_val(std::vector<double>& vec, const double val, int block_size)
-    {
-        vec.emplace_back(val);
-    }
-    void append_val(std::vector<double>& vec, const double* val, int block_size)
-    {
-        for (int i = 0; i < block_size; i++)
-            vec.emplace_back(val[i]);
-    }
-    
     template <typename T>
-    void combine_entries(int j, const int* rowptr, const int* col_indices, 
-            const T& values, int block_size, std::vector<int>& send_indices, 
-            std::vector<double>& send_values, int* size_ptr)
+    void combine_entries(int j, const int* rowptr, const index_t* col_indices, 
+            const T& values, int block_size, std::vector<index_t>& send_indices, 
+            BlockArray& send_values, int* size_ptr)
     {
         int idx_start, idx_end;
         int row_start, row_end;
-        int size, row, idx, ctr;
+        int size, row;
 
         idx_start = indptr_T[j];
         idx_end = indptr_T[j+1];
@@ -1245,7 +1306,7 @@ public:
             for (int l = row_start; l < row_end; l++)
             {
                 send_indices.emplace_back(col_indices[l]);
-                append_val(send_values, values[l], block_size);
+                send_values.emplace_back(&(values[l * block_size]));
             }
         }
         if (send_indices.size())
@@ -1256,22 +1317,18 @@ public:
             int s_send = send_indices.size();
             for (int k = 1; k < s_send; k++)
             {
-                ctr = k * block_size;
                 if (send_indices[k] != send_indices[size - 1])
                 {
-                    idx = size * block_size;
-                    for (int i = 0; i < block_size; i++)
-                    {
-                        send_values[idx + i] = send_values[ctr + i];
-                    }
+                    send_values.set(size, send_values[k]);
                     send_indices[size++] = send_indices[k];
                 }
                 else
                 {
-                    idx = (size - 1) * block_size;
+                    double* sum = send_values[size - 1];
+                    const double* addl = send_values[k];
                     for (int i = 0; i < block_size; i++)
                     {
-                        send_values[idx + i] += send_values[ctr + i];
+                        sum[i] += addl[i];
                     }
                 }
             } 
@@ -1281,8 +1338,8 @@ public:
         *size_ptr = size;
     }
     
-    void combine_entries(int j, const int* rowptr, const int* col_indices, 
-            std::vector<int>& send_indices, int* size_ptr)
+    void combine_entries(int j, const int* rowptr, const index_t* col_indices, 
+            std::vector<index_t>& send_indices, int* size_ptr)
     {
         int idx_start, idx_end;
         int row_start, row_end;
@@ -1323,28 +1380,19 @@ public:
     //
     void send(char* send_buffer,
             const int* rowptr, 
-            const int* col_indices,
+            const index_t* col_indices,
             const double* values, 
             int key, RAPtor_MPI_Comm mpi_comm, 
             const int block_size = 1)
     {
         send_helper(send_buffer, rowptr, col_indices, values, key, mpi_comm, block_size);
     }
-    void send(char* send_buffer,
-            const int* rowptr, 
-            const int* col_indices,
-            double const* const* values, 
-            int key, RAPtor_MPI_Comm mpi_comm, 
-            const int block_size = 1)
-    {
-        send_helper(send_buffer, rowptr, col_indices, values, key, mpi_comm, block_size);
-    }
 
     int get_msg_size(const int* rowptr, const bool has_vals, RAPtor_MPI_Comm mpi_comm, 
             const int block_size = 1)
     {
-        int num_ints, num_doubles;
-        int double_bytes, bytes;
+        int num_ints, num_indices, num_doubles;
+        int index_bytes, double_bytes, bytes;
 
         // Calculate message size (upper bound)
         num_ints = indptr[num_msgs] - indptr[0];
@@ -1354,8 +1402,10 @@ public:
         {
             num_doubles += (rowptr[*it+1] - rowptr[*it]);
         }
-        num_ints += num_doubles;
+        num_indices = num_doubles;
         RAPtor_MPI_Pack_size(num_ints, RAPtor_MPI_INT, mpi_comm, &bytes);
+        RAPtor_MPI_Pack_size(num_indices, RAPtor_MPI_INDEX_T, mpi_comm, &index_bytes);
+        bytes += index_bytes;
         if (has_vals)
         {
             RAPtor_MPI_Pack_size(num_doubles * block_size, RAPtor_MPI_DOUBLE, mpi_comm, &double_bytes);
@@ -1368,7 +1418,7 @@ public:
     template <typename T>
     void send_helper(char* send_buffer,
             const int* rowptr, 
-            const int* col_indices,
+            const index_t* col_indices,
             const T& values, 
             int key, RAPtor_MPI_Comm mpi_comm, 
             const int block_size = 1)
@@ -1391,8 +1441,8 @@ public:
             end = indptr[i+1];
             for (int j = start; j < end; j++)
             {
-                std::vector<int> send_indices;
-                std::vector<double> send_values;
+                std::vector<index_t> send_indices;
+                BlockArray send_values(block_size);
                 
                 if (values)
                 {
@@ -1404,7 +1454,7 @@ public:
                     combine_entries(j, rowptr, col_indices, send_indices, &size);
                 }
                 RAPtor_MPI_Pack(&size, 1, RAPtor_MPI_INT, send_buffer, bytes, &ctr, mpi_comm);
-                RAPtor_MPI_Pack(send_indices.data(), size, RAPtor_MPI_INT, send_buffer,
+                RAPtor_MPI_Pack(send_indices.data(), size, RAPtor_MPI_INDEX_T, send_buffer,
                     bytes, &ctr, mpi_comm);
 
                 if (values)
@@ -9,29 +9,30 @@ using namespace raptor;
 // Forward Declarations
 
 // Helper Methods
-template <typename T> std::vector<T>& create_mat(int n, int m, int b_n, int b_m,
+template <typename VecType> VecType& create_mat(int n, int m, int b_n, int b_m,
         CSRMatrix** mat_ptr);
 template <typename T> CSRMatrix* communication_helper(const int* rowptr,
-        const int* col_indices, const T& values,
+        const index_t* col_indices, const T& values,
         CommData* send_comm, CommData* recv_comm, int key, RAPtor_MPI_Comm mpi_comm, 
         const int b_rows, const int b_cols, const bool has_vals = true);
 template <typename T> void init_comm_helper(char* send_buffer,
-        const int* rowptr, const int* col_indices, const T& values,
+        const int* rowptr, const index_t* col_indices, const T& values,
         CommData* send_comm, int key, RAPtor_MPI_Comm mpi_comm, const int b_rows, 
         const int b_cols);
 CSRMatrix* complete_comm_helper(CommData* send_comm, 
         CommData* recv_comm, int key, RAPtor_MPI_Comm mpi_comm, const int b_rows, 
         const int b_cols, const bool has_vals = true);
 
-template <typename T> CSRMatrix* transpose_recv(CSRMatrix* recv_mat_T, 
-        std::vector<T>& T_vals, NonContigData* send_data, int n);
-template <typename T> CSRMatrix* combine_recvs(CSRMatrix* L_mat, CSRMatrix* R_mat, 
-        std::vector<T>& L_vals, std::vector<T>& R_vals, const int b_rows, 
+template <typename VecType> CSRMatrix* transpose_recv(CSRMatrix* recv_mat_T, 
+        VecType& T_vals, NonContigData* send_data, int n);
+template <typename VecType> CSRMatrix* combine_recvs(CSRMatrix* L_mat, CSRMatrix* R_mat, 
+        VecType& L_vals, VecType& R_vals, const int b_rows, 
         const int b_cols, NonContigData* local_L_recv, NonContigData* local_R_recv, 
         std::vector<int>& row_sizes);
-template <typename T> CSRMatrix* combine_recvs_T(CSRMatrix* L_mat, 
+template <typename VecType> void sort_global_rows(CSRMatrix* recv_mat, VecType& vals);
+template <typename VecType> CSRMatrix* combine_recvs_T(CSRMatrix* L_mat, 
         CSRMatrix* final_mat, NonContigData* local_L_send, NonContigData* final_send, 
-        std::vector<T>& L_vals, std::vector<T>& final_vals, int n, 
+        VecType& L_vals, VecType& final_vals, int n, 
         int b_rows, int b_cols);
 
 
@@ -55,11 +56,11 @@ void CommPkg::init_par_mat_comm(ParCSRMatrix* A, std::vector<char>& send_buffer,
 {
     int start, end;
     int ctr;
-    int global_col;
+    index_t global_col;
 
     int nnz = A->on_proc->nnz + A->off_proc->nnz;
     std::vector<int> rowptr(A->local_num_rows + 1);
-    std::vector<int> col_indices;
+    std::vector<index_t> col_indices;
     std::vector<double> values;
     if (nnz)
     {
@@ -99,12 +100,12 @@ void CommPkg::init_par_mat_comm(ParBSRMatrix* A, std::vector<char>& send_buffer,
 {
     int start, end;
     int ctr;
-    int global_col;
+    index_t global_col;
 
     int nnz = A->on_proc->nnz + A->off_proc->nnz;
     std::vector<int> rowptr(A->local_num_rows + 1);
-    std::vector<int> col_indices;
-    std::vector<double*> values;
+    std::vector<index_t> col_indices;
+    BlockArray values(A->on_proc->b_size);
     if (nnz)
     {
         col_indices.resize(nnz);
@@ -124,7 +125,7 @@ void CommPkg::init_par_mat_comm(ParBSRMatrix* A, std::vector<char>& send_buffer,
         for (int j = start; j < end; j++)
         {
             global_col = A->on_proc_column_map[A->on_proc->idx2[j]];
-            if (has_vals) values[ctr] = A->on_proc->copy_val(A_on->block_vals[j]);
+            if (has_vals) values.set(ctr, A_on->block_vals[j]);
             col_indices[ctr++] = global_col;
         }
 
@@ -133,7 +134,7 @@ void CommPkg::init_par_mat_comm(ParBSRMatrix* A, std::vector<char>& send_buffer,
         for (int j = start; j < end; j++)
         {
             global_col = A->off_proc_column_map[A->off_proc->idx2[j]];
-            if (has_vals) values[ctr] = A->off_proc->copy_val(A_off->block_vals[j]);
+            if (has_vals) values.set(ctr, A_off->block_vals[j]);
             col_indices[ctr++] = global_col;
         }
         rowptr[i+1] = ctr;
@@ -143,7 +144,7 @@ void CommPkg::init_par_mat_comm(ParBSRMatrix* A, std::vector<char>& send_buffer,
 }
 
 CSRMatrix* ParComm::communicate(const std::vector<int>& rowptr, 
-        const std::vector<int>& col_indices, const std::vector<double>& values, 
+        const std::vector<index_t>& col_indices, const std::vector<double>& values, 
         const int b_rows, const int b_cols, const bool has_vals)
 {
     std::vector<char> send_buffer;
@@ -151,7 +152,7 @@ CSRMatrix* ParComm::communicate(const std::vector<int>& rowptr,
     return complete_mat_comm(b_rows, b_cols, has_vals);
 }
 CSRMatrix* ParComm::communicate(const std::vector<int>& rowptr, 
-        const std::vector<int>& col_indices, const std::vector<double*>& values, 
+        const std::vector<index_t>& col_indices, const BlockArray& values, 
         const int b_rows, const int b_cols, const bool has_vals)
 {
     std::vector<char> send_buffer;
@@ -160,7 +161,7 @@ CSRMatrix* ParComm::communicate(const std::vector<int>& rowptr,
 }
 
 void ParComm::init_mat_comm(std::vector<char>& send_buffer,
-        const std::vector<int>& rowptr, const std::vector<int>& col_indices, 
+        const std::vector<int>& rowptr, const std::vector<index_t>& col_indices, 
         const std::vector<double>& values, const int b_rows, const int b_cols, 
         const bool has_vals)
 {
@@ -170,8 +171,8 @@ void ParComm::init_mat_comm(std::vector<char>& send_buffer,
             send_data, key, mpi_comm, b_rows, b_cols);
 }
 void ParComm::init_mat_comm(std::vector<char>& send_buffer,
-        const std::vector<int>& rowptr, const std::vector<int>& col_indices, 
-        const std::vector<double*>& values, const int b_rows, const int b_cols,
+        const std::vector<int>& rowptr, const std::vector<index_t>& col_indices, 
+        const BlockArray& values, const int b_rows, const int b_cols,
         const bool has_vals)
 {
     int s = send_data->get_msg_size(rowptr.data(), values.data(), mpi_comm, b_rows * b_cols);
@@ -191,7 +192,7 @@ CSRMatrix* ParComm::complete_mat_comm(const int b_rows, const int b_cols,
 
 
 CSRMatrix* ParComm::communicate_T(const std::vector<int>& rowptr, 
-        const std::vector<int>& col_indices, const std::vector<double>& values,
+        const std::vector<index_t>& col_indices, const std::vector<double>& values,
         const int n_result_rows, const int b_rows, const int b_cols, const bool has_vals)
 {
     std::vector<char> send_buffer;
@@ -199,7 +200,7 @@ CSRMatrix* ParComm::communicate_T(const std::vector<int>& rowptr,
     return complete_mat_comm_T(n_result_rows, b_rows, b_cols, has_vals);
 }
 CSRMatrix* ParComm::communicate_T(const std::vector<int>& rowptr, 
-        const std::vector<int>& col_indices, const std::vector<double*>& values,
+        const std::vector<index_t>& col_indices, const BlockArray& values,
         const int n_result_rows, const int b_rows, const int b_cols, const bool has_vals)
 {
     std::vector<char> send_buffer;
@@ -207,7 +208,7 @@ CSRMatrix* ParComm::communicate_T(const std::vector<int>& rowptr,
     return complete_mat_comm_T(n_result_rows, b_rows, b_cols, has_vals);
 }
 void ParComm::init_mat_comm_T(std::vector<char>& send_buffer, const std::vector<int>& rowptr, 
-        const std::vector<int>& col_indices, const std::vector<double>& values,
+        const std::vector<index_t>& col_indices, const std::vector<double>& values,
         const int b_rows, const int b_cols, const bool has_vals)
 {
     int s = recv_data->get_msg_size(rowptr.data(), values.data(), mpi_comm, b_rows * b_cols);
@@ -216,7 +217,7 @@ void ParComm::init_mat_comm_T(std::vector<char>& send_buffer, const std::vector<
             recv_data, key, mpi_comm, b_rows, b_cols);
 }
 void ParComm::init_mat_comm_T(std::vector<char>& send_buffer, const std::vector<int>& rowptr, 
-        const std::vector<int>& col_indices, const std::vector<double*>& values,
+        const std::vector<index_t>& col_indices, const BlockArray& values,
         const int b_rows, const int b_cols, const bool has_vals)
 {
     int s = recv_data->get_msg_size(rowptr.data(), values.data(), mpi_comm, b_rows * b_cols);
@@ -252,7 +253,7 @@ CSRMatrix* ParComm::complete_mat_comm_T(const int n_result_rows, const int b_row
 
 
 CSRMatrix* TAPComm::communicate(const std::vector<int>& rowptr, 
-        const std::vector<int>& col_indices, const std::vector<double>& values,
+        const std::vector<index_t>& col_indices, const std::vector<double>& values,
         const int b_rows, const int b_cols, const bool has_vals)
 {
     std::vector<char> send_buffer;  
@@ -261,7 +262,7 @@ CSRMatrix* TAPComm::communicate(const std::vector<int>& rowptr,
 }
 
 CSRMatrix* TAPComm::communicate(const std::vector<int>& rowptr, 
-        const std::vector<int>& col_indices, const std::vector<double*>& values,
+        const std::vector<index_t>& col_indices, const BlockArray& values,
         const int b_rows, const int b_cols, const bool has_vals)
 {   
     std::vector<char> send_buffer;  
@@ -269,7 +270,7 @@ CSRMatrix* TAPComm::communicate(const std::vector<int>& rowptr,
     return complete_mat_comm(b_rows, b_cols, has_vals);
 }
 void TAPComm::init_mat_comm(std::vector<char>& send_buffer, const std::vector<int>& rowptr, 
-        const std::vector<int>& col_indices, const std::vector<double>& values,
+        const std::vector<index_t>& col_indices, const std::vector<double>& values,
         const int b_rows, const int b_cols, const bool has_vals)
 {  
     int block_size = b_rows * b_cols;
@@ -286,7 +287,7 @@ void TAPComm::init_mat_comm(std::vector<char>& send_buffer, const std::vector<in
         send_buffer.resize(l_bytes + g_bytes);
 
         init_comm_helper(&(send_buffer[0]), S_mat->idx1.data(),
-                S_mat->idx2.data(), S_mat->vals.data(), global_par_comm->send_data, 
+                S_mat->global_idx2.data(), S_mat->vals.data(), global_par_comm->send_data, 
                 global_par_comm->key, global_par_comm->mpi_comm, b_rows, b_cols);
         delete S_mat;
     }
@@ -307,7 +308,7 @@ void TAPComm::init_mat_comm(std::vector<char>& send_buffer, const std::vector<in
 
 
 void TAPComm::init_mat_comm(std::vector<char>& send_buffer, const std::vector<int>& rowptr, 
-        const std::vector<int>& col_indices, const std::vector<double*>& values,
+        const std::vector<index_t>& col_indices, const BlockArray& values,
         const int b_rows, const int b_cols, const bool has_vals)
 {  
     int block_size = b_rows * b_cols;
@@ -324,7 +325,7 @@ void TAPComm::init_mat_comm(std::vector<char>& send_buffer, const std::vector<in
         send_buffer.resize(l_bytes + g_bytes);
 
         init_comm_helper(&(send_buffer[0]), S_mat->idx1.data(),
-                S_mat->idx2.data(), S_mat->vals.data(), global_par_comm->send_data, 
+                S_mat->global_idx2.data(), S_mat->block_vals.data(), global_par_comm->send_data, 
                 global_par_comm->key, global_par_comm->mpi_comm, b_rows, b_cols);
         delete S_mat;
     }
@@ -353,7 +354,7 @@ CSRMatrix* TAPComm::complete_mat_comm(const int b_rows, const int b_cols, const
     if (b_rows > 1 || b_cols > 1)
     {
         BSRMatrix* G_mat_bsr = (BSRMatrix*) G_mat;
-        R_mat = local_R_par_comm->communicate(G_mat_bsr->idx1, G_mat_bsr->idx2, 
+        R_mat = local_R_par_comm->communicate(G_mat_bsr->idx1, G_mat_bsr->global_idx2, 
             G_mat_bsr->block_vals, b_rows, b_cols, has_vals);
 
         BSRMatrix* R_mat_bsr = (BSRMatrix*) R_mat;
@@ -368,7 +369,7 @@ CSRMatrix* TAPComm::complete_mat_comm(const int b_rows, const int b_cols, const
     }
     else
     {
-        R_mat = local_R_par_comm->communicate(G_mat->idx1, G_mat->idx2, 
+        R_mat = local_R_par_comm->communicate(G_mat->idx1, G_mat->global_idx2, 
                 G_mat->vals, b_rows, b_cols, has_vals);
 
         // Create recv_mat (combination of L_mat and R_mat)
@@ -387,7 +388,7 @@ CSRMatrix* TAPComm::complete_mat_comm(const int b_rows, const int b_cols, const
 
 
 CSRMatrix* TAPComm::communicate_T(const std::vector<int>& rowptr, 
-        const std::vector<int>& col_indices, const std::vector<double>& values,
+        const std::vector<index_t>& col_indices, const std::vector<double>& values,
         const int n_result_rows, const int b_rows, const int b_cols, const bool has_vals)
 {   
     std::vector<char> send_buffer;
@@ -396,7 +397,7 @@ CSRMatrix* TAPComm::communicate_T(const std::vector<int>& rowptr,
 }
 
 CSRMatrix* TAPComm::communicate_T(const std::vector<int>& rowptr, 
-        const std::vector<int>& col_indices, const std::vector<double*>& values,
+        const std::vector<index_t>& col_indices, const BlockArray& values,
         const int n_result_rows, const int b_rows, const int b_cols, const bool has_vals)
 {  
     std::vector<char> send_buffer;
@@ -404,7 +405,7 @@ CSRMatrix* TAPComm::communicate_T(const std::vector<int>& rowptr,
     return complete_mat_comm_T(n_result_rows, b_rows, b_cols, has_vals);    
 }
 void TAPComm::init_mat_comm_T(std::vector<char>& send_buffer, const std::vector<int>& rowptr, 
-        const std::vector<int>& col_indices, const std::vector<double>& values,
+        const std::vector<index_t>& col_indices, const std::vector<double>& values,
         const int b_rows, const int b_cols, const bool has_vals)
 {
     int block_size = b_rows * b_cols;
@@ -424,7 +425,7 @@ void TAPComm::init_mat_comm_T(std::vector<char>& send_buffer, const std::vector<
     send_buffer.resize(l_bytes + g_bytes);
 
     // Initialize global_par_comm
-    init_comm_helper(&(send_buffer[0]), R_mat->idx1.data(), R_mat->idx2.data(),
+    init_comm_helper(&(send_buffer[0]), R_mat->idx1.data(), R_mat->global_idx2.data(),
             R_mat->vals.data(), global_par_comm->recv_data, global_par_comm->key,
             global_par_comm->mpi_comm, b_rows, b_cols);
     delete R_mat;
@@ -436,7 +437,7 @@ void TAPComm::init_mat_comm_T(std::vector<char>& send_buffer, const std::vector<
             b_rows, b_cols);
 }
 void TAPComm::init_mat_comm_T(std::vector<char>& send_buffer, const std::vector<int>& rowptr, 
-        const std::vector<int>& col_indices, const std::vector<double*>& values,
+        const std::vector<index_t>& col_indices, const BlockArray& values,
         const int b_rows, const int b_cols, const bool has_vals)
 {
     int block_size = b_rows * b_cols;
@@ -456,7 +457,7 @@ void TAPComm::init_mat_comm_T(std::vector<char>& send_buffer, const std::vector<
     send_buffer.resize(l_bytes + g_bytes);
 
     // Initialize global_par_comm
-    init_comm_helper(&(send_buffer[0]), R_mat->idx1.data(), R_mat->idx2.data(),
+    init_comm_helper(&(send_buffer[0]), R_mat->idx1.data(), R_mat->global_idx2.data(),
             R_mat->block_vals.data(), global_par_comm->recv_data, global_par_comm->key,
             global_par_comm->mpi_comm, b_rows, b_cols);
     delete R_mat;
@@ -491,7 +492,7 @@ CSRMatrix* TAPComm::complete_mat_comm_T(const int n_result_rows, const int b_row
         if (local_S_par_comm)
         {
             BSRMatrix* G_mat_bsr = (BSRMatrix*) G_mat;
-            final_mat = communication_helper(G_mat_bsr->idx1.data(), G_mat_bsr->idx2.data(),
+            final_mat = communication_helper(G_mat_bsr->idx1.data(), G_mat_bsr->global_idx2.data(),
                     G_mat_bsr->block_vals.data(), local_S_par_comm->recv_data, 
                     local_S_par_comm->send_data, local_S_par_comm->key, 
                     local_S_par_comm->mpi_comm, b_rows, b_cols, has_vals);
@@ -508,13 +509,14 @@ CSRMatrix* TAPComm::complete_mat_comm_T(const int n_result_rows, const int b_row
 
         recv_mat = combine_recvs_T(L_mat_bsr, final_mat_bsr,
                 local_L_par_comm->send_data, final_comm->send_data,
-                L_mat_bsr->vals, final_mat_bsr->vals, n_result_rows, b_rows, b_cols);
+                L_mat_bsr->block_vals, final_mat_bsr->block_vals, n_result_rows, 
+                b_rows, b_cols);
     }
     else
     {
         if (local_S_par_comm)
         {
-            final_mat = communication_helper(G_mat->idx1.data(), G_mat->idx2.data(),
+            final_mat = communication_helper(G_mat->idx1.data(), G_mat->global_idx2.data(),
                     G_mat->vals.data(), local_S_par_comm->recv_data, local_S_par_comm->send_data, 
                     local_S_par_comm->key, local_S_par_comm->mpi_comm, b_rows, b_cols, has_vals);
             local_S_par_comm->key++;
@@ -548,14 +550,15 @@ CSRMatrix* TAPComm::complete_mat_comm_T(const int n_result_rows, const int b_row
 
 // Helper Methods
 // Create matrix (either CSR or BSR)
-template<> std::vector<double>& create_mat<double>(int n, int m, int b_n, int b_m, 
+template<> std::vector<double>& create_mat<std::vector<double>>(int n, int m, 
+        int b_n, int b_m, 
         CSRMatrix** mat_ptr)
 {  
     CSRMatrix* recv_mat = new CSRMatrix(n, m);
     *mat_ptr = recv_mat;
     return recv_mat->vals;
 }
-template<> std::vector<double*>& create_mat<double*>(int n, int m, int b_n, int b_m, 
+template<> BlockArray& create_mat<BlockArray>(int n, int m, int b_n, int b_m, 
         CSRMatrix** mat_ptr)
 {  
     BSRMatrix* recv_mat = new BSRMatrix(n, m, b_n, b_m);
@@ -563,9 +566,9 @@ template<> std::vector<double*>& create_mat<double*>(int n, int m, int b_n, int
     return recv_mat->block_vals;
 }
 
-template <typename T> // double* or double**
+template <typename T> // const double* (scalar or contiguous block values)
 CSRMatrix* communication_helper(const int* rowptr,
-        const int* col_indices, const T& values,
+        const index_t* col_indices, const T& values,
         CommData* send_comm, CommData* recv_comm, int key, RAPtor_MPI_Comm mpi_comm, 
         const int b_rows, const int b_cols, const bool has_vals)
 {
@@ -577,9 +580,9 @@ CSRMatrix* communication_helper(const int* rowptr,
     return complete_comm_helper(send_comm, recv_comm, key, mpi_comm, 
             b_rows, b_cols, has_vals);
 }    
-template <typename T> // double* or double**
+template <typename T> // const double* (scalar or contiguous block values)
 void init_comm_helper(char* send_buffer, const int* rowptr,
-        const int* col_indices, const T& values,
+        const index_t* col_indices, const T& values,
         CommData* send_comm, int key, RAPtor_MPI_Comm mpi_comm, 
         const int b_rows, const int b_cols)
 {
@@ -613,15 +616,15 @@ CSRMatrix* complete_comm_helper(CommData* send_comm, CommData* recv_comm, int ke
 
 
 
-template <typename T>
-CSRMatrix* transpose_recv(CSRMatrix* recv_mat_T, std::vector<T>& T_vals,
+template <typename VecType>
+CSRMatrix* transpose_recv(CSRMatrix* recv_mat_T, VecType& T_vals,
         NonContigData* send_data, int n)
 {
     int idx, ptr;
     int start, end;
 
     CSRMatrix* recv_mat;
-    std::vector<T>& vals = create_mat<T>(n, -1, recv_mat_T->b_rows, 
+    VecType& vals = create_mat<VecType>(n, -1, recv_mat_T->b_rows, 
             recv_mat_T->b_cols, &recv_mat);
 
     if (n == 0) return recv_mat;
@@ -643,7 +646,7 @@ CSRMatrix* transpose_recv(CSRMatrix* recv_mat_T, std::vector<T>& T_vals,
     recv_mat->nnz = recv_mat->idx1[n];
     if (recv_mat->nnz)
     {
-        recv_mat->idx2.resize(recv_mat->nnz);
+        recv_mat->global_idx2.resize(recv_mat->nnz);
         if (T_vals.size())
             vals.resize(recv_mat->nnz);
     }
@@ -655,17 +658,17 @@ CSRMatrix* transpose_recv(CSRMatrix* recv_mat_T, std::vector<T>& T_vals,
         for (int j = start; j < end; j++)
         {
             ptr = recv_mat->idx1[idx] + row_sizes[idx]++;
-            recv_mat->idx2[ptr] = recv_mat_T->idx2[j];
-            if (recv_mat_T->vals.size())
-                vals[ptr] = T_vals[j];
+            recv_mat->global_idx2[ptr] = recv_mat_T->global_idx2[j];
+            if (T_vals.size())
+                recv_mat->copy_val(vals, ptr, T_vals[j]);
         }
     }
     return recv_mat;
 }
 
-template <typename T>
+template <typename VecType>
 CSRMatrix* combine_recvs(CSRMatrix* L_mat, CSRMatrix* R_mat, 
-        std::vector<T>& L_vals, std::vector<T>& R_vals,
+        VecType& L_vals, VecType& R_vals,
         const int b_rows, const int b_cols,
         NonContigData* local_L_recv, NonContigData* local_R_recv,
         std::vector<int>& row_sizes)
@@ -674,13 +677,13 @@ CSRMatrix* combine_recvs(CSRMatrix* L_mat, CSRMatrix* R_mat,
     int start, end;
 
     CSRMatrix* recv_mat;
-    std::vector<T>& vals = create_mat<T>(L_mat->n_rows + R_mat->n_rows, -1, b_rows, b_cols,
+    VecType& vals = create_mat<VecType>(L_mat->n_rows + R_mat->n_rows, -1, b_rows, b_cols,
             &recv_mat);
     recv_mat->nnz = L_mat->nnz + R_mat->nnz;
     int ptr;
     if (recv_mat->nnz)
     {
-        recv_mat->idx2.resize(recv_mat->nnz);
+        recv_mat->global_idx2.resize(recv_mat->nnz);
         if (L_vals.size() || R_vals.size()) 
             vals.resize(recv_mat->nnz);
     }
@@ -713,9 +716,9 @@ CSRMatrix* combine_recvs(CSRMatrix* L_mat, CSRMatrix* R_mat,
         for (int j = start; j < end; j++)
         {
             ptr = recv_mat->idx1[row] + row_sizes[row]++;
-            recv_mat->idx2[ptr] = R_mat->idx2[j];
+            recv_mat->global_idx2[ptr] = R_mat->global_idx2[j];
             if (vals.size()) 
-                vals[ptr] = R_mat->copy_val(R_vals[j]);
+                recv_mat->copy_val(vals, ptr, R_vals[j]);
         }
     }
     for (int i = 0; i < L_mat->n_rows; i++)
@@ -726,33 +729,55 @@ CSRMatrix* combine_recvs(CSRMatrix* L_mat, CSRMatrix* R_mat,
         for (int j = start; j < end; j++)
         {
             ptr = recv_mat->idx1[row] + row_sizes[row]++;
-            recv_mat->idx2[ptr] = L_mat->idx2[j];
+            recv_mat->global_idx2[ptr] = L_mat->global_idx2[j];
             if (vals.size())
-                vals[ptr] = L_mat->copy_val(L_vals[j]);
+                recv_mat->copy_val(vals, ptr, L_vals[j]);
         }
     }
 
     return recv_mat;
 }
    
-template <typename T>
+// Sorts each received row by global column (idx2 is not yet formed)
+template <typename VecType>
+void sort_global_rows(CSRMatrix* recv_mat, VecType& vals)
+{
+    int start, end;
+    std::vector<int> perm;
+
+    for (int i = 0; i < recv_mat->n_rows; i++)
+    {
+        start = recv_mat->idx1[i];
+        end = recv_mat->idx1[i+1];
+        if (end - start < 2) continue;
+
+        if (vals.size())
+            vec_sort(recv_mat->global_idx2, vals, start, end, perm);
+        else
+            std::sort(recv_mat->global_idx2.begin() + start, 
+                    recv_mat->global_idx2.begin() + end);
+    }
+    recv_mat->sorted = true;
+}
+
+template <typename VecType>
 CSRMatrix* combine_recvs_T(CSRMatrix* L_mat, CSRMatrix* final_mat,
         NonContigData* local_L_send, NonContigData* final_send,
-        std::vector<T>& L_vals, std::vector<T>& final_vals,
+        VecType& L_vals, VecType& final_vals,
         int n, int b_rows, int b_cols)
 {
     int row_start, row_end, row_size;
     int row, idx;
 
     CSRMatrix* recv_mat;
-    std::vector<T>& vals = create_mat<T>(n, -1, b_rows, b_cols,
+    VecType& vals = create_mat<VecType>(n, -1, b_rows, b_cols,
             &recv_mat);
 
     std::vector<int> row_sizes(n, 0);
     int nnz = L_mat->nnz + final_mat->nnz;
     if (nnz)
     {
-        recv_mat->idx2.resize(nnz);
+        recv_mat->global_idx2.resize(nnz);
         if (L_vals.size() || final_vals.size())
             vals.resize(nnz);
     }
@@ -782,9 +807,9 @@ CSRMatrix* combine_recvs_T(CSRMatrix* L_mat, CSRMatrix* final_mat,
         for (int j = row_start; j < row_end; j++)
         {
             idx = recv_mat->idx1[row] + row_sizes[row]++;
-            recv_mat->idx2[idx] = final_mat->idx2[j];
+            recv_mat->global_idx2[idx] = final_mat->global_idx2[j];
             if (final_vals.size())
-                vals[idx] = final_vals[j];
+                recv_mat->copy_val(vals, idx, final_vals[j]);
         }
     }
     for (int i = 0; i < local_L_send->size_msgs; i++)
@@ -795,13 +820,13 @@ CSRMatrix* combine_recvs_T(CSRMatrix* L_mat, CSRMatrix* final_mat,
         for (int j = row_start; j < row_end; j++)
         {
             idx = recv_mat->idx1[row] + row_sizes[row]++;
-            recv_mat->idx2[idx] = L_mat->idx2[j];
+            recv_mat->global_idx2[idx] = L_mat->global_idx2[j];
             if (L_vals.size())
-                vals[idx] = L_vals[j];
+                recv_mat->copy_val(vals, idx, L_vals[j]);
         }
     }
-    recv_mat->nnz = recv_mat->idx2.size();
-    recv_mat->sort();
+    recv_mat->nnz = recv_mat->global_idx2.size();
+    sort_global_rows(recv_mat, vals);
 
     return recv_mat;
 }
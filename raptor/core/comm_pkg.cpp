@@ -201,3 +201,14 @@ void CommPkg::init_comm(ParVector& v, const int block_size)
     init_double_comm(v.local.data(), block_size);
 }
 
+std::vector<double>& CommPkg::communicate(ParMultiVector& v)
+{
+    init_double_comm(v.local.data(), v.n_vecs);
+    return complete_double_comm(v.n_vecs);
+}
+
+void CommPkg::init_comm(ParMultiVector& v)
+{
+    init_double_comm(v.local.data(), v.n_vecs);
+}
+
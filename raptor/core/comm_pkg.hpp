@@ -8,6 +8,7 @@
 #include "matrix.hpp"
 #include "partition.hpp"
 #include "par_vector.hpp"
+#include "int_map.hpp"
 
 #define STANDARD_PPN 4
 #define STANDARD_PROC_LAYOUT 1
@@ -72,38 +73,40 @@ namespace raptor
         }
 
         // Matrix Communication
+        // Column indices are global (index_t), and received rows hold
+        // them in global_idx2 for the caller to map to local columns
         // TODO -- Block transpose communication
         //      -- Should b_rows / b_cols be switched?
         virtual CSRMatrix* communicate(const std::vector<int>& rowptr, 
-                const std::vector<int>& col_indices, const std::vector<double>& values,
+                const std::vector<index_t>& col_indices, const std::vector<double>& values,
                 const int b_rows = 1, const int b_cols = 1, const bool has_vals = true) = 0;
         virtual CSRMatrix* communicate(const std::vector<int>& rowptr, 
-                const std::vector<int>& col_indices, const std::vector<double*>& values,
+                const std::vector<index_t>& col_indices, const BlockArray& values,
                 const int b_rows = 1, const int b_cols = 1, const bool has_vals = true) = 0;
         virtual void init_mat_comm(std::vector<char>& send_buffer, const std::vector<int>& rowptr, 
-                const std::vector<int>& col_indices, const std::vector<double>& values,
+                const std::vector<index_t>& col_indices, const std::vector<double>& values,
                 const int b_rows = 1, const int b_cols = 1, const bool has_vals = true) = 0;
         virtual void init_mat_comm(std::vector<char>& send_buffer, const std::vector<int>& rowptr, 
-                const std::vector<int>& col_indices, const std::vector<double*>& values,
+                const std::vector<index_t>& col_indices, const BlockArray& values,
                 const int b_rows = 1, const int b_cols = 1, const bool has_vals = true) = 0;
         virtual CSRMatrix* complete_mat_comm(const int b_rows = 1, const int b_cols = 1, 
                 const bool has_vals = true) = 0;
 
         virtual CSRMatrix* communicate_T(const std::vector<int>& rowptr,
-                const std::vector<int>& col_indices, const std::vector<double>& values, 
+                const std::vector<index_t>& col_indices, const std::vector<double>& values, 
                 const int n_result_rows, const int b_rows = 1, const int b_cols = 1,
                 const bool has_vals = true) = 0;
         virtual CSRMatrix* communicate_T(const std::vector<int>& rowptr,
-                const std::vector<int>& col_indices, const std::vector<double*>& values, 
+                const std::vector<index_t>& col_indices, const BlockArray& values, 
                 const int n_result_rows, const int b_rows = 1, const int b_cols = 1,
                 const bool has_vals = true) = 0;
         virtual void init_mat_comm_T(std::vector<char>& send_buffer, 
-                const std::vector<int>& rowptr, const std::vector<int>& col_indices, 
+                const std::vector<int>& rowptr, const std::vector<index_t>& col_indices, 
                 const std::vector<double>& values, const int b_rows = 1, 
                 const int b_cols = 1, const bool has_vals = true) = 0;
         virtual void init_mat_comm_T(std::vector<char>& send_buffer,
-                const std::vector<int>& rowptr, const std::vector<int>& col_indices, 
-                const std::vector<double*>& values, const int b_rows = 1, 
+                const std::vector<int>& rowptr, const std::vector<index_t>& col_indices, 
+                const BlockArray& values, const int b_rows = 1, 
                 const int b_cols = 1, const bool has_vals = true) = 0;
         virtual CSRMatrix* complete_mat_comm_T(const int n_result_rows, 
                 const int b_rows = 1, const int b_cols = 1,
@@ -113,7 +116,7 @@ namespace raptor
         {
             return A->vals;
         }
-        std::vector<double*> get_vals(BSRMatrix* A)
+        BlockArray& get_vals(BSRMatrix* A)
         {
             return A->block_vals;
         }
@@ -132,17 +135,22 @@ namespace raptor
 
         CSRMatrix* communicate(CSRMatrix* A, const int has_vals = true)
         {
-            return communicate(A->idx1, A->idx2, get_vals(A), A->b_rows, A->b_cols, has_vals);
+            std::vector<index_t> cols(A->idx2.begin(), A->idx2.end());
+            return communicate(A->idx1, cols, get_vals(A), A->b_rows, A->b_cols, has_vals);
         }
         CSRMatrix* communicate_T(CSRMatrix* A, const int has_vals = true)
         {
-            return communicate_T(A->idx1, A->idx2, get_vals(A), A->n_rows, A->b_rows, 
+            std::vector<index_t> cols(A->idx2.begin(), A->idx2.end());
+            return communicate_T(A->idx1, cols, get_vals(A), A->n_rows, A->b_rows, 
                     A->b_cols, has_vals);
         }
 
         // Vector Communication
         std::vector<double>& communicate(ParVector& v, const int block_size = 1);
         void init_comm(ParVector& v, const int block_size = 1);
+        // All n_vecs values of each row are sent in one message per neighbor
+        std::vector<double>& communicate(ParMultiVector& v);
+        void init_comm(ParMultiVector& v);
 
         // Standard Communication
         template<typename T>
@@ -346,30 +354,32 @@ namespace raptor
         *****
         ***** Parameters
         ***** -------------
-        ***** off_proc_column_map : std::vector<int>&
+        ***** off_proc_column_map : std::vector<index_t>&
         *****    Maps local off_proc columns indices to global
         ***** _key : int (optional)
         *****    Tag to be used in RAPtor_MPI Communication (default 9999)
         **************************************************************/
         ParComm(Partition* partition,
-                const std::vector<int>& off_proc_column_map,
+                const std::vector<index_t>& off_proc_column_map,
                 int _key = 9999,
                 RAPtor_MPI_Comm comm = RAPtor_MPI_COMM_WORLD,
                 CommData* r_data = NULL) : CommPkg(partition)
         {
             mpi_comm = comm;
+            std::vector<index_t> send_cols;
             std::vector<int> off_proc_col_to_proc(off_proc_column_map.size());
             partition->form_col_to_proc(off_proc_column_map, off_proc_col_to_proc);
-            init_par_comm(off_proc_column_map, off_proc_col_to_proc, _key, comm, r_data);
+            init_par_comm(off_proc_column_map, off_proc_col_to_proc, send_cols, 
+                    _key, comm, r_data);
             for (int i = 0; i < send_data->size_msgs; i++)
             {
-                send_data->indices[i] -= partition->first_local_col;
+                send_data->indices[i] = send_cols[i] - partition->first_local_col;
             }
         }
 
         ParComm(Partition* partition,
-                const std::vector<int>& off_proc_column_map,
-                const std::vector<int>& on_proc_column_map,
+                const std::vector<index_t>& off_proc_column_map,
+                const std::vector<index_t>& on_proc_column_map,
                 int _key = 9999, 
                 RAPtor_MPI_Comm comm = RAPtor_MPI_COMM_WORLD,
                 CommData* r_data = NULL) : CommPkg(partition)
@@ -378,20 +388,22 @@ namespace raptor
             int idx;
             int ctr = 0;
             std::vector<int> part_col_to_new;
+            std::vector<index_t> send_cols;
             std::vector<int> off_proc_col_to_proc(off_proc_column_map.size());
             partition->form_col_to_proc(off_proc_column_map, off_proc_col_to_proc);
 
-            init_par_comm(off_proc_column_map, off_proc_col_to_proc, _key, comm, r_data);
+            init_par_comm(off_proc_column_map, off_proc_col_to_proc, send_cols,
+                    _key, comm, r_data);
             for (int i = 0; i < send_data->size_msgs; i++)
             {
-                send_data->indices[i] -= partition->first_local_col;
+                send_data->indices[i] = send_cols[i] - partition->first_local_col;
             }
             
             if (partition->local_num_cols)
             {
                 part_col_to_new.resize(partition->local_num_cols, -1);
             }
-            for (std::vector<int>::const_iterator it = on_proc_column_map.begin();
+            for (std::vector<index_t>::const_iterator it = on_proc_column_map.begin();
                     it != on_proc_column_map.end(); ++it)
             {
                 part_col_to_new[*it - partition->first_local_col] = ctr++;
@@ -407,38 +419,38 @@ namespace raptor
         }
 
         ParComm(Topology* _topology,
-                const std::vector<int>& off_proc_column_map,
+                const std::vector<index_t>& off_proc_column_map,
                 const std::vector<int>& off_proc_col_to_proc,
-                const std::vector<int>& local_row_map,
+                const std::vector<index_t>& local_row_map,
                 int _key = 9999,
                 RAPtor_MPI_Comm comm = RAPtor_MPI_COMM_WORLD,
                 CommData* r_data = NULL) : CommPkg(_topology)
         {
             mpi_comm = comm;
-            init_par_comm(off_proc_column_map, off_proc_col_to_proc,
+            std::vector<index_t> send_cols;
+            init_par_comm(off_proc_column_map, off_proc_col_to_proc, send_cols,
                     _key, comm, r_data);
-            std::map<int,int> global_to_local;
+            IntMap<index_t> global_to_local(local_row_map.size());
             for (int i = 0; i < (int)local_row_map.size(); i++)
             {
-                global_to_local[local_row_map[i]] = i;
+                global_to_local.insert(local_row_map[i], i);
             }
             for (int i = 0; i < send_data->size_msgs; i++)
             {
-                send_data->indices[i] = global_to_local[send_data->indices[i]];
+                send_data->indices[i] = global_to_local.find(send_cols[i]);
             }
 
         }
 
-        void init_par_comm(const std::vector<int>& off_proc_column_map,
+        // Forms recv_data from off_proc_column_map, and send_data from the
+        // global indices requested by other processes (returned in 
+        // send_cols for the caller to map to local indices)
+        void init_par_comm(const std::vector<index_t>& off_proc_column_map,
                 const std::vector<int>& off_proc_col_to_proc,
+                std::vector<index_t>& send_cols,
                 int _key, RAPtor_MPI_Comm comm,
                 CommData* r_data = NULL)
         {
-            // Get RAPtor_MPI Information
-            int rank, num_procs;
-            RAPtor_MPI_Comm_rank(comm, &rank);
-            RAPtor_MPI_Comm_size(comm, &num_procs);
-
             // Initialize class variables
             key = _key;
 
@@ -480,17 +492,20 @@ namespace raptor
             }
 
             // For each process I recv from, send the global column indices
-            // for which I must recv corresponding rows 
-            std::vector<int> recv_sizes(num_procs, 0);
-            for (int i = 0; i < recv_data->num_msgs; i++)
-                recv_sizes[recv_data->procs[i]] = 
-                    recv_data->indptr[i+1] - recv_data->indptr[i];
-            RAPtor_MPI_Allreduce(RAPtor_MPI_IN_PLACE, recv_sizes.data(), num_procs, RAPtor_MPI_INT,
-                    RAPtor_MPI_SUM, RAPtor_MPI_COMM_WORLD);
+            // for which I must recv corresponding rows.  Processes I send
+            // to are found from these messages (NBX), so no process
+            // needs a vector of size num_procs.
             if (profile) vec_t -= RAPtor_MPI_Wtime();
-            recv_data->send(off_proc_column_map.data(), tag, comm);
-            send_data->probe(recv_sizes[rank], tag, comm);
-            recv_data->waitall();
+            for (int i = 0; i < recv_data->num_msgs; i++)
+            {
+                int start = recv_data->indptr[i];
+                int end = recv_data->indptr[i+1];
+                RAPtor_MPI_Issend(&(off_proc_column_map[start]), end - start, 
+                        RAPtor_MPI_INDEX_T, recv_data->procs[i], tag, comm,
+                        &(recv_data->requests[i]));
+            }
+            send_data->nbx_probe(tag, comm, recv_data->num_msgs,
+                    recv_data->requests.data(), send_cols);
             if (profile) vec_t += RAPtor_MPI_Wtime();
         }
 
@@ -906,35 +921,35 @@ namespace raptor
 
         // Matrix Communication
         CSRMatrix* communicate(const std::vector<int>& rowptr, 
-                const std::vector<int>& col_indices, const std::vector<double>& values,
+                const std::vector<index_t>& col_indices, const std::vector<double>& values,
                 const int b_rows = 1, const int b_cols = 1, const bool has_vals = true);
         CSRMatrix* communicate(const std::vector<int>& rowptr, 
-                const std::vector<int>& col_indices, const std::vector<double*>& values,
+                const std::vector<index_t>& col_indices, const BlockArray& values,
                 const int b_rows = 1, const int b_cols = 1, const bool has_vals = true);
         void init_mat_comm(std::vector<char>& send_buffer, const std::vector<int>& rowptr, 
-                const std::vector<int>& col_indices, const std::vector<double>& values,
+                const std::vector<index_t>& col_indices, const std::vector<double>& values,
                 const int b_rows = 1, const int b_cols = 1, const bool has_vals = true);
         void init_mat_comm(std::vector<char>& send_buffer, const std::vector<int>& rowptr, 
-                const std::vector<int>& col_indices, const std::vector<double*>& values,
+                const std::vector<index_t>& col_indices, const BlockArray& values,
                 const int b_rows = 1, const int b_cols = 1, const bool has_vals = true);
         CSRMatrix* complete_mat_comm(const int b_rows = 1, const int b_cols = 1, 
                 const bool has_vals = true);
 
         CSRMatrix* communicate_T(const std::vector<int>& rowptr, 
-                const std::vector<int>& col_indices, const std::vector<double>& values, 
+                const std::vector<index_t>& col_indices, const std::vector<double>& values, 
                 const int n_result_rows, const int b_rows = 1, const int b_cols = 1, 
                 const bool has_vals = true);
         CSRMatrix* communicate_T(const std::vector<int>& rowptr, 
-                const std::vector<int>& col_indices, const std::vector<double*>& values, 
+                const std::vector<index_t>& col_indices, const BlockArray& values, 
                 const int n_result_rows, const int b_rows = 1, const int b_cols = 1, 
                 const bool has_vals = true);
         void init_mat_comm_T(std::vector<char>& send_buffer, 
-                const std::vector<int>& rowptr, const std::vector<int>& col_indices, 
+                const std::vector<int>& rowptr, const std::vector<index_t>& col_indices, 
                 const std::vector<double>& values, const int b_rows = 1, 
                 const int b_cols = 1, const bool has_vals = true) ;
         void init_mat_comm_T(std::vector<char>& send_buffer,
-                const std::vector<int>& rowptr, const std::vector<int>& col_indices, 
-                const std::vector<double*>& values, const int b_rows = 1, 
+                const std::vector<int>& rowptr, const std::vector<index_t>& col_indices, 
+                const BlockArray& values, const int b_rows = 1, 
                 const int b_cols = 1, const bool has_vals = true) ;
         CSRMatrix* complete_mat_comm_T(const int n_result_rows, 
                 const int b_rows = 1, const int b_cols = 1,
@@ -968,6 +983,14 @@ namespace raptor
         {
             CommPkg::init_comm(v, block_size);
         }
+        std::vector<double>& communicate(ParMultiVector& v)
+        {
+            return CommPkg::communicate(v);
+        }
+        void init_comm(ParMultiVector& v)
+        {
+            CommPkg::init_comm(v);
+        }
 
         // Helper Methods
         std::vector<double>& get_double_buffer()
@@ -1057,7 +1080,7 @@ namespace raptor
         *****
         ***** Parameters
         ***** -------------
-        ***** off_proc_column_map : std::vector<int>&
+        ***** off_proc_column_map : std::vector<index_t>&
         *****    Maps local off_proc columns indices to global
         ***** global_num_cols : int
         *****    Number of global columns in matrix
@@ -1065,7 +1088,7 @@ namespace raptor
         *****    Number of columns local to rank
         **************************************************************/
         TAPComm(Partition* partition, 
-                const std::vector<int>& off_proc_column_map,
+                const std::vector<index_t>& off_proc_column_map,
                 bool form_S = true,
                 RAPtor_MPI_Comm comm = RAPtor_MPI_COMM_WORLD)
                 : CommPkg(partition)
@@ -1081,8 +1104,8 @@ namespace raptor
         }
 
         TAPComm(Partition* partition,
-                const std::vector<int>& off_proc_column_map,
-                const std::vector<int>& on_proc_column_map,
+                const std::vector<index_t>& off_proc_column_map,
+                const std::vector<index_t>& on_proc_column_map,
                 bool form_S = true,
                 RAPtor_MPI_Comm comm = RAPtor_MPI_COMM_WORLD)
                 : CommPkg(partition)
@@ -1142,6 +1165,7 @@ namespace raptor
         **************************************************************/
         TAPComm(TAPComm* tap_comm) : CommPkg(tap_comm->topology)
         {
+            shared_mem = tap_comm->shared_mem;
             if (tap_comm->local_S_par_comm)
             {
                 local_S_par_comm = new ParComm(tap_comm->local_S_par_comm);
@@ -1163,6 +1187,7 @@ namespace raptor
         TAPComm(TAPComm* tap_comm, const std::vector<int>& off_proc_col_to_new, 
                 ParComm* local_L = NULL) : CommPkg(tap_comm->topology)
         {
+            shared_mem = tap_comm->shared_mem;
             init_off_proc_new(tap_comm, off_proc_col_to_new, local_L);
         }
 
@@ -1172,6 +1197,7 @@ namespace raptor
         {
             int idx;
 
+            shared_mem = tap_comm->shared_mem;
             init_off_proc_new(tap_comm, off_proc_col_to_new, local_L);
 
             if (!local_L)
@@ -1315,6 +1341,8 @@ namespace raptor
         **************************************************************/
         ~TAPComm()
         {
+            free_shared_comm();
+
             if (global_par_comm)
                 global_par_comm->delete_comm();
             if (local_S_par_comm)
@@ -1326,7 +1354,7 @@ namespace raptor
         }
 
         void init_tap_comm(Partition* partition,
-                const std::vector<int>& off_proc_column_map,
+                const std::vector<index_t>& off_proc_column_map,
                 RAPtor_MPI_Comm comm)
         {
             // Get RAPtor_MPI Information
@@ -1345,15 +1373,16 @@ namespace raptor
 
             // Initialize Variables
             std::vector<int> off_proc_col_to_proc;
-            std::vector<int> on_node_column_map;
+            std::vector<index_t> on_node_column_map;
             std::vector<int> on_node_col_to_proc;
-            std::vector<int> off_node_column_map;
+            std::vector<index_t> off_node_column_map;
             std::vector<int> off_node_col_to_node;
             std::vector<int> on_node_to_off_proc;
             std::vector<int> off_node_to_off_proc;
             std::vector<int> recv_nodes;
             std::vector<int> orig_procs;
             std::vector<int> node_to_local_proc;
+            TAPSetupCols setup_cols;
 
             // Find process on which vector value associated with each column is
             // stored
@@ -1366,18 +1395,18 @@ namespace raptor
 
             // Gather all nodes with which any local process must communication
             form_local_R_par_comm(off_node_column_map, off_node_col_to_node, 
-                    orig_procs);
+                    orig_procs, setup_cols);
 
             // Find global processes with which rank communications
-            form_global_par_comm(orig_procs);
+            form_global_par_comm(orig_procs, setup_cols);
 
             // Form local_S_par_comm: initial distribution of values among local
             // processes, before inter-node communication
-            form_local_S_par_comm(orig_procs);
+            form_local_S_par_comm(orig_procs, setup_cols, partition->first_local_col);
 
-            // Adjust send indices (currently global vector indices) to be index 
-            // of global vector value from previous recv
-            adjust_send_indices(partition->first_local_col);
+            // Form send indices from the global columns in setup_cols, as
+            // the index of each global vector value in the previous recv
+            adjust_send_indices(partition->first_local_col, setup_cols);
 
             // Form local_L_par_comm: fully local communication (origin and
             // destination processes both local to node)
@@ -1390,7 +1419,7 @@ namespace raptor
         }
 
         void init_tap_comm_simple(Partition* partition,
-                const std::vector<int>& off_proc_column_map,
+                const std::vector<index_t>& off_proc_column_map,
                 RAPtor_MPI_Comm comm)
         {
             // Get RAPtor_MPI Information
@@ -1408,12 +1437,13 @@ namespace raptor
 
             // Initialize Variables
             std::vector<int> off_proc_col_to_proc;
-            std::vector<int> on_node_column_map;
+            std::vector<index_t> on_node_column_map;
             std::vector<int> on_node_col_to_proc;
-            std::vector<int> off_node_column_map;
+            std::vector<index_t> off_node_column_map;
             std::vector<int> off_node_col_to_proc;
             std::vector<int> on_node_to_off_proc;
             std::vector<int> off_node_to_off_proc;
+            TAPSetupCols setup_cols;
 
             // Find process on which vector value associated with each column is
             // stored
@@ -1428,16 +1458,17 @@ namespace raptor
             // corresponding to global rank on which data originates.  E.g. if
             // data is on rank r = (p, n), and my rank is s = (q, m), I will
             // recv data from (p, m).
-            form_simple_R_par_comm(off_node_column_map, off_node_col_to_proc);
+            form_simple_R_par_comm(off_node_column_map, off_node_col_to_proc,
+                    setup_cols);
 
             // Form global par comm.. Will recv from proc on which data
             // originates
-            form_simple_global_comm(off_node_col_to_proc);
+            form_simple_global_comm(off_node_col_to_proc, setup_cols);
 
-            // Adjust send indices (currently global vector indices) to be
-            // index of global vector value from previous recv (only updating
-            // local_R to match position in global)
-            adjust_send_indices(partition->first_local_col);
+            // Form send indices from the global columns in setup_cols, as
+            // the index of each global vector value in the previous recv
+            // (only updating local_R to match position in global)
+            adjust_send_indices(partition->first_local_col, setup_cols);
 
             // Form local_L_par_comm: fully local communication (origin and
             // destination processes both local to node)
@@ -1450,30 +1481,108 @@ namespace raptor
 
         }
 
+        // Global columns exchanged while forming the sub-communicators,
+        // held apart from their (int) send and recv indices, which are
+        // formed from these in adjust_send_indices
+        struct TAPSetupCols
+        {
+            std::vector<index_t> R_send;      // sent by local_R_par_comm
+            std::vector<index_t> global_recv; // recvd by global_par_comm
+            std::vector<index_t> global_send; // sent by global_par_comm
+            std::vector<index_t> S_recv;      // recvd by local_S_par_comm
+        };
+
         // Helper methods for forming TAPComm:
-        void split_off_proc_cols(const std::vector<int>& off_proc_column_map,
+        void split_off_proc_cols(const std::vector<index_t>& off_proc_column_map,
                 const std::vector<int>& off_proc_col_to_proc,
-                std::vector<int>& on_node_column_map,
+                std::vector<index_t>& on_node_column_map,
                 std::vector<int>& on_node_col_to_proc,
                 std::vector<int>& on_node_to_off_proc,
-                std::vector<int>& off_node_column_map,
+                std::vector<index_t>& off_node_column_map,
                 std::vector<int>& off_node_col_to_node,
                 std::vector<int>& off_node_to_off_proc);
-        void form_local_R_par_comm(const std::vector<int>& off_node_column_map,
+        void form_local_R_par_comm(const std::vector<index_t>& off_node_column_map,
                 const std::vector<int>& off_node_col_to_node,
-                std::vector<int>& orig_procs);
-        void form_global_par_comm(std::vector<int>& orig_procs);
-        void form_local_S_par_comm(std::vector<int>& orig_procs);
-        void adjust_send_indices(const int first_local_col);
-        void form_local_L_par_comm(const std::vector<int>& on_node_column_map,
+                std::vector<int>& orig_procs, TAPSetupCols& setup_cols);
+        void form_global_par_comm(std::vector<int>& orig_procs,
+                TAPSetupCols& setup_cols);
+        void form_local_S_par_comm(std::vector<int>& orig_procs,
+                TAPSetupCols& setup_cols, const index_t first_local_col);
+        void adjust_send_indices(const index_t first_local_col,
+                TAPSetupCols& setup_cols);
+        void form_local_L_par_comm(const std::vector<index_t>& on_node_column_map,
                 const std::vector<int>& on_node_col_to_proc,
-                const int first_local_col);
-        void form_simple_R_par_comm(std::vector<int>& off_node_column_map,
-                std::vector<int>& off_node_col_to_proc);
-        void form_simple_global_comm(std::vector<int>& off_node_col_to_proc);
+                const index_t first_local_col);
+        void form_simple_R_par_comm(std::vector<index_t>& off_node_column_map,
+                std::vector<int>& off_node_col_to_proc, TAPSetupCols& setup_cols);
+        void form_simple_global_comm(std::vector<int>& off_node_col_to_proc,
+                TAPSetupCols& setup_cols);
         void update_recv(const std::vector<int>& on_node_to_off_proc,
                 const std::vector<int>& off_node_to_off_proc, bool update_L = true);
 
+        // Helper methods for shared memory intra-node steps:
+        bool init_shared_comm(const int bytes_per_value);
+        void free_shared_comm();
+        void exchange_shared_offsets(ParComm* comm, int offset, int tag,
+                std::vector<int>& src);
+        void shared_sync()
+        {
+            RAPtor_MPI_Win_sync(shared_win);
+            RAPtor_MPI_Barrier(topology->local_comm);
+            RAPtor_MPI_Win_sync(shared_win);
+        }
+
+        // Writes the values comm would send into this process's segment
+        // of the shared window, starting at offset
+        template<typename T>
+        void shared_pack(ParComm* comm, const T* values, int offset, 
+                const int block_size)
+        {
+            int rank;
+            RAPtor_MPI_Comm_rank(topology->local_comm, &rank);
+            T* segment = ((T*) shared_bases[rank]) 
+                + (shared_parity * shared_size + offset) * block_size;
+
+            int idx;
+            NonContigData* send_data = comm->send_data;
+            for (int i = 0; i < send_data->size_msgs; i++)
+            {
+                idx = send_data->indices[i] * block_size;
+                for (int j = 0; j < block_size; j++)
+                {
+                    segment[i * block_size + j] = values[idx + j];
+                }
+            }
+        }
+
+        // Reads the values comm would recv directly from the segments of
+        // the sending processes.  Recvd value i is written to position 
+        // dest_idx[i] of dest (or i if dest_idx is NULL).
+        template<typename T>
+        void shared_unpack(ParComm* comm, const std::vector<int>& src,
+                T* dest, const int* dest_idx, const int block_size)
+        {
+            int start, end, pos, idx;
+            const T* segment;
+            CommData* recv_data = comm->recv_data;
+            for (int i = 0; i < recv_data->num_msgs; i++)
+            {
+                segment = ((const T*) shared_bases[recv_data->procs[i]])
+                    + shared_parity * shared_size * block_size;
+                start = recv_data->indptr[i];
+                end = recv_data->indptr[i+1];
+                for (int j = start; j < end; j++)
+                {
+                    pos = (src[i] + j - start) * block_size;
+                    idx = (dest_idx ? dest_idx[j] : j) * block_size;
+                    for (int k = 0; k < block_size; k++)
+                    {
+                        dest[idx + k] = segment[pos + k];
+                    }
+                }
+            }
+        }
+
         // Class Methods
         void init_double_comm(const double* values, const int block_size)
         {
@@ -1508,6 +1617,12 @@ namespace raptor
         template<typename T>
         void initialize(const T* values, const int block_size = 1)
         {
+            if (shared_mem && init_shared_comm(sizeof(T) * block_size))
+            {
+                shared_initialize(values, block_size);
+                return;
+            }
+
             // Messages with origin and final destination on node
             local_L_par_comm->communicate<T>(values, block_size);
 
@@ -1528,6 +1643,11 @@ namespace raptor
         template<typename T>
         std::vector<T>& complete(const int block_size = 1)
         {
+            if (shared_mem)
+            {
+                return shared_complete<T>(block_size);
+            }
+
             // Complete inter-node communication
             std::vector<T>& G_vals = global_par_comm->complete<T>(block_size);
 
@@ -1572,6 +1692,85 @@ namespace raptor
             return recvbuf;
         }
 
+        /**************************************************************
+        *****   TAPComm Shared Memory Communication
+        **************************************************************
+        ***** Replaces the node-local messages of initialize and 
+        ***** complete with copies through a shared window on the
+        ***** node (see init_shared_comm).  Each process writes the 
+        ***** values it would send into its own segment, and after a
+        ***** node barrier, reads the values it would recv directly 
+        ***** from the segments of the other processes.  Values from 
+        ***** local_L and local_R are read straight into the final 
+        ***** recv buffer.  Segments alternate between two halves on
+        ***** successive communications, so a process can only 
+        ***** overwrite values that every process on the node has 
+        ***** finished reading.
+        *****
+        ***** All processes on a node must take part in each 
+        ***** communication.
+        **************************************************************/
+        template<typename T>
+        void shared_initialize(const T* values, const int block_size = 1)
+        {
+            int L_size = local_L_par_comm->send_data->size_msgs;
+
+            shared_parity = 1 - shared_parity;
+            shared_pack(local_L_par_comm, values, 0, block_size);
+            if (local_S_par_comm)
+            {
+                shared_pack(local_S_par_comm, values, L_size, block_size);
+            }
+            shared_sync();
+
+            if (local_S_par_comm)
+            {
+                // Initial redistribution among node
+                std::vector<T>& S_vals = local_S_par_comm->recv_data->get_buffer<T>();
+                int S_size = local_S_par_comm->recv_data->size_msgs * block_size;
+                if ((int)S_vals.size() < S_size) S_vals.resize(S_size);
+                shared_unpack(local_S_par_comm, S_recv_src, S_vals.data(), 
+                        (const int*) NULL, block_size);
+
+                // Begin inter-node communication 
+                global_par_comm->initialize(S_vals.data(), block_size);
+            }
+            else
+            {
+                global_par_comm->initialize(values, block_size);
+            }
+        }
+
+        template<typename T>
+        std::vector<T>& shared_complete(const int block_size = 1)
+        {
+            int R_offset = local_L_par_comm->send_data->size_msgs;
+            if (local_S_par_comm)
+            {
+                R_offset += local_S_par_comm->send_data->size_msgs;
+            }
+
+            // Complete inter-node communication
+            std::vector<T>& G_vals = global_par_comm->complete<T>(block_size);
+
+            // Redistributing recvd inter-node values
+            shared_pack(local_R_par_comm, G_vals.data(), R_offset, block_size);
+            shared_sync();
+
+            std::vector<T>& recvbuf = get_buffer<T>();
+            if ((int)recvbuf.size() < recv_size * block_size)
+                recvbuf.resize(recv_size * block_size);
+
+            NonContigData* local_R_recv = (NonContigData*) local_R_par_comm->recv_data;
+            NonContigData* local_L_recv = (NonContigData*) local_L_par_comm->recv_data;
+            shared_unpack(local_R_par_comm, R_recv_src, recvbuf.data(), 
+                    local_R_recv->indices.data(), block_size);
+            shared_unpack(local_L_par_comm, L_recv_src, recvbuf.data(), 
+                    local_L_recv->indices.data(), block_size);
+
+            return recvbuf;
+        }
+
 
         // Transpose Communication
         void init_double_comm_T(const double* values,
@@ -1757,35 +1956,35 @@ namespace raptor
 
         // Matrix Communication
         CSRMatrix* communicate(const std::vector<int>& rowptr, 
-                const std::vector<int>& col_indices, const std::vector<double>& values,
+                const std::vector<index_t>& col_indices, const std::vector<double>& values,
                 const int b_rows = 1, const int b_cols = 1, const bool has_vals = true);
         CSRMatrix* communicate(const std::vector<int>& rowptr, 
-                const std::vector<int>& col_indices, const std::vector<double*>& values,
+                const std::vector<index_t>& col_indices, const BlockArray& values,
                 const int b_rows = 1, const int b_cols = 1, const bool has_vals = true);
         void init_mat_comm(std::vector<char>& send_buffer, const std::vector<int>& rowptr, 
-                const std::vector<int>& col_indices, const std::vector<double>& values,
+                const std::vector<index_t>& col_indices, const std::vector<double>& values,
                 const int b_rows = 1, const int b_cols = 1, const bool has_vals = true);
         void init_mat_comm(std::vector<char>& send_buffer, const std::vector<int>& rowptr, 
-                const std::vector<int>& col_indices, const std::vector<double*>& values,
+                const std::vector<index_t>& col_indices, const BlockArray& values,
                 const int b_rows = 1, const int b_cols = 1, const bool has_vals = true);
         CSRMatrix* complete_mat_comm(const int b_rows = 1, const int b_cols = 1, 
                 const bool has_vals = true);
 
         CSRMatrix* communicate_T(const std::vector<int>& rowptr, 
-                const std::vector<int>& col_indices, const std::vector<double>& values, 
+                const std::vector<index_t>& col_indices, const std::vector<double>& values, 
                 const int n_result_rows, const int b_rows = 1, const int b_cols = 1, 
                 const bool has_vals = true);
         CSRMatrix* communicate_T(const std::vector<int>& rowptr, 
-                const std::vector<int>& col_indices, const std::vector<double*>& values, 
+                const std::vector<index_t>& col_indices, const BlockArray& values, 
                 const int n_result_rows, const int b_rows = 1, const int b_cols = 1, 
                 const bool has_vals = true);
         void init_mat_comm_T(std::vector<char>& send_buffer, 
-                const std::vector<int>& rowptr, const std::vector<int>& col_indices, 
+                const std::vector<int>& rowptr, const std::vector<index_t>& col_indices, 
                 const std::vector<double>& values, const int b_rows = 1, 
                 const int b_cols = 1, const bool has_vals = true) ;
         void init_mat_comm_T(std::vector<char>& send_buffer,
-                const std::vector<int>& rowptr, const std::vector<int>& col_indices, 
-                const std::vector<double*>& values, const int b_rows = 1, 
+                const std::vector<int>& rowptr, const std::vector<index_t>& col_indices, 
+                const BlockArray& values, const int b_rows = 1, 
                 const int b_cols = 1, const bool has_vals = true) ;
         CSRMatrix* complete_mat_comm_T(const int n_result_rows, 
                 const int b_rows = 1, const int b_cols = 1,
@@ -1819,6 +2018,14 @@ namespace raptor
         {
             CommPkg::init_comm(v, block_size);
         }
+        std::vector<double>& communicate(ParMultiVector& v)
+        {
+            return CommPkg::communicate(v);
+        }
+        void init_comm(ParMultiVector& v)
+        {
+            CommPkg::init_comm(v);
+        }
 
         // Helper Methods
         std::vector<double>& get_double_buffer()
@@ -1836,6 +2043,23 @@ namespace raptor
         ParComm* local_R_par_comm;
         ParComm* local_L_par_comm;
         ParComm* global_par_comm;
+
+        // Intra-node steps of initialize / complete go through a shared
+        // memory window when shared_mem is set (default with 
+        // WITH_SHARED_TAP).  The window is created on first use.
+#ifdef USING_SHARED_TAP
+        bool shared_mem = true;
+#else
+        bool shared_mem = false;
+#endif
+        RAPtor_MPI_Win shared_win = RAPtor_MPI_WIN_NULL;
+        int shared_unit = 0;
+        int shared_size = 0;
+        int shared_parity = 0;
+        std::vector<char*> shared_bases;
+        std::vector<int> L_recv_src;
+        std::vector<int> S_recv_src;
+        std::vector<int> R_recv_src;
     };
 }
 #endif
@@ -0,0 +1,161 @@
+// Copyright (c) 2015-2017, RAPtor Developer Team
+// License: Simplified BSD, http://opensource.org/licenses/BSD-2-Clause
+#ifndef RAPTOR_CORE_INT_MAP_HPP
+#define RAPTOR_CORE_INT_MAP_HPP
+
+#include "types.hpp"
+
+/**************************************************************
+ *****   IntMap
+ **************************************************************
+ ***** Open-addressing hash map from non-negative integer keys
+ ***** (global row or column indices) to local int indices, used
+ ***** for the global-to-local maps formed during setup.  Keys
+ ***** and values are stored in two flat arrays, probed linearly,
+ ***** and the table doubles once half full, so a lookup touches
+ ***** one or two cache lines and only growth allocates.
+ *****
+ ***** Methods
+ ***** -------
+ ***** insert(key, val)
+ *****    Maps key to val unless key is already held.  Returns the
+ *****    value held for key.
+ ***** find(key)
+ *****    Returns the value held for key, or -1 if key is not held
+ ***** reserve(n)
+ *****    Sizes the table for n keys
+ ***** size()
+ *****    Number of keys held
+ ***** clear()
+ *****    Removes all keys, keeping the table
+ **************************************************************/
+namespace raptor
+{
+template <typename T>
+class IntMap
+{
+  public:
+    IntMap(int n = 0)
+    {
+        num_keys = 0;
+        mask = 0;
+        reserve(n);
+    }
+
+    void reserve(int n)
+    {
+        int capacity = 16;
+        while (capacity < 2*n) capacity *= 2;
+        if (capacity > (int) keys.size())
+        {
+            rehash(capacity);
+        }
+    }
+
+    int insert(T key, int val)
+    {
+        if (2*(num_keys + 1) > (int) keys.size())
+        {
+            rehash(keys.size() ? 2*keys.size() : 16);
+        }
+
+        int pos = hash(key);
+        while (keys[pos] != -1)
+        {
+            if (keys[pos] == key) return vals[pos];
+            pos = (pos + 1) & mask;
+        }
+        keys[pos] = key;
+        vals[pos] = val;
+        num_keys++;
+        return val;
+    }
+
+    int find(T key) const
+    {
+        if (num_keys == 0) return -1;
+
+        int pos = hash(key);
+        while (keys[pos] != -1)
+        {
+            if (keys[pos] == key) return vals[pos];
+            pos = (pos + 1) & mask;
+        }
+        return -1;
+    }
+
+    int size() const
+    {
+        return num_keys;
+    }
+
+    void clear()
+    {
+        std::fill(keys.begin(), keys.end(), -1);
+        num_keys = 0;
+    }
+
+  private:
+    // Fibonacci hashing: the high bits of key * 2^64/phi
+    int hash(T key) const
+    {
+        return (int) ((((uint64_t) key) * 11400714819323198485ull) >> shift);
+    }
+
+    void rehash(int capacity)
+    {
+        std::vector<T> old_keys(capacity, -1);
+        std::vector<int> old_vals(capacity);
+        old_keys.swap(keys);
+        old_vals.swap(vals);
+
+        mask = capacity - 1;
+        shift = 64;
+        while (capacity > 1)
+        {
+            capacity /= 2;
+            shift--;
+        }
+
+        int pos;
+        int n = old_keys.size();
+        for (int i = 0; i < n; i++)
+        {
+            if (old_keys[i] == -1) continue;
+            pos = hash(old_keys[i]);
+            while (keys[pos] != -1)
+            {
+                pos = (pos + 1) & mask;
+            }
+            keys[pos] = old_keys[i];
+            vals[pos] = old_vals[i];
+        }
+    }
+
+    std::vector<T> keys;
+    std::vector<int> vals;
+    int num_keys;
+    int mask;
+    int shift;
+};
+
+// Sorts vec and removes duplicate entries
+template <typename T>
+void sort_unique(std::vector<T>& vec)
+{
+    std::sort(vec.begin(), vec.end());
+    vec.erase(std::unique(vec.begin(), vec.end()), vec.end());
+}
+
+// Position of key in a sorted vector without duplicates, or -1
+template <typename T>
+int sorted_find(const std::vector<T>& vec, T key)
+{
+    typename std::vector<T>::const_iterator it =
+        std::lower_bound(vec.begin(), vec.end(), key);
+    if (it == vec.end() || *it != key) return -1;
+    return it - vec.begin();
+}
+}
+
+#endif
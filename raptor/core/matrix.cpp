@@ -6,14 +6,25 @@
 
 using namespace raptor;
 
+// Move the value (or block of values) at position j to position
+// first, shifting positions [first, j) back by one
+void rotate_vals(std::vector<double>& vals, int first, int j)
+{
+    std::rotate(vals.begin() + first, vals.begin() + j, vals.begin() + j + 1);
+}
+void rotate_vals(BlockArray& vals, int first, int j)
+{
+    vals.rotate(first, j, j + 1);
+}
+
 /**************************************************************
 *****  Matrix Print
 **************************************************************
 ***** Print the nonzeros in the matrix, as well as the row
 ***** and column according to each nonzero
 **************************************************************/
-template <typename T>
-void print_helper(const COOMatrix* A, const std::vector<T>& vals)
+template <typename VecType>
+void print_helper(const COOMatrix* A, const VecType& vals)
 {
     int row, col;
 
@@ -24,8 +35,8 @@ void print_helper(const COOMatrix* A, const std::vector<T>& vals)
         A->val_print(row, col, vals[i]);
     }
 }
-template <typename T>
-void print_helper(const CSRMatrix* A, const std::vector<T>& vals)
+template <typename VecType>
+void print_helper(const CSRMatrix* A, const VecType& vals)
 {
     int col, start, end;
 
@@ -40,8 +51,8 @@ void print_helper(const CSRMatrix* A, const std::vector<T>& vals)
         }
     }
 }
-template <typename T>
-void print_helper(const CSCMatrix* A, const std::vector<T>& vals)
+template <typename VecType>
+void print_helper(const CSCMatrix* A, const VecType& vals)
 {
     int row, start, end;
 
@@ -56,8 +67,8 @@ void print_helper(const CSCMatrix* A, const std::vector<T>& vals)
         }
     }
 }
-template <typename T>
-void bcoo_print_helper(const BCOOMatrix* A, const std::vector<T>& vals)
+template <typename VecType>
+void bcoo_print_helper(const BCOOMatrix* A, const VecType& vals)
 {
     int row, col;
 
@@ -68,8 +79,8 @@ void bcoo_print_helper(const BCOOMatrix* A, const std::vector<T>& vals)
         A->val_print(row, col, vals[i]);
     }
 }
-template <typename T>
-void bsr_print_helper(const BSRMatrix* A, const std::vector<T>& vals)
+template <typename VecType>
+void bsr_print_helper(const BSRMatrix* A, const VecType& vals)
 {
     int col, start, end;
 
@@ -84,8 +95,8 @@ void bsr_print_helper(const BSRMatrix* A, const std::vector<T>& vals)
         }
     }
 }
-template <typename T>
-void bsc_print_helper(const BSCMatrix* A, const std::vector<T>& vals)
+template <typename VecType>
+void bsc_print_helper(const BSCMatrix* A, const VecType& vals)
 {
     int row, start, end;
 
@@ -114,15 +125,15 @@ void CSCMatrix::print()
 }
 void BCOOMatrix::print()
 {
-    bcoo_print_helper(this, vals);
+    bcoo_print_helper(this, block_vals);
 }
 void BSRMatrix::print()
 {
-    bsr_print_helper(this, vals);
+    bsr_print_helper(this, block_vals);
 }
 void BSCMatrix::print()
 {
-    bsc_print_helper(this, vals);
+    bsc_print_helper(this, block_vals);
 }
 
 /**************************************************************
@@ -131,6 +142,26 @@ void BSCMatrix::print()
 ***** Transpose the matrix, reversing rows and columns
 ***** Retain matrix type, and block structure if applicable
 **************************************************************/
+// Transpose each (b_rows x b_cols) block of vals into T_vals
+void transpose_blocks(const BlockArray& vals, BlockArray& T_vals, 
+        int b_rows, int b_cols)
+{
+    int n = vals.size();
+    T_vals.resize(n);
+    for (int i = 0; i < n; i++)
+    {
+        const double* block = vals[i];
+        double* T_block = T_vals[i];
+        for (int row = 0; row < b_rows; row++)
+        {
+            for (int col = 0; col < b_cols; col++)
+            {
+                T_block[col * b_rows + row] = block[row * b_cols + col];
+            }
+        }
+    }
+}
+
 COOMatrix* COOMatrix::transpose()
 {
     COOMatrix* T = new COOMatrix(n_rows, n_cols, idx2, idx1, vals);
@@ -139,7 +170,9 @@ COOMatrix* COOMatrix::transpose()
 
 BCOOMatrix* BCOOMatrix::transpose()
 {
-    BCOOMatrix* T = new BCOOMatrix(b_rows, b_cols, n_rows, n_cols, idx2, idx1, block_vals);
+    BlockArray T_vals(b_size);
+    transpose_blocks(block_vals, T_vals, b_rows, b_cols);
+    BCOOMatrix* T = new BCOOMatrix(n_cols, n_rows, b_cols, b_rows, idx2, idx1, T_vals);
     return T;
 }
 
@@ -153,7 +186,9 @@ CSRMatrix* CSRMatrix::transpose()
 
 BSRMatrix* BSRMatrix::transpose()
 {
-    BSCMatrix* T_bsc = new BSCMatrix(b_rows, b_cols, n_rows, n_cols, idx1, idx2, block_vals);
+    BlockArray T_vals(b_size);
+    transpose_blocks(block_vals, T_vals, b_rows, b_cols);
+    BSCMatrix* T_bsc = new BSCMatrix(n_cols, n_rows, b_cols, b_rows, idx1, idx2, T_vals);
     BSRMatrix* T = (BSRMatrix*) T_bsc->to_CSR();
     delete T_bsc;
     return T;
@@ -168,7 +203,9 @@ CSCMatrix* CSCMatrix::transpose()
 }
 BSCMatrix* BSCMatrix::transpose()
 {
-    BSRMatrix* T_bsr = new BSRMatrix(b_rows, b_cols, n_rows, n_cols, idx1, idx2, block_vals); 
+    BlockArray T_vals(b_size);
+    transpose_blocks(block_vals, T_vals, b_rows, b_cols);
+    BSRMatrix* T_bsr = new BSRMatrix(n_cols, n_rows, b_cols, b_rows, idx1, idx2, T_vals);
     BSCMatrix* T = (BSCMatrix*) T_bsr->to_CSC();
     delete T_bsr;
     return T;
@@ -202,9 +239,9 @@ void Matrix::resize(int _n_rows, int _n_cols)
 ***** -------------
 ***** Matrix* A : original matrix to copy (of some type)
 **************************************************************/
-template <typename T>
-void COO_to_COO(const COOMatrix* A, COOMatrix* B, std::vector<T>& A_vals,
-        std::vector<T>& B_vals)
+template <typename VecType>
+void COO_to_COO(const COOMatrix* A, COOMatrix* B, VecType& A_vals,
+        VecType& B_vals)
 {
     B->n_rows = A->n_rows;
     B->n_cols = A->n_cols;
@@ -221,12 +258,12 @@ void COO_to_COO(const COOMatrix* A, COOMatrix* B, std::vector<T>& A_vals,
     {
         B->idx1.emplace_back(A->idx1[i]);
         B->idx2.emplace_back(A->idx2[i]);
-        B_vals.emplace_back(B->copy_val(A_vals[i]));
+        B_vals.emplace_back(A_vals[i]);
     }
 }
-template <typename T>
-void CSR_to_COO(const CSRMatrix* A, COOMatrix* B, std::vector<T>& A_vals,
-        std::vector<T>& B_vals)
+template <typename VecType>
+void CSR_to_COO(const CSRMatrix* A, COOMatrix* B, VecType& A_vals,
+        VecType& B_vals)
 {
     B->n_rows = A->n_rows;
     B->n_cols = A->n_cols;
@@ -247,13 +284,13 @@ void CSR_to_COO(const CSRMatrix* A, COOMatrix* B, std::vector<T>& A_vals,
         {
             B->idx1.emplace_back(i);
             B->idx2.emplace_back(A->idx2[j]);
-            B_vals.emplace_back(B->copy_val(A_vals[j]));
+            B_vals.emplace_back(A_vals[j]);
         }
     }
 }
-template <typename T>
-void CSC_to_COO(const CSCMatrix* A, COOMatrix* B, std::vector<T>& A_vals,
-        std::vector<T>& B_vals)
+template <typename VecType>
+void CSC_to_COO(const CSCMatrix* A, COOMatrix* B, VecType& A_vals,
+        VecType& B_vals)
 {
     B->n_rows = A->n_rows;
     B->n_cols = A->n_cols;
@@ -274,14 +311,14 @@ void CSC_to_COO(const CSCMatrix* A, COOMatrix* B, std::vector<T>& A_vals,
         {
             B->idx1.emplace_back(A->idx2[j]);
             B->idx2.emplace_back(i);
-            B_vals.emplace_back(B->copy_val(A_vals[j]));
+            B_vals.emplace_back(A_vals[j]);
         }
     }
 
 }
-template <typename T>
-void COO_to_CSR(const COOMatrix* A, CSRMatrix* B, std::vector<T>& A_vals,
-        std::vector<T>& B_vals)
+template <typename VecType>
+void COO_to_CSR(const COOMatrix* A, CSRMatrix* B, VecType& A_vals,
+        VecType& B_vals)
 {
     B->n_rows = A->n_rows;
     B->n_cols = A->n_cols;
@@ -321,22 +358,25 @@ void COO_to_CSR(const COOMatrix* A, CSRMatrix* B, std::vector<T>& A_vals,
         B->idx2[index] = col;
         if (A->data_size()) // Checking that matrix has values (not S)
         {
-            B_vals[index] = B->copy_val(A_vals[i]);
+            B->copy_val(B_vals, index, A_vals[i]);
         }
     }
 
 }
-template <typename T>
-void CSR_to_CSR(const CSRMatrix* A, CSRMatrix* B, std::vector<T>& A_vals,
-        std::vector<T>& B_vals)
+template <typename VecType>
+void CSR_to_CSR(const CSRMatrix* A, CSRMatrix* B, VecType& A_vals,
+        VecType& B_vals)
 {
     B->n_rows = A->n_rows;
     B->n_cols = A->n_cols;
     B->nnz = A->nnz;
 
+    // Pattern-only matrices (such as strength) have no values to copy
+    bool has_vals = A->data_size();
+
     B->idx1.resize(A->n_rows + 1);
     B->idx2.resize(A->nnz);
-    B_vals.resize(A->nnz);
+    B_vals.resize(has_vals ? A->nnz : 0);
 
     B->idx1[0] = 0;
     for (int i = 0; i < A->n_rows; i++)
@@ -347,14 +387,13 @@ void CSR_to_CSR(const CSRMatrix* A, CSRMatrix* B, std::vector<T>& A_vals,
         for (int j = row_start; j < row_end; j++)
         {
             B->idx2[j] = A->idx2[j];
-            B_vals[j] = B->copy_val(A_vals[j]);
+            if (has_vals) B->copy_val(B_vals, j, A_vals[j]);
         }
     }
 
 }
-template <typename T>
-void BSR_to_CSR(const BSRMatrix* A, CSRMatrix* B, std::vector<T*>& A_vals,
-        std::vector<T>& B_vals)
+void BSR_to_CSR(const BSRMatrix* A, CSRMatrix* B, BlockArray& A_vals,
+        std::vector<double>& B_vals)
 {
     B->n_rows = A->n_rows * A->b_rows;
     B->n_cols = A->n_cols * A->b_cols;
@@ -363,7 +402,7 @@ void BSR_to_CSR(const BSRMatrix* A, CSRMatrix* B, std::vector<T*>& A_vals,
     B->idx2.reserve(A->nnz);
     B->vals.reserve(A->nnz);
 
-    T val;
+    double val;
     int col;
     B->idx1[0] = 0;
     for (int i = 0; i < A->n_rows; i++)
@@ -391,9 +430,9 @@ void BSR_to_CSR(const BSRMatrix* A, CSRMatrix* B, std::vector<T*>& A_vals,
     B->nnz = B->vals.size();
 
 }
-template <typename T>
-void CSC_to_CSR(const CSCMatrix* A, CSRMatrix* B, std::vector<T>& A_vals,
-        std::vector<T>& B_vals)
+template <typename VecType>
+void CSC_to_CSR(const CSCMatrix* A, CSRMatrix* B, VecType& A_vals,
+        VecType& B_vals)
 {
     B->n_rows = A->n_rows;
     B->n_cols = A->n_cols;
@@ -433,15 +472,15 @@ void CSC_to_CSR(const CSCMatrix* A, CSRMatrix* B, std::vector<T>& A_vals,
             B->idx2[idx] = i;
             if (A->data_size())
             {
-                B_vals[idx] = B->copy_val(A_vals[j]);
+                B->copy_val(B_vals, idx, A_vals[j]);
             }
         }
     }
 
 }
-template <typename T>
-void COO_to_CSC(const COOMatrix* A, CSCMatrix* B, std::vector<T>& A_vals,
-        std::vector<T>& B_vals)
+template <typename VecType>
+void COO_to_CSC(const COOMatrix* A, CSCMatrix* B, VecType& A_vals,
+        VecType& B_vals)
 {
     B->n_rows = A->n_rows;
     B->n_cols = A->n_cols;
@@ -481,14 +520,14 @@ void COO_to_CSC(const COOMatrix* A, CSCMatrix* B, std::vector<T>& A_vals,
         B->idx2[index] = row;
         if (A->data_size()) // Checking that matrix has values (not S)
         {
-            B_vals[index] = B->copy_val(A_vals[i]);
+            B->copy_val(B_vals, index, A_vals[i]);
         }
     }
 
 }
-template <typename T>
-void CSR_to_CSC(const CSRMatrix* A, CSCMatrix* B, std::vector<T>& A_vals,
-        std::vector<T>& B_vals)
+template <typename VecType>
+void CSR_to_CSC(const CSRMatrix* A, CSCMatrix* B, VecType& A_vals,
+        VecType& B_vals)
 {
     B->n_rows = A->n_rows;
     B->n_cols = A->n_cols;
@@ -528,15 +567,15 @@ void CSR_to_CSC(const CSRMatrix* A, CSCMatrix* B, std::vector<T>& A_vals,
             B->idx2[idx] = i;
             if (A->data_size())
             {
-                B_vals[idx] = B->copy_val(A_vals[j]);
+                B->copy_val(B_vals, idx, A_vals[j]);
             }
         }
     }
 
 }
-template <typename T>
-void CSC_to_CSC(const CSCMatrix* A, CSCMatrix* B, std::vector<T>& A_vals,
-        std::vector<T>& B_vals)
+template <typename VecType>
+void CSC_to_CSC(const CSCMatrix* A, CSCMatrix* B, VecType& A_vals,
+        VecType& B_vals)
 {
     B->n_rows = A->n_rows;
     B->n_cols = A->n_cols;
@@ -544,7 +583,7 @@ void CSC_to_CSC(const CSCMatrix* A, CSCMatrix* B, std::vector<T>& A_vals,
 
     B->idx1.resize(A->n_cols + 1);
     B->idx2.resize(A->nnz);
-    B->vals.resize(A->nnz);
+    B_vals.resize(A->nnz);
 
     B->idx1[0] = 0;
     for (int i = 0; i < A->n_cols; i++)
@@ -555,7 +594,7 @@ void CSC_to_CSC(const CSCMatrix* A, CSCMatrix* B, std::vector<T>& A_vals,
         for (int j = col_start; j < col_end; j++)
         {
             B->idx2[j] = A->idx2[j];
-            B_vals[j] = B->copy_val(A_vals[j]);
+            B->copy_val(B_vals, j, A_vals[j]);
         }
     }
 }
@@ -566,8 +605,8 @@ void CSC_to_CSC(const CSCMatrix* A, CSCMatrix* B, std::vector<T>& A_vals,
 **************************************************************
 ***** Sorts the sparse matrix by row and column
 **************************************************************/
-template <typename T>
-void sort_helper(COOMatrix* A, std::vector<T>& vals)
+template <typename VecType>
+void sort_helper(COOMatrix* A, VecType& vals)
 {
     if (A->sorted || A->nnz == 0)
     {
@@ -575,15 +614,62 @@ void sort_helper(COOMatrix* A, std::vector<T>& vals)
         return;
     }
 
-    vec_sort(A->idx1, A->idx2, vals);
+    int row, pos;
+    int has_vals = A->data_size();
+
+    // Radix sort: one counting pass places entries in row buckets,
+    // then each row is sorted by column
+    int n_rows = A->n_rows;
+    for (int i = 0; i < A->nnz; i++)
+    {
+        if (A->idx1[i] >= n_rows) n_rows = A->idx1[i] + 1;
+    }
+    std::vector<int> row_ptr(n_rows + 1, 0);
+    for (int i = 0; i < A->nnz; i++)
+    {
+        row_ptr[A->idx1[i] + 1]++;
+    }
+    for (int i = 0; i < n_rows; i++)
+    {
+        row_ptr[i+1] += row_ptr[i];
+    }
+
+    // Destination of each entry, applied in place by swapping along
+    // the cycles of the permutation
+    std::vector<int> dest(A->nnz);
+    std::vector<int> row_pos(row_ptr.begin(), row_ptr.end() - 1);
+    for (int i = 0; i < A->nnz; i++)
+    {
+        dest[i] = row_pos[A->idx1[i]]++;
+    }
+    for (int i = 0; i < A->nnz; i++)
+    {
+        while (dest[i] != i)
+        {
+            pos = dest[i];
+            std::swap(A->idx1[i], A->idx1[pos]);
+            std::swap(A->idx2[i], A->idx2[pos]);
+            if (has_vals) swap_vals(vals, i, pos);
+            std::swap(dest[i], dest[pos]);
+        }
+    }
+
+    // Sort the columns of each row, reusing dest as scratch
+    for (row = 0; row < n_rows; row++)
+    {
+        if (has_vals)
+            vec_sort(A->idx2, vals, row_ptr[row], row_ptr[row+1], dest);
+        else
+            std::sort(A->idx2.begin() + row_ptr[row], A->idx2.begin() + row_ptr[row+1]);
+    }
 
     A->sorted = true;
     A->diag_first = false;
 
 }
 
-template <typename T>
-void sort_helper(CSRMatrix* A, std::vector<T>& vals)
+template <typename VecType>
+void sort_helper(CSRMatrix* A, VecType& vals)
 {
     int start, end, row_size;
 
@@ -593,7 +679,9 @@ void sort_helper(CSRMatrix* A, std::vector<T>& vals)
         return;
     }
 
-    // Sort the columns of each row (and data accordingly) 
+    // Sort the columns of each row (and data accordingly), sharing
+    // one scratch permutation across rows
+    std::vector<int> perm;
     for (int row = 0; row < A->n_rows; row++)
     {
         start = A->idx1[row];
@@ -605,7 +693,7 @@ void sort_helper(CSRMatrix* A, std::vector<T>& vals)
         }
 
         if (A->data_size())
-            vec_sort(A->idx2, vals, start, end);
+            vec_sort(A->idx2, vals, start, end, perm);
         else
             std::sort(A->idx2.begin() + start, A->idx2.begin() + end);
     }
@@ -614,8 +702,8 @@ void sort_helper(CSRMatrix* A, std::vector<T>& vals)
     A->diag_first = false;
 }
 
-template <typename T>
-void sort_helper(CSCMatrix* A, std::vector<T>& vals)
+template <typename VecType>
+void sort_helper(CSCMatrix* A, VecType& vals)
 {
     int start, end, col_size;
 
@@ -625,8 +713,9 @@ void sort_helper(CSCMatrix* A, std::vector<T>& vals)
         return;
     }
 
-    // Sort the columns of each col (and data accordingly) and remove
-    // duplicates (summing values together)
+    // Sort the rows of each col (and data accordingly), sharing
+    // one scratch permutation across columns
+    std::vector<int> perm;
     for (int col = 0; col < A->n_cols; col++)
     {
         start = A->idx1[col];
@@ -638,7 +727,7 @@ void sort_helper(CSCMatrix* A, std::vector<T>& vals)
         }
 
         if (A->data_size())
-            vec_sort(A->idx2, vals, start, end);
+            vec_sort(A->idx2, vals, start, end, perm);
         else
             std::sort(A->idx2.begin() + start, A->idx2.begin() + end);
     }
@@ -679,8 +768,8 @@ void BSCMatrix::sort()
 ***** Moves the diagonal element to the front of each row
 ***** If matrix is not sorted, sorts before moving
 **************************************************************/
-template <typename T>
-void move_diag_helper(COOMatrix* A, std::vector<T>& vals)
+template <typename VecType>
+void move_diag_helper(COOMatrix* A, VecType& vals)
 {
     if (A->diag_first || A->nnz == 0)
     {
@@ -709,22 +798,20 @@ void move_diag_helper(COOMatrix* A, std::vector<T>& vals)
         }
         else if (row == col)
         {
-            auto tmp = vals[i];
             for (int j = i; j > row_start; j--)
             {
                 A->idx2[j] = A->idx2[j-1];
-                vals[j] = vals[j-1];
             }
             A->idx2[row_start] = row;
-            vals[row_start] = tmp;
+            rotate_vals(vals, row_start, i);
         }
     }
 
     A->diag_first = true;
 }
 
-template <typename T>
-void move_diag_helper(CSRMatrix* A, std::vector<T>& vals)
+template <typename VecType>
+void move_diag_helper(CSRMatrix* A, VecType& vals)
 {
     int start, end;
     int col;
@@ -746,14 +833,12 @@ void move_diag_helper(CSRMatrix* A, std::vector<T>& vals)
                 col = A->idx2[j];
                 if (col == i)
                 {
-                    auto tmp = vals[j];
                     for (int k = j; k > start; k--)
                     {
                         A->idx2[k] = A->idx2[k-1];
-                        vals[k] = vals[k-1];
                     }
                     A->idx2[start] = i;
-                    vals[start] = tmp;
+                    rotate_vals(vals, start, j);
                     break;
                 }
             }
@@ -783,8 +868,8 @@ void move_diag_helper(CSRMatrix* A, std::vector<T>& vals)
     A->diag_first = true;
 }
 
-template <typename T>
-void move_diag_helper(CSCMatrix* A, std::vector<T>& vals)
+template <typename VecType>
+void move_diag_helper(CSCMatrix* A, VecType& vals)
 {
     int start, end;
     int row;
@@ -806,14 +891,12 @@ void move_diag_helper(CSCMatrix* A, std::vector<T>& vals)
                 row = A->idx2[j];
                 if (row == i)
                 {
-                    auto tmp = vals[j];
                     for (int k = j; k > start; k--)
                     {
                         A->idx2[k] = A->idx2[k-1];
-                        vals[k] = vals[k-1];
                     }
                     A->idx2[start] = i;
-                    vals[start] = tmp;
+                    rotate_vals(vals, start, j);
                     break;
                 }
             }
@@ -874,9 +957,14 @@ void BSCMatrix::move_diag()
 ***** Goes thorugh each sorted row, and removes duplicate
 ***** entries, summing associated values
 **************************************************************/
-template <typename T>
-void remove_duplicates_helper(COOMatrix* A, std::vector<T>& vals)
+template <typename VecType>
+void remove_duplicates_helper(COOMatrix* A, VecType& vals)
 {
+    if (A->nnz == 0)
+    {
+        return;
+    }
+
     if (!A->sorted)
     {
         A->sort();
@@ -896,7 +984,7 @@ void remove_duplicates_helper(COOMatrix* A, std::vector<T>& vals)
         col = A->idx2[i];
         if (row == prev_row && col == prev_col)
         {
-            A->append_vals(&vals[ctr - 1], &vals[i]);
+            A->append_vals(vals[ctr - 1], vals[i]);
         }
         else
         { 
@@ -904,7 +992,7 @@ void remove_duplicates_helper(COOMatrix* A, std::vector<T>& vals)
             {
                 A->idx1[ctr] = row;
                 A->idx2[ctr] = col;
-                vals[ctr] = vals[i];
+                A->copy_val(vals, ctr, vals[i]);
             }
             ctr++;
 
@@ -916,8 +1004,8 @@ void remove_duplicates_helper(COOMatrix* A, std::vector<T>& vals)
     A->nnz = ctr;
 }
 
-template <typename T>
-void remove_duplicates_helper(CSRMatrix* A, std::vector<T>& vals)
+template <typename VecType>
+void remove_duplicates_helper(CSRMatrix* A, VecType& vals)
 {
     int orig_start, orig_end;
     int new_start;
@@ -946,7 +1034,7 @@ void remove_duplicates_helper(CSRMatrix* A, std::vector<T>& vals)
         // Remove Duplicates
         col = A->idx2[orig_start];
         A->idx2[new_start] = col;
-        vals[new_start] = vals[orig_start];
+        A->copy_val(vals, new_start, vals[orig_start]);
         prev_col = col;
         ctr = 1;
         for (int j = orig_start + 1; j < orig_end; j++)
@@ -954,7 +1042,7 @@ void remove_duplicates_helper(CSRMatrix* A, std::vector<T>& vals)
             col = A->idx2[j];
             if (col == prev_col)
             {
-                A->append_vals(&vals[ctr - 1 + new_start], &vals[j]);
+                A->append_vals(vals[ctr - 1 + new_start], vals[j]);
             }
             else
             {
@@ -964,7 +1052,7 @@ void remove_duplicates_helper(CSRMatrix* A, std::vector<T>& vals)
                 }
 
                 A->idx2[ctr + new_start] = col;
-                vals[ctr + new_start] = vals[j];
+                A->copy_val(vals, ctr + new_start, vals[j]);
                 ctr++;
                 prev_col = col;
             }
@@ -982,8 +1070,8 @@ void remove_duplicates_helper(CSRMatrix* A, std::vector<T>& vals)
     vals.resize(A->nnz);
 }
 
-template <typename T>
-void remove_duplicates_helper(CSCMatrix* A, std::vector<T>& vals)
+template <typename VecType>
+void remove_duplicates_helper(CSCMatrix* A, VecType& vals)
 {
     int orig_start, orig_end;
     int new_start;
@@ -1012,7 +1100,7 @@ void remove_duplicates_helper(CSCMatrix* A, std::vector<T>& vals)
         // Remove Duplicates
         row = A->idx2[orig_start];
         A->idx2[new_start] = row;
-        vals[new_start] = vals[orig_start];
+        A->copy_val(vals, new_start, vals[orig_start]);
         prev_row = row;
         ctr = 1;
         for (int j = orig_start + 1; j < orig_end; j++)
@@ -1020,7 +1108,7 @@ void remove_duplicates_helper(CSCMatrix* A, std::vector<T>& vals)
             row = A->idx2[j];
             if (row == prev_row)
             {
-                A->append_vals(&vals[ctr - 1 + new_start], &vals[j]);
+                A->append_vals(vals[ctr - 1 + new_start], vals[j]);
             }
             else
             {
@@ -1030,7 +1118,7 @@ void remove_duplicates_helper(CSCMatrix* A, std::vector<T>& vals)
                 }
 
                 A->idx2[ctr + new_start] = row;
-                vals[ctr + new_start] = vals[j];
+                A->copy_val(vals, ctr + new_start, vals[j]);
                 ctr++;
                 prev_row = row;
             }
@@ -1112,10 +1200,7 @@ CSRMatrix* BCOOMatrix::to_CSR()
 }
 CSRMatrix* BCOOMatrix::to_BSR()
 {
-    BSRMatrix* A = new BSRMatrix();
-    A->b_rows = b_rows;
-    A->b_cols = b_cols;
-    A->b_size = b_size;
+    BSRMatrix* A = new BSRMatrix(n_rows, n_cols, b_rows, b_cols);
     COO_to_CSR(this, A, block_vals, A->block_vals);
     return A;
 }
@@ -1135,10 +1220,7 @@ CSCMatrix* BCOOMatrix::to_CSC()
 }
 CSCMatrix* BCOOMatrix::to_BSC()
 {
-    BSCMatrix* A = new BSCMatrix();
-    A->b_rows = b_rows;
-    A->b_cols = b_cols;
-    A->b_size = b_size;
+    BSCMatrix* A = new BSCMatrix(n_rows, n_cols, b_rows, b_cols);
     COO_to_CSC(this, A, block_vals, A->block_vals);
     return A;
 }
@@ -1159,10 +1241,7 @@ COOMatrix* BSRMatrix::to_COO()
 }
 COOMatrix* BSRMatrix::to_BCOO()
 {
-    BCOOMatrix* A = new BCOOMatrix();
-    A->b_rows = b_rows;
-    A->b_cols = b_cols;
-    A->b_size = b_size;
+    BCOOMatrix* A = new BCOOMatrix(n_rows, n_cols, b_rows, b_cols);
     CSR_to_COO(this, A, block_vals, A->block_vals);
     return A;
 }
@@ -1200,10 +1279,7 @@ CSCMatrix* BSRMatrix::to_CSC()
 }
 CSCMatrix* BSRMatrix::to_BSC()
 {
-    BSCMatrix* A = new BSCMatrix();
-    A->b_rows = b_rows;
-    A->b_cols = b_cols;
-    A->b_size = b_size;
+    BSCMatrix* A = new BSCMatrix(n_rows, n_cols, b_rows, b_cols);
     CSR_to_CSC(this, A, block_vals, A->block_vals);
     return A;
 }
@@ -1224,10 +1300,7 @@ COOMatrix* BSCMatrix::to_COO()
 }
 COOMatrix* BSCMatrix::to_BCOO()
 {
-    BCOOMatrix* A = new BCOOMatrix();
-    A->b_rows = b_rows;
-    A->b_cols = b_cols;
-    A->b_size = b_size;
+    BCOOMatrix* A = new BCOOMatrix(n_rows, n_cols, b_rows, b_cols);
     CSC_to_COO(this, A, block_vals, A->block_vals);
     return A;
 }
@@ -1247,10 +1320,7 @@ CSRMatrix* BSCMatrix::to_CSR()
 }
 CSRMatrix* BSCMatrix::to_BSR()
 {
-    BSRMatrix* A = new BSRMatrix();
-    A->b_rows = b_rows;
-    A->b_cols = b_cols;
-    A->b_size = b_size;
+    BSRMatrix* A = new BSRMatrix(n_rows, n_cols, b_rows, b_cols);
     CSC_to_CSR(this, A, block_vals, A->block_vals);
     return A;
 }
@@ -1282,10 +1352,7 @@ COOMatrix* COOMatrix::copy()
 }
 BCOOMatrix* BCOOMatrix::copy()
 {
-    BCOOMatrix* A = new BCOOMatrix();
-    A->b_rows = b_rows;
-    A->b_cols = b_cols;
-    A->b_size = b_size;
+    BCOOMatrix* A = new BCOOMatrix(n_rows, n_cols, b_rows, b_cols);
     COO_to_COO(this, A, block_vals, A->block_vals);
     return A;
 }
@@ -1297,10 +1364,7 @@ CSRMatrix* CSRMatrix::copy()
 }
 BSRMatrix* BSRMatrix::copy()
 {
-    BSRMatrix* A = new BSRMatrix();
-    A->b_rows = b_rows;
-    A->b_cols = b_cols;
-    A->b_size = b_size;
+    BSRMatrix* A = new BSRMatrix(n_rows, n_cols, b_rows, b_cols);
     CSR_to_CSR(this, A, block_vals, A->block_vals);
     return A;
 }
@@ -1312,10 +1376,7 @@ CSCMatrix* CSCMatrix::copy()
 }
 BSCMatrix* BSCMatrix::copy()
 {
-    BSCMatrix* A = new BSCMatrix();
-    A->b_rows = b_rows;
-    A->b_cols = b_cols;
-    A->b_size = b_size;
+    BSCMatrix* A = new BSCMatrix(n_rows, n_cols, b_rows, b_cols);
     CSC_to_CSC(this, A, block_vals, A->block_vals);
     return A;
 }
@@ -1341,7 +1402,7 @@ void BCOOMatrix::block_removal_col_check(bool* col_check)
     }
     
     int idx, first_col;
-    double* block_val;
+    const double* block_val;
     for (int i = 0; i < nnz; i++)
     {
         block_val = block_vals[i];
@@ -1375,7 +1436,7 @@ void BSCMatrix::block_removal_col_check(bool* col_check)
     }
     
     int start, end, idx;
-    double* block_val;
+    const double* block_val;
     for (int j = 0; j < n_cols; j++)
     {
         start = idx1[j];
@@ -1413,7 +1474,7 @@ void BSRMatrix::block_removal_col_check(bool* col_check)
     }
 
     int start, end, idx, first_col;
-    double* block_val;
+    const double* block_val;
     for (int i = 0; i < n_rows; i++)
     {
         start = idx1[i];
@@ -5,6 +5,7 @@
 
 #include "types.hpp"
 #include "vector.hpp"
+#include "block_array.hpp"
 
 /**************************************************************
  *****   Matrix Base Class
@@ -26,6 +27,11 @@
  *****    List of position indices, specific to type of matrix
  ***** vals : std::vector<double>
  *****    List of values in matrix
+ ***** global_idx2 : std::vector<index_t>
+ *****    Global columns of rows received through a CommPkg, 
+ *****    left for the receiver to map to local columns in idx2
+ *****    (also holds off_proc columns added to a ParMatrix
+ *****    until it is finalized)
  *****
  ***** Methods
  ***** -------
@@ -106,21 +112,19 @@ namespace raptor
 
     virtual ~Matrix(){}
 
-    template <typename T>
+    template <typename VecType>
     void init_from_lists(std::vector<int>& _idx1, std::vector<int>& _idx2, 
-            std::vector<T>& data)
+            VecType& data)
     {
         nnz = data.size();
         resize_data(nnz);
 
-        T* val_list = (T*) get_data();
-
         std::copy(_idx1.begin(), _idx1.end(), std::back_inserter(idx1));
         std::copy(_idx2.begin(), _idx2.end(), std::back_inserter(idx2));
 
         for (int i = 0; i < nnz; i++)
         {
-            val_list[i] = copy_val(data[i]);
+            copy_data(i, data[i]);
         }
     }
 
@@ -169,7 +173,7 @@ namespace raptor
     {
         printf("A[%d][%d] = %e\n", row, col, val);
     }
-    void val_print(int row, int col, double* val) const
+    void val_print(int row, int col, const double* val) const
     {
         for (int i = 0; i < b_rows; i++)
         {
@@ -180,18 +184,15 @@ namespace raptor
         }
     }
 
-    double copy_val(double val) const
+    // Methods for copying a single or block value
+    // into position j of a list of values
+    void copy_val(std::vector<double>& dest, int j, double val) const
     {
-        return val;
+        dest[j] = val;
     }
-    double* copy_val(double* val) const
+    void copy_val(BlockArray& dest, int j, const double* val) const
     {
-        double* new_val = new double[b_size];
-        for (int i = 0; i < b_size; i++)
-        {
-            new_val[i] = val[i];
-        }
-        return new_val;
+        dest.set(j, val);
     }
 
     // Method for finding the absolute value of 
@@ -200,7 +201,7 @@ namespace raptor
     {
         return fabs(val);
     }
-    double abs_val(double* val) const
+    double abs_val(const double* val) const
     {
         double sum = 0;
         for (int i = 0; i < b_size; i++)
@@ -212,58 +213,15 @@ namespace raptor
 
     // Methods for appending two values
     // (either single or block values)
-    void append_vals(double* val, double* addl_val) const
+    void append_vals(double& val, double addl_val) const
     {
-        *val += *addl_val;
+        val += addl_val;
     }
-    void append_vals(double** val, double** addl_val) const
+    void append_vals(double* val, const double* addl_val) const
     {
         for (int i = 0; i < b_size; i++)
         {
-            *val[i] += *addl_val[i];
-        }
-        delete[] *addl_val;
-    }
-    void mult_vals(double val, double addl_val, double* sum, 
-            int nr, int nc0, int n_inner) const
-    {
-        *sum += (val * addl_val);
-    }
-    void mult_vals(double* val, double* addl_val, double** sum,
-            int nr, int nc, int n_inner) const
-    {
-        for (int i = 0; i < nr; i++) // Go through b_rows of A
-        { 
-            for (int j = 0; j < nc; j++) // Go through b_cols of B
-            {
-                double s = 0;
-                for (int k = 0; k < n_inner; k++) // Go through b_cols of A (== b_rows of B)
-                {
-                    s += val[i*n_inner + k] * addl_val[k*n_inner + j];
-                }
-                (*sum)[i*nc + j] += s;
-            }
-        }
-    }
-    void mult_T_vals(double val, double addl_val, double* sum,
-            int nr, int nc, int n_inner) const
-    {
-        *sum += (val * addl_val);
-    }
-    void mult_T_vals(double* val, double* addl_val, double** sum,
-            int nr, int nc, int n_inner) const
-    {
-        for (int i = 0; i < nr; i++) // Go through b_rows of A
-        { 
-            for (int j = 0; j < nc; j++) // Go through b_cols of B
-            {
-                double s = 0;
-                for (int k = 0; k < n_inner; k++) // Go through b_cols of A (== b_rows of B)
-                {
-                    s += val[k*n_inner + i] * addl_val[k*n_inner + j];
-                }
-                (*sum)[i*nc + j] += s;
-            }
+            val[i] += addl_val[i];
         }
     }
 
@@ -325,7 +283,7 @@ namespace raptor
     void append_neg_T(int _idx1, int _idx2, double* b, const double* x, const double* val) const
     {
         int first_row = _idx1*b_rows;
-        int first_col = _idx1*b_cols;
+        int first_col = _idx2*b_cols;
         for (int row = 0; row < b_rows; row++)
         {
             for (int col = 0; col < b_cols; col++)
@@ -385,6 +343,8 @@ namespace raptor
 
     virtual void resize_data(int size) = 0;
     virtual void* get_data() = 0;
+    virtual void copy_data(int j, double val) = 0;
+    virtual void copy_data(int j, const double* val) = 0;
     virtual int data_size() const = 0;
     virtual void reserve_size(int size) = 0;
     virtual double get_val(const int j, const int k) = 0;
@@ -392,6 +352,7 @@ namespace raptor
     std::vector<int> idx1;
     std::vector<int> idx2;
     std::vector<double> vals;
+    std::vector<index_t> global_idx2;
 
     int b_rows;
     int b_cols;
@@ -493,8 +454,6 @@ namespace raptor
             resize_data(nnz_dense);
         }
 
-        T* val_list = (T*) get_data();
-
         for (int i = 0; i < n_rows; i++)
         {
             for (int j = 0; j < n_cols; j++)
@@ -504,7 +463,7 @@ namespace raptor
                 {
                     idx1[nnz] = i;
                     idx2[nnz] = j;
-                    val_list[nnz] = copy_val(_data[pos]);
+                    copy_data(nnz, _data[pos]);
                     nnz++;
                 }
             }
@@ -567,7 +526,15 @@ namespace raptor
     void* get_data()
     {
        return vals.data();
-    } 
+    }
+    void copy_data(int j, double val)
+    {
+        vals[j] = val;
+    }
+    void copy_data(int j, const double* val)
+    {
+        vals[j] = *val;
+    }
     int data_size() const
     {
         return vals.size();
@@ -677,8 +644,6 @@ namespace raptor
             resize_data(nnz_dense);
         }
 
-        T* val_list = (T*) get_data();
-
         idx1[0] = 0;
         for (int i = 0; i < n_rows; i++)
         {
@@ -688,7 +653,7 @@ namespace raptor
                 if (abs_val(_data[pos]))
                 {
                     idx2[nnz] = j;
-                    val_list[nnz] = copy_val(_data[pos]);
+                    copy_data(nnz, _data[pos]);
                     nnz++;
                 }
             }
@@ -711,6 +676,14 @@ namespace raptor
     void spmv_append_neg_T(const double* x, double* b) const;
     void spmv_residual(const double* x, const double* b, double* r) const; 
 
+    // Sparse matrix times n_vecs vectors, stored row-major (CSR values only)
+    void spmm(const double* x, double* b, int n_vecs) const;
+    void spmm_append(const double* x, double* b, int n_vecs) const;
+    void spmm_append_T(const double* x, double* b, int n_vecs) const;
+    void spmm_append_neg(const double* x, double* b, int n_vecs) const;
+    void spmm_residual(const double* x, const double* b, double* r, 
+            int n_vecs) const;
+
     CSRMatrix* spgemm(CSRMatrix* B, int* B_to_C = NULL);
     CSRMatrix* spgemm_T(CSCMatrix* A, int* C_map = NULL);
 
@@ -759,7 +732,15 @@ namespace raptor
     void* get_data()
     {
        return vals.data();
-    } 
+    }
+    void copy_data(int j, double val)
+    {
+        vals[j] = val;
+    }
+    void copy_data(int j, const double* val)
+    {
+        vals[j] = *val;
+    }
     int data_size() const
     {
         return vals.size();
@@ -853,8 +834,6 @@ namespace raptor
             resize_data(nnz_dense);
         }
 
-        T* val_list = (T*) get_data();
-
         idx1[0] = 0;
         for (int i = 0; i < n_cols; i++)
         {
@@ -864,7 +843,7 @@ namespace raptor
                 if (abs_val(_data[pos]) > zero_tol)
                 {
                     idx2[nnz] = j;
-                    val_list[nnz] = copy_val(_data[pos]);
+                    copy_data(nnz, _data[pos]);
                     nnz++;
                 }
             }
@@ -928,7 +907,15 @@ namespace raptor
     void* get_data()
     {
        return vals.data();
-    } 
+    }
+    void copy_data(int j, double val)
+    {
+        vals[j] = val;
+    }
+    void copy_data(int j, const double* val)
+    {
+        vals[j] = *val;
+    }
     int data_size() const
     {
         return vals.size();
@@ -969,6 +956,7 @@ class BSRMatrix : public CSRMatrix
         b_rows = block_row_size;
         b_cols = block_col_size;
         b_size = b_rows * b_cols;
+        block_vals.set_block_size(b_size);
     }
 
     BSRMatrix(int num_block_rows, int num_block_cols, 
@@ -978,19 +966,22 @@ class BSRMatrix : public CSRMatrix
         b_rows = block_row_size;
         b_cols = block_col_size;
         b_size = b_rows * b_cols;
+        block_vals.set_block_size(b_size);
 
         init_from_dense(data);
     }
 
 
+    template <typename VecType>
     BSRMatrix(int num_block_rows, int num_block_cols, 
             int block_row_size, int block_col_size, std::vector<int>& rowptr, 
-            std::vector<int>& cols, std::vector<double*>& data)
+            std::vector<int>& cols, VecType& data)
         :  CSRMatrix(num_block_rows, num_block_cols, 0)
     {
         b_rows = block_row_size;
         b_cols = block_col_size;
         b_size = b_rows * b_cols;
+        block_vals.set_block_size(b_size);
 
         init_from_lists(rowptr, cols, data);
     }
@@ -1003,13 +994,6 @@ class BSRMatrix : public CSRMatrix
         b_size = 1;
     }
 
-    ~BSRMatrix()
-    {
-        for (std::vector<double*>::iterator it = block_vals.begin();
-                it != block_vals.end(); ++it)
-            delete[] *it;
-    }
-
     BSRMatrix* transpose();
     void sort();
     void remove_duplicates();
@@ -1045,14 +1029,22 @@ class BSRMatrix : public CSRMatrix
     void add_value(int row, int col, double* value) 
     {
         idx2.emplace_back(col);
-        block_vals.emplace_back(copy_val(value));
+        block_vals.emplace_back(value);
         nnz++;
     }
 
     void* get_data()
     {
        return block_vals.data();
-    } 
+    }
+    void copy_data(int j, double val)
+    {
+        std::fill(block_vals[j], block_vals[j] + b_size, val);
+    }
+    void copy_data(int j, const double* val)
+    {
+        block_vals.set(j, val);
+    }
     int data_size() const
     {
         return block_vals.size();
@@ -1072,7 +1064,7 @@ class BSRMatrix : public CSRMatrix
         return block_vals[j][k];
     }
 
-    std::vector<double*> block_vals;
+    BlockArray block_vals;
 };
 
 class BCOOMatrix : public COOMatrix
@@ -1085,6 +1077,7 @@ class BCOOMatrix : public COOMatrix
         b_rows = block_row_size;
         b_cols = block_col_size;
         b_size = b_rows * b_cols;
+        block_vals.set_block_size(b_size);
     }
 
     BCOOMatrix(int num_block_rows, int num_block_cols,
@@ -1094,19 +1087,22 @@ class BCOOMatrix : public COOMatrix
         b_rows = block_row_size;
         b_cols = block_col_size;
         b_size = b_rows * b_cols;
+        block_vals.set_block_size(b_size);
         
         init_from_dense(values); 
     }
 
+    template <typename VecType>
     BCOOMatrix(int num_block_rows, int num_block_cols,
             int block_row_size, int block_col_size,
             std::vector<int>& rows, std::vector<int>& cols, 
-            std::vector<double*>& data)
+            VecType& data)
        : COOMatrix(num_block_rows, num_block_cols, 0) 
     {
         b_rows = block_row_size;
         b_cols = block_col_size;
         b_size = b_rows * b_cols;
+        block_vals.set_block_size(b_size);
 
         init_from_lists(rows, cols, data);
     }
@@ -1118,13 +1114,6 @@ class BCOOMatrix : public COOMatrix
         b_size = 1;
     }
 
-    ~BCOOMatrix()
-    {
-        for (std::vector<double*>::iterator it = block_vals.begin();
-                it != block_vals.end(); ++it)
-            delete[] *it;
-    }
-
     BCOOMatrix* transpose();
     void sort();
     void remove_duplicates();
@@ -1155,7 +1144,7 @@ class BCOOMatrix : public COOMatrix
     {
         idx1.emplace_back(row);
         idx2.emplace_back(col);
-        block_vals.emplace_back(copy_val(values));
+        block_vals.emplace_back(values);
         nnz++;
     }
 
@@ -1167,7 +1156,15 @@ class BCOOMatrix : public COOMatrix
     void* get_data()
     {
        return block_vals.data();
-    } 
+    }
+    void copy_data(int j, double val)
+    {
+        std::fill(block_vals[j], block_vals[j] + b_size, val);
+    }
+    void copy_data(int j, const double* val)
+    {
+        block_vals.set(j, val);
+    }
     int data_size() const
     {
         return block_vals.size();
@@ -1188,7 +1185,7 @@ class BCOOMatrix : public COOMatrix
         return block_vals[j][k];
     }
 
-    std::vector<double*> block_vals;
+    BlockArray block_vals;
 };
 
 // Blocks are still stored row-wise in BSC matrix...
@@ -1202,6 +1199,7 @@ class BSCMatrix : public CSCMatrix
         b_rows = block_row_size;
         b_cols = block_col_size;
         b_size = b_rows * b_cols;
+        block_vals.set_block_size(b_size);
     }
 
     BSCMatrix(int num_block_rows, int num_block_cols, 
@@ -1211,19 +1209,22 @@ class BSCMatrix : public CSCMatrix
         b_rows = block_row_size;
         b_cols = block_col_size;
         b_size = b_rows * b_cols;
+        block_vals.set_block_size(b_size);
 
         init_from_dense(data);
     }
 
 
+    template <typename VecType>
     BSCMatrix(int num_block_rows, int num_block_cols, 
             int block_row_size, int block_col_size, std::vector<int>& colptr, 
-            std::vector<int>& rows, std::vector<double*>& data)
+            std::vector<int>& rows, VecType& data)
         :  CSCMatrix(num_block_rows, num_block_cols, 0)
     {
         b_rows = block_row_size;
         b_cols = block_col_size;
         b_size = b_rows * b_cols;
+        block_vals.set_block_size(b_size);
 
         init_from_lists(colptr, rows, data);
     }
@@ -1236,13 +1237,6 @@ class BSCMatrix : public CSCMatrix
         b_size = 1;
     }
 
-    ~BSCMatrix()
-    {
-        for (std::vector<double*>::iterator it = block_vals.begin();
-                it != block_vals.end(); ++it)
-            delete[] *it;
-    }
-
     BSCMatrix* transpose();
     void sort();
     void remove_duplicates();
@@ -1278,7 +1272,7 @@ class BSCMatrix : public CSCMatrix
     void add_value(int row, int col, double* value)
     {
         idx2.emplace_back(row);
-        block_vals.emplace_back(copy_val(value));
+        block_vals.emplace_back(value);
         nnz++;
     }
 
@@ -1286,6 +1280,14 @@ class BSCMatrix : public CSCMatrix
     {
        return block_vals.data();
     }
+    void copy_data(int j, double val)
+    {
+        std::fill(block_vals[j], block_vals[j] + b_size, val);
+    }
+    void copy_data(int j, const double* val)
+    {
+        block_vals.set(j, val);
+    }
     void resize_data(int size)
     {
         block_vals.resize(size);
@@ -1305,7 +1307,7 @@ class BSCMatrix : public CSCMatrix
         return block_vals[j][k];
     }
 
-    std::vector<double*> block_vals;
+    BlockArray block_vals;
 };
 
 
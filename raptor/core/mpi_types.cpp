@@ -122,6 +122,25 @@ int RAPtor_MPI_Bcast(void *buffer, int count, RAPtor_MPI_Datatype datatype,
     if (profile) collective_t += RAPtor_MPI_Wtime();
     return val;
 }
+int RAPtor_MPI_Alltoall(const void* sendbuf, int sendcount, RAPtor_MPI_Datatype sendtype,
+        void *recvbuf, int recvcount, RAPtor_MPI_Datatype recvtype, RAPtor_MPI_Comm comm)
+{
+    if (profile) collective_t -= RAPtor_MPI_Wtime();
+    int val = MPI_Alltoall(sendbuf, sendcount, sendtype, recvbuf, recvcount,
+            recvtype, comm);
+    if (profile) collective_t += RAPtor_MPI_Wtime();
+    return val;
+}
+int RAPtor_MPI_Alltoallv(const void* sendbuf, const int *sendcounts, const int* sdispls,
+        RAPtor_MPI_Datatype sendtype, void *recvbuf, const int *recvcounts, 
+        const int* rdispls, RAPtor_MPI_Datatype recvtype, RAPtor_MPI_Comm comm)
+{
+    if (profile) collective_t -= RAPtor_MPI_Wtime();
+    int val = MPI_Alltoallv(sendbuf, sendcounts, sdispls, sendtype, recvbuf, 
+            recvcounts, rdispls, recvtype, comm);
+    if (profile) collective_t += RAPtor_MPI_Wtime();
+    return val;
+}
 int RAPtor_MPI_Ibarrier(RAPtor_MPI_Comm comm, RAPtor_MPI_Request *request)
 {
     if (profile) collective_t -= RAPtor_MPI_Wtime();
@@ -328,4 +347,47 @@ int RAPtor_MPI_Comm_dup(MPI_Comm comm, MPI_Comm* new_comm)
     if (profile) new_comm_t += RAPtor_MPI_Wtime();
     return val;
 }
+int RAPtor_MPI_Comm_split_type(RAPtor_MPI_Comm comm, int split_type, int key,
+        MPI_Info info, RAPtor_MPI_Comm* new_comm)
+{
+    if (profile) new_comm_t -= RAPtor_MPI_Wtime();
+    int val = MPI_Comm_split_type(comm, split_type, key, info, new_comm);
+    if (profile) new_comm_t += RAPtor_MPI_Wtime();
+    return val;
+}
+
+
 
+// Shared Memory Windows
+int RAPtor_MPI_Win_allocate_shared(RAPtor_MPI_Aint size, int disp_unit,
+        MPI_Info info, RAPtor_MPI_Comm comm, void* baseptr, RAPtor_MPI_Win* win)
+{
+    if (profile) new_comm_t -= RAPtor_MPI_Wtime();
+    int val = MPI_Win_allocate_shared(size, disp_unit, info, comm, baseptr, win);
+    if (profile) new_comm_t += RAPtor_MPI_Wtime();
+    return val;
+}
+int RAPtor_MPI_Win_shared_query(RAPtor_MPI_Win win, int rank, 
+        RAPtor_MPI_Aint* size, int* disp_unit, void* baseptr)
+{
+    return MPI_Win_shared_query(win, rank, size, disp_unit, baseptr);
+}
+int RAPtor_MPI_Win_lock_all(int assert, RAPtor_MPI_Win win)
+{
+    return MPI_Win_lock_all(assert, win);
+}
+int RAPtor_MPI_Win_unlock_all(RAPtor_MPI_Win win)
+{
+    return MPI_Win_unlock_all(win);
+}
+int RAPtor_MPI_Win_sync(RAPtor_MPI_Win win)
+{
+    return MPI_Win_sync(win);
+}
+int RAPtor_MPI_Win_free(RAPtor_MPI_Win* win)
+{
+    if (profile) new_comm_t -= RAPtor_MPI_Wtime();
+    int val = MPI_Win_free(win);
+    if (profile) new_comm_t += RAPtor_MPI_Wtime();
+    return val;
+}
@@ -30,6 +30,8 @@ extern void average_profile(int n_iter);
 #define RAPtor_MPI_Request           MPI_Request
 #define RAPtor_MPI_Status            MPI_Status
 #define RAPtor_MPI_Op                MPI_Op
+#define RAPtor_MPI_Win               MPI_Win
+#define RAPtor_MPI_Aint              MPI_Aint
 
 #define RAPtor_MPI_INT               MPI_INT
 #define RAPtor_MPI_DOUBLE            MPI_DOUBLE
@@ -43,9 +45,15 @@ extern void average_profile(int n_iter);
 #define RAPtor_MPI_SOURCE            MPI_SOURCE
 #define RAPtor_MPI_ANY_SOURCE        MPI_ANY_SOURCE
 
+#define RAPtor_MPI_INFO_NULL         MPI_INFO_NULL
+#define RAPtor_MPI_WIN_NULL          MPI_WIN_NULL
+#define RAPtor_MPI_MODE_NOCHECK      MPI_MODE_NOCHECK
+#define RAPtor_MPI_COMM_TYPE_SHARED  MPI_COMM_TYPE_SHARED
+
 #define RAPtor_MPI_IN_PLACE          MPI_IN_PLACE
 #define RAPtor_MPI_SUM               MPI_SUM
 #define RAPtor_MPI_MAX               MPI_MAX
+#define RAPtor_MPI_MIN               MPI_MIN
 #define RAPtor_MPI_BOR               MPI_BOR
 
 
@@ -76,6 +84,13 @@ extern int RAPtor_MPI_Ibarrier(RAPtor_MPI_Comm comm,
 extern int RAPtor_MPI_Barrier(RAPtor_MPI_Comm comm);
 extern int RAPtor_MPI_Bcast(void *buffer, int count, RAPtor_MPI_Datatype datatype,
         int root, RAPtor_MPI_Comm comm);
+extern int RAPtor_MPI_Alltoall(const void* sendbuf, int sendcount,
+        RAPtor_MPI_Datatype sendtype, void *recvbuf, int recvcount,
+        RAPtor_MPI_Datatype recvtype, RAPtor_MPI_Comm comm);
+extern int RAPtor_MPI_Alltoallv(const void* sendbuf, const int *sendcounts,
+        const int* sdispls, RAPtor_MPI_Datatype sendtype, void *recvbuf, 
+        const int *recvcounts, const int* rdispls, RAPtor_MPI_Datatype recvtype,
+        RAPtor_MPI_Comm comm);
 
 // Point-to-Point Operations
 extern int RAPtor_MPI_Send(const void *buf, int count,
@@ -129,5 +144,17 @@ extern int RAPtor_MPI_Group_incl(RAPtor_MPI_Group group, int n, const int ranks[
         RAPtor_MPI_Group *newgroup);
 extern int RAPtor_MPI_Group_free(RAPtor_MPI_Group* group);
 extern int RAPtor_MPI_Comm_dup(MPI_Comm comm, MPI_Comm* new_comm);
+extern int RAPtor_MPI_Comm_split_type(RAPtor_MPI_Comm comm, int split_type, 
+        int key, MPI_Info info, RAPtor_MPI_Comm* new_comm);
+
+// Shared Memory Windows
+extern int RAPtor_MPI_Win_allocate_shared(RAPtor_MPI_Aint size, int disp_unit,
+        MPI_Info info, RAPtor_MPI_Comm comm, void* baseptr, RAPtor_MPI_Win* win);
+extern int RAPtor_MPI_Win_shared_query(RAPtor_MPI_Win win, int rank, 
+        RAPtor_MPI_Aint* size, int* disp_unit, void* baseptr);
+extern int RAPtor_MPI_Win_lock_all(int assert, RAPtor_MPI_Win win);
+extern int RAPtor_MPI_Win_unlock_all(RAPtor_MPI_Win win);
+extern int RAPtor_MPI_Win_sync(RAPtor_MPI_Win win);
+extern int RAPtor_MPI_Win_free(RAPtor_MPI_Win* win);
 
 #endif
@@ -16,7 +16,7 @@ void bsr_to_csr_copy_helper(ParBSRMatrix* A, ParCSRMatrix* B);
 *****
 ***** Parameters
 ***** -------------
-***** row : index_t
+***** row : int
 *****    Local row of value
 ***** global_col : index_t 
 *****    Global column of value
@@ -35,7 +35,14 @@ void ParMatrix::add_value(
     }
     else 
     {
-        off_proc->add_value(row, global_col, value);
+        // Off-process columns are staged in off_proc->global_idx2
+        // until finalize() condenses them
+        int nnz = off_proc->nnz;
+        off_proc->add_value(row, -1, value);
+        if (off_proc->nnz > nnz)
+        {
+            off_proc->global_idx2.emplace_back(global_col);
+        }
     }
 }
 
@@ -83,36 +90,56 @@ void ParMatrix::condense_off_proc()
         return;
     }
 
-    int prev_col = -1;
-
-    std::map<int, int> orig_to_new;
+    // Columns added through add_value() are staged in global_idx2,
+    // while assembled off_proc blocks hold global columns in idx2
+    bool staged = off_proc->global_idx2.size();
+    if (staged)
+    {
+        std::copy(off_proc->global_idx2.begin(), off_proc->global_idx2.end(),
+                std::back_inserter(off_proc_column_map));
+    }
+    else
+    {
+        std::copy(off_proc->idx2.begin(), off_proc->idx2.end(),
+                std::back_inserter(off_proc_column_map));
+    }
+    sort_unique(off_proc_column_map);
+    off_proc_num_cols = off_proc_column_map.size();
 
-    std::copy(off_proc->idx2.begin(), off_proc->idx2.end(),
-            std::back_inserter(off_proc_column_map));
-    std::sort(off_proc_column_map.begin(), off_proc_column_map.end());
+    IntMap<index_t> orig_to_new(off_proc_num_cols);
+    for (int i = 0; i < off_proc_num_cols; i++)
+    {
+        orig_to_new.insert(off_proc_column_map[i], i);
+    }
 
-    off_proc_num_cols = 0;
-    for (std::vector<int>::iterator it = off_proc_column_map.begin(); 
-            it != off_proc_column_map.end(); ++it)
+    if (staged)
     {
-        if (*it != prev_col)
+        for (int i = 0; i < (int) off_proc->idx2.size(); i++)
         {
-            orig_to_new[*it] = off_proc_num_cols;
-            off_proc_column_map[off_proc_num_cols++] = *it;
-            prev_col = *it;
+            off_proc->idx2[i] = orig_to_new.find(off_proc->global_idx2[i]);
         }
+        std::vector<index_t>().swap(off_proc->global_idx2);
     }
-    off_proc_column_map.resize(off_proc_num_cols);
-
-    for (std::vector<int>::iterator it = off_proc->idx2.begin();
-            it != off_proc->idx2.end(); ++it)
+    else
     {
-        *it = orig_to_new[*it];
+        for (std::vector<int>::iterator it = off_proc->idx2.begin();
+                it != off_proc->idx2.end(); ++it)
+        {
+            *it = orig_to_new.find(*it);
+        }
     }
 }
 
 void ParMatrix::finalize(bool create_comm)
 {
+    // Staged off_proc columns are condensed before sorting, as sort()
+    // permutes idx2 but not global_idx2
+    bool staged = off_proc->global_idx2.size();
+    if (staged)
+    {
+        condense_off_proc();
+    }
+
     on_proc->sort();
     on_proc->remove_duplicates();
     off_proc->sort();
@@ -141,15 +168,19 @@ void ParMatrix::finalize(bool create_comm)
         }
     }
 
-    // Condense columns in off_proc, storing global
-    // columns as 0-num_cols, and store mapping
-    if (off_proc->nnz)
+    // Condense columns in off_proc (unless staged columns were
+    // condensed above), storing global columns as 0-num_cols, and 
+    // store mapping
+    if (!staged)
     {
-        condense_off_proc();
-    }
-    else
-    {
-        off_proc_num_cols = 0;
+        if (off_proc->nnz)
+        {
+            condense_off_proc();
+        }
+        else
+        {
+            off_proc_num_cols = 0;
+        }
     }
     off_proc->resize(local_num_rows, off_proc_num_cols);
     local_nnz = on_proc->nnz + off_proc->nnz;
@@ -601,6 +632,8 @@ void ParCSRMatrix::copy_helper(ParCSRMatrix* A)
 
     on_proc = A->on_proc->copy();
     off_proc = A->off_proc->copy();
+    interior_rows = A->interior_rows;
+    boundary_rows = A->boundary_rows;
 
     ParMatrix::copy_helper(A);
 }
@@ -690,6 +723,27 @@ void ParCSCMatrix::copy_helper(ParCOOMatrix* A)
     ParMatrix::copy_helper(A);
 }
 
+/**************************************************************
+ *****   ParCSRMatrix Split Rows
+ **************************************************************
+ ***** Splits local rows into interior rows, with no off_proc
+ ***** entries, and boundary rows, which depend on values 
+ ***** owned by other processes.  Relaxation updates interior
+ ***** rows while the halo exchange is in flight.
+ **************************************************************/
+void ParCSRMatrix::split_rows()
+{
+    interior_rows.clear();
+    boundary_rows.clear();
+    for (int i = 0; i < local_num_rows; i++)
+    {
+        if (off_proc->idx1[i+1] > off_proc->idx1[i])
+            boundary_rows.emplace_back(i);
+        else
+            interior_rows.emplace_back(i);
+    }
+}
+
 // Main transpose
 ParCSRMatrix* ParCSRMatrix::transpose()
 {
@@ -858,14 +912,14 @@ ParBSRMatrix* ParCSRMatrix::to_ParBSR(const int block_row_size, const int block_
     int global_col, pos;
     double val;
 
-    int global_block_rows = global_num_rows / block_row_size;
-    int global_block_cols = global_num_cols / block_col_size;
+    index_t global_block_rows = global_num_rows / block_row_size;
+    index_t global_block_cols = global_num_cols / block_col_size;
     ParBSRMatrix* A = new ParBSRMatrix(global_block_rows, global_block_cols,
             block_row_size, block_col_size);
 
     // Get local to global mappings for block matrix
     prev_row = -1;
-    for (std::vector<int>::iterator it = local_row_map.begin();
+    for (std::vector<index_t>::iterator it = local_row_map.begin();
             it != local_row_map.end(); ++it)
     {
         block_row = *it / block_row_size;
@@ -882,7 +936,7 @@ ParBSRMatrix* ParCSRMatrix::to_ParBSR(const int block_row_size, const int block_
     else
     {
         prev_col = -1;        
-        for (std::vector<int>::iterator it = on_proc_column_map.begin();
+        for (std::vector<index_t>::iterator it = on_proc_column_map.begin();
                 it != on_proc_column_map.end(); ++it)
         {
             block_col = *it / block_col_size;
@@ -895,14 +949,14 @@ ParBSRMatrix* ParCSRMatrix::to_ParBSR(const int block_row_size, const int block_
     }
 
     prev_col = -1;
-    std::map<int, int> global_to_block_local;
-    for (std::vector<int>::iterator it = off_proc_column_map.begin();
+    IntMap<index_t> global_to_block_local;
+    for (std::vector<index_t>::iterator it = off_proc_column_map.begin();
             it != off_proc_column_map.end(); ++it)
     {
         block_col = *it / block_col_size;
         if (block_col != prev_col)
         {
-            global_to_block_local[block_col] = A->off_proc_column_map.size();
+            global_to_block_local.insert(block_col, A->off_proc_column_map.size());
             A->off_proc_column_map.emplace_back(block_col);
             prev_col = block_col;
         }
@@ -933,8 +987,8 @@ ParBSRMatrix* ParCSRMatrix::to_ParBSR(const int block_row_size, const int block_
                 {
                     on_proc_pos[block_col] = A_on_proc->idx2.size();
                     A_on_proc->idx2.emplace_back(block_col);
-                    A_on_proc->block_vals.emplace_back(
-                            new double[A_on_proc->b_size]());
+                    A_on_proc->block_vals.resize(
+                            A_on_proc->block_vals.size() + 1);
                 }
                 val = on_proc->vals[k];
                 pos = on_proc_pos[block_col];
@@ -949,13 +1003,13 @@ ParBSRMatrix* ParCSRMatrix::to_ParBSR(const int block_row_size, const int block_
             {
                 col = off_proc->idx2[k];
                 global_col = off_proc_column_map[col];
-                block_col = global_to_block_local[global_col / block_col_size];
+                block_col = global_to_block_local.find(global_col / block_col_size);
                 if (off_proc_pos[block_col] == -1)
                 {
                     off_proc_pos[block_col] = A_off_proc->idx2.size();
                     A_off_proc->idx2.emplace_back(block_col);
-                    A_off_proc->block_vals.emplace_back(
-                            new double[A_off_proc->b_size]());
+                    A_off_proc->block_vals.resize(
+                            A_off_proc->block_vals.size() + 1);
                 }
                 val = off_proc->vals[k];
                 pos = off_proc_pos[block_col];
@@ -990,9 +1044,9 @@ void ParMatrix::init_tap_communicators(RAPtor_MPI_Comm mpi_comm)
 
     // Initialize Variables
     std::vector<int> off_proc_col_to_proc;
-    std::vector<int> on_node_column_map;
+    std::vector<index_t> on_node_column_map;
     std::vector<int> on_node_col_to_proc;
-    std::vector<int> off_node_column_map;
+    std::vector<index_t> off_node_column_map;
     std::vector<int> off_node_col_to_proc;
     std::vector<int> on_node_to_off_proc;
     std::vector<int> off_node_to_off_proc;
@@ -1000,6 +1054,8 @@ void ParMatrix::init_tap_communicators(RAPtor_MPI_Comm mpi_comm)
     std::vector<int> orig_procs;
     std::vector<int> node_to_local_proc;
     std::vector<int> on_proc_to_new;
+    TAPComm::TAPSetupCols tap_cols;
+    TAPComm::TAPSetupCols tap_mat_cols;
     int on_proc_nc = on_proc_column_map.size();
     if (partition->local_num_cols)
     {
@@ -1040,18 +1096,19 @@ void ParMatrix::init_tap_communicators(RAPtor_MPI_Comm mpi_comm)
      * *******************************/
     // Gather all nodes with which any local process must communication
     tap_comm->form_local_R_par_comm(off_node_column_map, off_node_col_to_proc, 
-            orig_procs);
+            orig_procs, tap_cols);
 
     // Find global processes with which rank communications
-    tap_comm->form_global_par_comm(orig_procs);
+    tap_comm->form_global_par_comm(orig_procs, tap_cols);
 
     // Form local_S_par_comm: initial distribution of values among local
     // processes, before inter-node communication
-    tap_comm->form_local_S_par_comm(orig_procs);
+    tap_comm->form_local_S_par_comm(orig_procs, tap_cols, 
+            partition->first_local_col);
 
-    // Adjust send indices (currently global vector indices) to be index 
-    // of global vector value from previous recv
-    tap_comm->adjust_send_indices(partition->first_local_col);
+    // Form send indices from the global columns in tap_cols, as the 
+    // index of each global vector value in the previous recv
+    tap_comm->adjust_send_indices(partition->first_local_col, tap_cols);
 
 
     tap_comm->update_recv(on_node_to_off_proc, off_node_to_off_proc);
@@ -1074,16 +1131,17 @@ void ParMatrix::init_tap_communicators(RAPtor_MPI_Comm mpi_comm)
     // corresponding to global rank on which data originates.  E.g. if
     // data is on rank r = (p, n), and my rank is s = (q, m), I will
     // recv data from (p, m).
-    tap_mat_comm->form_simple_R_par_comm(off_node_column_map, off_node_col_to_proc);
+    tap_mat_comm->form_simple_R_par_comm(off_node_column_map, off_node_col_to_proc,
+            tap_mat_cols);
 
     // Form global par comm.. Will recv from proc on which data
     // originates
-    tap_mat_comm->form_simple_global_comm(off_node_col_to_proc);
+    tap_mat_comm->form_simple_global_comm(off_node_col_to_proc, tap_mat_cols);
 
-    // Adjust send indices (currently global vector indices) to be
-    // index of global vector value from previous recv (only updating
-    // local_R to match position in global)
-    tap_mat_comm->adjust_send_indices(partition->first_local_col);
+    // Form send indices from the global columns in tap_mat_cols, as the
+    // index of each global vector value in the previous recv (only 
+    // updating local_R to match position in global)
+    tap_mat_comm->adjust_send_indices(partition->first_local_col, tap_mat_cols);
 
     tap_mat_comm->update_recv(on_node_to_off_proc, off_node_to_off_proc, false);
 
@@ -12,6 +12,7 @@
 #include "comm_pkg.hpp"
 #include "mpi_types.hpp"
 #include "partition.hpp"
+#include "int_map.hpp"
 
 // Making Par Matrix an abstract Class
 /**************************************************************
@@ -39,9 +40,9 @@
  *****    Matrix storing local diagonal block
  ***** offd : Matrix*
  *****    Matrix storing local off-diagonal block
- ***** offd_num_cols : index_t
+ ***** offd_num_cols : int
  *****    Number of columns in the off-diagonal matrix
- ***** offd_column_map : std::vector<int>
+ ***** offd_column_map : std::vector<index_t>
  *****    Maps local columns of offd Matrix to global
  ***** comm : ParComm*
  *****    Parallel communicator for matrix
@@ -208,7 +209,7 @@ namespace raptor
     ***** value : data_t
     *****    Value to be added to parallel matrix
     **************************************************************/
-    void add_value(index_t row, index_t global_col, data_t value);
+    void add_value(int row, index_t global_col, data_t value);
 
     /**************************************************************
     *****   ParMatrix Add Global Value
@@ -226,7 +227,7 @@ namespace raptor
     ***** value : data_t
     *****    Value to be added to parallel matrix
     **************************************************************/
-    void add_global_value(int row, int global_col, double value);
+    void add_global_value(index_t row, index_t global_col, data_t value);
 
     /**************************************************************
     *****   ParMatrix Finalize
@@ -248,6 +249,11 @@ namespace raptor
     void tap_mult_append(ParVector& x, ParVector& b);
     void mult_T(ParVector& x, ParVector& b, bool tap = false);
     void tap_mult_T(ParVector& x, ParVector& b);
+    void residual(ParMultiVector& x, ParMultiVector& b, ParMultiVector& r, 
+            bool tap = false);
+    void mult(ParMultiVector& x, ParMultiVector& b, bool tap = false);
+    void mult_append(ParMultiVector& x, ParMultiVector& b, bool tap = false);
+    void mult_T(ParMultiVector& x, ParMultiVector& b, bool tap = false);
     ParMatrix* mult(ParCSRMatrix* B, bool tap = false);
     ParMatrix* tap_mult(ParCSRMatrix* B);
     ParMatrix* mult_T(ParCSCMatrix* B, bool tap = false);
@@ -283,17 +289,17 @@ namespace raptor
 
     virtual ParMatrix* transpose() = 0;
 
-    std::vector<int>& get_off_proc_column_map()
+    std::vector<index_t>& get_off_proc_column_map()
     {
         return off_proc_column_map;
     }
 
-    std::vector<int>& get_on_proc_column_map()
+    std::vector<index_t>& get_on_proc_column_map()
     {
         return on_proc_column_map;
     }
 
-    std::vector<int>& get_local_row_map()
+    std::vector<index_t>& get_local_row_map()
     {
         return local_row_map;
     }
@@ -313,8 +319,8 @@ namespace raptor
     // Store dimensions of parallel matrix
     int local_nnz;
     int local_num_rows;
-    int global_num_rows;
-    int global_num_cols;
+    index_t global_num_rows;
+    index_t global_num_cols;
     int off_proc_num_cols;
     int on_proc_num_cols;
 
@@ -329,9 +335,9 @@ namespace raptor
     // It will be condensed to only store columns with 
     // nonzeros, and these must be mapped to 
     // global column indices
-    std::vector<int> off_proc_column_map; // Maps off_proc local to global
-    std::vector<int> on_proc_column_map; // Maps on_proc local to global
-    std::vector<int> local_row_map; // Maps local rows to global
+    std::vector<index_t> off_proc_column_map; // Maps off_proc local to global
+    std::vector<index_t> on_proc_column_map; // Maps on_proc local to global
+    std::vector<index_t> local_row_map; // Maps local rows to global
 
     // Parallel communication package indicating which 
     // processes hold vector values associated with off_proc,
@@ -586,12 +592,15 @@ namespace raptor
     void tap_mult(ParVector& x, ParVector& b);
     void mult_T(ParVector& x, ParVector& b, bool tap = false);
     void tap_mult_T(ParVector& x, ParVector& b);
+    void mult(ParMultiVector& x, ParMultiVector& b, bool tap = false);
+    void mult_T(ParMultiVector& x, ParMultiVector& b, bool tap = false);
     ParCSRMatrix* mult(ParCSRMatrix* B, bool tap = false);
     ParCSRMatrix* tap_mult(ParCSRMatrix* B);
     ParCSRMatrix* mult_T(ParCSCMatrix* A, bool tap = false);
     ParCSRMatrix* mult_T(ParCSRMatrix* A, bool tap = false);
     ParCSRMatrix* tap_mult_T(ParCSCMatrix* A);
     ParCSRMatrix* tap_mult_T(ParCSRMatrix* A);
+    ParCSRMatrix* rap(ParCSRMatrix* P, bool tap = false);
     ParCSRMatrix* add(ParCSRMatrix* A);
     ParCSRMatrix* subtract(ParCSRMatrix* B);
 
@@ -608,6 +617,13 @@ namespace raptor
             CSRMatrix* C_on_on, CSRMatrix* C_off_on);
     
     ParCSRMatrix* transpose();
+
+    void split_rows();
+
+    // Local rows without (interior) and with (boundary) off_proc 
+    // entries, formed by split_rows()
+    std::vector<int> interior_rows;
+    std::vector<int> boundary_rows;
   };
 
  class ParBSRMatrix : public ParCSRMatrix
@@ -847,6 +863,119 @@ class ParBSCMatrix : public ParCSCMatrix
 
   };
 
+  /**************************************************************
+   *****   ParSpGEMMPlan Class
+   **************************************************************
+   ***** Product of parallel CSR matrices, split into a symbolic
+   ***** phase and a numeric phase.  The symbolic phase forms the
+   ***** exact pattern of the product, its column maps, and the
+   ***** communication of values.  The numeric phase recomputes
+   ***** the values of the product in place.  A plan remains valid
+   ***** while the patterns of both factors are unchanged, so
+   ***** products repeated with new values (such as the Galerkin
+   ***** product during a resetup) skip all symbolic work,
+   ***** allocation, and communication of indices.
+   *****
+   ***** Columns of the product are indexed [0, n_on) for on_proc
+   ***** columns, and n_on + j for off_proc column j.  Entries of
+   ***** the product are kept even if their values are zero.
+   *****
+   ***** Attributes
+   ***** -------------
+   ***** transpose : bool
+   *****    True if the plan forms P^T*A rather than A*B
+   ***** n_on : int
+   *****    Number of on_proc columns of the product
+   ***** val_comm : ParComm*
+   *****    Communicates the values of rows of B (A*B), or of
+   *****    P_off^T*A (P^T*A)
+   *****
+   ***** Methods
+   ***** -------
+   ***** symbolic(A, B)
+   *****    Forms the plan for A*B, returning the product with
+   *****    all values zero
+   ***** symbolic_T(A, P)
+   *****    Forms the plan for P^T*A, returning the product with
+   *****    all values zero
+   ***** numeric(A, B, C)
+   *****    Overwrites the values of C with A*B (or B^T*A), where
+   *****    A and B have the patterns given to the symbolic phase.
+   *****    C must hold the pattern returned by the symbolic phase,
+   *****    in any order within each row.
+   **************************************************************/
+  class ParSpGEMMPlan
+  {
+  public:
+    ParSpGEMMPlan()
+    {
+        transpose = false;
+        n_on = 0;
+        n_inner_on = 0;
+        val_comm = NULL;
+    }
+
+    ~ParSpGEMMPlan()
+    {
+        delete val_comm;
+    }
+
+    ParCSRMatrix* symbolic(ParCSRMatrix* A, ParCSRMatrix* B);
+    ParCSRMatrix* symbolic_T(ParCSRMatrix* A, ParCSRMatrix* P);
+    void numeric(ParCSRMatrix* A, ParCSRMatrix* B, ParCSRMatrix* C);
+
+    bool transpose;
+    int n_on;
+    ParComm* val_comm;
+
+  private:
+    void numeric_T(ParCSRMatrix* A, ParCSRMatrix* P, ParCSRMatrix* C);
+    void form_pattern(ParCSRMatrix* A, ParCSRMatrix* C);
+    void add_row_cols(ParCSRMatrix* A, int row, int mark,
+            std::vector<int>& cols);
+    void scatter_row(ParCSRMatrix* C, int row);
+
+    // Columns of A (in P^T*A) are indexed [0, n_inner_on) for
+    // on_proc columns, and n_inner_on + j for off_proc column j
+    int n_inner_on;
+
+    // Marks columns during the symbolic phase, and holds the position
+    // of each column within the current row during the numeric phase
+    std::vector<int> pos;
+
+    // A*B : local rows of B (on_proc, then off_proc entries of each
+    // row) and rows of B received for each off_proc column of A, with
+    // columns of the product
+    std::vector<int> B_ptr;
+    std::vector<int> B_cols;
+    std::vector<double> B_vals;
+
+    // P^T*A : transposed patterns of P->on_proc and P->off_proc, with
+    // positions of each entry in the values of P
+    std::vector<int> PT_on_ptr;
+    std::vector<int> PT_on_rows;
+    std::vector<int> PT_on_pos;
+    std::vector<int> PT_off_ptr;
+    std::vector<int> PT_off_rows;
+    std::vector<int> PT_off_pos;
+
+    // P^T*A : rows of P_off^T*A sent to the owner of each off_proc
+    // column of P, with columns of A, and the product column of each
+    // off_proc column of A (-1 if unused)
+    std::vector<int> send_ptr;
+    std::vector<int> send_cols;
+    std::vector<double> send_vals;
+    std::vector<int> A_off_to_C;
+
+    // Received entries, with columns of the product.  For A*B, these
+    // are rows of B for each off_proc column of A.  For P^T*A, they
+    // are grouped by local row of the product, with the position of
+    // each in the received values.
+    std::vector<int> recv_ptr;
+    std::vector<int> recv_idx;
+    std::vector<int> recv_cols;
+  };
+
 
 }
 #endif
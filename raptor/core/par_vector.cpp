@@ -82,10 +82,10 @@ void ParVector::set_rand_values()
 *****
 ***** Parameters
 ***** -------------
-***** p : index_t
+***** p : int
 *****    Determines which p-norm to calculate
 **************************************************************/
-data_t ParVector::norm(index_t p)
+data_t ParVector::norm(int p)
 {
     data_t result = 0.0;
     if (local_n)
@@ -121,3 +121,127 @@ data_t ParVector::inner_product(ParVector& x)
 }
 
 
+
+
+
+/**************************************************************
+*****   ParMultiVector Methods
+**************************************************************
+***** Each operation acts on the interleaved local storage, so 
+***** a single pass (and a single reduction) covers every vector
+***** in the block
+**************************************************************/
+void ParMultiVector::set_const_value(data_t alpha)
+{
+    if (local_n)
+    {
+        local.set_const_value(alpha);
+    }
+}
+
+void ParMultiVector::set_rand_values()
+{
+    if (local_n)
+    {
+        local.set_rand_values();
+    }
+}
+
+void ParMultiVector::axpy(ParMultiVector& y, data_t alpha)
+{
+    if (local_n)
+    {
+        local.axpy(y.local, alpha);
+    }
+}
+
+void ParMultiVector::axpy(ParMultiVector& y, const std::vector<data_t>& alphas)
+{
+    for (int i = 0; i < local_n; i++)
+    {
+        int first = i * n_vecs;
+        for (int v = 0; v < n_vecs; v++)
+        {
+            local.values[first + v] += alphas[v] * y.local.values[first + v];
+        }
+    }
+}
+
+void ParMultiVector::scale(data_t alpha)
+{
+    if (local_n)
+    {
+        local.scale(alpha);
+    }
+}
+
+void ParMultiVector::scale(const std::vector<data_t>& alphas)
+{
+    for (int i = 0; i < local_n; i++)
+    {
+        int first = i * n_vecs;
+        for (int v = 0; v < n_vecs; v++)
+        {
+            local.values[first + v] *= alphas[v];
+        }
+    }
+}
+
+void ParMultiVector::norm(int p, std::vector<data_t>& norms)
+{
+    norms.resize(n_vecs);
+    std::fill(norms.begin(), norms.end(), 0.0);
+    for (int i = 0; i < local_n; i++)
+    {
+        int first = i * n_vecs;
+        for (int v = 0; v < n_vecs; v++)
+        {
+            norms[v] += pow(fabs(local.values[first + v]), p);
+        }
+    }
+    RAPtor_MPI_Allreduce(RAPtor_MPI_IN_PLACE, norms.data(), n_vecs, RAPtor_MPI_DATA_T, 
+            RAPtor_MPI_SUM, RAPtor_MPI_COMM_WORLD);
+    for (int v = 0; v < n_vecs; v++)
+    {
+        norms[v] = pow(norms[v], 1./p);
+    }
+}
+
+void ParMultiVector::inner_product(ParMultiVector& x, std::vector<data_t>& inner_prods)
+{
+    if (local_n != x.local_n || n_vecs != x.n_vecs)
+    {
+        printf("Error.  Cannot perform inner product.  Dimensions do not match.\n");
+        exit(-1);
+    }
+
+    inner_prods.resize(n_vecs);
+    std::fill(inner_prods.begin(), inner_prods.end(), 0.0);
+    for (int i = 0; i < local_n; i++)
+    {
+        int first = i * n_vecs;
+        for (int v = 0; v < n_vecs; v++)
+        {
+            inner_prods[v] += local.values[first + v] * x.local.values[first + v];
+        }
+    }
+    RAPtor_MPI_Allreduce(RAPtor_MPI_IN_PLACE, inner_prods.data(), n_vecs, 
+            RAPtor_MPI_DATA_T, RAPtor_MPI_SUM, RAPtor_MPI_COMM_WORLD);
+}
+
+void ParMultiVector::get_vector(int v, ParVector& x)
+{
+    x.resize(global_n, local_n);
+    for (int i = 0; i < local_n; i++)
+    {
+        x.local.values[i] = local.values[i * n_vecs + v];
+    }
+}
+
+void ParMultiVector::set_vector(int v, ParVector& x)
+{
+    for (int i = 0; i < local_n; i++)
+    {
+        local.values[i * n_vecs + v] = x.local.values[i];
+    }
+}
@@ -23,7 +23,7 @@
  *****    Local portion of the parallel vector
  ***** global_n : index_t
  *****    Number of entries in the global vector
- ***** local_n : index_t
+ ***** local_n : int
  *****    Dimension of the local portion of the vector
  ***** 
  ***** Methods
@@ -36,7 +36,7 @@
  *****    Performs axpy on local portion of vector
  ***** scale(data_t alpha)
  *****    Multiplies entries of the local vector by a constant
- ***** norm(index_t p)
+ ***** norm(int p)
  *****    Calculates the p-norm of the global vector
  **************************************************************/
 namespace raptor
@@ -54,7 +54,7 @@ namespace raptor
         ***** -------------
         ***** glbl_n : index_t
         *****    Number of entries in global vector
-        ***** lcl_n : index_t
+        ***** lcl_n : int
         *****    Number of entries of global vector stored locally
         **************************************************************/
         ParVector(index_t glbl_n, int lcl_n)
@@ -153,10 +153,10 @@ namespace raptor
         *****
         ***** Parameters
         ***** -------------
-        ***** p : index_t
+        ***** p : int
         *****    Determines which p-norm to calculate
         **************************************************************/
-        data_t norm(index_t p);
+        data_t norm(int p);
 
         data_t inner_product(ParVector& x);        
 
@@ -171,9 +171,159 @@ namespace raptor
         }
 
         Vector local;
-        int global_n;
+        index_t global_n;
         int local_n;
     };
 
+
+    /**************************************************************
+     *****   ParMultiVector Class
+     **************************************************************
+     ***** This class constructs a block of n_vecs parallel vectors
+     ***** sharing one row partition, stored row-major so that the
+     ***** n_vecs values of each row are contiguous
+     *****
+     ***** Attributes
+     ***** -------------
+     ***** local : Vector
+     *****    Local rows, with entry (i, v) stored at local[i*n_vecs + v]
+     ***** global_n : index_t
+     *****    Number of rows in each global vector
+     ***** local_n : int
+     *****    Number of rows stored locally
+     ***** n_vecs : int
+     *****    Number of vectors in the block
+     ***** 
+     ***** Methods
+     ***** -------
+     ***** axpy(ParMultiVector& y, data_t alpha)
+     *****    Performs axpy on every vector in the block
+     ***** norm(int p, std::vector<data_t>& norms)
+     *****    Calculates the p-norm of each vector with one reduction
+     ***** inner_product(ParMultiVector& x, std::vector<data_t>& inner_prods)
+     *****    Calculates all inner products with one reduction
+     **************************************************************/
+    class ParMultiVector
+    {
+    public:
+        /**************************************************************
+        *****   ParMultiVector Class Constructor
+        **************************************************************
+        ***** Sets the dimensions of the block and initializes local
+        ***** storage for _n_vecs vectors
+        *****
+        ***** Parameters
+        ***** -------------
+        ***** glbl_n : index_t
+        *****    Number of rows in each global vector
+        ***** lcl_n : int
+        *****    Number of rows stored locally
+        ***** _n_vecs : int
+        *****    Number of vectors in the block
+        **************************************************************/
+        ParMultiVector(index_t glbl_n, int lcl_n, int _n_vecs)
+        {
+            resize(glbl_n, lcl_n, _n_vecs);
+        }
+
+        ParMultiVector(const ParMultiVector& x)
+        {
+            copy(x);
+        }
+
+        ParMultiVector()
+        {
+            global_n = 0;
+            local_n = 0;
+            n_vecs = 0;
+        }
+
+        ~ParMultiVector()
+        {
+        }
+
+        void resize(index_t glbl_n, int lcl_n, int _n_vecs)
+        {
+            global_n = glbl_n;
+            local_n = lcl_n;
+            n_vecs = _n_vecs;
+            local.resize(local_n * n_vecs);
+        }
+
+        void copy(const ParMultiVector& x)
+        {
+            global_n = x.global_n;
+            local_n = x.local_n;
+            n_vecs = x.n_vecs;
+            local.copy(x.local);
+        }
+
+        void set_const_value(data_t alpha);
+        void set_rand_values();
+
+        /**************************************************************
+        *****   ParMultiVector AXPY
+        **************************************************************
+        ***** Adds alpha * y to each vector in the block.  The second
+        ***** version uses a separate alpha for each vector.
+        **************************************************************/
+        void axpy(ParMultiVector& y, data_t alpha);
+        void axpy(ParMultiVector& y, const std::vector<data_t>& alphas);
+
+        /**************************************************************
+        *****   ParMultiVector Scale
+        **************************************************************
+        ***** Multiplies each vector by alpha (or by alphas[v])
+        **************************************************************/
+        void scale(data_t alpha);
+        void scale(const std::vector<data_t>& alphas);
+
+        /**************************************************************
+        *****   ParMultiVector Norm
+        **************************************************************
+        ***** Calculates the p-norm of each vector in the block, 
+        ***** reducing all n_vecs norms in a single collective
+        *****
+        ***** Parameters
+        ***** -------------
+        ***** p : int
+        *****    Determines which p-norm to calculate
+        ***** norms : std::vector<data_t>&
+        *****    Returns the norm of each vector
+        **************************************************************/
+        void norm(int p, std::vector<data_t>& norms);
+
+        /**************************************************************
+        *****   ParMultiVector Inner Product
+        **************************************************************
+        ***** Calculates the inner product of each vector with the
+        ***** corresponding vector of x, in a single collective
+        **************************************************************/
+        void inner_product(ParMultiVector& x, std::vector<data_t>& inner_prods);
+
+        /**************************************************************
+        *****   ParMultiVector Get/Set Vector
+        **************************************************************
+        ***** Copies vector v of the block into (or out of) a ParVector
+        **************************************************************/
+        void get_vector(int v, ParVector& x);
+        void set_vector(int v, ParVector& x);
+
+        const data_t& operator()(const int row, const int vec) const
+        {
+            return local.values[row * n_vecs + vec];
+        }
+
+        data_t& operator()(const int row, const int vec)
+        {
+            return local.values[row * n_vecs + vec];
+        }
+
+        Vector local;
+        index_t global_n;
+        int local_n;
+        int n_vecs;
+    };
+
 }
 #endif
@@ -40,8 +40,8 @@ namespace raptor
             Topology* _topology = NULL)
     {
         int rank, num_procs;
-        int avg_num;
-        int extra;
+        index_t avg_num;
+        index_t extra;
 
         RAPtor_MPI_Comm_rank(RAPtor_MPI_COMM_WORLD, &rank);
         RAPtor_MPI_Comm_size(RAPtor_MPI_COMM_WORLD, &num_procs);
@@ -113,8 +113,8 @@ namespace raptor
             index_t _brows, index_t _bcols, Topology* _topology = NULL)
     {
         int rank, num_procs;
-        int avg_num_blocks, global_num_row_blocks, global_num_col_blocks;
-        int extra;
+        index_t avg_num_blocks, global_num_row_blocks, global_num_col_blocks;
+        index_t extra;
 
         RAPtor_MPI_Comm_rank(RAPtor_MPI_COMM_WORLD, &rank);
         RAPtor_MPI_Comm_size(RAPtor_MPI_COMM_WORLD, &num_procs);
@@ -292,22 +292,23 @@ namespace raptor
         if (global_num_cols % num_procs) assumed_num_cols++;
 
         first_cols.resize(num_procs+1);
-        RAPtor_MPI_Allgather(&(first_local_col), 1, RAPtor_MPI_INT, first_cols.data(), 1, RAPtor_MPI_INT,
-                        RAPtor_MPI_COMM_WORLD);
+        RAPtor_MPI_Allgather(&(first_local_col), 1, RAPtor_MPI_INDEX_T, first_cols.data(), 1, 
+                RAPtor_MPI_INDEX_T, RAPtor_MPI_COMM_WORLD);
         first_cols[num_procs] = global_num_cols;
     }
 
-    void form_col_to_proc (const std::vector<int>& off_proc_column_map,
+    void form_col_to_proc (const std::vector<index_t>& off_proc_column_map,
             std::vector<int>& off_proc_col_to_proc) 
     {
         int rank, num_procs;
         RAPtor_MPI_Comm_rank(RAPtor_MPI_COMM_WORLD, &rank);
         RAPtor_MPI_Comm_size(RAPtor_MPI_COMM_WORLD, &num_procs);
 
-        int global_col, assumed_proc;
+        index_t global_col;
+        int assumed_proc;
         int ctr = 0;
         off_proc_col_to_proc.resize(off_proc_column_map.size());
-        for (std::vector<int>::const_iterator it = off_proc_column_map.begin();
+        for (std::vector<index_t>::const_iterator it = off_proc_column_map.begin();
                         it != off_proc_column_map.end(); ++it)
         {
             global_col = *it;
@@ -334,8 +335,8 @@ namespace raptor
     index_t last_local_row;
     index_t last_local_col;
 
-    int assumed_num_cols;
-    std::vector<int> first_cols;
+    index_t assumed_num_cols;
+    std::vector<index_t> first_cols;
 
     Topology* topology;
 
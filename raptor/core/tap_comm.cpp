@@ -17,36 +17,36 @@ using namespace raptor;
 *****
 ***** Parameters
 ***** -------------
-***** off_proc_column_map : std::vector<int>&
+***** off_proc_column_map : std::vector<index_t>&
 *****    Vector holding rank's off_proc_columns
 ***** off_proc_col_to_proc : std::vector<int>&
 *****    Vector mapping rank's off_proc_columns to distant procs
-***** on_node_column_map : std::vector<int>&
+***** on_node_column_map : std::vector<index_t>&
 *****    Will be returned holding on_node columns
 ***** on_node_col_to_proc : std::vector<int>&
 *****    Will be returned holding procs corresponding to on_node cols
 ***** on_node_to_off_proc : std::vector<int>&
 *****    Will be returned holding map from on_node to off_proc
-***** off_node_column_map : std::vector<int>&
+***** off_node_column_map : std::vector<index_t>&
 *****    Will be returned holding off_node columns
 ***** off_node_col_to_node : std::vector<int>&
 *****    Will be returned holding procs corresponding to off_node cols
 ***** off_node_to_off_proc : std::vector<int>&
 *****    Will be returned holding map from off_node to off_proc
 **************************************************************/
-void TAPComm::split_off_proc_cols(const std::vector<int>& off_proc_column_map,
+void TAPComm::split_off_proc_cols(const std::vector<index_t>& off_proc_column_map,
         const std::vector<int>& off_proc_col_to_proc,
-        std::vector<int>& on_node_column_map,
+        std::vector<index_t>& on_node_column_map,
         std::vector<int>& on_node_col_to_proc,
         std::vector<int>& on_node_to_off_proc,
-        std::vector<int>& off_node_column_map,
+        std::vector<index_t>& off_node_column_map,
         std::vector<int>& off_node_col_to_proc,
         std::vector<int>& off_node_to_off_proc)
 {
     int rank, rank_node, num_procs;
     int proc;
     int node;
-    int global_col;
+    index_t global_col;
     int off_proc_num_cols = off_proc_column_map.size();
 
     RAPtor_MPI_Comm_rank(RAPtor_MPI_COMM_WORLD, &rank);
@@ -93,10 +93,13 @@ void TAPComm::split_off_proc_cols(const std::vector<int>& off_proc_column_map,
 ***** recv_nodes : std::vector<int>&
 *****    Returned holding all nodes with which any local
 *****    process communicates (union of off_node_col_to_node)
+***** setup_cols : TAPSetupCols&
+*****    Returned with the global columns local_R_par_comm sends
+*****    in setup_cols.R_send
 **************************************************************/
-void TAPComm::form_local_R_par_comm(const std::vector<int>& off_node_column_map,
+void TAPComm::form_local_R_par_comm(const std::vector<index_t>& off_node_column_map,
         const std::vector<int>& off_node_col_to_proc,
-        std::vector<int>& orig_procs)
+        std::vector<int>& orig_procs, TAPSetupCols& setup_cols)
 {
     int local_rank;
     RAPtor_MPI_Comm_rank(topology->local_comm, &local_rank);
@@ -129,7 +132,8 @@ void TAPComm::form_local_R_par_comm(const std::vector<int>& off_node_column_map,
     std::vector<int> local_send_procs(topology->PPN);
     std::vector<int> proc_idx;
     std::vector<int> off_node_col_to_lcl_proc;
-    std::vector<int> send_buffer;
+    std::vector<index_t> send_buffer;
+    std::vector<index_t> recv_buffer;
     std::vector<int> recv_nodes;
 
     RAPtor_MPI_Status recv_status;
@@ -301,28 +305,33 @@ void TAPComm::form_local_R_par_comm(const std::vector<int>& off_node_column_map,
             send_buffer[ctr++] = off_node_col_to_proc[idx];
         }
         RAPtor_MPI_Isend(&(send_buffer[start_ctr]), 2*(recv_end - recv_start),
-                RAPtor_MPI_INT, recv_proc, 6543, topology->local_comm, 
+                RAPtor_MPI_INDEX_T, recv_proc, 6543, topology->local_comm, 
                 &(local_R_recv->requests[i]));
         start_ctr = ctr;
     }
 
-    // Recv messages from local processes and add to send_data
+    // Recv messages from local processes and add to send_data (global
+    // columns are held in setup_cols.R_send)
     ctr = 0;
     for (int i = 0; i < local_num_sends; i++)
     {
         RAPtor_MPI_Probe(RAPtor_MPI_ANY_SOURCE, 6543, topology->local_comm, &recv_status);
-        RAPtor_MPI_Get_count(&recv_status, RAPtor_MPI_INT, &count);
+        RAPtor_MPI_Get_count(&recv_status, RAPtor_MPI_INDEX_T, &count);
         proc = recv_status.RAPtor_MPI_SOURCE;
-        int recvbuf[count];
-        RAPtor_MPI_Recv(recvbuf, count, RAPtor_MPI_INT, proc, 6543, topology->local_comm,
-                &recv_status);
-        local_R_par_comm->send_data->add_msg(proc, count / 2, recvbuf);
+        if ((int) recv_buffer.size() < count) recv_buffer.resize(count);
+        RAPtor_MPI_Recv(recv_buffer.data(), count, RAPtor_MPI_INDEX_T, proc, 6543, 
+                topology->local_comm, &recv_status);
+        local_R_par_comm->send_data->add_msg(proc, count / 2);
         start_ctr = count / 2;
+        for (int j = 0; j < start_ctr; j++)
+        {
+            setup_cols.R_send.emplace_back(recv_buffer[j]);
+        }
         // Add orig nodes for each recvd col (need to know this for
         // global communication setup)
         for (int j = start_ctr; j < count; j++)
         {
-            orig_procs.emplace_back(recvbuf[j]);
+            orig_procs.emplace_back(recv_buffer[j]);
         }
     }
     local_R_par_comm->send_data->finalize();
@@ -351,14 +360,15 @@ void TAPComm::form_local_R_par_comm(const std::vector<int>& off_node_column_map,
 *****    Returns with all off_node processes to which rank sends
 ***** recv_procs : std::vector<int>&
 *****    Returns with all off_node process from which rank recvs
+***** setup_cols : TAPSetupCols&
+*****    Holds the global columns sent by local_R_par_comm, and
+*****    is returned with those recvd and sent by global_par_comm
 **************************************************************/
-void TAPComm::form_global_par_comm(std::vector<int>& orig_procs)
+void TAPComm::form_global_par_comm(std::vector<int>& orig_procs,
+        TAPSetupCols& setup_cols)
 {
-    int rank, num_procs;
     int local_rank;
-    RAPtor_MPI_Comm_rank(RAPtor_MPI_COMM_WORLD, &rank);
     RAPtor_MPI_Comm_rank(topology->local_comm, &local_rank);
-    RAPtor_MPI_Comm_size(RAPtor_MPI_COMM_WORLD, &num_procs);
 
     int n_sends;
     int proc, node;
@@ -381,7 +391,10 @@ void TAPComm::form_global_par_comm(std::vector<int>& orig_procs)
     std::vector<int> send_proc_sizes;
     std::vector<int> node_to_idx(topology->num_nodes, 0);
     std::vector<int> node_recv_idx_orig_procs;
-    std::vector<int> send_buffer;
+    std::vector<index_t> send_buffer;
+    std::vector<index_t> recv_buffer;
+    std::vector<index_t>& recv_cols = setup_cols.global_recv;
+    std::vector<index_t>& send_cols = setup_cols.global_send;
 
     NonContigData* global_recv = (NonContigData*) global_par_comm->recv_data;
 
@@ -414,15 +427,15 @@ void TAPComm::form_global_par_comm(std::vector<int>& orig_procs)
     global_recv->num_msgs = global_recv->procs.size();
     global_recv->size_msgs = recv_s;
 
-    // Form recv indices, placing global column in correct position
-    global_recv->indices.resize(recv_s);
+    // Form recv columns, placing global column in correct position
+    recv_cols.resize(recv_s);
     for (int i = 0; i < local_R_par_comm->send_data->size_msgs; i++)
     {
         proc = orig_procs[i];
         node = topology->get_node(proc);
         node_idx = node_to_idx[node];
         idx = global_recv->indptr[node_idx] + node_sizes[node]++;
-        global_recv->indices[idx] = local_R_par_comm->send_data->indices[i];
+        recv_cols[idx] = setup_cols.R_send[i];
         node_recv_idx_orig_procs[idx] = proc;
     }
 
@@ -444,8 +457,7 @@ void TAPComm::form_global_par_comm(std::vector<int>& orig_procs)
             std::sort(p.begin(), p.end(),
                     [&] (int j, int k)
                     {
-                        return global_recv->indices[j+start] 
-                               < global_recv->indices[k+start];
+                        return recv_cols[j+start] < recv_cols[k+start];
                     });
 
             // Sort node_recv_indices and node_recv_idx_orig_procs together
@@ -459,8 +471,7 @@ void TAPComm::form_global_par_comm(std::vector<int>& orig_procs)
                 int k = p[j];
                 while (j != k)
                 {
-                    std::swap(global_recv->indices[prev_k+start],
-                            global_recv->indices[k+start]);
+                    std::swap(recv_cols[prev_k+start], recv_cols[k+start]);
                     std::swap(node_recv_idx_orig_procs[prev_k+start], 
                             node_recv_idx_orig_procs[k+start]);
                     done[k] = true;
@@ -472,55 +483,38 @@ void TAPComm::form_global_par_comm(std::vector<int>& orig_procs)
 
         // Add msg to global_par_comm->recv_data
         node_recv_idx_orig_procs[ctr] = node_recv_idx_orig_procs[start];
-        global_recv->indices[ctr++] 
-                = global_recv->indices[start];
+        recv_cols[ctr++] = recv_cols[start];
         for (int j = start+1; j < end; j++)
         {
-            if (global_recv->indices[j] != global_recv->indices[j-1])
+            if (recv_cols[j] != recv_cols[j-1])
             {
                 node_recv_idx_orig_procs[ctr] = node_recv_idx_orig_procs[j];
-                global_recv->indices[ctr++] = global_recv->indices[j];
+                recv_cols[ctr++] = recv_cols[j];
             }
         }
         global_recv->indptr[i + 1] = ctr;
         start = end;
     }
-    global_recv->indices.resize(ctr);
+    recv_cols.resize(ctr);
     global_recv->size_msgs = ctr;
     global_recv->finalize();
 
-    std::vector<int> send_p(num_procs, 0);
-    for (int i = 0; i < global_recv->num_msgs; i++)
-    {
-        node = global_recv->procs[i];
-        proc = topology->get_global_proc(node, local_rank);
-        send_p[proc] = 1;
-    }
-    RAPtor_MPI_Allreduce(RAPtor_MPI_IN_PLACE, send_p.data(), num_procs, RAPtor_MPI_INT,
-            RAPtor_MPI_SUM, RAPtor_MPI_COMM_WORLD);
-    int recv_n = send_p[rank];
-    sendbuf.resize(recv_n);
-    sendbuf_sizes.resize(recv_n);
-    // Send recv sizes to corresponding local procs on appropriate nodes
-    ctr = 0;
+    // Send recv sizes to corresponding local procs on appropriate nodes,
+    // which find the procs they send to from these messages (NBX).
+    // Nodes may hold fewer processes than this node.
     for (int i = 0; i < global_recv->num_msgs; i++)
     {
         node = global_recv->procs[i];
-        proc = topology->get_global_proc(node, local_rank);
-        RAPtor_MPI_Isend(&(node_sizes[node]), 1, RAPtor_MPI_INT, proc, 9876, RAPtor_MPI_COMM_WORLD,
+        proc = topology->get_global_proc(node,
+                local_rank % topology->get_node_size(node));
+        RAPtor_MPI_Issend(&(node_sizes[node]), 1, RAPtor_MPI_INT, proc, 9876, RAPtor_MPI_COMM_WORLD,
                 &(global_recv->requests[i]));
     }
-    for (int i = 0; i < recv_n; i++)
-    {
-        RAPtor_MPI_Probe(RAPtor_MPI_ANY_SOURCE, 9876, RAPtor_MPI_COMM_WORLD, &recv_status);
-        proc = recv_status.RAPtor_MPI_SOURCE;
-        RAPtor_MPI_Recv(&recvbuf, 1, RAPtor_MPI_INT, proc, 9876, RAPtor_MPI_COMM_WORLD, 
-                &recv_status);
-        sendbuf[i] = proc;
-        sendbuf_sizes[i] = recvbuf;
-    }
-    RAPtor_MPI_Waitall(global_recv->num_msgs, global_recv->requests.data(),
-            RAPtor_MPI_STATUSES_IGNORE);
+    NonContigData node_size_recv;
+    node_size_recv.nbx_probe(9876, RAPtor_MPI_COMM_WORLD, global_recv->num_msgs,
+            global_recv->requests.data());
+    sendbuf = node_size_recv.procs;
+    sendbuf_sizes = node_size_recv.indices;
 
     // Gather all procs to which node must send 
     n_sends = sendbuf.size();
@@ -601,7 +595,7 @@ void TAPComm::form_global_par_comm(std::vector<int>& orig_procs)
 
     for (int i = 0; i < global_recv->size_msgs; i++)
     {
-        send_buffer.emplace_back(global_recv->indices[i]);
+        send_buffer.emplace_back(recv_cols[i]);
         send_buffer.emplace_back(node_recv_idx_orig_procs[i]);
     }
 
@@ -616,30 +610,30 @@ void TAPComm::form_global_par_comm(std::vector<int>& orig_procs)
         start = global_recv->indptr[i];
         end = global_recv->indptr[i+1];
         RAPtor_MPI_Isend(&(send_buffer[2*start]), 2*(end - start),
-                RAPtor_MPI_INT, proc, 5432, RAPtor_MPI_COMM_WORLD,
+                RAPtor_MPI_INDEX_T, proc, 5432, RAPtor_MPI_COMM_WORLD,
                 &(global_recv->requests[i]));
         
     }
 
-    // Recv send data (which indices to send) to global processes
+    // Recv send data (which global columns to send) to global processes
     orig_procs.clear();
     for (int i = 0; i < global_par_comm->send_data->num_msgs; i++)
     {
         proc = global_par_comm->send_data->procs[i];
         RAPtor_MPI_Probe(proc, 5432, RAPtor_MPI_COMM_WORLD, &recv_status);
-        RAPtor_MPI_Get_count(&recv_status, RAPtor_MPI_INT, &count);
-        int commbuf[count];
-        RAPtor_MPI_Recv(commbuf, count, RAPtor_MPI_INT, proc, 5432, RAPtor_MPI_COMM_WORLD, &recv_status);
+        RAPtor_MPI_Get_count(&recv_status, RAPtor_MPI_INDEX_T, &count);
+        if ((int) recv_buffer.size() < count) recv_buffer.resize(count);
+        RAPtor_MPI_Recv(recv_buffer.data(), count, RAPtor_MPI_INDEX_T, proc, 5432, 
+                RAPtor_MPI_COMM_WORLD, &recv_status);
         for (int j = 0; j < count; j += 2)
         {
-           global_par_comm->send_data->indices.emplace_back(commbuf[j]);
-           orig_procs.emplace_back(topology->get_local_proc(commbuf[j+1]));
+           send_cols.emplace_back(recv_buffer[j]);
+           orig_procs.emplace_back(topology->get_local_proc(recv_buffer[j+1]));
         }
-        global_par_comm->send_data->indptr.emplace_back(
-                global_par_comm->send_data->indices.size()); 
+        global_par_comm->send_data->indptr.emplace_back(send_cols.size()); 
     }
     global_par_comm->send_data->num_msgs = global_par_comm->send_data->procs.size();
-    global_par_comm->send_data->size_msgs = global_par_comm->send_data->indices.size();
+    global_par_comm->send_data->size_msgs = send_cols.size();
     global_par_comm->send_data->finalize();
 
     if (global_recv->num_msgs)
@@ -660,8 +654,17 @@ void TAPComm::form_global_par_comm(std::vector<int>& orig_procs)
 *****
 ***** Parameters
 ***** -------------
+***** orig_procs : std::vector<int>&
+*****    Local process on which each column sent by 
+*****    global_par_comm originates
+***** setup_cols : TAPSetupCols&
+*****    Holds the global columns sent by global_par_comm, and is
+*****    returned with those recvd by local_S_par_comm
+***** first_local_col : index_t
+*****    First column local to rank
 **************************************************************/
-void TAPComm::form_local_S_par_comm(std::vector<int>& orig_procs)
+void TAPComm::form_local_S_par_comm(std::vector<int>& orig_procs,
+        TAPSetupCols& setup_cols, const index_t first_local_col)
 {
     int rank;
     int local_rank;
@@ -679,12 +682,14 @@ void TAPComm::form_local_S_par_comm(std::vector<int>& orig_procs)
     std::vector<int> proc_sizes(topology->PPN, 0);
     std::vector<int> recv_procs(topology->PPN, 0);
     std::vector<int> proc_to_idx(topology->PPN);
+    std::vector<index_t> recv_buffer;
+    std::vector<index_t>& recv_cols = setup_cols.S_recv;
 
     NonContigData* local_S_recv = (NonContigData*) local_S_par_comm->recv_data;
 
     if (global_par_comm->send_data->num_msgs)
     {
-        local_S_recv->indices.resize(global_par_comm->send_data->size_msgs);
+        recv_cols.resize(global_par_comm->send_data->size_msgs);
     }
 
     // Find all column indices originating on local procs
@@ -718,7 +723,7 @@ void TAPComm::form_local_S_par_comm(std::vector<int>& orig_procs)
         proc = orig_procs[i];
         proc_idx = proc_to_idx[proc];
         idx = local_S_recv->indptr[proc_idx] + proc_sizes[proc]++;
-        local_S_recv->indices[idx] = global_par_comm->send_data->indices[i];
+        recv_cols[idx] = setup_cols.global_send[i];
     }
 
     // Remove duplicate entries from local_S_par_comm recv_data (proc may have
@@ -732,24 +737,20 @@ void TAPComm::form_local_S_par_comm(std::vector<int>& orig_procs)
         size = end - start;
         if (size)
         {
-            std::sort(local_S_recv->indices.begin() + start, 
-                    local_S_recv->indices.begin() + end);
-            local_S_recv->indices[ctr++] = 
-                local_S_recv->indices[start];
+            std::sort(recv_cols.begin() + start, recv_cols.begin() + end);
+            recv_cols[ctr++] = recv_cols[start];
             for (int j = start+1; j < end; j++)
             {
-                if (local_S_recv->indices[j] 
-                        != local_S_recv->indices[j-1])
+                if (recv_cols[j] != recv_cols[j-1])
                 {
-                    local_S_recv->indices[ctr++] 
-                        = local_S_recv->indices[j];
+                    recv_cols[ctr++] = recv_cols[j];
                 }
             }
         }
         local_S_recv->indptr[i+1] = ctr;
         start = end;
     }
-    local_S_recv->indices.resize(ctr);
+    recv_cols.resize(ctr);
     local_S_recv->size_msgs = ctr;
     local_S_recv->finalize();
 
@@ -759,23 +760,26 @@ void TAPComm::form_local_S_par_comm(std::vector<int>& orig_procs)
         proc = local_S_recv->procs[i];
         start = local_S_recv->indptr[i];
         end = local_S_recv->indptr[i+1];
-        RAPtor_MPI_Isend(&(local_S_recv->indices[start]), 
-                end - start, RAPtor_MPI_INT, proc, 4321, topology->local_comm,
+        RAPtor_MPI_Isend(&(recv_cols[start]), 
+                end - start, RAPtor_MPI_INDEX_T, proc, 4321, topology->local_comm,
                 &(local_S_recv->requests[i]));
     }
-    // Recv messages and form local_S_par_comm send_data
+    // Recv messages and form local_S_par_comm send_data (recvd columns
+    // are local to rank)
     int count;
     RAPtor_MPI_Status recv_status;
     for (int i = 0; i < n_recvs; i++)
     {
         RAPtor_MPI_Probe(RAPtor_MPI_ANY_SOURCE, 4321, topology->local_comm, &recv_status);
-        RAPtor_MPI_Get_count(&recv_status, RAPtor_MPI_INT, &count);
+        RAPtor_MPI_Get_count(&recv_status, RAPtor_MPI_INDEX_T, &count);
         proc = recv_status.RAPtor_MPI_SOURCE;        
-        int recvbuf[count];
-        RAPtor_MPI_Recv(recvbuf, count, RAPtor_MPI_INT, proc, 4321, topology->local_comm, &recv_status);
+        if ((int) recv_buffer.size() < count) recv_buffer.resize(count);
+        RAPtor_MPI_Recv(recv_buffer.data(), count, RAPtor_MPI_INDEX_T, proc, 4321, 
+                topology->local_comm, &recv_status);
         for (int j = 0; j < count; j++)
         {
-            local_S_par_comm->send_data->indices.emplace_back(recvbuf[j]);
+            local_S_par_comm->send_data->indices.emplace_back(
+                    recv_buffer[j] - first_local_col);
         }
         local_S_par_comm->send_data->indptr.emplace_back(
                 local_S_par_comm->send_data->indices.size());
@@ -793,33 +797,48 @@ void TAPComm::form_local_S_par_comm(std::vector<int>& orig_procs)
 }
 
 
-void TAPComm::adjust_send_indices(const int first_local_col)
+/**************************************************************
+*****   Adjust Send Indices
+**************************************************************
+***** Forms the send indices of global_par_comm and local_R_par_comm
+***** (and the transpose indices of their recvs) from the global 
+***** columns exchanged during setup, as the position of each 
+***** global column in the previous recv
+*****
+***** Parameters
+***** -------------
+***** first_local_col : index_t
+*****    First column local to rank
+***** setup_cols : TAPSetupCols&
+*****    Global columns sent and recvd by each sub-communicator
+**************************************************************/
+void TAPComm::adjust_send_indices(const index_t first_local_col,
+        TAPSetupCols& setup_cols)
 {
     int idx, idx_pos, size;
     int local_S_idx, global_comm_idx;
 
+    global_par_comm->send_data->indices.resize(setup_cols.global_send.size());
+    local_R_par_comm->send_data->indices.resize(setup_cols.R_send.size());
+
     if (local_S_par_comm)
     {
         DuplicateData* local_S_recv = (DuplicateData*) local_S_par_comm->recv_data;
-        // Update global row index with local row to send 
-        for (int i = 0; i < local_S_par_comm->send_data->size_msgs; i++)
-        {
-            local_S_par_comm->send_data->indices[i] -= first_local_col;
-        }
 
-        // Update global_par_comm->send_data->indices (global rows) to 
-        std::map<int, int> S_global_to_local;
-        for (int i = 0; i < local_S_recv->size_msgs; i++)
+        // Set global_par_comm->send_data->indices (global rows) to 
+        // positions in local_S_recv (a repeated index maps to its last
+        // position, so indices are inserted last to first)
+        IntMap<index_t> S_global_to_local(local_S_recv->size_msgs);
+        for (int i = local_S_recv->size_msgs - 1; i >= 0; i--)
         {
-            S_global_to_local[local_S_recv->indices[i]] = i;
+            S_global_to_local.insert(setup_cols.S_recv[i], i);
         }
         std::vector<int> local_S_num_pos;
         if (local_S_recv->size_msgs)
             local_S_num_pos.resize(local_S_recv->size_msgs, 0);
         for (int i = 0; i < global_par_comm->send_data->size_msgs; i++)
         {
-            idx = global_par_comm->send_data->indices[i];
-            local_S_idx = S_global_to_local[idx];
+            local_S_idx = S_global_to_local.find(setup_cols.global_send[i]);
             global_par_comm->send_data->indices[i] = local_S_idx;
             local_S_num_pos[local_S_idx]++;
         }
@@ -844,24 +863,25 @@ void TAPComm::adjust_send_indices(const int first_local_col)
     {
         for (int i = 0; i < global_par_comm->send_data->size_msgs; i++)
         {
-            global_par_comm->send_data->indices[i] -= first_local_col;
+            global_par_comm->send_data->indices[i] = setup_cols.global_send[i]
+                - first_local_col;
         }
     }
 
-    // Update local_R_par_comm->send_data->indices (global_rows)
+    // Set local_R_par_comm->send_data->indices (global_rows) to 
+    // positions in global_recv
     DuplicateData* global_recv = (DuplicateData*) global_par_comm->recv_data;
-    std::map<int, int> global_to_local;
-    for (int i = 0; i < global_recv->size_msgs; i++)
+    IntMap<index_t> global_to_local(global_recv->size_msgs);
+    for (int i = global_recv->size_msgs - 1; i >= 0; i--)
     {
-        global_to_local[global_recv->indices[i]] = i;
+        global_to_local.insert(setup_cols.global_recv[i], i);
     }
     std::vector<int> global_num_pos;
     if (global_recv->size_msgs)
         global_num_pos.resize(global_recv->size_msgs, 0);
     for (int i = 0; i < local_R_par_comm->send_data->size_msgs; i++)
     {
-        idx = local_R_par_comm->send_data->indices[i];
-        global_comm_idx = global_to_local[idx];
+        global_comm_idx = global_to_local.find(setup_cols.R_send[i]);
         local_R_par_comm->send_data->indices[i] = global_comm_idx;
         global_num_pos[global_comm_idx]++;
     }
@@ -892,16 +912,16 @@ void TAPComm::adjust_send_indices(const int first_local_col)
 *****
 ***** Parameters
 ***** -------------
-***** on_node_column_map : std::vector<int>&
+***** on_node_column_map : std::vector<index_t>&
 *****    Columns corresponding to on_node processes
 ***** on_node_col_to_proc : std::vector<int>&
 *****    On node process corresponding to each column
 *****    in on_node_column_map
-***** first_local_row : int
-*****    First row local to rank 
+***** first_local_col : index_t
+*****    First column local to rank 
 **************************************************************/
-void TAPComm::form_local_L_par_comm(const std::vector<int>& on_node_column_map,
-        const std::vector<int>& on_node_col_to_proc, const int first_local_col)
+void TAPComm::form_local_L_par_comm(const std::vector<index_t>& on_node_column_map,
+        const std::vector<int>& on_node_col_to_proc, const index_t first_local_col)
 {
     int local_rank;
     RAPtor_MPI_Comm_rank(topology->local_comm, &local_rank);
@@ -913,6 +933,8 @@ void TAPComm::form_local_L_par_comm(const std::vector<int>& on_node_column_map,
     int count;
     RAPtor_MPI_Status recv_status;
     std::vector<int> recv_procs(topology->PPN, 0);
+    std::vector<index_t> recv_buffer;
+    std::vector<int> local_cols;
 
     NonContigData* local_L_recv = (NonContigData*) local_L_par_comm->recv_data;
 
@@ -950,21 +972,26 @@ void TAPComm::form_local_L_par_comm(const std::vector<int>& on_node_column_map,
         proc = local_L_recv->procs[i];
         start = local_L_recv->indptr[i];
         end = local_L_recv->indptr[i+1];
-        RAPtor_MPI_Isend(&(on_node_column_map[start]), end - start, RAPtor_MPI_INT, proc,
-                7890, topology->local_comm, &(local_L_recv->requests[i]));
+        RAPtor_MPI_Isend(&(on_node_column_map[start]), end - start, RAPtor_MPI_INDEX_T, 
+                proc, 7890, topology->local_comm, &(local_L_recv->requests[i]));
     }
     for (int i = 0; i < num_sends; i++)
     {
         RAPtor_MPI_Probe(RAPtor_MPI_ANY_SOURCE, 7890, topology->local_comm, &recv_status);
-        RAPtor_MPI_Get_count(&recv_status, RAPtor_MPI_INT, &count);
+        RAPtor_MPI_Get_count(&recv_status, RAPtor_MPI_INDEX_T, &count);
         proc = recv_status.RAPtor_MPI_SOURCE;
-        int recvbuf[count];
-        RAPtor_MPI_Recv(recvbuf, count, RAPtor_MPI_INT, proc, 7890, topology->local_comm, &recv_status);
+        if ((int) recv_buffer.size() < count)
+        {
+            recv_buffer.resize(count);
+            local_cols.resize(count);
+        }
+        RAPtor_MPI_Recv(recv_buffer.data(), count, RAPtor_MPI_INDEX_T, proc, 7890, 
+                topology->local_comm, &recv_status);
         for (int j = 0; j < count; j++)
         {
-            recvbuf[j] -= first_local_col;
+            local_cols[j] = recv_buffer[j] - first_local_col;
         }
-        local_L_par_comm->send_data->add_msg(proc, count, recvbuf);
+        local_L_par_comm->send_data->add_msg(proc, count, local_cols.data());
     }
     local_L_par_comm->send_data->finalize();
     
@@ -976,8 +1003,8 @@ void TAPComm::form_local_L_par_comm(const std::vector<int>& on_node_column_map,
     }
 }
 
-void TAPComm::form_simple_R_par_comm(std::vector<int>& off_node_column_map,
-        std::vector<int>& off_node_col_to_proc)
+void TAPComm::form_simple_R_par_comm(std::vector<index_t>& off_node_column_map,
+        std::vector<int>& off_node_col_to_proc, TAPSetupCols& setup_cols)
 {
     int rank, local_rank;
     RAPtor_MPI_Comm_rank(RAPtor_MPI_COMM_WORLD, &rank);
@@ -988,14 +1015,17 @@ void TAPComm::form_simple_R_par_comm(std::vector<int>& off_node_column_map,
     int off_node_num_cols = off_node_column_map.size();
     std::vector<int> local_proc_sizes(topology->PPN, 0);
     std::vector<int> proc_size_idx(topology->PPN);
+    std::vector<index_t> send_buffer;
 
     NonContigData* local_R_recv = (NonContigData*) local_R_par_comm->recv_data;
 
-    // Form local_R_par_comm recv_data (currently with global recv indices)
+    // Form local_R_par_comm recv_data.
+    // Values from a process are recvd by the local process of the same
+    // local rank, wrapping around when the other node holds more processes
     for (std::vector<int>::iterator it = off_node_col_to_proc.begin();
             it != off_node_col_to_proc.end(); ++it)
     {
-        local_proc = topology->get_local_proc(*it);
+        local_proc = topology->get_local_proc(*it) % topology->PPN;
         local_proc_sizes[local_proc]++;
     }
 
@@ -1023,7 +1053,7 @@ void TAPComm::form_simple_R_par_comm(std::vector<int>& off_node_column_map,
     for (int i = 0; i < off_node_num_cols; i++)
     {
         proc = off_node_col_to_proc[i];
-        local_proc = topology->get_local_proc(proc);
+        local_proc = topology->get_local_proc(proc) % topology->PPN;
         proc_idx = proc_size_idx[local_proc];
         idx = local_R_recv->indptr[proc_idx] + local_proc_sizes[local_proc]++;
         local_R_recv->indices[idx] = i;
@@ -1034,20 +1064,35 @@ void TAPComm::form_simple_R_par_comm(std::vector<int>& off_node_column_map,
     RAPtor_MPI_Allreduce(RAPtor_MPI_IN_PLACE, local_proc_sizes.data(), topology->PPN, RAPtor_MPI_INT,
             RAPtor_MPI_SUM, topology->local_comm);
 
-    local_R_par_comm->recv_data->send(off_node_column_map.data(), 6543, topology->local_comm);
-    local_R_par_comm->send_data->probe(local_proc_sizes[local_rank], 6543, topology->local_comm);
+    // (global columns sent are held in setup_cols.R_send)
+    if (local_R_recv->size_msgs)
+    {
+        send_buffer.resize(local_R_recv->size_msgs);
+    }
+    for (int i = 0; i < local_R_recv->size_msgs; i++)
+    {
+        send_buffer[i] = off_node_column_map[local_R_recv->indices[i]];
+    }
+    for (int i = 0; i < local_R_recv->num_msgs; i++)
+    {
+        int start = local_R_recv->indptr[i];
+        int end = local_R_recv->indptr[i+1];
+        RAPtor_MPI_Isend(&(send_buffer[start]), end - start, RAPtor_MPI_INDEX_T,
+                local_R_recv->procs[i], 6543, topology->local_comm, 
+                &(local_R_recv->requests[i]));
+    }
+    local_R_par_comm->send_data->probe(local_proc_sizes[local_rank], 6543, 
+            topology->local_comm, setup_cols.R_send);
     local_R_par_comm->recv_data->waitall();
 }
 
-void TAPComm::form_simple_global_comm(std::vector<int>& off_proc_col_to_proc)
+void TAPComm::form_simple_global_comm(std::vector<int>& off_proc_col_to_proc,
+        TAPSetupCols& setup_cols)
 {
-    int rank;
     int num_procs;
     int proc, start, end;
     int idx, proc_idx;
-    int global_idx;
 
-    RAPtor_MPI_Comm_rank(RAPtor_MPI_COMM_WORLD, &rank);
     RAPtor_MPI_Comm_size(RAPtor_MPI_COMM_WORLD, &num_procs);
 
     std::vector<int> proc_sizes(num_procs, 0);
@@ -1081,36 +1126,32 @@ void TAPComm::form_simple_global_comm(std::vector<int>& off_proc_col_to_proc)
     }
     if (global_recv->size_msgs)
     {
-        global_recv->indices.resize(global_recv->size_msgs);
+        setup_cols.global_recv.resize(global_recv->size_msgs);
         proc_ctr.resize(global_recv->num_msgs, 0);
     }
 
     for (int i = 0; i < local_R_par_comm->send_data->size_msgs; i++)
     {
-        global_idx = local_R_par_comm->send_data->indices[i];
         proc = int_send_buffer[i];
         proc_idx = proc_sizes[proc];
         idx = global_recv->indptr[proc_idx] + proc_ctr[proc_idx]++;
-        global_recv->indices[idx] = global_idx;
+        setup_cols.global_recv[idx] = setup_cols.R_send[i];
     }
     global_recv->finalize();
 
     // Communicate global recv_data so send_data can be formed (dynamic comm)
-    std::vector<int> recv_sizes(num_procs, 0);
-    for (int i = 0; i < global_recv->num_msgs; i++)
-        recv_sizes[global_recv->procs[i]] = global_recv->indptr[i+1] - global_recv->indptr[i];
-    RAPtor_MPI_Allreduce(RAPtor_MPI_IN_PLACE, recv_sizes.data(), num_procs, RAPtor_MPI_INT, RAPtor_MPI_SUM, RAPtor_MPI_COMM_WORLD);
-
     for (int i = 0; i < global_recv->num_msgs; i++)
     {
         proc = global_recv->procs[i];
         start = global_recv->indptr[i];
         end = global_recv->indptr[i+1];
-        RAPtor_MPI_Isend(&(global_recv->indices[start]), end - start, RAPtor_MPI_INT,
-                proc, 6789, RAPtor_MPI_COMM_WORLD, &(global_recv->requests[i]));
+        RAPtor_MPI_Issend(&(setup_cols.global_recv[start]), end - start, 
+                RAPtor_MPI_INDEX_T, proc, 6789, RAPtor_MPI_COMM_WORLD, 
+                &(global_recv->requests[i]));
     }
-    global_par_comm->send_data->probe(recv_sizes[rank], 6789, RAPtor_MPI_COMM_WORLD);
-    global_par_comm->recv_data->waitall();
+    global_par_comm->send_data->nbx_probe(6789, RAPtor_MPI_COMM_WORLD,
+            global_recv->num_msgs, global_recv->requests.data(), 
+            setup_cols.global_send);
 }
 
 void TAPComm::update_recv(const std::vector<int>& on_node_to_off_proc,
@@ -1156,3 +1197,154 @@ void TAPComm::update_recv(const std::vector<int>& on_node_to_off_proc,
 
 
 
+
+/**************************************************************
+*****   Init Shared Comm
+**************************************************************
+***** Prepares the shared memory window used for the intra-node
+***** steps of initialize / complete.  On first use, checks that
+***** all processes of topology->local_comm can share memory
+***** (otherwise shared_mem is unset and messages are used), and
+***** finds where each recvd message starts in the segment of its
+***** sender.  Each segment holds two copies of the values sent
+***** by local_L, local_S and local_R, in that order.  The window
+***** is reallocated whenever values grow beyond its unit size.
+***** Collective over topology->local_comm.
+*****
+***** Parameters
+***** -------------
+***** bytes_per_value : int
+*****    Size of each communicated value (times block size)
+*****
+***** Returns
+***** -------------
+***** bool : true if the shared window can be used
+**************************************************************/
+bool TAPComm::init_shared_comm(const int bytes_per_value)
+{
+    RAPtor_MPI_Comm local_comm = topology->local_comm;
+    int local_size;
+    RAPtor_MPI_Comm_size(local_comm, &local_size);
+
+    if (shared_bases.empty())
+    {
+        // Virtual nodes (PPN) may span several shared memory domains
+        RAPtor_MPI_Comm shm_comm;
+        int shm_size;
+        RAPtor_MPI_Comm_split_type(local_comm, RAPtor_MPI_COMM_TYPE_SHARED, 0,
+                RAPtor_MPI_INFO_NULL, &shm_comm);
+        RAPtor_MPI_Comm_size(shm_comm, &shm_size);
+        RAPtor_MPI_Comm_free(&shm_comm);
+        int can_share = (shm_size == local_size);
+        RAPtor_MPI_Allreduce(RAPtor_MPI_IN_PLACE, &can_share, 1, RAPtor_MPI_INT,
+                RAPtor_MPI_MIN, local_comm);
+        if (!can_share)
+        {
+            shared_mem = false;
+            return false;
+        }
+
+        int L_size = local_L_par_comm->send_data->size_msgs;
+        int S_size = local_S_par_comm ? local_S_par_comm->send_data->size_msgs : 0;
+        int R_size = local_R_par_comm->send_data->size_msgs;
+        exchange_shared_offsets(local_L_par_comm, 0, 6789, L_recv_src);
+        if (local_S_par_comm)
+        {
+            exchange_shared_offsets(local_S_par_comm, L_size, 6790, S_recv_src);
+        }
+        exchange_shared_offsets(local_R_par_comm, L_size + S_size, 6791, R_recv_src);
+
+        shared_size = L_size + S_size + R_size;
+        RAPtor_MPI_Allreduce(RAPtor_MPI_IN_PLACE, &shared_size, 1, RAPtor_MPI_INT,
+                RAPtor_MPI_MAX, local_comm);
+        if (shared_size == 0) shared_size = 1;
+        shared_bases.resize(local_size);
+    }
+
+    if (bytes_per_value > shared_unit)
+    {
+        // Every process on the node communicates values of the same size,
+        // so all reallocate together
+        if (shared_win != RAPtor_MPI_WIN_NULL)
+        {
+            RAPtor_MPI_Win_unlock_all(shared_win);
+            RAPtor_MPI_Win_free(&shared_win);
+        }
+        shared_unit = bytes_per_value;
+
+        char* base;
+        RAPtor_MPI_Aint bytes = 2 * (RAPtor_MPI_Aint) shared_size * shared_unit;
+        RAPtor_MPI_Win_allocate_shared(bytes, 1, RAPtor_MPI_INFO_NULL, local_comm,
+                &base, &shared_win);
+        for (int i = 0; i < local_size; i++)
+        {
+            int disp_unit;
+            RAPtor_MPI_Win_shared_query(shared_win, i, &bytes, &disp_unit, 
+                    &shared_bases[i]);
+        }
+        RAPtor_MPI_Win_lock_all(RAPtor_MPI_MODE_NOCHECK, shared_win);
+        shared_parity = 0;
+    }
+
+    return true;
+}
+
+// Frees the shared window (collective over topology->local_comm)
+void TAPComm::free_shared_comm()
+{
+    if (shared_win != RAPtor_MPI_WIN_NULL)
+    {
+        RAPtor_MPI_Win_unlock_all(shared_win);
+        RAPtor_MPI_Win_free(&shared_win);
+    }
+}
+
+/**************************************************************
+*****   Exchange Shared Offsets
+**************************************************************
+***** Sends the position of each message of comm within the
+***** sender's segment (offset plus the start of the message)
+***** to its destination, so that recvd messages can be read
+***** from the shared window.
+*****
+***** Parameters
+***** -------------
+***** comm : ParComm*
+*****    Node-local communication package
+***** offset : int
+*****    Position of comm's send values within the segment
+***** tag : int
+*****    Message tag
+***** src : std::vector<int>&
+*****    Returned with the position of each recvd message in the
+*****    segment of the process it is recvd from
+**************************************************************/
+void TAPComm::exchange_shared_offsets(ParComm* comm, int offset, int tag,
+        std::vector<int>& src)
+{
+    RAPtor_MPI_Comm local_comm = topology->local_comm;
+    CommData* send_data = comm->send_data;
+    CommData* recv_data = comm->recv_data;
+
+    std::vector<int> send_offsets(send_data->num_msgs);
+    std::vector<RAPtor_MPI_Request> send_requests(send_data->num_msgs);
+    std::vector<RAPtor_MPI_Request> recv_requests(recv_data->num_msgs);
+    src.resize(recv_data->num_msgs);
+
+    for (int i = 0; i < send_data->num_msgs; i++)
+    {
+        send_offsets[i] = offset + send_data->indptr[i];
+        RAPtor_MPI_Isend(&(send_offsets[i]), 1, RAPtor_MPI_INT, send_data->procs[i],
+                tag, local_comm, &(send_requests[i]));
+    }
+    for (int i = 0; i < recv_data->num_msgs; i++)
+    {
+        RAPtor_MPI_Irecv(&(src[i]), 1, RAPtor_MPI_INT, recv_data->procs[i],
+                tag, local_comm, &(recv_requests[i]));
+    }
+
+    RAPtor_MPI_Waitall(send_data->num_msgs, send_requests.data(), 
+            RAPtor_MPI_STATUSES_IGNORE);
+    RAPtor_MPI_Waitall(recv_data->num_msgs, recv_requests.data(), 
+            RAPtor_MPI_STATUSES_IGNORE);
+}
@@ -109,25 +109,25 @@ TEST(BlockMatrixTest, TestsInCore)
     ASSERT_EQ(A_bsr->nnz, A_bsc->nnz);
     ASSERT_EQ(A_csr_from_bsr->nnz, A_csr->nnz);
 
-    double** bcoo_vals = (double**) A_bcoo->get_data();
-    double** bsr_vals = (double**) A_bsr->get_data();
+    double* bcoo_vals = (double*) A_bcoo->get_data();
+    double* bsr_vals = (double*) A_bsr->get_data();
     for (int i = 0; i < A_bcoo->nnz; i++)
     {
         for (int j = 0; j < A_bcoo->b_size; j++)
         {
-            ASSERT_NEAR(bcoo_vals[i][j], bsr_vals[i][j], 1e-10);
+            ASSERT_NEAR(bcoo_vals[i*A_bcoo->b_size + j], bsr_vals[i*A_bsr->b_size + j], 1e-10);
         }
     }
 
     Matrix* Atmp = A_bsc->to_CSR();
     Atmp->sort();
     Atmp->move_diag();
-    double** tmp_vals = (double**) Atmp->get_data();
+    double* tmp_vals = (double*) Atmp->get_data();
     for (int i = 0; i < A_bsr->nnz; i++)
     {
         for (int j = 0; j < A_bsr->b_size; j++)
         {
-            ASSERT_NEAR(bsr_vals[i][j], tmp_vals[i][j], 1e-10);
+            ASSERT_NEAR(bsr_vals[i*A_bsr->b_size + j], tmp_vals[i*A_bsr->b_size + j], 1e-10);
         }
     }
 
@@ -210,3 +210,97 @@ TEST(BlockMatrixTest, TestsInCore)
 } // end of TEST(MatrixTest, TestsInCore) //
 
 
+
+// Block tridiagonal BSR matrix, compared against its CSR equivalent
+// (block sizes 3, 4, and 6 use the fixed-size kernels, 5 and 2x3 the
+// general ones)
+void test_block_size(int b_rows, int b_cols)
+{
+    int n = 4;
+    int b_size = b_rows * b_cols;
+    std::vector<int> rowptr(n+1);
+    std::vector<int> cols;
+    BlockArray vals(b_size);
+    std::vector<double> block(b_size);
+
+    rowptr[0] = 0;
+    for (int i = 0; i < n; i++)
+    {
+        for (int j = i-1; j <= i+1; j++)
+        {
+            if (j < 0 || j >= n) continue;
+            for (int k = 0; k < b_size; k++)
+                block[k] = ((i + 2*j + 3*k) % 7) - 2.5;
+            cols.push_back(j);
+            vals.emplace_back(block.data());
+        }
+        rowptr[i+1] = cols.size();
+    }
+
+    BSRMatrix* A_bsr = new BSRMatrix(n, n, b_rows, b_cols, rowptr, cols, vals);
+    CSRMatrix* A_csr = A_bsr->to_CSR();
+
+    int num_rows = n * b_rows;
+    int num_cols = n * b_cols;
+    Vector x(num_cols);
+    Vector b(num_rows);
+    Vector tmp(num_rows);
+    for (int i = 0; i < num_cols; i++)
+        x[i] = sin(i + 1.0);
+    for (int i = 0; i < num_rows; i++)
+        tmp[i] = cos(i + 1.0);
+
+    A_csr->mult(x, b);
+    A_bsr->mult(x, tmp);
+    for (int i = 0; i < num_rows; i++)
+        ASSERT_NEAR(b[i], tmp[i], 1e-10);
+
+    Vector r(num_rows);
+    Vector r_bsr(num_rows);
+    A_csr->residual(x, tmp, r);
+    A_bsr->residual(x, tmp, r_bsr);
+    for (int i = 0; i < num_rows; i++)
+        ASSERT_NEAR(r[i], r_bsr[i], 1e-10);
+
+    Vector y(num_rows);
+    Vector z(num_cols);
+    Vector z_bsr(num_cols);
+    for (int i = 0; i < num_rows; i++)
+        y[i] = sin(2.0*i + 1.0);
+    A_csr->mult_T(y, z);
+    A_bsr->mult_T(y, z_bsr);
+    for (int i = 0; i < num_cols; i++)
+        ASSERT_NEAR(z[i], z_bsr[i], 1e-10);
+
+    CSCMatrix* A_csc = A_csr->to_CSC();
+    CSCMatrix* A_bsc = A_bsr->to_BSC();
+    CSRMatrix* D_csr = A_csr->mult_T(A_csc);
+    CSRMatrix* D_bsr = A_bsr->mult_T((BSCMatrix*)A_bsc);
+    compare_vals(D_csr, (BSRMatrix*) D_bsr);
+
+    if (b_rows == b_cols)
+    {
+        CSRMatrix* C_csr = A_csr->mult(A_csr);
+        CSRMatrix* C_bsr = A_bsr->mult((BSRMatrix*)A_bsr);
+        compare_vals(C_csr, (BSRMatrix*) C_bsr);
+        delete C_csr;
+        delete C_bsr;
+    }
+
+    delete D_csr;
+    delete D_bsr;
+    delete A_csc;
+    delete A_bsc;
+    delete A_csr;
+    delete A_bsr;
+}
+
+TEST(BlockSizeTest, TestsInCore)
+{
+    test_block_size(3, 3);
+    test_block_size(4, 4);
+    test_block_size(5, 5);
+    test_block_size(6, 6);
+    test_block_size(2, 3);
+
+} // end of TEST(BlockSizeTest, TestsInCore) //
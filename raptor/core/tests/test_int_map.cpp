@@ -0,0 +1,67 @@
+// Copyright (c) 2015-2017, RAPtor Developer Team
+// License: Simplified BSD, http://opensource.org/licenses/BSD-2-Clause
+
+#include "gtest/gtest.h"
+#include "raptor.hpp"
+using namespace raptor;
+
+
+int main(int argc, char** argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+
+} // end of main() //
+
+TEST(IntMapTest, TestsInCore)
+{
+    // Keys spread over a large range, inserted past several rehashes
+    int n = 5000;
+    std::vector<index_t> keys(n);
+    srand(2448422);
+    for (int i = 0; i < n; i++)
+    {
+        keys[i] = (index_t) rand();
+    }
+
+    IntMap<index_t> map;
+    std::map<index_t, int> ref;
+    for (int i = 0; i < n; i++)
+    {
+        int val = map.insert(keys[i], i);
+        ref.insert(std::make_pair(keys[i], i));
+        ASSERT_EQ(val, ref[keys[i]]);
+    }
+    ASSERT_EQ(map.size(), (int) ref.size());
+
+    for (std::map<index_t, int>::iterator it = ref.begin(); it != ref.end(); ++it)
+    {
+        ASSERT_EQ(map.find(it->first), it->second);
+    }
+    for (int i = 0; i < n; i++)
+    {
+        if (ref.find(i) == ref.end())
+        {
+            ASSERT_EQ(map.find(i), -1);
+        }
+    }
+
+    map.clear();
+    ASSERT_EQ(map.size(), 0);
+    ASSERT_EQ(map.find(keys[0]), -1);
+
+    // Sorted array utilities
+    std::vector<index_t> sorted(keys);
+    sort_unique(sorted);
+    ASSERT_EQ(sorted.size(), ref.size());
+    int ctr = 0;
+    for (std::map<index_t, int>::iterator it = ref.begin(); it != ref.end(); ++it)
+    {
+        ASSERT_EQ(sorted[ctr], it->first);
+        ASSERT_EQ(sorted_find(sorted, it->first), ctr);
+        ctr++;
+    }
+    ASSERT_EQ(sorted_find(sorted, (index_t) -1), -1);
+    ASSERT_EQ(sorted_find(sorted, (index_t) (sorted.back() + 1)), -1);
+
+} // end of TEST(IntMapTest, TestsInCore) //
@@ -62,3 +62,90 @@ TEST(MatrixTest, TestsInCore)
 
 } // end of TEST(MatrixTest, TestsInCore) //
 
+
+TEST(MatrixSortTest, TestsInCore)
+{
+    // Random entries with duplicates, where the first rows (and
+    // columns) are long enough to skip the insertion sort
+    int n = 40;
+    int nnz = 2000;
+    int row, col;
+    double val;
+    srand(2448422);
+
+    std::map<std::pair<int, int>, double> ref;
+    COOMatrix* A_coo = new COOMatrix(n, n, 0);
+    for (int i = 0; i < nnz; i++)
+    {
+        row = (i % 3) ? rand() % n : rand() % 4;
+        col = (i % 3) ? rand() % n : rand() % 4;
+        val = 1.0 + double(rand()) / RAND_MAX;
+        A_coo->add_value(row, col, val);
+        ref[std::make_pair(row, col)] += val;
+    }
+    CSRMatrix* A_csr = A_coo->to_CSR();
+
+    // Columns of A_csc are formed in row order, so reverse each
+    CSCMatrix* A_csc = A_csr->to_CSC();
+    for (int i = 0; i < n; i++)
+    {
+        std::reverse(A_csc->idx2.begin() + A_csc->idx1[i],
+                A_csc->idx2.begin() + A_csc->idx1[i+1]);
+        std::reverse(A_csc->vals.begin() + A_csc->idx1[i],
+                A_csc->vals.begin() + A_csc->idx1[i+1]);
+    }
+
+    A_coo->sort();
+    for (int i = 1; i < A_coo->nnz; i++)
+    {
+        ASSERT_TRUE(A_coo->idx1[i-1] < A_coo->idx1[i] || (A_coo->idx1[i-1] == A_coo->idx1[i]
+                    && A_coo->idx2[i-1] <= A_coo->idx2[i]));
+    }
+    A_coo->remove_duplicates();
+    ASSERT_EQ(A_coo->nnz, (int) ref.size());
+    int ctr = 0;
+    for (std::map<std::pair<int, int>, double>::iterator it = ref.begin();
+            it != ref.end(); ++it)
+    {
+        ASSERT_EQ(A_coo->idx1[ctr], it->first.first);
+        ASSERT_EQ(A_coo->idx2[ctr], it->first.second);
+        ASSERT_NEAR(A_coo->vals[ctr], it->second, 1e-12);
+        ctr++;
+    }
+
+    A_csr->sorted = false;
+    A_csr->sort();
+    A_csr->remove_duplicates();
+    ASSERT_EQ(A_csr->nnz, (int) ref.size());
+    ctr = 0;
+    for (std::map<std::pair<int, int>, double>::iterator it = ref.begin();
+            it != ref.end(); ++it)
+    {
+        ASSERT_TRUE(ctr >= A_csr->idx1[it->first.first]);
+        ASSERT_TRUE(ctr < A_csr->idx1[it->first.first + 1]);
+        ASSERT_EQ(A_csr->idx2[ctr], it->first.second);
+        ASSERT_NEAR(A_csr->vals[ctr], it->second, 1e-12);
+        ctr++;
+    }
+
+    A_csc->sorted = false;
+    A_csc->sort();
+    A_csc->remove_duplicates();
+    ASSERT_EQ(A_csc->nnz, (int) ref.size());
+    for (int i = 0; i < n; i++)
+    {
+        for (int j = A_csc->idx1[i]; j < A_csc->idx1[i+1]; j++)
+        {
+            if (j > A_csc->idx1[i])
+            {
+                ASSERT_LT(A_csc->idx2[j-1], A_csc->idx2[j]);
+            }
+            ASSERT_NEAR(A_csc->vals[j], ref[std::make_pair(A_csc->idx2[j], i)], 1e-12);
+        }
+    }
+
+    delete A_coo;
+    delete A_csr;
+    delete A_csc;
+
+} // end of TEST(MatrixSortTest, TestsInCore) //
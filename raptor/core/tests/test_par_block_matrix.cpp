@@ -120,6 +120,8 @@ TEST(ParBlockMatrixTest, TestsInCore)
     // Test Blocked Matrix Communication
     CSRMatrix* C = A->comm->communicate(A);
     BSRMatrix* C_bsr = (BSRMatrix*) A_bsr->comm->communicate(A_bsr);
+    C->idx2.assign(C->global_idx2.begin(), C->global_idx2.end());
+    C_bsr->idx2.assign(C_bsr->global_idx2.begin(), C_bsr->global_idx2.end());
     C->sort();
     C_bsr->sort();
     ASSERT_EQ(C->n_rows, C_bsr->n_rows * C_bsr->b_rows);
@@ -69,7 +69,7 @@ TEST(ParCommTest, TestsInCore)
         end = recv_mat->idx1[i+1];
         for (int j = start; j < end; j++)
         {
-            global_col = recv_mat->idx2[j];
+            global_col = recv_mat->global_idx2[j];
             val = recv_mat->vals[j];
             ASSERT_NEAR(seq_row[global_col], val, 1e-06);
         }
@@ -81,3 +81,59 @@ TEST(ParCommTest, TestsInCore)
     delete A_seq;
 
 } // end of TEST(ParCommTest, TestsInCore) //
+
+TEST(ParCommNeighborTest, TestsInCore)
+{
+    int rank, num_procs;
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &num_procs);
+
+    // Each process owns 4 columns, and needs one column from rank+1 and
+    // two from rank+3, so the processes sent to differ from those
+    // received from
+    int n = 4;
+    Partition* partition = new Partition(num_procs*n, num_procs*n);
+    std::vector<index_t> off_proc_column_map;
+    int proc = (rank + 1) % num_procs;
+    if (proc != rank)
+    {
+        off_proc_column_map.emplace_back(proc*n);
+    }
+    proc = (rank + 3) % num_procs;
+    if (proc != rank)
+    {
+        off_proc_column_map.emplace_back(proc*n + 1);
+        off_proc_column_map.emplace_back(proc*n + 2);
+    }
+    sort_unique(off_proc_column_map);
+
+    std::vector<int> sendbuf(n);
+    for (int i = 0; i < n; i++)
+    {
+        sendbuf[i] = partition->first_local_col + i;
+    }
+
+    // Consecutive packages discover neighbors with the same tag
+    for (int test = 0; test < 3; test++)
+    {
+        ParComm* comm = new ParComm(partition, off_proc_column_map);
+        comm->communicate(sendbuf);
+        ASSERT_EQ(comm->recv_data->size_msgs, (int) off_proc_column_map.size());
+        for (size_t i = 0; i < off_proc_column_map.size(); i++)
+        {
+            ASSERT_EQ(comm->recv_data->int_buffer[i], off_proc_column_map[i]);
+        }
+
+        // Every requested column is sent once
+        int size_sends = comm->send_data->size_msgs;
+        int size_recvs = comm->recv_data->size_msgs;
+        MPI_Allreduce(MPI_IN_PLACE, &size_sends, 1, MPI_INT, MPI_SUM, MPI_COMM_WORLD);
+        MPI_Allreduce(MPI_IN_PLACE, &size_recvs, 1, MPI_INT, MPI_SUM, MPI_COMM_WORLD);
+        ASSERT_EQ(size_sends, size_recvs);
+
+        delete comm;
+    }
+
+    delete partition;
+
+} // end of TEST(ParCommNeighborTest, TestsInCore) //
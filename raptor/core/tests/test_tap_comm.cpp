@@ -68,6 +68,11 @@ TEST(TAPCommTest, TestsInCore)
     CSRMatrix* recv_mat = A->comm->communicate(B);
     CSRMatrix* tap_recv_mat = A->tap_comm->communicate(B);
     CSRMatrix* tap_recv_simp_mat = A->tap_mat_comm->communicate(B);
+    // Received rows hold global columns, which are small enough to compare as idx2
+    recv_mat->idx2.assign(recv_mat->global_idx2.begin(), recv_mat->global_idx2.end());
+    tap_recv_mat->idx2.assign(tap_recv_mat->global_idx2.begin(), tap_recv_mat->global_idx2.end());
+    tap_recv_simp_mat->idx2.assign(tap_recv_simp_mat->global_idx2.begin(), 
+            tap_recv_simp_mat->global_idx2.end());
     compare(recv_mat, tap_recv_mat);
     compare(tap_recv_mat, tap_recv_simp_mat);
     delete recv_mat;
@@ -79,3 +84,63 @@ TEST(TAPCommTest, TestsInCore)
 
 
 } // end of TEST(TAPCommTest, TestsInCore) //
+
+TEST(TAPCommTopologyTest, TestsInCore)
+{
+    int rank, num_procs;
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &num_procs);
+
+    // Nodes found from shared memory domains, and virtual nodes of 3
+    // processes (the last node holding fewer when 3 does not divide
+    // num_procs)
+    for (int test = 0; test < 2; test++)
+    {
+        if (test == 1) setenv("PPN", "3", 1);
+        Topology* topology = new Topology();
+
+        int local_size;
+        MPI_Comm_size(topology->local_comm, &local_size);
+        ASSERT_EQ(topology->PPN, local_size);
+        ASSERT_EQ(topology->get_node_size(topology->get_node(rank)), local_size);
+        if (test == 1)
+        {
+            ASSERT_EQ(topology->num_nodes, (num_procs + 2) / 3);
+        }
+
+        int total_size = 0;
+        for (int node = 0; node < topology->num_nodes; node++)
+        {
+            total_size += topology->get_node_size(node);
+        }
+        ASSERT_EQ(total_size, num_procs);
+
+        for (int proc = 0; proc < num_procs; proc++)
+        {
+            ASSERT_EQ(topology->get_global_proc(topology->get_node(proc),
+                        topology->get_local_proc(proc)), proc);
+        }
+
+        delete topology;
+    }
+
+    // Node-aware communication over nodes of different sizes
+    int grid[2] = {25, 25};
+    double* stencil = diffusion_stencil_2d(0.001, M_PI / 8.0);
+    ParCSRMatrix* A = par_stencil_grid(stencil, grid, 2);
+    A->init_tap_communicators(MPI_COMM_WORLD);
+    ParVector x(A->global_num_rows, A->local_num_rows);
+    x.set_rand_values();
+    std::vector<double> par_recv = A->comm->communicate(x);
+    std::vector<double>& tap_recv = A->tap_comm->communicate(x);
+    ASSERT_EQ(tap_recv.size(), par_recv.size());
+    for (int i = 0; i < (int)par_recv.size(); i++)
+    {
+        ASSERT_NEAR(par_recv[i], tap_recv[i], zero_tol);
+    }
+    unsetenv("PPN");
+
+    delete[] stencil;
+    delete A;
+
+} // end of TEST(TAPCommTopologyTest, TestsInCore) //
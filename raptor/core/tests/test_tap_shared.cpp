@@ -0,0 +1,115 @@
+// Copyright (c) 2015-2017, RAPtor Developer Team
+// License: Simplified BSD, http://opensource.org/licenses/BSD-2-Clause
+
+#include "gtest/gtest.h"
+#include "raptor.hpp"
+
+using namespace raptor;
+
+int main(int argc, char** argv)
+{
+    MPI_Init(&argc, &argv);
+    ::testing::InitGoogleTest(&argc, argv);
+    int temp=RUN_ALL_TESTS();
+    MPI_Finalize();
+    return temp;
+
+} // end of main() //
+
+void compare_comm(ParCSRMatrix* A, TAPComm* tap_comm)
+{
+    int n_vecs = 3;
+    ParVector x(A->global_num_rows, A->local_num_rows);
+    ParMultiVector X(A->global_num_rows, A->local_num_rows, n_vecs);
+    std::vector<int> int_vals(A->local_num_rows);
+
+    // Repeated communication alternates between halves of the window
+    for (int iter = 0; iter < 3; iter++)
+    {
+        for (int i = 0; i < A->local_num_rows; i++)
+        {
+            x[i] = A->local_row_map[i] + 0.5 * iter;
+        }
+        std::vector<double> par_recv = A->comm->communicate(x);
+        std::vector<double>& tap_recv = tap_comm->communicate(x);
+        ASSERT_GE((int) tap_recv.size(), A->off_proc_num_cols);
+        for (int i = 0; i < A->off_proc_num_cols; i++)
+        {
+            ASSERT_EQ(par_recv[i], tap_recv[i]);
+        }
+    }
+
+    for (int i = 0; i < A->local_num_rows; i++)
+    {
+        int_vals[i] = A->local_row_map[i] * 2;
+    }
+    std::vector<int> par_int_recv = A->comm->communicate(int_vals);
+    std::vector<int>& tap_int_recv = tap_comm->communicate(int_vals);
+    for (int i = 0; i < A->off_proc_num_cols; i++)
+    {
+        ASSERT_EQ(par_int_recv[i], tap_int_recv[i]);
+    }
+
+    // Larger values reallocate the window
+    for (int i = 0; i < A->local_num_rows; i++)
+    {
+        for (int v = 0; v < n_vecs; v++)
+        {
+            X(i, v) = A->local_row_map[i] * (v + 1);
+        }
+    }
+    std::vector<double> par_multi_recv = A->comm->communicate(X);
+    std::vector<double>& tap_multi_recv = tap_comm->communicate(X);
+    for (int i = 0; i < A->off_proc_num_cols * n_vecs; i++)
+    {
+        ASSERT_EQ(par_multi_recv[i], tap_multi_recv[i]);
+    }
+}
+
+TEST(TAPSharedTest, TestsInCore)
+{
+    // Two processes per node, so values also cross nodes
+    setenv("PPN", "2", 1);
+
+    int grid[3] = {10, 10, 10};
+    double* stencil = laplace_stencil_27pt();
+    ParCSRMatrix* A = par_stencil_grid(stencil, grid, 3);
+    delete[] stencil;
+
+    if (!A->comm)
+    {
+        A->comm = new ParComm(A->partition, A->off_proc_column_map, 
+                A->on_proc_column_map);
+    }
+
+    // 3-step and 2-step node-aware communication
+    TAPComm* tap_comm = new TAPComm(A->partition, A->off_proc_column_map,
+            A->on_proc_column_map, true);
+    TAPComm* simple_comm = new TAPComm(A->partition, A->off_proc_column_map,
+            A->on_proc_column_map, false);
+    tap_comm->shared_mem = true;
+    simple_comm->shared_mem = true;
+    compare_comm(A, tap_comm);
+    compare_comm(A, simple_comm);
+    ASSERT_TRUE(tap_comm->shared_mem);
+    delete simple_comm;
+
+    // Node-aware SpMV through the shared window
+    A->tap_comm = tap_comm;
+    ParVector x(A->global_num_rows, A->local_num_rows);
+    ParVector b(A->global_num_rows, A->local_num_rows);
+    ParVector tap_b(A->global_num_rows, A->local_num_rows);
+    for (int i = 0; i < A->local_num_rows; i++)
+    {
+        x[i] = 1.0 + (A->local_row_map[i] % 5);
+    }
+    A->mult(x, b);
+    A->tap_mult(x, tap_b);
+    for (int i = 0; i < A->local_num_rows; i++)
+    {
+        ASSERT_NEAR(b[i], tap_b[i], 1e-12);
+    }
+
+    delete A;
+
+} // end of TEST(TAPSharedTest, TestsInCore) //
@@ -1,6 +1,6 @@
 // Copyright (c) 2015-2017, RAPtor Developer Team
 // License: Simplified BSD, http://opensource.org/licenses/BSD-2-Clause
-#ifndef TOPOLOGY_HPP 
+#ifndef TOPOLOGY_HPP
 #define TOPOLOGY_HPP
 
 #include <mpi.h>
@@ -13,60 +13,67 @@
  *****   Topology Class
  **************************************************************
  ***** This class holds information about the topology of
- ***** the parallel computer on which Raptor is being run
+ ***** the parallel computer on which Raptor is being run.
+ ***** Nodes are the shared memory domains found by
+ ***** MPI_Comm_split_type, so any placement of ranks and any
+ ***** number of processes per node is supported.  If the PPN
+ ***** environment variable is set (or PPN is passed to the
+ ***** constructor), virtual nodes of PPN processes are formed
+ ***** instead, laid out by RAPtor_MPICH_RANK_REORDER_METHOD:
+ *****    0 : round-robin over nodes
+ *****    1 : contiguous blocks of PPN ranks (default)
+ *****    2 : round-robin, reversing direction each round
  *****
  ***** Attributes
  ***** -------------
- ***** global_num_indices : index_t
- *****    Number of rows to be partitioned
- ***** first_local_idx : index_t
- *****    First global index of a row in partition local to rank
- ***** local_num_indices : index_t
- *****    Number of rows local to rank's partition
+ ***** PPN : int
+ *****    Number of processes on the node local to rank
+ ***** num_nodes : int
+ *****    Number of nodes
+ ***** local_comm : RAPtor_MPI_Comm
+ *****    Communicator of the processes on the node local to rank,
+ *****    ordered by global rank
+ ***** proc_to_node : std::vector<int>
+ *****    Node of each process
+ ***** proc_to_local : std::vector<int>
+ *****    Rank of each process in the local_comm of its node
+ ***** node_procs_ptr, node_procs : std::vector<int>
+ *****    Processes of node n are node_procs[node_procs_ptr[n]] to
+ *****    node_procs[node_procs_ptr[n+1]-1], in local rank order
  *****
  ***** Methods
  ***** ---------
+ ***** get_node(proc)
+ *****    Returns the node of proc
+ ***** get_local_proc(proc)
+ *****    Returns the local rank of proc on its node
+ ***** get_global_proc(node, local_proc)
+ *****    Returns the global rank of local_proc on node
+ ***** get_node_size(node)
+ *****    Returns the number of processes on node
  **************************************************************/
 namespace raptor
 {
   class Topology
   {
   public:
-    Topology(int _PPN = 16, int _standard_rank_ordering = 1)
-    {     
-        int rank, num_procs;
-        RAPtor_MPI_Comm_rank(RAPtor_MPI_COMM_WORLD, &rank);
-        RAPtor_MPI_Comm_size(RAPtor_MPI_COMM_WORLD, &num_procs);
-
-        int rank_node;
-
-        char* proc_layout_c = getenv("RAPtor_MPICH_RANK_REORDER_METHOD");
+    Topology()
+    {
         char* PPN_c = getenv("PPN");
-        if (PPN_c) 
-        {
-            PPN = atoi(PPN_c);
-        }
-        else
-        {
-            PPN = _PPN;
-        }
-
-        if (proc_layout_c)
+        if (PPN_c)
         {
-            rank_ordering = atoi(proc_layout_c);
+            char* proc_layout_c = getenv("RAPtor_MPICH_RANK_REORDER_METHOD");
+            init_virtual_nodes(atoi(PPN_c), proc_layout_c ? atoi(proc_layout_c) : 1);
         }
         else
         {
-            rank_ordering = _standard_rank_ordering;
+            init_shared_nodes();
         }
+    }
 
-        num_nodes = num_procs / PPN;
-        if (num_procs % PPN) num_nodes++;
-        rank_node = get_node(rank);
-
-        // Create intra-node communicator
-        RAPtor_MPI_Comm_split(RAPtor_MPI_COMM_WORLD, rank_node, rank, &local_comm);
-        num_shared = 0;
+    Topology(int _PPN, int _standard_rank_ordering = 1)
+    {
+        init_virtual_nodes(_PPN, _standard_rank_ordering);
     }
 
     ~Topology()
@@ -76,98 +83,154 @@ namespace raptor
 
     int get_node(int proc)
     {
-        if (rank_ordering == 0)
-        {
-            return proc % num_nodes;
-        }
-        else if (rank_ordering == 1)
-        {
-            return proc / PPN;
-        }
-        else if (rank_ordering == 2)
+        return proc_to_node[proc];
+    }
+
+    int get_local_proc(int proc)
+    {
+        return proc_to_local[proc];
+    }
+
+    int get_global_proc(int node, int local_proc)
+    {
+        return node_procs[node_procs_ptr[node] + local_proc];
+    }
+
+    int get_node_size(int node)
+    {
+        return node_procs_ptr[node+1] - node_procs_ptr[node];
+    }
+
+    int PPN;
+    int rank_ordering;
+    int num_shared;
+    int num_nodes;
+
+    std::vector<int> proc_to_node;
+    std::vector<int> proc_to_local;
+    std::vector<int> node_procs_ptr;
+    std::vector<int> node_procs;
+
+    RAPtor_MPI_Comm local_comm;
+
+  private:
+    // Nodes are the shared memory domains, numbered in order of
+    // their lowest rank
+    void init_shared_nodes()
+    {
+        int rank, num_procs;
+        RAPtor_MPI_Comm_rank(RAPtor_MPI_COMM_WORLD, &rank);
+        RAPtor_MPI_Comm_size(RAPtor_MPI_COMM_WORLD, &num_procs);
+
+        rank_ordering = -1;
+        RAPtor_MPI_Comm_split_type(RAPtor_MPI_COMM_WORLD, RAPtor_MPI_COMM_TYPE_SHARED,
+                rank, RAPtor_MPI_INFO_NULL, &local_comm);
+
+        // Lowest rank on each process's node
+        int first_proc = rank;
+        RAPtor_MPI_Bcast(&first_proc, 1, RAPtor_MPI_INT, 0, local_comm);
+        std::vector<int> first_procs(num_procs);
+        RAPtor_MPI_Allgather(&first_proc, 1, RAPtor_MPI_INT, first_procs.data(), 1,
+                RAPtor_MPI_INT, RAPtor_MPI_COMM_WORLD);
+
+        num_nodes = 0;
+        proc_to_node.resize(num_procs);
+        for (int i = 0; i < num_procs; i++)
         {
-            if ((proc / num_nodes) % 2 == 0)
+            if (first_procs[i] == i)
             {
-                return proc % num_nodes;
+                proc_to_node[i] = num_nodes++;
             }
             else
             {
-                return num_nodes - (proc % num_nodes) - 1;
-            }
-        }
-        else
-        { 
-            int rank;
-            RAPtor_MPI_Comm_rank(RAPtor_MPI_COMM_WORLD, &rank);
-            if (rank == 0)
-            {
-                printf("This RAPtor_MPI rank ordering is not supported!\n");
+                proc_to_node[i] = proc_to_node[first_procs[i]];
             }
-            return -1;
         }
+
+        form_node_procs();
+        RAPtor_MPI_Comm_size(local_comm, &PPN);
+        num_shared = 0;
     }
 
-    int get_local_proc(int proc)
+    void init_virtual_nodes(int _PPN, int _rank_ordering)
     {
-        if (rank_ordering == 0 || rank_ordering == 2)
-        {
-            return proc / num_nodes;
-        }
-        else if (rank_ordering == 1)
+        int rank, num_procs;
+        RAPtor_MPI_Comm_rank(RAPtor_MPI_COMM_WORLD, &rank);
+        RAPtor_MPI_Comm_size(RAPtor_MPI_COMM_WORLD, &num_procs);
+
+        rank_ordering = _rank_ordering;
+        num_nodes = num_procs / _PPN;
+        if (num_procs % _PPN) num_nodes++;
+
+        proc_to_node.resize(num_procs);
+        for (int i = 0; i < num_procs; i++)
         {
-            return proc % PPN;
-        }
-        else
-        { 
-            int rank;
-            RAPtor_MPI_Comm_rank(RAPtor_MPI_COMM_WORLD, &rank);
-            if (rank == 0)
+            if (rank_ordering == 0)
+            {
+                proc_to_node[i] = i % num_nodes;
+            }
+            else if (rank_ordering == 1)
+            {
+                proc_to_node[i] = i / _PPN;
+            }
+            else if (rank_ordering == 2)
+            {
+                if ((i / num_nodes) % 2 == 0)
+                {
+                    proc_to_node[i] = i % num_nodes;
+                }
+                else
+                {
+                    proc_to_node[i] = num_nodes - (i % num_nodes) - 1;
+                }
+            }
+            else
             {
-                printf("This RAPtor_MPI rank ordering is not supported!\n");
+                if (rank == 0)
+                {
+                    printf("This RAPtor_MPI rank ordering is not supported!\n");
+                }
+                exit(-1);
             }
-            return -1;
         }
+
+        form_node_procs();
+
+        // Create intra-node communicator
+        RAPtor_MPI_Comm_split(RAPtor_MPI_COMM_WORLD, proc_to_node[rank], rank, &local_comm);
+        RAPtor_MPI_Comm_size(local_comm, &PPN);
+        num_shared = 0;
     }
 
-    int get_global_proc(int node, int local_proc)
+    // Forms node_procs and proc_to_local from proc_to_node, with
+    // the processes of each node in order of rank (as in local_comm)
+    void form_node_procs()
     {
-        if (rank_ordering == 0)
+        int num_procs = proc_to_node.size();
+
+        node_procs_ptr.resize(num_nodes + 1);
+        std::fill(node_procs_ptr.begin(), node_procs_ptr.end(), 0);
+        for (int i = 0; i < num_procs; i++)
         {
-            return local_proc * num_nodes + node;
+            node_procs_ptr[proc_to_node[i] + 1]++;
         }
-        else if (rank_ordering == 1)
+        for (int i = 0; i < num_nodes; i++)
         {
-            return local_proc + (node * PPN);
+            node_procs_ptr[i+1] += node_procs_ptr[i];
         }
-        else if (rank_ordering == 2)
+
+        int node, idx;
+        std::vector<int> node_sizes(num_nodes, 0);
+        node_procs.resize(num_procs);
+        proc_to_local.resize(num_procs);
+        for (int i = 0; i < num_procs; i++)
         {
-            if (local_proc % 2 == 0)
-            {
-                return local_proc * num_nodes + node;
-            }
-            else
-            {
-                return local_proc * num_nodes + num_nodes - node - 1;                
-            }
-        }
-        else
-        { 
-            int rank;
-            RAPtor_MPI_Comm_rank(RAPtor_MPI_COMM_WORLD, &rank);
-            if (rank == 0)
-            {
-                printf("This RAPtor_MPI rank ordering is not supported!\n");
-            }
-            return -1;
+            node = proc_to_node[i];
+            idx = node_sizes[node]++;
+            node_procs[node_procs_ptr[node] + idx] = i;
+            proc_to_local[i] = idx;
         }
     }
-
-    int PPN;
-    int rank_ordering;
-    int num_shared;
-    int num_nodes;
-
-    RAPtor_MPI_Comm local_comm;
   };
 }
 
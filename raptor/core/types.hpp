@@ -18,13 +18,19 @@
 #include <set>
 
 #include <cstdint>
+#include <cinttypes>
+#include <climits>
 #include <vector>
 #include <stdexcept>
 
 using namespace std;
 
 #define zero_tol 1e-16
+#ifdef USING_64BIT_INDICES
+#define RAPtor_MPI_INDEX_T MPI_INT64_T
+#else
 #define RAPtor_MPI_INDEX_T MPI_INT
+#endif
 #define RAPtor_MPI_DATA_T MPI_DOUBLE
 
 // Defines for CF splitting and aggregation
@@ -47,14 +53,21 @@ struct PairData
 namespace raptor
 {
     using data_t = double;
+
+    // Global row / column indices (local indices are always int)
+#ifdef USING_64BIT_INDICES
+    using index_t = int64_t;
+#else
     using index_t = int;
+#endif
     enum strength_t {Classical, Symmetric};
     enum format_t {COO, CSR, CSC, BCOO, BSR, BSC};
     enum coarsen_t {RS, CLJP, Falgout, PMIS, HMIS};
-    enum interp_t {Direct, ModClassical, Extended};
+    enum interp_t {Direct, ModClassical, Extended, Multipass};
     enum agg_t {MIS};
-    enum prolong_t {JacobiProlongation};
-    enum relax_t {Jacobi, SOR, SSOR};
+    enum prolong_t {JacobiProlongation, SpectralJacobiProlongation};
+    enum relax_t {Jacobi, SOR, SSOR, L1Jacobi, Chebyshev};
+    enum coarse_solve_t {DenseCoarse, SparseCoarse, IterativeCoarse, AutoCoarse};
 
     template<typename T, typename U> 
     U sum_func(const U& a, const T&b)
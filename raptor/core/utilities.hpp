@@ -3,6 +3,16 @@
 
 #include "core/types.hpp"
 
+#ifdef USING_OPENMP
+#include <omp.h>
+#endif
+
+namespace raptor
+{
+    // Minimum number of local nonzeros before kernels are threaded
+    static const int omp_nnz_threshold = 10000;
+}
+
 using namespace raptor;
 
 // BLAS LU routine that is used for coarse solve
@@ -11,53 +21,95 @@ extern "C" void dgetrf_(int* dim1, int* dim2, double* a, int* lda,
 extern "C" void dgetrs_(char *TRANS, int *N, int *NRHS, double *A, 
         int *LDA, int *IPIV, double *B, int *LDB, int *INFO );
 
+// LAPACK eigenvalues of a symmetric tridiagonal matrix (ascending)
+extern "C" void dsterf_(int* N, double* D, double* E, int* INFO);
+
 
-template <typename T, typename U>
-void vec_sort(std::vector<T>& vec1, std::vector<U>& vec2, int start = 0, int end = -1)
+// Swap positions i and j of a value list (block value lists
+// provide their own swap_vals, found through argument lookup)
+template <typename T>
+void swap_vals(std::vector<T>& vals, int i, int j)
 {
-    vec1.shrink_to_fit();
-    vec2.shrink_to_fit();
+    std::swap(vals[i], vals[j]);
+}
+
+namespace raptor
+{
+    // Segments of at most this many entries are sorted by insertion
+    constexpr int insertion_sort_size = 16;
+}
 
+// Sorts vec1[start, end) by insertion, swapping each entry of vec2
+// along with its key
+template <typename T, typename VecType>
+void insertion_sort(std::vector<T>& vec1, VecType& vec2, int start, int end)
+{
+    for (int i = start + 1; i < end; i++)
+    {
+        for (int j = i; j > start && vec1[j] < vec1[j-1]; j--)
+        {
+            std::swap(vec1[j-1], vec1[j]);
+            swap_vals(vec2, j-1, j);
+        }
+    }
+}
+
+// Sorts vec1[start, end) in place, permuting vec2 accordingly.  perm is
+// scratch space, reused across calls (such as over the rows of a matrix)
+// so that sorting allocates nothing once it has grown to the longest
+// segment.
+template <typename T, typename VecType>
+void vec_sort(std::vector<T>& vec1, VecType& vec2, int start, int end,
+        std::vector<int>& perm)
+{
     int k, prev_k;
-    int n = vec1.size();
-    if (end < 0) end = n;
     int size = end - start;
 
-    std::vector<int> p(size);
-    std::vector<bool> done(size, false);
+    if (size <= insertion_sort_size)
+    {
+        insertion_sort(vec1, vec2, start, end);
+        return;
+    }
 
-    std::iota(p.begin(), p.end(), 0);
-    std::sort(p.begin(), p.end(),
+    if ((int) perm.size() < size) perm.resize(size);
+    std::iota(perm.begin(), perm.begin() + size, 0);
+    std::sort(perm.begin(), perm.begin() + size,
             [&](const int i, const int j)
             {
                 return vec1[i+start] < vec1[j+start];
             });
+
+    // Follow the cycles of the permutation, marking each position
+    // as done by pointing it to itself
     for (int i = 0; i < size; i++)
     {
-        if (done[i]) continue;
-        done[i] = true;
         prev_k = i;
-        k = p[i];
-        while (i != k)
+        k = perm[i];
+        while (k != i)
         {
             std::swap(vec1[prev_k + start], vec1[k + start]);
-            std::swap(vec2[prev_k + start], vec2[k + start]);
-            done[k] = true;
+            swap_vals(vec2, prev_k + start, k + start);
+            perm[prev_k] = prev_k;
             prev_k = k;
-            k = p[k];
+            k = perm[k];
         }
+        perm[prev_k] = prev_k;
     }
 }
 
-template <typename T, typename U>
+template <typename T, typename VecType>
+void vec_sort(std::vector<T>& vec1, VecType& vec2, int start = 0, int end = -1)
+{
+    std::vector<int> perm;
+    if (end < 0) end = vec1.size();
+    vec_sort(vec1, vec2, start, end, perm);
+}
+
+template <typename T, typename VecType>
 void vec_sort(std::vector<T>& vec1, std::vector<T>& vec2, 
-        std::vector<U>& vec3,
+        VecType& vec3,
         int start = 0, int end = -1)
 {
-    vec1.shrink_to_fit();
-    vec2.shrink_to_fit();
-    vec3.shrink_to_fit();
-
     int k, prev_k;
     int n = vec1.size();
     if (end < 0) end = n;
@@ -87,7 +139,7 @@ void vec_sort(std::vector<T>& vec1, std::vector<T>& vec2,
         {
             std::swap(vec1[prev_k + start], vec1[k + start]);
             std::swap(vec2[prev_k + start], vec2[k + start]);
-            std::swap(vec3[prev_k + start], vec3[k + start]);
+            swap_vals(vec3, prev_k + start, k + start);
             done[k] = true;
             prev_k = k;
             k = p[k];
@@ -96,5 +148,48 @@ void vec_sort(std::vector<T>& vec1, std::vector<T>& vec2,
 }
 
 
+/**************************************************************
+ *****   NNZ Balanced Row Range
+ **************************************************************
+ ***** Splits rows [0, n_rows) of a CSR rowptr into n_parts
+ ***** contiguous chunks, each holding roughly nnz / n_parts
+ ***** nonzeros, and returns the rows of chunk 'part'.  Used to
+ ***** divide rows among threads.
+ *****
+ ***** Parameters
+ ***** -------------
+ ***** rowptr : const std::vector<int>&
+ *****    Row pointer of the CSR matrix (size n_rows + 1)
+ ***** n_rows : int
+ *****    Number of rows to split
+ ***** n_parts : int
+ *****    Number of chunks (typically number of threads)
+ ***** part : int
+ *****    Chunk to return (typically thread id)
+ ***** first_row : int&
+ *****    Returns first row in chunk
+ ***** last_row : int&
+ *****    Returns one past the last row in chunk
+ **************************************************************/
+inline void nnz_balanced_rows(const std::vector<int>& rowptr, int n_rows,
+        int n_parts, int part, int& first_row, int& last_row)
+{
+    if (n_rows == 0 || n_parts <= 1)
+    {
+        first_row = 0;
+        last_row = n_rows;
+        return;
+    }
+
+    long nnz = rowptr[n_rows];
+    std::vector<int>::const_iterator begin = rowptr.begin();
+    std::vector<int>::const_iterator end = begin + n_rows;
+
+    if (part == 0) first_row = 0;
+    else first_row = std::lower_bound(begin, end, (int) ((nnz * part) / n_parts)) - begin;
+
+    if (part == n_parts - 1) last_row = n_rows;
+    else last_row = std::lower_bound(begin, end, (int) ((nnz * (part+1)) / n_parts)) - begin;
+}
 
 #endif
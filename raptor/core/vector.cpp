@@ -16,7 +16,7 @@ using namespace raptor;
 **************************************************************/
 void Vector::set_const_value(data_t alpha)
 {
-    for (index_t i = 0; i < num_values; i++)
+    for (int i = 0; i < num_values; i++)
     {
         values[i] = alpha;
     }
@@ -31,7 +31,7 @@ void Vector::set_const_value(data_t alpha)
 void Vector::set_rand_values()
 {
     srand(time(NULL));
-    for (index_t i = 0; i < num_values; i++)
+    for (int i = 0; i < num_values; i++)
     {
         values[i] = ((double)rand()) / RAND_MAX;
     }
@@ -52,7 +52,7 @@ void Vector::set_rand_values()
 **************************************************************/
 void Vector::axpy(Vector& x, data_t alpha)
 {
-    for (index_t i = 0; i < num_values; i++)
+    for (int i = 0; i < num_values; i++)
     {
         values[i] += x.values[i]*alpha;
     }
@@ -88,7 +88,7 @@ void Vector::copy(const Vector& y)
 **************************************************************/
 void Vector::scale(data_t alpha)
 {
-    for (index_t i = 0; i < num_values; i++)
+    for (int i = 0; i < num_values; i++)
     {
         values[i] *= alpha;
     }
@@ -101,14 +101,14 @@ void Vector::scale(data_t alpha)
 *****
 ***** Parameters
 ***** -------------
-***** p : index_t
+***** p : int
 *****    Determines which p-norm to calculate
 **************************************************************/
-data_t Vector::norm(index_t p)
+data_t Vector::norm(int p)
 {
     data_t result = 0.0;
     double val;
-    for (index_t i = 0; i < num_values; i++)
+    for (int i = 0; i < num_values; i++)
     {
         val = values[i];
         if (fabs(val) > zero_tol)
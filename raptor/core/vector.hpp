@@ -14,7 +14,7 @@
 // -------------
 // values : std::vector<double>
 //    stl vector of vector values
-// size : index_t
+// size : int
 //    Dimension of vector
 //
 // Methods
@@ -28,7 +28,7 @@
 //    adds corresponding values from y
 // scale(data_t alpha)
 //    Multiplies entries of vector by a constant
-// norm(index_t p)
+// norm(int p)
 //    Calculates the p-norm of the vector
 // print()
 //    Prints the nonzero values and positions
@@ -48,7 +48,7 @@ public:
     *****
     ***** Parameters
     ***** -------------
-    ***** len : index_t
+    ***** len : int
     *****    Size of the vector
     **************************************************************/
     Vector(int len)
@@ -143,10 +143,10 @@ public:
     *****
     ***** Parameters
     ***** -------------
-    ***** p : index_t
+    ***** p : int
     *****    Determines which p-norm to calculate
      **************************************************************/
-    data_t norm(index_t p);
+    data_t norm(int p);
 
     /**************************************************************
     *****   Print Vector
@@ -186,7 +186,7 @@ public:
         return values.data();
     }
 
-    index_t size()
+    int size()
     {
         return num_values;
     }
@@ -194,7 +194,7 @@ public:
     data_t inner_product(Vector& x);
 
     std::vector<double> values;
-    index_t num_values;
+    int num_values;
 };
 
 }
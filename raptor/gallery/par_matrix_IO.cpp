@@ -32,9 +32,8 @@ ParCSRMatrix* readParMatrix(const char* filename,
 
     int64_t pos;
     int32_t code;
-    int32_t global_num_rows;
-    int32_t global_num_cols;
-    int32_t global_nnz;
+    index_t global_num_rows;
+    index_t global_num_cols;
     int32_t idx;
     int n_items_read;
     double val;
@@ -49,21 +48,23 @@ ParCSRMatrix* readParMatrix(const char* filename,
     FILE* ifile = fopen(filename, "rb");
     if (fseek(ifile, 0, SEEK_SET)) printf("Error seeking beginning of file\n"); 
     
-    // Read code, and determine if little endian, or if long int
+    // Read code, and determine if little endian.  The header is
+    // stored as int32, and widened to index_t once swapped (the
+    // global nnz in header[3] is recomputed from the row sizes)
     int32_t header[4];
     n_items_read = fread(header, sizeof_int32, 4, ifile);
     code = header[0];
-    global_num_rows = header[1];
-    global_num_cols = header[2];
-    global_nnz = header[3];
     if (code != PETSC_MAT_CODE)
     {
-        endian_swap(&code);
-        endian_swap(&global_num_rows);
-        endian_swap(&global_num_cols);
-        endian_swap(&global_nnz);
+        for (int i = 0; i < 4; i++)
+        {
+            endian_swap(&(header[i]));
+        }
+        code = header[0];
         is_little_endian = true;
     }
+    global_num_rows = header[1];
+    global_num_cols = header[2];
 
     if (first_local_col >= 0)
     {
@@ -79,10 +80,10 @@ ParCSRMatrix* readParMatrix(const char* filename,
     std::vector<int32_t> row_sizes;
     std::vector<int32_t> col_indices;
     std::vector<double> vals;
-    std::vector<int> proc_nnz(num_procs);
+    std::vector<index_t> proc_nnz(num_procs);
     if (A->local_num_rows)
         row_sizes.resize(A->local_num_rows);
-    int nnz = 0;
+    index_t nnz = 0;
 
     // Find row sizes
     pos = (4 + A->partition->first_local_row) * sizeof_int32;
@@ -110,11 +111,12 @@ ParCSRMatrix* readParMatrix(const char* filename,
     }
 
     // Find nnz per proc (to find first_nnz)
-    RAPtor_MPI_Allgather(&nnz, 1, RAPtor_MPI_INT, proc_nnz.data(), 1, RAPtor_MPI_INT, comm);
-    long first_nnz = 0;
+    RAPtor_MPI_Allgather(&nnz, 1, RAPtor_MPI_INDEX_T, proc_nnz.data(), 1, 
+            RAPtor_MPI_INDEX_T, comm);
+    int64_t first_nnz = 0;
     for (int i = 0; i < rank; i++)
         first_nnz += proc_nnz[i];
-    long total_nnz = first_nnz;
+    int64_t total_nnz = first_nnz;
     for (int i = rank; i < num_procs; i++)
         total_nnz += proc_nnz[i];
 
@@ -140,7 +142,7 @@ ParCSRMatrix* readParMatrix(const char* filename,
    
     if (is_little_endian)
     {
-        for (int i = 0; i < nnz; i++)
+        for (index_t i = 0; i < nnz; i++)
         {
             endian_swap(&(col_indices[i]));
             endian_swap(&(vals[i]));
@@ -159,8 +161,8 @@ ParCSRMatrix* readParMatrix(const char* filename,
         {
             idx = col_indices[ctr];
             val = vals[ctr++];
-            if ((int) idx >= A->partition->first_local_col &&
-                    (int) idx <= A->partition->last_local_col)
+            if (idx >= A->partition->first_local_col &&
+                    idx <= A->partition->last_local_col)
             {
                 A->on_proc->idx2.emplace_back(idx - A->partition->first_local_col);
                 A->on_proc->vals.emplace_back(val);
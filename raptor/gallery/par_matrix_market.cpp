@@ -16,18 +16,24 @@
 using namespace raptor;
 
 // Declare Private Methods
+void read_mm_chunk(FILE* f, long start, long end, std::vector<char>& buffer);
+bool parse_mm_entry(const char*& ptr, const char* end, index_t& row, 
+        index_t& col, double& val);
 void write_par_data(FILE* f, int n, int* rowptr, int* col_idx,
-        double* vals, int first_row, int* col_map);
+        double* vals, index_t first_row, index_t* col_map);
 
 ParCSRMatrix* read_par_mm(const char *fname)
 {
+    int rank, num_procs;
+    RAPtor_MPI_Comm_rank(RAPtor_MPI_COMM_WORLD, &rank);
+    RAPtor_MPI_Comm_size(RAPtor_MPI_COMM_WORLD, &num_procs);
+
     FILE *f;
     MM_typecode matcode;
     int M, N, nz;
-    int i;
-    int row, col;
-    int n_items_read;
+    index_t row, col;
     double val;
+    int proc;
  
     if ((f = fopen(fname, "r")) == NULL)
             return NULL;
@@ -58,88 +64,216 @@ ParCSRMatrix* read_par_mm(const char *fname)
         return NULL;
     }
  
-    int row_nnz = nz / M;
     ParCOOMatrix* A = new ParCOOMatrix(M, N);
-    A->on_proc->vals.reserve(row_nnz);
-    A->off_proc->vals.reserve(row_nnz);
-
-    /* NOTE: when reading in doubles, ANSI C requires the use of the "l"  */
-    /*   specifier as in "%lg", "%lf", "%le", otherwise errors will occur */
-    /*  (ANSI C X3.159-1989, Sec. 4.9.6.2, p. 136 lines 13-15)            */
- 
     bool symmetric = mm_is_symmetric(matcode);
-    bool row_local;
-    bool col_local;
-    for (i=0; i<nz; i++)
+
+    // Each process reads an equal byte range of the entries, and owns
+    // every line beginning in that range
+    long data_start = ftell(f);
+    if (fseek(f, 0, SEEK_END)) printf("Error seeking end of file\n");
+    long data_size = ftell(f) - data_start;
+    long first_byte = data_start + (data_size * rank) / num_procs;
+    long last_byte = data_start + (data_size * (rank + 1)) / num_procs;
+
+    // Read one byte early to see if first_byte begins a line
+    long read_start = first_byte;
+    if (first_byte > data_start) read_start--;
+    std::vector<char> buffer;
+    read_mm_chunk(f, read_start, last_byte, buffer);
+    fclose(f);
+    buffer.emplace_back('\0');
+
+    const char* ptr = buffer.data();
+    const char* buf_end = ptr + buffer.size() - 1;
+    const char* own_end = ptr + (last_byte - read_start);
+    if (read_start < first_byte)
+    {
+        while (ptr < buf_end && *ptr != '\n') ptr++;
+        if (ptr < buf_end) ptr++;
+    }
+
+    // Find owner of each entry (and its transpose if symmetric)
+    std::vector<index_t> first_rows(num_procs + 1);
+    RAPtor_MPI_Allgather(&(A->partition->first_local_row), 1, RAPtor_MPI_INDEX_T,
+            first_rows.data(), 1, RAPtor_MPI_INDEX_T, RAPtor_MPI_COMM_WORLD);
+    first_rows[num_procs] = M;
+
+    std::vector<int> proc_sizes(num_procs, 0);
+    std::vector<int> entry_procs;
+    std::vector<index_t> entry_rows;
+    std::vector<index_t> entry_cols;
+    std::vector<double> entry_vals;
+    int est_nnz = (symmetric ? 2 : 1) * (int)(((long) nz) / num_procs + 1);
+    entry_procs.reserve(est_nnz);
+    entry_rows.reserve(est_nnz);
+    entry_cols.reserve(est_nnz);
+    entry_vals.reserve(est_nnz);
+    while (ptr < own_end && ptr < buf_end)
     {
-        n_items_read = fscanf(f, "%d %d %lg\n", &row, &col, &val);
-        if (n_items_read == EOF) printf("EOF reading code\n");
+        if (!parse_mm_entry(ptr, buf_end, row, col, val))
+            continue;
         row--;
         col--;
-        if (row >= A->partition->first_local_row && row <= A->partition->last_local_row)
-        {
-            row_local = true;
-            row -= A->partition->first_local_row;
-        }
-        else
-        {
-            row_local = false;
-            if (!symmetric) 
-                continue;
-        }
-        if (col >= A->partition->first_local_col && col <= A->partition->last_local_col)
-        {
-            col_local = true;
-            col -= A->partition->first_local_col;
-        }
-        else
-        {
-            col_local = false;
-            if (!row_local) 
-                continue;
-        }
 
-        if (row_local)
-        {
-            if (col_local)
-            {
-                A->on_proc->add_value(row, col, val);
-            }
-            else
-            {
-                A->off_proc->add_value(row, col, val);
-            }
-        }
+        proc = std::upper_bound(first_rows.begin(), first_rows.end(), row) 
+            - first_rows.begin() - 1;
+        entry_procs.emplace_back(proc);
+        entry_rows.emplace_back(row);
+        entry_cols.emplace_back(col);
+        entry_vals.emplace_back(val);
+        proc_sizes[proc]++;
 
-        if (symmetric)
+        if (symmetric && row != col)
         {
-            if (col_local)
-            {
-                if (row_local)
-                {
-                    A->on_proc->add_value(col, row, val);
-                }
-                else
-                {
-                    A->off_proc->add_value(col, row, val);
-                }
-            }
+            proc = std::upper_bound(first_rows.begin(), first_rows.end(), col) 
+                - first_rows.begin() - 1;
+            entry_procs.emplace_back(proc);
+            entry_rows.emplace_back(col);
+            entry_cols.emplace_back(row);
+            entry_vals.emplace_back(val);
+            proc_sizes[proc]++;
         }
     }
+    std::vector<char>().swap(buffer);
+
+    // Order entries by owner, and exchange in a single all-to-all
+    int n_entries = entry_procs.size();
+    std::vector<int> send_displs(num_procs + 1);
+    std::vector<int> send_ctr(num_procs);
+    send_displs[0] = 0;
+    for (int i = 0; i < num_procs; i++)
+    {
+        send_displs[i+1] = send_displs[i] + proc_sizes[i];
+        send_ctr[i] = send_displs[i];
+    }
+    std::vector<index_t> send_rows(n_entries);
+    std::vector<index_t> send_cols(n_entries);
+    std::vector<double> send_vals(n_entries);
+    for (int i = 0; i < n_entries; i++)
+    {
+        int idx = send_ctr[entry_procs[i]]++;
+        send_rows[idx] = entry_rows[i];
+        send_cols[idx] = entry_cols[i];
+        send_vals[idx] = entry_vals[i];
+    }
+    std::vector<int>().swap(entry_procs);
+    std::vector<index_t>().swap(entry_rows);
+    std::vector<index_t>().swap(entry_cols);
+    std::vector<double>().swap(entry_vals);
+
+    std::vector<int> recv_sizes(num_procs);
+    std::vector<int> recv_displs(num_procs + 1);
+    RAPtor_MPI_Alltoall(proc_sizes.data(), 1, RAPtor_MPI_INT, recv_sizes.data(), 1,
+            RAPtor_MPI_INT, RAPtor_MPI_COMM_WORLD);
+    recv_displs[0] = 0;
+    for (int i = 0; i < num_procs; i++)
+    {
+        recv_displs[i+1] = recv_displs[i] + recv_sizes[i];
+    }
+    int n_recv = recv_displs[num_procs];
+    std::vector<index_t> recv_rows(n_recv);
+    std::vector<index_t> recv_cols(n_recv);
+    std::vector<double> recv_vals(n_recv);
+    RAPtor_MPI_Alltoallv(send_rows.data(), proc_sizes.data(), send_displs.data(),
+            RAPtor_MPI_INDEX_T, recv_rows.data(), recv_sizes.data(), recv_displs.data(),
+            RAPtor_MPI_INDEX_T, RAPtor_MPI_COMM_WORLD);
+    RAPtor_MPI_Alltoallv(send_cols.data(), proc_sizes.data(), send_displs.data(),
+            RAPtor_MPI_INDEX_T, recv_cols.data(), recv_sizes.data(), recv_displs.data(),
+            RAPtor_MPI_INDEX_T, RAPtor_MPI_COMM_WORLD);
+    RAPtor_MPI_Alltoallv(send_vals.data(), proc_sizes.data(), send_displs.data(),
+            RAPtor_MPI_DOUBLE, recv_vals.data(), recv_sizes.data(), recv_displs.data(),
+            RAPtor_MPI_DOUBLE, RAPtor_MPI_COMM_WORLD);
+
+    int row_nnz = A->local_num_rows ? n_recv / A->local_num_rows : 0;
+    A->on_proc->vals.reserve(row_nnz);
+    A->off_proc->vals.reserve(row_nnz);
+    for (int i = 0; i < n_recv; i++)
+    {
+        A->add_global_value(recv_rows[i], recv_cols[i], recv_vals[i]);
+    }
 
     A->finalize();
     ParCSRMatrix* A_csr = A->to_ParCSR();
     delete A;
-
-    fclose(f);
  
     return A_csr;
 }
 
+/**************************************************************
+*****   Read MM Chunk
+**************************************************************
+***** Reads bytes [start, end) of the file into buffer, followed
+***** by the remainder of the line containing byte end-1
+**************************************************************/
+void read_mm_chunk(FILE* f, long start, long end, std::vector<char>& buffer)
+{
+    const long chunk_size = 4096;
+    long size = end - start;
+    long n_read, line_end;
+
+    buffer.resize(size);
+    if (fseek(f, start, SEEK_SET)) printf("Error seeking pos\n");
+    size = fread(buffer.data(), 1, size, f);
+
+    while (size > 0 && buffer[size-1] != '\n')
+    {
+        buffer.resize(size + chunk_size);
+        n_read = fread(&(buffer[size]), 1, chunk_size, f);
+        if (n_read <= 0) break;
+
+        line_end = size;
+        while (line_end < size + n_read && buffer[line_end] != '\n')
+            line_end++;
+        if (line_end < size + n_read)
+            size = line_end + 1;
+        else
+            size += n_read;
+    }
+    buffer.resize(size);
+}
+
+/**************************************************************
+*****   Parse MM Entry
+**************************************************************
+***** Parses a "row col val" line starting at ptr, and advances
+***** ptr to the start of the following line.  Returns false
+***** for blank lines.  The buffer must be null-terminated.
+**************************************************************/
+bool parse_mm_entry(const char*& ptr, const char* end, index_t& row, 
+        index_t& col, double& val)
+{
+    char* val_end;
+
+    while (ptr < end && (*ptr == ' ' || *ptr == '\t')) ptr++;
+    if (ptr >= end || *ptr == '\n' || *ptr == '\r')
+    {
+        while (ptr < end && *ptr != '\n') ptr++;
+        if (ptr < end) ptr++;
+        return false;
+    }
+
+    row = 0;
+    while (*ptr >= '0' && *ptr <= '9')
+        row = row * 10 + (*ptr++ - '0');
+    while (*ptr == ' ' || *ptr == '\t') ptr++;
+
+    col = 0;
+    while (*ptr >= '0' && *ptr <= '9')
+        col = col * 10 + (*ptr++ - '0');
+
+    val = strtod(ptr, &val_end);
+    ptr = val_end;
+
+    while (ptr < end && *ptr != '\n') ptr++;
+    if (ptr < end) ptr++;
+    return true;
+}
+
 void write_par_data(FILE* f, int n, int* rowptr, int* col_idx,
-        double* vals, int first_row, int* col_map)
+        double* vals, index_t first_row, index_t* col_map)
 {
-    int start, end, global_row;
+    int start, end;
+    index_t global_row;
 
     for (int i = 0; i < n; i++)
     {
@@ -148,8 +282,9 @@ void write_par_data(FILE* f, int n, int* rowptr, int* col_idx,
         end = rowptr[i+1];
         for (int j = start; j < end; j++)
         {
-            fprintf(f, "%d %d %2.15e\n", global_row + 1, 
-                    col_map[col_idx[j]] + 1, vals[j]);
+            fprintf(f, "%" PRId64 " %" PRId64 " %2.15e\n", 
+                    (int64_t) global_row + 1, (int64_t) col_map[col_idx[j]] + 1, 
+                    vals[j]);
         }
     }
 }
@@ -164,15 +299,16 @@ void write_par_mm(ParCSRMatrix* A, const char *fname)
     FILE *f;
     MM_typecode matcode;
     int pos;
-    int int_bytes, double_bytes;
-    int num_ints, num_doubles;
+    int int_bytes, index_bytes, double_bytes;
+    int num_ints, num_indices, num_doubles;
     int comm_size;
 
     std::vector<char> buffer;
 
-    int nnz = A->local_nnz;
-    int global_nnz;
-    RAPtor_MPI_Reduce(&nnz, &global_nnz, 1, RAPtor_MPI_INT, RAPtor_MPI_SUM, 0, RAPtor_MPI_COMM_WORLD);
+    index_t nnz = A->local_nnz;
+    index_t global_nnz;
+    RAPtor_MPI_Reduce(&nnz, &global_nnz, 1, RAPtor_MPI_INDEX_T, RAPtor_MPI_SUM, 0, 
+            RAPtor_MPI_COMM_WORLD);
 
     std::vector<int> proc_dims(5*num_procs);
     int dims[5];
@@ -194,11 +330,13 @@ void write_par_mm(ParCSRMatrix* A, const char *fname)
 
         mm_write_banner(f, matcode);
         fprintf(f, "%%\n");
-        mm_write_mtx_crd_size(f, A->global_num_rows, A->global_num_cols,
-                global_nnz);
+        // Global sizes may exceed the int arguments of mm_write_mtx_crd_size
+        fprintf(f, "%" PRId64 " %" PRId64 " %" PRId64 "\n", 
+                (int64_t) A->global_num_rows, (int64_t) A->global_num_cols,
+                (int64_t) global_nnz);
 
         // Write local data
-        int first_row = 0;
+        index_t first_row = 0;
         write_par_data(f, A->local_num_rows, A->on_proc->idx1.data(),
                 A->on_proc->idx2.data(), A->on_proc->vals.data(),
                 first_row, A->on_proc_column_map.data());
@@ -212,16 +350,18 @@ void write_par_mm(ParCSRMatrix* A, const char *fname)
         std::vector<int> idx2;
         std::vector<double> vals;
         std::vector<int> row_map;
-        std::vector<int> col_map; 
+        std::vector<index_t> col_map; 
         for (int i = 1; i < num_procs; i++)
         {
             // Calculate comm_size and allocate recv_buf
             int* i_dims = &proc_dims[i*5];
-            num_ints = i_dims[0] * 2 + i_dims[1] + i_dims[3] + i_dims[3] + i_dims[4];
+            num_ints = i_dims[0] * 2 + i_dims[3] + i_dims[4];
+            num_indices = i_dims[1] + i_dims[2];
             num_doubles = i_dims[3] + i_dims[4];
             RAPtor_MPI_Pack_size(num_ints, RAPtor_MPI_INT, RAPtor_MPI_COMM_WORLD, &int_bytes);
+            RAPtor_MPI_Pack_size(num_indices, RAPtor_MPI_INDEX_T, RAPtor_MPI_COMM_WORLD, &index_bytes);
             RAPtor_MPI_Pack_size(num_doubles, RAPtor_MPI_DOUBLE, RAPtor_MPI_COMM_WORLD, &double_bytes);
-            comm_size = int_bytes + double_bytes;
+            comm_size = int_bytes + index_bytes + double_bytes;
             if ((int)buffer.size() < comm_size) buffer.resize(comm_size);
 
             // Resize Matrix Arrays
@@ -245,7 +385,7 @@ void write_par_mm(ParCSRMatrix* A, const char *fname)
             // Unpack On Proc Data
             pos = 0;
             RAPtor_MPI_Unpack(buffer.data(), comm_size, &pos, col_map.data(), i_dims[1],
-                    RAPtor_MPI_INT, RAPtor_MPI_COMM_WORLD);
+                    RAPtor_MPI_INDEX_T, RAPtor_MPI_COMM_WORLD);
             RAPtor_MPI_Unpack(buffer.data(), comm_size, &pos, idx1.data(), i_dims[0],
                     RAPtor_MPI_INT, RAPtor_MPI_COMM_WORLD);
             RAPtor_MPI_Unpack(buffer.data(), comm_size, &pos, idx2.data(), i_dims[3],
@@ -256,7 +396,7 @@ void write_par_mm(ParCSRMatrix* A, const char *fname)
                     vals.data(), first_row, col_map.data());
 
             RAPtor_MPI_Unpack(buffer.data(), comm_size, &pos, col_map.data(), i_dims[2],
-                    RAPtor_MPI_INT, RAPtor_MPI_COMM_WORLD);
+                    RAPtor_MPI_INDEX_T, RAPtor_MPI_COMM_WORLD);
             RAPtor_MPI_Unpack(buffer.data(), comm_size, &pos, idx1.data(), i_dims[0],
                     RAPtor_MPI_INT, RAPtor_MPI_COMM_WORLD);
             RAPtor_MPI_Unpack(buffer.data(), comm_size, &pos, idx2.data(), i_dims[4],
@@ -274,16 +414,18 @@ void write_par_mm(ParCSRMatrix* A, const char *fname)
     else // All processes that are not 0, send to 0
     {
         // Determine send size (in bytes)
-        num_ints = dims[0] * 2 + dims[1] + dims[3] + dims[3] + dims[4];
+        num_ints = dims[0] * 2 + dims[3] + dims[4];
+        num_indices = dims[1] + dims[2];
         num_doubles = dims[3] + dims[4];
         RAPtor_MPI_Pack_size(num_ints, RAPtor_MPI_INT, RAPtor_MPI_COMM_WORLD, &int_bytes);
+        RAPtor_MPI_Pack_size(num_indices, RAPtor_MPI_INDEX_T, RAPtor_MPI_COMM_WORLD, &index_bytes);
         RAPtor_MPI_Pack_size(num_doubles, RAPtor_MPI_DOUBLE, RAPtor_MPI_COMM_WORLD, &double_bytes);
-        comm_size = int_bytes + double_bytes;
+        comm_size = int_bytes + index_bytes + double_bytes;
         buffer.resize(comm_size);
 
         // Pack Data
         pos = 0;
-        RAPtor_MPI_Pack(A->on_proc_column_map.data(), dims[1], RAPtor_MPI_INT, buffer.data(), comm_size, 
+        RAPtor_MPI_Pack(A->on_proc_column_map.data(), dims[1], RAPtor_MPI_INDEX_T, buffer.data(), comm_size, 
                &pos, RAPtor_MPI_COMM_WORLD); 
         RAPtor_MPI_Pack(A->on_proc->idx1.data(), dims[0], RAPtor_MPI_INT, buffer.data(), comm_size,
                 &pos, RAPtor_MPI_COMM_WORLD);
@@ -292,7 +434,7 @@ void write_par_mm(ParCSRMatrix* A, const char *fname)
         RAPtor_MPI_Pack(A->on_proc->vals.data(), dims[3], RAPtor_MPI_DOUBLE, buffer.data(), comm_size,
                 &pos, RAPtor_MPI_COMM_WORLD);
         
-        RAPtor_MPI_Pack(A->off_proc_column_map.data(), dims[2], RAPtor_MPI_INT, buffer.data(), comm_size, 
+        RAPtor_MPI_Pack(A->off_proc_column_map.data(), dims[2], RAPtor_MPI_INDEX_T, buffer.data(), comm_size, 
                &pos, RAPtor_MPI_COMM_WORLD); 
         RAPtor_MPI_Pack(A->off_proc->idx1.data(), dims[0], RAPtor_MPI_INT, buffer.data(), comm_size,
                 &pos, RAPtor_MPI_COMM_WORLD);
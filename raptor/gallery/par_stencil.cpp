@@ -225,3 +225,218 @@ ParCSRMatrix* par_stencil_grid(data_t* stencil, int* grid, int dim)
 } 
 
 
+
+
+// First grid point and number of points of part i when n points
+// are split into p contiguous parts
+void box_range(int n, int p, int i, int& first, int& size)
+{
+    int avg = n / p;
+    int extra = n % p;
+    size = avg + (i < extra);
+    first = avg * i + (i < extra ? i : extra);
+}
+
+// Part (of p contiguous parts of n points) holding point c
+int box_part(int n, int p, int c)
+{
+    int avg = n / p;
+    int extra = n % p;
+    if (c < (avg + 1) * extra)
+    {
+        return c / (avg + 1);
+    }
+    return extra + (c - (avg + 1) * extra) / avg;
+}
+
+// Global index of the first row owned by the process at box
+// coordinates box_coords, with boxes in row-major order
+index_t box_first_row(int* grid, int* proc_grid, int dim,
+        const std::vector<int>& box_coords)
+{
+    int first, size;
+    index_t first_row = 0;
+    index_t block = 1;
+    for (int d = 0; d < dim; d++)
+    {
+        box_range(grid[d], proc_grid[d], box_coords[d], first, size);
+
+        // Rows of boxes before box_coords[d] in dimension d, among
+        // boxes equal to box_coords in dimensions before d
+        index_t before = block * first;
+        for (int e = d + 1; e < dim; e++)
+        {
+            before *= grid[e];
+        }
+        first_row += before;
+        block *= size;
+    }
+    return first_row;
+}
+
+void proc_box_grid(int num_procs, int* grid, int dim, int* proc_grid)
+{
+    std::vector<int> factors;
+    int n = num_procs;
+    for (int f = 2; f * f <= n; f++)
+    {
+        while (n % f == 0)
+        {
+            factors.emplace_back(f);
+            n /= f;
+        }
+    }
+    if (n > 1) factors.emplace_back(n);
+
+    // Give each prime factor (largest first) to the dimension with
+    // the most grid points per process
+    for (int d = 0; d < dim; d++)
+    {
+        proc_grid[d] = 1;
+    }
+    for (int i = factors.size() - 1; i >= 0; i--)
+    {
+        int max_d = 0;
+        for (int d = 1; d < dim; d++)
+        {
+            if (grid[d] * proc_grid[max_d] > grid[max_d] * proc_grid[d])
+            {
+                max_d = d;
+            }
+        }
+        proc_grid[max_d] *= factors[i];
+    }
+}
+
+ParCSRMatrix* par_stencil_grid(data_t* stencil, int* grid, int dim, int* proc_grid)
+{
+    // Get MPI Information
+    int rank, num_procs;
+    RAPtor_MPI_Comm_rank(RAPtor_MPI_COMM_WORLD, &rank);
+    RAPtor_MPI_Comm_size(RAPtor_MPI_COMM_WORLD, &num_procs);
+
+    int stencil_len, N_s, n_v;
+    int idx, tmp;
+    index_t N_v, first_row, col;
+    bool in_grid;
+
+    N_v = 1;
+    n_v = 1;
+    tmp = 1;
+    for (int d = 0; d < dim; d++)
+    {
+        N_v *= grid[d];
+        tmp *= proc_grid[d];
+    }
+    if (tmp != num_procs)
+    {
+        if (rank == 0)
+        {
+            printf("Processor grid does not match number of processes!\n");
+        }
+        exit(-1);
+    }
+
+    // Coordinates of this process's box (row-major over proc_grid),
+    // and its first point and extent in each dimension
+    std::vector<int> box_coords(dim);
+    std::vector<int> box_first(dim);
+    std::vector<int> box_size(dim);
+    tmp = rank;
+    for (int d = dim - 1; d >= 0; d--)
+    {
+        box_coords[d] = tmp % proc_grid[d];
+        tmp /= proc_grid[d];
+    }
+    for (int d = 0; d < dim; d++)
+    {
+        box_range(grid[d], proc_grid[d], box_coords[d], box_first[d], box_size[d]);
+        n_v *= box_size[d];
+    }
+    first_row = box_first_row(grid, proc_grid, dim, box_coords);
+
+    // Offsets (-1, 0, 1 in each dimension) of nonzero stencil entries
+    stencil_len = (int)pow(3, dim);
+    std::vector<int> offsets;
+    std::vector<double> nonzero_stencil;
+    for (int i = 0; i < stencil_len; i++)
+    {
+        if (fabs(stencil[i]) > zero_tol)
+        {
+            tmp = i;
+            for (int d = dim - 1; d >= 0; d--)
+            {
+                offsets.emplace_back((tmp % 3) - 1);
+                tmp /= 3;
+            }
+            std::reverse(offsets.end() - dim, offsets.end());
+            nonzero_stencil.emplace_back(stencil[i]);
+        }
+    }
+    N_s = nonzero_stencil.size();
+
+    ParCSRMatrix* A = new ParCSRMatrix(N_v, N_v, n_v, n_v, first_row, first_row);
+    A->on_proc->idx2.reserve(n_v*N_s);
+    A->on_proc->vals.reserve(n_v*N_s);
+
+    // Rows are the points of the box in row-major order
+    std::vector<int> point(dim);
+    std::vector<int> nbr(dim);
+    std::vector<int> nbr_box(dim);
+    std::vector<int> nbr_first(dim);
+    std::vector<int> nbr_size(dim);
+    for (int d = 0; d < dim; d++)
+    {
+        point[d] = box_first[d];
+    }
+    A->on_proc->idx1[0] = 0;
+    A->off_proc->idx1[0] = 0;
+    for (int i = 0; i < n_v; i++)
+    {
+        for (int s = 0; s < N_s; s++)
+        {
+            // Zero boundary conditions
+            in_grid = true;
+            for (int d = 0; d < dim; d++)
+            {
+                nbr[d] = point[d] + offsets[s*dim + d];
+                if (nbr[d] < 0 || nbr[d] >= grid[d])
+                {
+                    in_grid = false;
+                    break;
+                }
+            }
+            if (!in_grid) continue;
+
+            // Global row of neighbor, within the box that holds it
+            for (int d = 0; d < dim; d++)
+            {
+                nbr_box[d] = box_part(grid[d], proc_grid[d], nbr[d]);
+                box_range(grid[d], proc_grid[d], nbr_box[d], nbr_first[d], nbr_size[d]);
+            }
+            idx = 0;
+            for (int d = 0; d < dim; d++)
+            {
+                idx = idx * nbr_size[d] + (nbr[d] - nbr_first[d]);
+            }
+            col = box_first_row(grid, proc_grid, dim, nbr_box) + idx;
+            A->add_value(i, col, nonzero_stencil[s]);
+        }
+        A->on_proc->idx1[i+1] = A->on_proc->idx2.size();
+        A->off_proc->idx1[i+1] = A->off_proc->idx2.size();
+
+        // Next point of box
+        for (int d = dim - 1; d >= 0; d--)
+        {
+            if (++point[d] < box_first[d] + box_size[d]) break;
+            point[d] = box_first[d];
+        }
+    }
+
+    A->on_proc->nnz = A->on_proc->idx2.size();
+    A->off_proc->nnz = A->off_proc->idx2.size();
+
+    A->finalize();
+
+    return A;
+}
@@ -15,6 +15,35 @@ using namespace raptor;
 
 ParCSRMatrix* par_stencil_grid(data_t* stencil, int* grid, int dim);
 
+/**************************************************************
+ *****   Box Partitioned Stencil Grid
+ **************************************************************
+ ***** Forms the same operator as par_stencil_grid, but splits
+ ***** the grid into a proc_grid[0] x ... x proc_grid[dim-1] grid
+ ***** of boxes, one per process (in row-major order over
+ ***** proc_grid).  Rows are renumbered so that each process owns
+ ***** a contiguous range of rows: the points of its box, in
+ ***** row-major order.
+ *****
+ ***** Parameters
+ ***** -------------
+ ***** stencil : data_t*
+ *****    Stencil of 3^dim entries
+ ***** grid : int*
+ *****    Number of points in each dimension
+ ***** dim : int
+ *****    Number of dimensions
+ ***** proc_grid : int*
+ *****    Number of processes in each dimension (product must
+ *****    equal the number of processes)
+ **************************************************************/
+ParCSRMatrix* par_stencil_grid(data_t* stencil, int* grid, int dim, int* proc_grid);
+
+// Factors num_procs into proc_grid, giving the processes to the
+// dimensions with the most grid points per process so that boxes
+// are as close to cubes as possible
+void proc_box_grid(int num_procs, int* grid, int dim, int* proc_grid);
+
 #endif
 
 
@@ -96,3 +96,96 @@ TEST(ParLaplacianTest, TestsInGallery)
 
 } // end of TEST(ParLaplacianTest, TestsInGallery) //
 
+
+TEST(ParLaplacianBoxTest, TestsInGallery)
+{
+    int rank, num_procs;
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &num_procs);
+
+    int grid[3] = {10, 10, 10};
+    int proc_grid[3];
+    double* stencil = laplace_stencil_27pt();
+
+    proc_box_grid(num_procs, grid, 3, proc_grid);
+    ASSERT_EQ(proc_grid[0] * proc_grid[1] * proc_grid[2], num_procs);
+
+    ParCSRMatrix* A_sten = par_stencil_grid(stencil, grid, 3);
+    ParCSRMatrix* A_box = par_stencil_grid(stencil, grid, 3, proc_grid);
+    ASSERT_EQ(A_box->global_num_rows, A_sten->global_num_rows);
+    ASSERT_EQ(A_box->global_num_cols, A_sten->global_num_cols);
+
+    // Box of this process (row-major over proc_grid)
+    int box_first[3], box_size[3];
+    int tmp = rank;
+    for (int d = 2; d >= 0; d--)
+    {
+        int p = tmp % proc_grid[d];
+        tmp /= proc_grid[d];
+        int avg = grid[d] / proc_grid[d];
+        int extra = grid[d] % proc_grid[d];
+        box_size[d] = avg + (p < extra);
+        box_first[d] = avg * p + (p < extra ? p : extra);
+    }
+    ASSERT_EQ(A_box->local_num_rows, box_size[0] * box_size[1] * box_size[2]);
+
+    // Row of the standard (lexicographic) ordering for each local box row
+    std::vector<int> orig_rows(A_box->local_num_rows);
+    int ctr = 0;
+    for (int i = 0; i < box_size[0]; i++)
+    {
+        for (int j = 0; j < box_size[1]; j++)
+        {
+            for (int k = 0; k < box_size[2]; k++)
+            {
+                orig_rows[ctr++] = ((box_first[0] + i) * grid[1] + (box_first[1] + j))
+                    * grid[2] + (box_first[2] + k);
+            }
+        }
+    }
+
+    // A_box is A_sten with rows and columns renumbered, so the products
+    // with the same grid function must agree
+    ParVector x(A_sten->global_num_rows, A_sten->local_num_rows);
+    ParVector b(A_sten->global_num_rows, A_sten->local_num_rows);
+    ParVector x_box(A_box->global_num_rows, A_box->local_num_rows);
+    ParVector b_box(A_box->global_num_rows, A_box->local_num_rows);
+    for (int i = 0; i < A_sten->local_num_rows; i++)
+    {
+        x.local.values[i] = sin(A_sten->partition->first_local_row + i);
+    }
+    for (int i = 0; i < A_box->local_num_rows; i++)
+    {
+        x_box.local.values[i] = sin(orig_rows[i]);
+    }
+    A_sten->mult(x, b);
+    A_box->mult(x_box, b_box);
+
+    std::vector<int> sizes(num_procs);
+    std::vector<int> displs(num_procs);
+    MPI_Allgather(&A_sten->local_num_rows, 1, MPI_INT, sizes.data(), 1, MPI_INT,
+            MPI_COMM_WORLD);
+    displs[0] = 0;
+    for (int i = 1; i < num_procs; i++)
+    {
+        displs[i] = displs[i-1] + sizes[i-1];
+    }
+    std::vector<double> b_all(A_sten->global_num_rows);
+    MPI_Allgatherv(b.local.values.data(), A_sten->local_num_rows, MPI_DOUBLE,
+            b_all.data(), sizes.data(), displs.data(), MPI_DOUBLE, MPI_COMM_WORLD);
+    for (int i = 0; i < A_box->local_num_rows; i++)
+    {
+        ASSERT_NEAR(b_box.local.values[i], b_all[orig_rows[i]], 1e-10);
+    }
+
+    int nnz = A_box->local_nnz;
+    int nnz_sten = A_sten->local_nnz;
+    MPI_Allreduce(MPI_IN_PLACE, &nnz, 1, MPI_INT, MPI_SUM, MPI_COMM_WORLD);
+    MPI_Allreduce(MPI_IN_PLACE, &nnz_sten, 1, MPI_INT, MPI_SUM, MPI_COMM_WORLD);
+    ASSERT_EQ(nnz, nnz_sten);
+
+    delete A_box;
+    delete A_sten;
+    delete[] stencil;
+
+} // end of TEST(ParLaplacianBoxTest, TestsInGallery) //
@@ -48,3 +48,37 @@ TEST(ParAnisoTest, TestsInGallery)
  } // end of TEST(ParAnisoTest, TestsInGallery) //
 
 
+TEST(ParMatrixMarketTest, TestsInGallery)
+{
+    // Symmetric file: compare with local rows of the stored entries
+    // (and their transposes), read sequentially on every process
+    const char* f_mm = "../../../../test_data/aniso.mtx";
+
+    ParCSRMatrix* Amm = read_par_mm(f_mm);
+    CSRMatrix* A_seq = read_mm(f_mm);
+
+    ParCOOMatrix* A_coo = new ParCOOMatrix(A_seq->n_rows, A_seq->n_cols);
+    for (int i = 0; i < A_seq->n_rows; i++)
+    {
+        for (int j = A_seq->idx1[i]; j < A_seq->idx1[i+1]; j++)
+        {
+            int col = A_seq->idx2[j];
+            if (i >= A_coo->partition->first_local_row 
+                    && i <= A_coo->partition->last_local_row)
+                A_coo->add_global_value(i, col, A_seq->vals[j]);
+            if (col != i && col >= A_coo->partition->first_local_row
+                    && col <= A_coo->partition->last_local_row)
+                A_coo->add_global_value(col, i, A_seq->vals[j]);
+        }
+    }
+    A_coo->finalize();
+    ParCSRMatrix* A = A_coo->to_ParCSR();
+    compare(Amm, A);
+
+    delete A;
+    delete A_coo;
+    delete A_seq;
+    delete Amm;
+
+} // end of TEST(ParMatrixMarketTest, TestsInGallery) //
+
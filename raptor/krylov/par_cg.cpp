@@ -262,3 +262,355 @@ if (comm_t) *comm_t += RAPtor_MPI_Wtime();
     return;
 }
 
+/**************************************************************
+ *****   Pipelined Preconditioned CG
+ **************************************************************
+ ***** Ghysels-Vanroose pipelined PCG.  Both inner products of
+ ***** an iteration, (r, u) and (w, u), are reduced together in
+ ***** a single non-blocking allreduce, which completes while
+ ***** the preconditioner and SpMV of the same iteration run.
+ ***** Equivalent to PCG in exact arithmetic, at the cost of 
+ ***** five extra work vectors and a few more axpys.  
+ *****
+ ***** Parameters
+ ***** -------------
+ ***** A : ParCSRMatrix*
+ *****    Matrix of the linear system
+ ***** ml : ParMultilevel*
+ *****    Preconditioner (already setup)
+ ***** x : ParVector&
+ *****    Initial guess, will contain solution
+ ***** b : ParVector&
+ *****    Right-hand side
+ ***** res : std::vector<double>&
+ *****    Preconditioned residual (r, M^{-1}r) / (b, M^{-1}b)
+ *****    of each iteration
+ **************************************************************/
+void PipelinedPCG(ParCSRMatrix* A, ParMultilevel* ml, ParVector& x, ParVector& b, 
+        std::vector<double>& res, double tol, int max_iter, double* precond_t, 
+        double* comm_t)
+{
+    int rank;
+    RAPtor_MPI_Comm_rank(RAPtor_MPI_COMM_WORLD, &rank);
+
+    ParVector r(b.global_n, b.local_n);  // residual
+    ParVector u(b.global_n, b.local_n);  // M^{-1} r
+    ParVector w(b.global_n, b.local_n);  // A u
+    ParVector m(b.global_n, b.local_n);  // M^{-1} w
+    ParVector n(b.global_n, b.local_n);  // A m
+    ParVector p(b.global_n, b.local_n);  // search direction
+    ParVector s(b.global_n, b.local_n);  // A p
+    ParVector q(b.global_n, b.local_n);  // M^{-1} s
+    ParVector z(b.global_n, b.local_n);  // A q
+
+    int iter;
+    data_t alpha, beta;
+    data_t gamma, gamma_old, delta;
+    data_t b_inner;
+    data_t inner[2];
+    double norm_b;
+    RAPtor_MPI_Request request;
+
+    if (max_iter <= 0)
+    {
+        max_iter = ((int)(1.3*b.global_n)) + 2;
+    }
+
+    // Initial b_norm (preconditioned)
+    u.set_const_value(0.0);
+if (precond_t) *precond_t -= RAPtor_MPI_Wtime();
+    ml->cycle(u, b);
+if (precond_t) *precond_t += RAPtor_MPI_Wtime();
+if (comm_t) *comm_t -= RAPtor_MPI_Wtime();
+    b_inner = b.inner_product(u);
+if (comm_t) *comm_t += RAPtor_MPI_Wtime();
+    norm_b = sqrt(b_inner);
+    if (norm_b > zero_tol)
+    {
+        tol = tol * norm_b;
+    }
+
+    // r0 = b - A * x0, u0 = M^{-1}r0, w0 = A * u0
+    A->residual(x, b, r);
+    u.set_const_value(0.0);
+if (precond_t) *precond_t -= RAPtor_MPI_Wtime();
+    ml->cycle(u, r);
+if (precond_t) *precond_t += RAPtor_MPI_Wtime();
+    A->mult(u, w);
+
+    p.set_const_value(0.0);
+    s.set_const_value(0.0);
+    q.set_const_value(0.0);
+    z.set_const_value(0.0);
+
+    alpha = 0.0;
+    gamma_old = 0.0;
+    iter = 0;
+
+    // Main Pipelined CG Loop
+    while (iter < max_iter)
+    {
+        // gamma_i = (r_i, u_i), delta_i = (w_i, u_i)
+        inner[0] = 0.0;
+        inner[1] = 0.0;
+        if (b.local_n)
+        {
+            inner[0] = r.local.inner_product(u.local);
+            inner[1] = w.local.inner_product(u.local);
+        }
+        RAPtor_MPI_Iallreduce(RAPtor_MPI_IN_PLACE, inner, 2, RAPtor_MPI_DATA_T,
+                RAPtor_MPI_SUM, RAPtor_MPI_COMM_WORLD, &request);
+
+        // m_i = M^{-1}w_i, n_i = A * m_i, while the reduction is in flight
+        m.set_const_value(0.0);
+if (precond_t) *precond_t -= RAPtor_MPI_Wtime();
+        ml->cycle(m, w);
+if (precond_t) *precond_t += RAPtor_MPI_Wtime();
+        A->mult(m, n);
+
+if (comm_t) *comm_t -= RAPtor_MPI_Wtime();
+        RAPtor_MPI_Wait(&request, RAPtor_MPI_STATUS_IGNORE);
+if (comm_t) *comm_t += RAPtor_MPI_Wtime();
+        gamma = inner[0];
+        delta = inner[1];
+
+        res.emplace_back(gamma / b_inner);
+        if (gamma < tol) break;
+
+        if (delta < 0.0)
+        {
+            if (rank == 0)
+            {
+                printf("Indefinite matrix detected in CG! Aborting...\n");
+            }
+            exit(-1);
+        }
+
+        if (iter > 0)
+        {
+            beta = gamma / gamma_old;
+            alpha = gamma / (delta - beta * gamma / alpha);
+        }
+        else
+        {
+            beta = 0.0;
+            alpha = gamma / delta;
+        }
+
+        // z = n + beta*z, q = m + beta*q, s = w + beta*s, p = u + beta*p
+        z.scale(beta);
+        z.axpy(n, 1.0);
+        q.scale(beta);
+        q.axpy(m, 1.0);
+        s.scale(beta);
+        s.axpy(w, 1.0);
+        p.scale(beta);
+        p.axpy(u, 1.0);
+
+        // x += alpha*p, r -= alpha*s, u -= alpha*q, w -= alpha*z
+        x.axpy(p, alpha);
+        r.axpy(s, -1.0*alpha);
+        u.axpy(q, -1.0*alpha);
+        w.axpy(z, -1.0*alpha);
+
+        gamma_old = gamma;
+        iter++;
+    }
+
+    if (rank == 0)
+    {
+        if (iter == max_iter)
+        {
+            printf("Max Iterations Reached.\n");
+        }
+        else
+        {
+            printf("%d Iteration required to converge\n", iter);
+        }
+        printf("Relative Residual: %lg\n\n", res.back());
+    }
+
+    return;
+}
+
+/**************************************************************
+ *****   Preconditioned CG (Multiple Right-Hand Sides)
+ **************************************************************
+ ***** Runs an independent PCG iteration for each vector of the
+ ***** block, sharing each SpMM, preconditioner cycle, and inner
+ ***** product reduction across all right-hand sides.  Vectors
+ ***** stop updating once converged; iteration ends when every 
+ ***** vector has converged.  res holds the largest residual.
+ **************************************************************/
+void PCG(ParCSRMatrix* A, ParMultilevel* ml, ParMultiVector& x, 
+        ParMultiVector& b, std::vector<double>& res, double tol, int max_iter, 
+        double* precond_t, double* comm_t)
+{
+    int rank;
+    RAPtor_MPI_Comm_rank(RAPtor_MPI_COMM_WORLD, &rank);
+
+    int n_vecs = b.n_vecs;
+    ParMultiVector r(b.global_n, b.local_n, n_vecs);
+    ParMultiVector z(b.global_n, b.local_n, n_vecs);
+    ParMultiVector p(b.global_n, b.local_n, n_vecs);
+    ParMultiVector Ap(b.global_n, b.local_n, n_vecs);
+
+    int iter, num_active;
+    int recompute_r;
+    bool full_r;
+    double max_res;
+    std::vector<data_t> alphas(n_vecs), betas(n_vecs), tols(n_vecs);
+    std::vector<data_t> b_inner, rz_inner, next_inner, App_inner;
+    std::vector<bool> active(n_vecs, true);
+
+    if (max_iter <= 0)
+    {
+        max_iter = ((int)(1.3*b.global_n)) + 2;
+    }
+
+    // Initial b_norm (preconditioned)
+    z.set_const_value(0.0);
+if (precond_t) *precond_t -= RAPtor_MPI_Wtime();
+    ml->cycle(z, b);
+if (precond_t) *precond_t += RAPtor_MPI_Wtime();
+if (comm_t) *comm_t -= RAPtor_MPI_Wtime();
+    b.inner_product(z, b_inner);
+if (comm_t) *comm_t += RAPtor_MPI_Wtime();
+    for (int v = 0; v < n_vecs; v++)
+    {
+        double norm_b = sqrt(b_inner[v]);
+        tols[v] = tol;
+        if (norm_b > zero_tol)
+        {
+            tols[v] = tol * norm_b;
+        }
+    }
+
+    // r0 = b - A * x0
+    A->residual(x, b, r);
+
+    // z = M^{-1}r0
+    z.set_const_value(0.0);
+if (precond_t) *precond_t -= RAPtor_MPI_Wtime();
+    ml->cycle(z, r);
+if (precond_t) *precond_t += RAPtor_MPI_Wtime();
+
+    // p0 = z0
+    p.copy(z);
+
+    // <r, z>
+if (comm_t) *comm_t -= RAPtor_MPI_Wtime();
+    r.inner_product(z, rz_inner);
+if (comm_t) *comm_t += RAPtor_MPI_Wtime();
+    max_res = 0;
+    for (int v = 0; v < n_vecs; v++)
+    {
+        max_res = std::max(max_res, sqrt(rz_inner[v]));
+    }
+    res.emplace_back(max_res);
+
+    recompute_r = 8;
+    iter = 0;
+
+    // Main CG Loop
+    while (iter < max_iter)
+    {
+        iter++;
+
+        // alpha_i = (r_i, z_i) / (A*p_i, p_i)
+        A->mult(p, Ap);
+if (comm_t) *comm_t -= RAPtor_MPI_Wtime();
+        Ap.inner_product(p, App_inner);
+if (comm_t) *comm_t += RAPtor_MPI_Wtime();
+        for (int v = 0; v < n_vecs; v++)
+        {
+            alphas[v] = 0.0;
+            if (!active[v]) continue;
+            if (App_inner[v] < 0.0)
+            {
+                if (rank == 0)
+                {
+                    printf("Indefinite matrix detected in CG! Aborting...\n");
+                }
+                exit(-1);
+            }
+            alphas[v] = rz_inner[v] / App_inner[v];
+        }
+
+        // x_{i+1} = x_i + alpha_i * p_i
+        x.axpy(p, alphas);
+
+        full_r = recompute_r && iter % recompute_r == 0;
+
+        if (full_r)
+        {
+            A->residual(x, b, r);
+        }
+        else
+        {
+            for (int v = 0; v < n_vecs; v++)
+            {
+                alphas[v] *= -1.0;
+            }
+            r.axpy(Ap, alphas);
+        }
+
+        // z_{j+1} = M^{-1}r_{j+1}
+        z.set_const_value(0.0);
+if (precond_t) *precond_t -= RAPtor_MPI_Wtime();
+        ml->cycle(z, r);
+if (precond_t) *precond_t += RAPtor_MPI_Wtime();
+
+        // beta_i = (r_{i+1}, z_{i+1}) / (r_i, z_i)
+if (comm_t) *comm_t -= RAPtor_MPI_Wtime();
+        r.inner_product(z, next_inner);
+if (comm_t) *comm_t += RAPtor_MPI_Wtime();
+
+        max_res = 0;
+        num_active = 0;
+        for (int v = 0; v < n_vecs; v++)
+        {
+            betas[v] = 0.0;
+            if (!active[v]) continue;
+            max_res = std::max(max_res, next_inner[v] / b_inner[v]);
+            if (next_inner[v] < tols[v])
+            {
+                active[v] = false;
+                continue;
+            }
+            betas[v] = next_inner[v] / rz_inner[v];
+            num_active++;
+        }
+        res.emplace_back(max_res);
+        if (num_active == 0) break;
+
+        // p_{i+1} = z_{i+1} + beta_i * p_i
+        if (full_r)
+        {
+            p.copy(z);
+        }
+        else
+        {
+            p.scale(betas);
+            p.axpy(z, 1.0);
+        }
+
+        // Update next inner product
+        rz_inner = next_inner;
+    }
+
+    if (rank == 0)
+    {
+        if (iter == max_iter)
+        {
+            printf("Max Iterations Reached.\n");
+        }
+        else
+        {
+            printf("%d Iteration required to converge\n", iter);
+        }
+        printf("Relative Residual: %lg\n\n", res[iter-1]);
+    }
+
+    return;
+}
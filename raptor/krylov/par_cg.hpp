@@ -14,5 +14,11 @@ void CG(ParCSRMatrix* A, ParVector& x, ParVector& b, std::vector<double>& res,
 void PCG(ParCSRMatrix* A, ParMultilevel* ml, ParVector& x, ParVector& b, 
         std::vector<double>& res, double tol = 1e-05, int max_iter = -1,
         double* precond_t = NULL, double* comm_t = NULL);
+void PipelinedPCG(ParCSRMatrix* A, ParMultilevel* ml, ParVector& x, 
+        ParVector& b, std::vector<double>& res, double tol = 1e-05, 
+        int max_iter = -1, double* precond_t = NULL, double* comm_t = NULL);
+void PCG(ParCSRMatrix* A, ParMultilevel* ml, ParMultiVector& x, 
+        ParMultiVector& b, std::vector<double>& res, double tol = 1e-05, 
+        int max_iter = -1, double* precond_t = NULL, double* comm_t = NULL);
 
 #endif
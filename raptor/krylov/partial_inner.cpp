@@ -140,7 +140,7 @@ data_t sequential_inner(ParVector &x, ParVector &y){
 /***************************************************************** 
  Performs sequential vector norm with parallel vector 
  ****************************************************************/
-data_t sequential_norm(ParVector &x, index_t p){
+data_t sequential_norm(ParVector &x, int p){
     int rank, num_procs;
     RAPtor_MPI_Comm_rank(RAPtor_MPI_COMM_WORLD, &rank);
     RAPtor_MPI_Comm_size(RAPtor_MPI_COMM_WORLD, &num_procs);
@@ -19,6 +19,6 @@ data_t partial_inner(RAPtor_MPI_Comm &inner_comm, RAPtor_MPI_Comm &root_comm, Pa
                      int send_color, int inner_root, int procs_in_group, int part_global);
 
 data_t sequential_inner(ParVector &x, ParVector &y);
-data_t sequential_norm(ParVector &x, index_t p);
+data_t sequential_norm(ParVector &x, int p);
 
 #endif
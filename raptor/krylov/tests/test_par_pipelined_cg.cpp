@@ -0,0 +1,65 @@
+// Copyright (c) 2015-2017, RAPtor Developer Team
+// License: Simplified BSD, http://opensource.org/licenses/BSD-2-Clause
+
+#include "gtest/gtest.h"
+#include "raptor.hpp"
+
+using namespace raptor;
+
+int main(int argc, char** argv)
+{
+    MPI_Init(&argc, &argv);
+    ::testing::InitGoogleTest(&argc, argv);
+    int temp=RUN_ALL_TESTS();
+    MPI_Finalize();
+    return temp;
+} // end of main() //
+
+TEST(ParPipelinedCGTest, TestsInKrylov)
+{
+    int grid[2] = {50, 50};
+    double* stencil = diffusion_stencil_2d(0.001, M_PI/8.0);
+    ParCSRMatrix* A = par_stencil_grid(stencil, grid, 2);
+    delete[] stencil;
+
+    ParVector x(A->global_num_rows, A->local_num_rows);
+    ParVector x_pipe(A->global_num_rows, A->local_num_rows);
+    ParVector b(A->global_num_rows, A->local_num_rows);
+    std::vector<double> res;
+    std::vector<double> res_pipe;
+
+    ParMultilevel* ml = new ParRugeStubenSolver(0.25, Falgout, ModClassical, 
+            Classical, SSOR);
+    ml->setup(A);
+
+    x.set_const_value(1.0);
+    A->mult(x, b);
+    x.set_const_value(0.0);
+    x_pipe.set_const_value(0.0);
+
+    PCG(A, ml, x, b, res, 1e-10);
+    PipelinedPCG(A, ml, x_pipe, b, res_pipe, 1e-10);
+
+    // Both track (r, M^{-1}r) / (b, M^{-1}b), which agree up to
+    // rounding (SSOR keeps the V-cycle symmetric)
+    int n_iter = res.size() - 1;
+    int n_iter_pipe = res_pipe.size() - 1;
+    ASSERT_LE(abs(n_iter - n_iter_pipe), 1);
+    for (int i = 1; i < std::min(n_iter, n_iter_pipe); i++)
+    {
+        ASSERT_NEAR(res[i] / res_pipe[i], 1.0, 1e-6);
+    }
+    ASSERT_LT(res_pipe.back(), 1e-10);
+
+    // Both converge to the solution of all ones
+    for (int i = 0; i < A->local_num_rows; i++)
+    {
+        ASSERT_NEAR(x_pipe[i], 1.0, 1e-4);
+        ASSERT_NEAR(x_pipe[i], x[i], 1e-6);
+    }
+
+    delete ml;
+    delete A;
+    
+} // end of TEST(ParPipelinedCGTest, TestsInKrylov) //
+
@@ -7,6 +7,11 @@ int main(int argc, char* argv[])
 {
     MPI_Init(&argc, &argv);
 
+#ifdef USING_OPENMP
+    // Compare against serial (single thread) results
+    omp_set_num_threads(1);
+#endif
+
     int rank, num_procs;
     MPI_Comm_rank(MPI_COMM_WORLD, &rank);
     MPI_Comm_size(MPI_COMM_WORLD, &num_procs);
@@ -21,6 +21,12 @@ namespace raptor
                 P = NULL;
                 AP = NULL;
                 I = NULL;
+                S = NULL;
+                AP_plan = NULL;
+                Ac_plan = NULL;
+                n_aggs = 0;
+                agglomerated = false;
+                rho = 0.0;
             }
 
             ~ParLevel()
@@ -28,8 +34,21 @@ namespace raptor
                 delete A;
                 delete P;
 
-                delete AP;
                 delete I;
+
+                delete S;
+
+                delete_plans();
+            }
+
+            void delete_plans()
+            {
+                delete AP;
+                delete AP_plan;
+                delete Ac_plan;
+                AP = NULL;
+                AP_plan = NULL;
+                Ac_plan = NULL;
             }
 
             ParCSRMatrix* A;
@@ -37,9 +56,34 @@ namespace raptor
             ParVector x;
             ParVector b;
             ParVector tmp;
+            // Work vectors for cycling on multiple right-hand sides,
+            // sized on first use by ParMultilevel::cycle
+            ParMultiVector multi_x;
+            ParMultiVector multi_b;
+            ParMultiVector multi_tmp;
 
             ParCSRMatrix* AP;
             ParCSRMatrix* I;
+
+            // Setup data kept for ParMultilevel::resetup()
+            ParCSRMatrix* S;
+            std::vector<int> states;
+            std::vector<int> off_proc_states;
+            std::vector<int> aggregates;
+            int n_aggs;
+
+            // Symbolic products A*P (into AP) and P^T*(AP), reused by
+            // resetup while the pattern of P is unchanged
+            ParSpGEMMPlan* AP_plan;
+            ParSpGEMMPlan* Ac_plan;
+
+            // Rows of A were gathered onto fewer processes
+            // (see ParMultilevel::agglomerate_level)
+            bool agglomerated;
+
+            // Spectral radius estimate of D^{-1}A, formed during setup
+            // for Chebyshev relaxation
+            double rho;
     };
 }
 #endif
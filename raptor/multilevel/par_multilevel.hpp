@@ -10,6 +10,9 @@
 #include "util/linalg/par_relax.hpp"
 #include "ruge_stuben/par_interpolation.hpp"
 #include "ruge_stuben/par_cf_splitting.hpp"
+#include "util/linalg/repartition.hpp"
+#include "util/linalg/sparse_lu.hpp"
+#include "multilevel/par_sparsify.hpp"
 
 #ifdef USING_HYPRE
 #include "_hypre_utilities.h"
@@ -41,27 +44,61 @@
  *****      - Direct 
  *****      - Classical (modified classical interpolation)
  *****      - Extended (extended + i interpolation)
+ *****      - Multipass (used on aggressive levels)
  ***** relax_type : relax_t (default SOR)
  *****    Relaxation scheme used in every cycle of solve phase.
  *****    Options are:
  *****      - Jacobi: weighted jacobi for both on and off proc
  *****      - SOR: weighted jacobi off_proc, SOR on_proc
  *****      - SSOR : weighted jacobi off_proc, SSOR on_proc
+ *****      - L1Jacobi : jacobi scaled by l1 row norms
+ *****      - Chebyshev : Chebyshev polynomial in D^{-1}A, using
+ *****        the spectral radius of each level estimated in setup
  ***** num_smooth_sweeps : int (defualt 1)
  *****    Number of relaxation sweeps (both pre and post smoothing)
  *****    to be performed during each cycle of the AMG solve.
  ***** relax_weight : double
- *****    Weight used in Jacobi, SOR, or SSOR
+ *****    Weight used in Jacobi, SOR, SSOR, or L1Jacobi
+ ***** chebyshev_degree : int (default 2)
+ *****    Degree of the Chebyshev polynomial (typically 2 to 4)
+ ***** chebyshev_lower : double (default 0.3)
+ ***** chebyshev_upper : double (default 1.1)
+ *****    Fractions of the estimated spectral radius of D^{-1}A
+ *****    bounding the eigenvalues damped by Chebyshev relaxation
+ ***** spectral_radius_iterations : int (default 10)
+ *****    Lanczos iterations used to estimate the spectral radius
+ *****    (for Chebyshev relaxation and SpectralJacobiProlongation)
  ***** max_coarse : int (default 50)
  *****    Maximum global num rows allowed in coarsest matrix
  ***** max_levels : int (default -1)
  *****    Maximum number of levels in hierarchy, or no maximum if -1
+ ***** agglomerate_rows : int (default 0)
+ *****    Coarse levels averaging fewer than agglomerate_rows rows per
+ *****    active process are gathered onto fewer processes (0 disables)
+ ***** sparsify_tol : double (default 0.0)
+ *****    If positive, coarse operators of C/F splitting hierarchies
+ *****    are non-Galerkin: entries of P^T*A*P outside the minimal
+ *****    pattern and smaller than sparsify_tol times the largest
+ *****    entry of their row are lumped into the diagonal (see
+ *****    sparsify).  0 keeps the Galerkin product.
+ ***** coarse_solve_type : coarse_solve_t (default AutoCoarse)
+ *****    Solver for the coarsest level.  Options are
+ *****      - DenseCoarse : redundant dense LU
+ *****      - SparseCoarse : redundant sparse LU
+ *****      - IterativeCoarse : coarse_iterations relaxation sweeps
+ *****      - AutoCoarse : dense LU up to max_dense_coarse rows (default
+ *****        1000), sparse LU up to max_sparse_coarse rows (default
+ *****        20000), and relaxation beyond that
  ***** 
  ***** Methods
  ***** -------
  ***** solve(x, b, num_iters)
  *****    Solves system Ax = b, performing at most num_iters iterations
  *****    of AMG.
+ ***** resetup(Af)
+ *****    Updates the hierarchy for a matrix with the same sparsity
+ *****    as the one passed to setup, keeping the coarsening and
+ *****    communication packages of each level.
  **************************************************************/
 
 namespace raptor
@@ -80,6 +117,10 @@ namespace raptor
                 relax_type = _relax_type;
                 num_smooth_sweeps = 1;
                 relax_weight = 1.0;
+                chebyshev_degree = 2;
+                chebyshev_lower = 0.3;
+                chebyshev_upper = 1.1;
+                spectral_radius_iterations = 10;
                 max_coarse = 50;
                 max_levels = 25;
                 tap_amg = -1;
@@ -91,6 +132,12 @@ namespace raptor
                 sparsify_tol = 0.0;
                 solve_tol = 1e-07;
                 max_iterations = 100;
+                agglomerate_rows = 0;
+                coarse_solve_type = AutoCoarse;
+                coarse_solver = DenseCoarse;
+                max_dense_coarse = 1000;
+                max_sparse_coarse = 20000;
+                coarse_iterations = 10;
             }
 
             virtual ~ParMultilevel()
@@ -116,6 +163,7 @@ namespace raptor
             }
             
             virtual void setup(ParCSRMatrix* Af) = 0;
+            virtual void resetup(ParCSRMatrix* Af) = 0;
 
             void setup_helper(ParCSRMatrix* Af)
             {
@@ -166,6 +214,7 @@ namespace raptor
                         (max_levels == -1 || (int) levels.size() < max_levels))
                 {
                     extend_hierarchy();
+                    agglomerate_level(levels.size() - 1);
 
                     if (track_times)
                     {
@@ -182,16 +231,22 @@ namespace raptor
                 }
 
                 num_levels = levels.size();
-                if (Af->local_num_rows) 
-                {
-                    delete[] weights;
-                    weights = NULL;
-                }
+                delete[] weights;
+                weights = NULL;
 
                 // Duplicate coarsest level across all processes that hold any
                 // rows of A_c
                 duplicate_coarse();
 
+                // Split rows into interior and boundary so relaxation can
+                // overlap the halo exchange
+                for (int i = 0; i < num_levels; i++)
+                {
+                    levels[i]->A->split_rows();
+                }
+
+                setup_relax();
+
                 if (track_times)
                 {
                     finalize_profile();
@@ -206,6 +261,431 @@ namespace raptor
             } 
 
 
+            /**************************************************************
+            *****   ParMultilevel Resetup Helper
+            **************************************************************
+            ***** Numeric-only setup for a fine-level matrix whose values
+            ***** have changed but whose sparsity pattern matches the matrix
+            ***** previously passed to setup.  The C/F splitting (or
+            ***** aggregates) and strength pattern of every level are 
+            ***** reused, so only interpolation weights and Galerkin values
+            ***** are recomputed.  Whenever P and Ac keep their sparsity,
+            ***** the values are copied into the existing matrices and their
+            ***** communication packages are kept.  If a coarse operator
+            ***** changes pattern, the hierarchy is rebuilt from that level.
+            *****
+            ***** Parameters
+            ***** -------------
+            ***** Af : ParCSRMatrix*
+            *****    Fine-level matrix with new values
+            **************************************************************/
+            void resetup_helper(ParCSRMatrix* Af)
+            {
+                if (num_levels == 0)
+                {
+                    setup_helper(Af);
+                    return;
+                }
+
+                // Coarsest level is refactored at the end of resetup
+                if (levels[num_levels-1]->A->local_num_rows)
+                {
+                    RAPtor_MPI_Comm_free(&coarse_comm);
+                }
+
+                ParCSRMatrix* A = Af->copy();
+                A->sort();
+                A->on_proc->move_diag();
+                if (!same_sparsity(A, levels[0]->A))
+                {
+                    // Fine-level pattern changed: full setup
+                    delete A;
+                    for (std::vector<ParLevel*>::iterator it = levels.begin();
+                            it != levels.end(); ++it)
+                    {
+                        delete *it;
+                    }
+                    levels.clear();
+                    num_levels = 0;
+                    delete[] setup_times;
+                    delete[] solve_times;
+                    setup_times = NULL;
+                    solve_times = NULL;
+                    setup_helper(Af);
+                    return;
+                }
+                copy_values(A, levels[0]->A);
+                delete A;
+
+                if (weights == NULL)
+                {
+                    form_rand_weights(Af->local_num_rows, Af->partition->first_local_row);
+                }
+
+                int last_level = 0;
+                while (last_level < num_levels - 1 && reextend_level(last_level))
+                {
+                    last_level++;
+                }
+
+                if (last_level < num_levels - 1)
+                {
+                    // Coarse pattern changed: remove levels below last_level
+                    // and extend the hierarchy again from there
+                    for (int i = last_level + 1; i < num_levels; i++)
+                    {
+                        delete levels[i];
+                    }
+                    levels.resize(last_level + 1);
+                    delete levels[last_level]->P;
+                    delete levels[last_level]->S;
+                    delete levels[last_level]->I;
+                    levels[last_level]->P = NULL;
+                    levels[last_level]->S = NULL;
+                    levels[last_level]->I = NULL;
+                    levels[last_level]->delete_plans();
+
+                    while (levels[last_level]->A->global_num_rows > max_coarse && 
+                            (max_levels == -1 || (int) levels.size() < max_levels))
+                    {
+                        extend_hierarchy();
+                        agglomerate_level(levels.size() - 1);
+                        last_level++;
+                    }
+                    num_levels = levels.size();
+
+                    if (solve_times)
+                    {
+                        delete[] solve_times;
+                        solve_times = new double[5 * num_levels]();
+                    }
+                }
+
+                delete[] weights;
+                weights = NULL;
+
+                duplicate_coarse();
+
+                setup_relax();
+            }
+
+            // Estimates the spectral radius of D^{-1}A on every level
+            // when relaxing with Chebyshev
+            void setup_relax()
+            {
+                if (relax_type != Chebyshev)
+                {
+                    return;
+                }
+
+                for (int i = 0; i < num_levels; i++)
+                {
+                    levels[i]->rho = spectral_radius(levels[i]->A, 
+                            spectral_radius_iterations);
+                }
+            }
+
+            /**************************************************************
+            *****   ParMultilevel Reextend Level
+            **************************************************************
+            ***** Recomputes P and the Galerkin product of a level during
+            ***** resetup, reusing the stored splitting / aggregates.
+            *****
+            ***** Parameters
+            ***** -------------
+            ***** level : int
+            *****    Level whose P and coarse matrix are recomputed
+            *****
+            ***** Returns
+            ***** -------------
+            ***** bool : false if the coarse matrix changed sparsity on any
+            *****    process (the hierarchy is then extended again from
+            *****    this level)
+            **************************************************************/
+            virtual bool reextend_level(int level) = 0;
+
+            // True if A and B share a sparsity pattern on every process
+            bool same_sparsity(const ParCSRMatrix* A, const ParCSRMatrix* B)
+            {
+                int changed = 0;
+                if (A->local_num_rows != B->local_num_rows
+                        || A->global_num_cols != B->global_num_cols
+                        || A->on_proc_column_map != B->on_proc_column_map
+                        || A->off_proc_column_map != B->off_proc_column_map
+                        || A->on_proc->nnz != B->on_proc->nnz
+                        || A->off_proc->nnz != B->off_proc->nnz)
+                {
+                    changed = 1;
+                }
+                else
+                {
+                    changed = !same_sparsity(A->on_proc, B->on_proc)
+                        || !same_sparsity(A->off_proc, B->off_proc);
+                }
+
+                RAPtor_MPI_Allreduce(RAPtor_MPI_IN_PLACE, &changed, 1, RAPtor_MPI_INT,
+                        RAPtor_MPI_MAX, RAPtor_MPI_COMM_WORLD);
+
+                return !changed;
+            }
+
+            bool same_sparsity(const Matrix* A, const Matrix* B)
+            {
+                if (A->n_rows != B->n_rows) return false;
+                for (int i = 0; i <= A->n_rows; i++)
+                {
+                    if (A->idx1[i] != B->idx1[i]) return false;
+                }
+                for (int j = 0; j < A->nnz; j++)
+                {
+                    if (A->idx2[j] != B->idx2[j]) return false;
+                }
+                return true;
+            }
+
+            // Copies values of A into B, which must have the same sparsity
+            void copy_values(const ParCSRMatrix* A, ParCSRMatrix* B)
+            {
+                std::copy(A->on_proc->vals.begin(), 
+                        A->on_proc->vals.begin() + A->on_proc->nnz,
+                        B->on_proc->vals.begin());
+                std::copy(A->off_proc->vals.begin(), 
+                        A->off_proc->vals.begin() + A->off_proc->nnz,
+                        B->off_proc->vals.begin());
+            }
+
+            // True if A and B hold the same columns in every row on every
+            // process, in any order within rows
+            bool same_pattern(const ParCSRMatrix* A, const ParCSRMatrix* B)
+            {
+                int changed = 0;
+                if (A->local_num_rows != B->local_num_rows
+                        || A->global_num_cols != B->global_num_cols
+                        || A->on_proc_column_map != B->on_proc_column_map
+                        || A->off_proc_column_map != B->off_proc_column_map
+                        || A->on_proc->nnz != B->on_proc->nnz
+                        || A->off_proc->nnz != B->off_proc->nnz)
+                {
+                    changed = 1;
+                }
+                else
+                {
+                    changed = !same_pattern(A->on_proc, B->on_proc, A->on_proc_num_cols)
+                        || !same_pattern(A->off_proc, B->off_proc, A->off_proc_num_cols);
+                }
+
+                RAPtor_MPI_Allreduce(RAPtor_MPI_IN_PLACE, &changed, 1, RAPtor_MPI_INT,
+                        RAPtor_MPI_MAX, RAPtor_MPI_COMM_WORLD);
+
+                return !changed;
+            }
+
+            bool same_pattern(const Matrix* A, const Matrix* B, int n_cols)
+            {
+                if (A->n_rows != B->n_rows) return false;
+                std::vector<int> marker(n_cols, -1);
+                for (int i = 0; i < A->n_rows; i++)
+                {
+                    if (A->idx1[i+1] != B->idx1[i+1]) return false;
+                    for (int j = A->idx1[i]; j < A->idx1[i+1]; j++)
+                    {
+                        marker[A->idx2[j]] = i;
+                    }
+                    for (int j = B->idx1[i]; j < B->idx1[i+1]; j++)
+                    {
+                        if (marker[B->idx2[j]] != i) return false;
+                    }
+                }
+                return true;
+            }
+
+            /**************************************************************
+            *****   ParMultilevel Reform Coarse Operator
+            **************************************************************
+            ***** Recomputes the values of the coarse matrix on level+1 as
+            ***** P^T*A*P during resetup.  While the pattern of P matches
+            ***** that kept on the level, the symbolic products A*P and
+            ***** P^T*(AP) are formed once and kept on the level, and every
+            ***** later resetup only repeats their numeric phases, writing
+            ***** directly into the coarse matrix.  Otherwise (or if the
+            ***** symbolic product holds entries the coarse matrix dropped
+            ***** as zeros), the product is formed with rap.  Coarse
+            ***** matrices of non-Galerkin levels are sparsified again
+            ***** from the new product (see form_coarse_operator).
+            *****
+            ***** Parameters
+            ***** -------------
+            ***** level : int
+            *****    Level whose coarse matrix is recomputed
+            ***** P : ParCSRMatrix*
+            *****    New interpolation, kept on the level (or deleted once
+            *****    its values are copied to the level)
+            ***** tap_level : bool
+            *****    Use node-aware communication in rap
+            ***** sort_coarse : bool
+            *****    Coarse matrices of this level are sorted, with the
+            *****    diagonal first in each row
+            *****
+            ***** Returns
+            ***** -------------
+            ***** bool : false if the coarse matrix changed sparsity on any
+            *****    process
+            **************************************************************/
+            bool reform_coarse_operator(int level, ParCSRMatrix* P, bool tap_level,
+                    bool sort_coarse)
+            {
+                ParLevel* l = levels[level];
+                ParCSRMatrix* Ac_old = levels[level+1]->A;
+
+                // Non-Galerkin levels are sparsified again from the new
+                // Galerkin product, with the injection kept from setup
+                if (l->I)
+                {
+                    if (same_sparsity(P, l->P))
+                    {
+                        copy_values(P, l->P);
+                        delete P;
+                    }
+                    else
+                    {
+                        delete l->P;
+                        l->P = P;
+                    }
+
+                    ParCSRMatrix* Ac = form_coarse_operator(level, tap_level);
+                    bool same = same_sparsity(Ac, Ac_old);
+                    if (same)
+                    {
+                        copy_values(Ac, Ac_old);
+                    }
+                    delete Ac;
+
+                    return same;
+                }
+
+                if (same_sparsity(P, l->P))
+                {
+                    copy_values(P, l->P);
+                    delete P;
+
+                    if (l->Ac_plan == NULL)
+                    {
+                        ParSpGEMMPlan* AP_plan = new ParSpGEMMPlan();
+                        ParSpGEMMPlan* Ac_plan = new ParSpGEMMPlan();
+                        ParCSRMatrix* AP = AP_plan->symbolic(l->A, l->P);
+                        ParCSRMatrix* Ac = Ac_plan->symbolic_T(AP, l->P);
+                        bool same = same_pattern(Ac, Ac_old);
+                        delete Ac;
+
+                        l->AP = AP;
+                        l->AP_plan = AP_plan;
+                        l->Ac_plan = Ac_plan;
+                        if (!same) l->delete_plans();
+                    }
+
+                    if (l->Ac_plan)
+                    {
+                        l->AP_plan->numeric(l->A, l->P, l->AP);
+                        l->Ac_plan->numeric(l->AP, l->P, Ac_old);
+                        return true;
+                    }
+                }
+                else
+                {
+                    delete l->P;
+                    l->P = P;
+                    l->delete_plans();
+                }
+
+                ParCSRMatrix* Ac = l->A->rap(l->P, tap_level);
+
+                if (sort_coarse)
+                {
+                    Ac->sort();
+                    Ac->on_proc->move_diag();
+                }
+
+                bool same = same_sparsity(Ac, Ac_old);
+                if (same)
+                {
+                    copy_values(Ac, Ac_old);
+                }
+                delete Ac;
+
+                return same;
+            }
+
+            /**************************************************************
+            *****   ParMultilevel Form Injection
+            **************************************************************
+            ***** Forms the injection I from the coarse points (states[i]
+            ***** == 1) of a C/F splitting, with the same layout as the
+            ***** interpolation P, whose on_proc columns are the local
+            ***** coarse points in order.  Kept on the level for sparsify.
+            *****
+            ***** Parameters
+            ***** -------------
+            ***** P : ParCSRMatrix*
+            *****    Interpolation of the splitting
+            ***** states : std::vector<int>&
+            *****    C/F splitting of the local rows
+            **************************************************************/
+            ParCSRMatrix* form_injection(ParCSRMatrix* P, const std::vector<int>& states)
+            {
+                ParCSRMatrix* I = new ParCSRMatrix(P->partition, P->global_num_rows,
+                        P->global_num_cols, P->local_num_rows, P->on_proc_num_cols, 0);
+                I->on_proc->idx1[0] = 0;
+                I->off_proc->idx1[0] = 0;
+                int ctr = 0;
+                for (int i = 0; i < P->local_num_rows; i++)
+                {
+                    if (states[i] == 1)
+                    {
+                        I->on_proc->idx2.emplace_back(ctr++);
+                        I->on_proc->vals.emplace_back(1.0);
+                    }
+                    I->on_proc->idx1[i+1] = I->on_proc->idx2.size();
+                    I->off_proc->idx1[i+1] = 0;
+                }
+                I->on_proc->nnz = I->on_proc->idx2.size();
+                I->off_proc->nnz = 0;
+                I->finalize();
+
+                return I;
+            }
+
+            /**************************************************************
+            *****   ParMultilevel Form Coarse Operator
+            **************************************************************
+            ***** Returns the coarse operator of a level from its A and P:
+            ***** the Galerkin product P^T*A*P, or, if the level holds an
+            ***** injection I (sparsify_tol > 0), the non-Galerkin
+            ***** operator sparsified from it.  A*P is then kept on the
+            ***** level as AP.
+            *****
+            ***** Parameters
+            ***** -------------
+            ***** level : int
+            *****    Level whose coarse operator is formed
+            ***** tap_level : bool
+            *****    Use node-aware communication
+            **************************************************************/
+            ParCSRMatrix* form_coarse_operator(int level, bool tap_level)
+            {
+                ParLevel* l = levels[level];
+                if (l->I == NULL)
+                {
+                    return l->A->rap(l->P, tap_level);
+                }
+
+                delete l->AP;
+                l->AP = l->A->mult(l->P, tap_level);
+                ParCSRMatrix* Ac = l->AP->mult_T(l->P, tap_level);
+                sparsify(l->A, l->P, l->I, l->AP, Ac, sparsify_tol);
+
+                return Ac;
+            }
+
             void form_rand_weights(int local_n, int first_n)
             {
                 if (local_n == 0) return;
@@ -220,6 +700,285 @@ namespace raptor
                 
             virtual void extend_hierarchy() = 0;
 
+            /**************************************************************
+            *****   ParMultilevel Agglomerate Level
+            **************************************************************
+            ***** Gathers the rows of a coarse matrix onto fewer processes
+            ***** once the average number of rows per active process drops
+            ***** below agglomerate_rows.  Consecutive active processes are
+            ***** grouped, and each group sends its rows to its first process
+            ***** with repartition_matrix, which numbers the rows
+            ***** contiguously.  The columns of P on the level above are
+            ***** renumbered to match, and per-row solver data is moved with
+            ***** agglomerate_row_data.  Processes left without rows hold no
+            ***** rows on any coarser level, and skip those levels in cycle().
+            *****
+            ***** Parameters
+            ***** -------------
+            ***** level : int
+            *****    Coarse level to agglomerate
+            **************************************************************/
+            void agglomerate_level(int level)
+            {
+                if (agglomerate_rows <= 0 || level == 0) return;
+
+                int rank, num_procs;
+                RAPtor_MPI_Comm_rank(RAPtor_MPI_COMM_WORLD, &rank);
+                RAPtor_MPI_Comm_size(RAPtor_MPI_COMM_WORLD, &num_procs);
+
+                ParCSRMatrix* A = levels[level]->A;
+                std::vector<int> proc_sizes(num_procs);
+                std::vector<int> active_procs;
+                RAPtor_MPI_Allgather(&(A->local_num_rows), 1, RAPtor_MPI_INT, proc_sizes.data(),
+                        1, RAPtor_MPI_INT, RAPtor_MPI_COMM_WORLD);
+                for (int i = 0; i < num_procs; i++)
+                {
+                    if (proc_sizes[i])
+                    {
+                        active_procs.emplace_back(i);
+                    }
+                }
+                int num_active = active_procs.size();
+                if (num_active <= 1 ||
+                        A->global_num_rows >= (index_t) agglomerate_rows * num_active)
+                {
+                    return;
+                }
+
+                // Group consecutive active processes so that each remaining
+                // process holds about agglomerate_rows rows
+                int num_groups = A->global_num_rows / agglomerate_rows;
+                if (num_groups < 1) num_groups = 1;
+                int group_size = (num_active + num_groups - 1) / num_groups;
+                int leader = rank;
+                for (int i = 0; i < num_active; i++)
+                {
+                    if (active_procs[i] == rank)
+                    {
+                        leader = active_procs[(i / group_size) * group_size];
+                        break;
+                    }
+                }
+
+                std::vector<int> partition(A->local_num_rows, leader);
+                std::vector<int> new_local_rows;
+                ParCSRMatrix* A_agg = repartition_matrix(A, partition.data(),
+                        new_local_rows);
+                A_agg->on_proc->n_cols = A_agg->on_proc_num_cols;
+                A_agg->off_proc->n_cols = A_agg->off_proc_num_cols;
+                if (A->tap_comm || A->tap_mat_comm)
+                {
+                    A_agg->init_tap_communicators(RAPtor_MPI_COMM_WORLD);
+                }
+
+                int local_n = A->local_num_rows;
+                delete A;
+                levels[level]->A = A_agg;
+                levels[level]->x.resize(A_agg->global_num_rows, A_agg->local_num_rows);
+                levels[level]->b.resize(A_agg->global_num_rows, A_agg->local_num_rows);
+                levels[level]->tmp.resize(A_agg->global_num_rows, A_agg->local_num_rows);
+                levels[level]->agglomerated = true;
+
+                ParCSRMatrix* P = levels[level-1]->P;
+                levels[level-1]->P = agglomerate_cols(P, A_agg->partition);
+                delete P;
+                if (levels[level-1]->I)
+                {
+                    P = levels[level-1]->I;
+                    levels[level-1]->I = agglomerate_cols(P, A_agg->partition);
+                    delete P;
+                    P = levels[level-1]->AP;
+                    levels[level-1]->AP = agglomerate_cols(P, A_agg->partition);
+                    delete P;
+                }
+
+                agglomerate_row_data(local_n, A_agg->local_num_rows);
+
+                // Random weights are indexed by local row
+                if (A_agg->local_num_rows > levels[0]->A->local_num_rows)
+                {
+                    delete[] weights;
+                    weights = NULL;
+                    form_rand_weights(A_agg->local_num_rows,
+                            A_agg->partition->first_local_row);
+                }
+            }
+
+            // Copy of P with its columns distributed as the rows of an
+            // agglomerated coarse matrix.  Coarse rows keep their global
+            // order, so column j of P local to rank r becomes column
+            // (number of columns local to ranks < r) + j.
+            ParCSRMatrix* agglomerate_cols(ParCSRMatrix* P, Partition* coarse_part)
+            {
+                int rank, num_procs;
+                RAPtor_MPI_Comm_rank(RAPtor_MPI_COMM_WORLD, &rank);
+                RAPtor_MPI_Comm_size(RAPtor_MPI_COMM_WORLD, &num_procs);
+
+                int start, end;
+                index_t global_col;
+                index_t first_col = 0;
+                std::vector<int> proc_sizes(num_procs);
+                RAPtor_MPI_Allgather(&(P->on_proc_num_cols), 1, RAPtor_MPI_INT,
+                        proc_sizes.data(), 1, RAPtor_MPI_INT, RAPtor_MPI_COMM_WORLD);
+                for (int i = 0; i < rank; i++)
+                {
+                    first_col += proc_sizes[i];
+                }
+
+                std::vector<int> new_cols(P->on_proc_num_cols);
+                for (int i = 0; i < P->on_proc_num_cols; i++)
+                {
+                    new_cols[i] = first_col + i;
+                }
+                if (P->comm == NULL)
+                {
+                    P->comm = new ParComm(P->partition, P->off_proc_column_map,
+                            P->on_proc_column_map);
+                }
+                std::vector<int>& off_cols = P->comm->communicate(new_cols);
+
+                Partition* part = new Partition(P->partition, coarse_part);
+                CSRMatrix* on_proc = new CSRMatrix(P->local_num_rows,
+                        part->local_num_cols, P->on_proc->nnz);
+                CSRMatrix* off_proc = new CSRMatrix(P->local_num_rows,
+                        part->global_num_cols, P->off_proc->nnz);
+                on_proc->idx1[0] = 0;
+                off_proc->idx1[0] = 0;
+                for (int i = 0; i < P->local_num_rows; i++)
+                {
+                    start = P->on_proc->idx1[i];
+                    end = P->on_proc->idx1[i+1];
+                    for (int j = start; j < end; j++)
+                    {
+                        global_col = new_cols[P->on_proc->idx2[j]];
+                        add_agglomerated_col(on_proc, off_proc, part, global_col,
+                                P->on_proc->vals[j]);
+                    }
+                    start = P->off_proc->idx1[i];
+                    end = P->off_proc->idx1[i+1];
+                    for (int j = start; j < end; j++)
+                    {
+                        global_col = off_cols[P->off_proc->idx2[j]];
+                        add_agglomerated_col(on_proc, off_proc, part, global_col,
+                                P->off_proc->vals[j]);
+                    }
+                    on_proc->idx1[i+1] = on_proc->idx2.size();
+                    off_proc->idx1[i+1] = off_proc->idx2.size();
+                }
+                on_proc->nnz = on_proc->idx2.size();
+                off_proc->nnz = off_proc->idx2.size();
+
+                // finalize() condenses the global off_proc columns and
+                // forms the communication package
+                ParCSRMatrix* P_agg = new ParCSRMatrix(part, on_proc, off_proc);
+                part->num_shared = 0;
+                if (P->tap_comm || P->tap_mat_comm)
+                {
+                    P_agg->init_tap_communicators(RAPtor_MPI_COMM_WORLD);
+                }
+
+                return P_agg;
+            }
+
+            void add_agglomerated_col(CSRMatrix* on_proc, CSRMatrix* off_proc,
+                    Partition* part, index_t global_col, double val)
+            {
+                if (global_col >= part->first_local_col &&
+                        global_col < part->first_local_col + part->local_num_cols)
+                {
+                    on_proc->idx2.emplace_back(global_col - part->first_local_col);
+                    on_proc->vals.emplace_back(val);
+                }
+                else
+                {
+                    off_proc->idx2.emplace_back(global_col);
+                    off_proc->vals.emplace_back(val);
+                }
+            }
+
+            // Moves P (recomputed during resetup) to the column layout of an
+            // agglomerated coarse level, deleting the original
+            ParCSRMatrix* agglomerate_interpolation(int level, ParCSRMatrix* P)
+            {
+                if (!levels[level+1]->agglomerated) return P;
+
+                ParCSRMatrix* P_agg = agglomerate_cols(P, levels[level+1]->A->partition);
+                delete P;
+                return P_agg;
+            }
+
+            // Moves per-row solver data (such as candidate vectors) along
+            // with the rows of an agglomerated level.  local_n rows were
+            // held before agglomeration, and agg_local_n rows are held now.
+            virtual void agglomerate_row_data(int local_n, int agg_local_n)
+            {
+            }
+
+            // Redistributes row data (stride values per row) from a layout
+            // with local_n rows on this process to one with new_n rows,
+            // keeping the global order of rows
+            template <typename T>
+            void redistribute_rows(std::vector<T>& data, int local_n, int new_n,
+                    int stride, RAPtor_MPI_Datatype type)
+            {
+                int rank, num_procs;
+                RAPtor_MPI_Comm_rank(RAPtor_MPI_COMM_WORLD, &rank);
+                RAPtor_MPI_Comm_size(RAPtor_MPI_COMM_WORLD, &num_procs);
+
+                std::vector<int> old_first(num_procs+1);
+                std::vector<int> new_first(num_procs+1);
+                RAPtor_MPI_Allgather(&local_n, 1, RAPtor_MPI_INT, &(old_first[1]), 1,
+                        RAPtor_MPI_INT, RAPtor_MPI_COMM_WORLD);
+                RAPtor_MPI_Allgather(&new_n, 1, RAPtor_MPI_INT, &(new_first[1]), 1,
+                        RAPtor_MPI_INT, RAPtor_MPI_COMM_WORLD);
+                old_first[0] = 0;
+                new_first[0] = 0;
+                for (int i = 0; i < num_procs; i++)
+                {
+                    old_first[i+1] += old_first[i];
+                    new_first[i+1] += new_first[i];
+                }
+
+                std::vector<int> send_sizes(num_procs);
+                std::vector<int> send_displs(num_procs);
+                std::vector<int> recv_sizes(num_procs);
+                std::vector<int> recv_displs(num_procs);
+                int first, last;
+                for (int i = 0; i < num_procs; i++)
+                {
+                    // Rows moving from this process to process i
+                    first = std::max(old_first[rank], new_first[i]);
+                    last = std::min(old_first[rank+1], new_first[i+1]);
+                    send_sizes[i] = last > first ? (last - first) * stride : 0;
+                    send_displs[i] = last > first ? (first - old_first[rank]) * stride : 0;
+
+                    // Rows moving from process i to this process
+                    first = std::max(old_first[i], new_first[rank]);
+                    last = std::min(old_first[i+1], new_first[rank+1]);
+                    recv_sizes[i] = last > first ? (last - first) * stride : 0;
+                    recv_displs[i] = last > first ? (first - new_first[rank]) * stride : 0;
+                }
+
+                std::vector<T> recv_data(new_n * stride);
+                RAPtor_MPI_Alltoallv(data.data(), send_sizes.data(), send_displs.data(),
+                        type, recv_data.data(), recv_sizes.data(), recv_displs.data(),
+                        type, RAPtor_MPI_COMM_WORLD);
+                data.swap(recv_data);
+            }
+
+            /**************************************************************
+            *****   ParMultilevel Duplicate Coarse
+            **************************************************************
+            ***** Prepares the solver for the coarsest level.  For a direct
+            ***** solve, the coarse matrix is gathered onto every process
+            ***** holding rows of it and factored redundantly, either as a
+            ***** dense LU (DenseCoarse) or a sparse LU of the CSR structure
+            ***** (SparseCoarse).  IterativeCoarse instead performs
+            ***** coarse_iterations relaxation sweeps on the distributed
+            ***** coarse matrix.  AutoCoarse picks dense LU up to
+            ***** max_dense_coarse rows, sparse LU up to max_sparse_coarse
+            ***** rows, and relaxation beyond that.
+            **************************************************************/
             void duplicate_coarse()
             {
                 int rank, num_procs;
@@ -248,6 +1007,25 @@ namespace raptor
                 RAPtor_MPI_Group_free(&world_group);
                 RAPtor_MPI_Group_free(&active_group);
 
+                coarse_n = Ac->global_num_rows;
+                coarse_solver = coarse_solve_type;
+                if (coarse_solver == AutoCoarse)
+                {
+                    if (coarse_n <= max_dense_coarse)
+                        coarse_solver = DenseCoarse;
+                    else if (coarse_n <= max_sparse_coarse)
+                        coarse_solver = SparseCoarse;
+                    else
+                        coarse_solver = IterativeCoarse;
+                }
+
+                A_coarse.clear();
+                A_coarse.shrink_to_fit();
+                LU_permute.clear();
+                coarse_lu = SparseLU();
+
+                if (coarse_solver == IterativeCoarse) return;
+
                 if (Ac->local_num_rows)
                 {
                     int num_active, active_rank;
@@ -255,12 +1033,9 @@ namespace raptor
                     RAPtor_MPI_Comm_size(coarse_comm, &num_active);
 
                     int proc;
-                    int global_col, local_col;
                     int start, end;
 
-                    std::vector<double> A_coarse_lcl;
-
-                    // Gather global col indices
+                    // Gather global row indices
                     coarse_sizes.resize(num_active);
                     coarse_displs.resize(num_active+1);
                     coarse_displs[0] = 0;
@@ -271,68 +1046,323 @@ namespace raptor
                         coarse_displs[i+1] = coarse_displs[i] + coarse_sizes[i]; 
                     }
 
-                    std::vector<int> global_row_indices(coarse_displs[num_active]);
+                    std::vector<index_t> global_row_indices(coarse_displs[num_active]);
 
-                    RAPtor_MPI_Allgatherv(Ac->local_row_map.data(), Ac->local_num_rows, RAPtor_MPI_INT,
+                    RAPtor_MPI_Allgatherv(Ac->local_row_map.data(), Ac->local_num_rows, RAPtor_MPI_INDEX_T,
                             global_row_indices.data(), coarse_sizes.data(), 
-                            coarse_displs.data(), RAPtor_MPI_INT, coarse_comm);
-    
-                    std::map<int, int> global_to_local;
-                    int ctr = 0;
-                    for (std::vector<int>::iterator it = global_row_indices.begin();
-                            it != global_row_indices.end(); ++it)
+                            coarse_displs.data(), RAPtor_MPI_INDEX_T, coarse_comm);
+
+                    // Position of each global row in the gathered order,
+                    // found by binary search of the sorted global rows
+                    std::vector<int> row_order(coarse_n);
+                    std::iota(row_order.begin(), row_order.end(), 0);
+                    std::sort(row_order.begin(), row_order.end(),
+                            [&](const int i, const int j)
+                            {
+                                return global_row_indices[i] < global_row_indices[j];
+                            });
+                    std::vector<index_t> sorted_rows(coarse_n);
+                    for (int i = 0; i < coarse_n; i++)
+                    {
+                        sorted_rows[i] = global_row_indices[row_order[i]];
+                    }
+                    std::vector<int> on_proc_to_coarse(Ac->on_proc_num_cols);
+                    std::vector<int> off_proc_to_coarse(Ac->off_proc_num_cols);
+                    for (int i = 0; i < Ac->on_proc_num_cols; i++)
                     {
-                        global_to_local[*it] = ctr++;
+                        on_proc_to_coarse[i] = row_order[sorted_find(sorted_rows,
+                                Ac->on_proc_column_map[i])];
+                    }
+                    for (int i = 0; i < Ac->off_proc_num_cols; i++)
+                    {
+                        off_proc_to_coarse[i] = row_order[sorted_find(sorted_rows,
+                                Ac->off_proc_column_map[i])];
                     }
 
-                    coarse_n = Ac->global_num_rows;
-                    A_coarse_lcl.resize(coarse_n*Ac->local_num_rows, 0);
-                    for (int i = 0; i < Ac->local_num_rows; i++)
+                    if (coarse_solver == SparseCoarse)
                     {
-                        start = Ac->on_proc->idx1[i];
-                        end = Ac->on_proc->idx1[i+1];
-                        for (int j = start; j < end; j++)
+                        // Gather CSR rows of Ac, with columns in gathered order
+                        std::vector<int> row_sizes(Ac->local_num_rows);
+                        std::vector<int> cols;
+                        std::vector<double> vals;
+                        cols.reserve(Ac->local_nnz);
+                        vals.reserve(Ac->local_nnz);
+                        for (int i = 0; i < Ac->local_num_rows; i++)
                         {
-                            global_col = Ac->on_proc_column_map[Ac->on_proc->idx2[j]];
-                            local_col = global_to_local[global_col];
-                            A_coarse_lcl[i*coarse_n + local_col] = Ac->on_proc->vals[j];
+                            start = Ac->on_proc->idx1[i];
+                            end = Ac->on_proc->idx1[i+1];
+                            for (int j = start; j < end; j++)
+                            {
+                                cols.emplace_back(on_proc_to_coarse[Ac->on_proc->idx2[j]]);
+                                vals.emplace_back(Ac->on_proc->vals[j]);
+                            }
+                            start = Ac->off_proc->idx1[i];
+                            end = Ac->off_proc->idx1[i+1];
+                            for (int j = start; j < end; j++)
+                            {
+                                cols.emplace_back(off_proc_to_coarse[Ac->off_proc->idx2[j]]);
+                                vals.emplace_back(Ac->off_proc->vals[j]);
+                            }
+                            row_sizes[i] = (Ac->on_proc->idx1[i+1] - Ac->on_proc->idx1[i])
+                                + (Ac->off_proc->idx1[i+1] - Ac->off_proc->idx1[i]);
                         }
 
-                        start = Ac->off_proc->idx1[i];
-                        end = Ac->off_proc->idx1[i+1];
-                        for (int j = start; j < end; j++)
+                        int local_nnz = cols.size();
+                        std::vector<int> nnz_sizes(num_active);
+                        std::vector<int> nnz_displs(num_active+1);
+                        RAPtor_MPI_Allgather(&local_nnz, 1, RAPtor_MPI_INT, nnz_sizes.data(), 1,
+                                RAPtor_MPI_INT, coarse_comm);
+                        nnz_displs[0] = 0;
+                        for (int i = 0; i < num_active; i++)
                         {
-                            global_col = Ac->off_proc_column_map[Ac->off_proc->idx2[j]];
-                            local_col = global_to_local[global_col];
-                            A_coarse_lcl[i*coarse_n + local_col] = Ac->off_proc->vals[j];
+                            nnz_displs[i+1] = nnz_displs[i] + nnz_sizes[i];
                         }
+
+                        CSRMatrix* A_gathered = new CSRMatrix(coarse_n, coarse_n);
+                        A_gathered->idx2.resize(nnz_displs[num_active]);
+                        A_gathered->vals.resize(nnz_displs[num_active]);
+                        RAPtor_MPI_Allgatherv(row_sizes.data(), Ac->local_num_rows, RAPtor_MPI_INT,
+                                &(A_gathered->idx1[1]), coarse_sizes.data(), coarse_displs.data(),
+                                RAPtor_MPI_INT, coarse_comm);
+                        RAPtor_MPI_Allgatherv(cols.data(), local_nnz, RAPtor_MPI_INT,
+                                A_gathered->idx2.data(), nnz_sizes.data(), nnz_displs.data(),
+                                RAPtor_MPI_INT, coarse_comm);
+                        RAPtor_MPI_Allgatherv(vals.data(), local_nnz, RAPtor_MPI_DOUBLE,
+                                A_gathered->vals.data(), nnz_sizes.data(), nnz_displs.data(),
+                                RAPtor_MPI_DOUBLE, coarse_comm);
+                        A_gathered->idx1[0] = 0;
+                        for (int i = 0; i < coarse_n; i++)
+                        {
+                            A_gathered->idx1[i+1] += A_gathered->idx1[i];
+                        }
+                        A_gathered->nnz = A_gathered->idx2.size();
+
+                        coarse_lu.factor(A_gathered);
+                        delete A_gathered;
                     }
+                    else
+                    {
+                        std::vector<double> A_coarse_lcl(coarse_n*Ac->local_num_rows, 0);
+                        for (int i = 0; i < Ac->local_num_rows; i++)
+                        {
+                            start = Ac->on_proc->idx1[i];
+                            end = Ac->on_proc->idx1[i+1];
+                            for (int j = start; j < end; j++)
+                            {
+                                A_coarse_lcl[i*coarse_n + on_proc_to_coarse[Ac->on_proc->idx2[j]]] 
+                                    = Ac->on_proc->vals[j];
+                            }
+
+                            start = Ac->off_proc->idx1[i];
+                            end = Ac->off_proc->idx1[i+1];
+                            for (int j = start; j < end; j++)
+                            {
+                                A_coarse_lcl[i*coarse_n + off_proc_to_coarse[Ac->off_proc->idx2[j]]] 
+                                    = Ac->off_proc->vals[j];
+                            }
+                        }
 
-                    A_coarse.resize(coarse_n*coarse_n);
-                    for (int i = 0; i < num_active; i++)
+                        A_coarse.resize(coarse_n*coarse_n);
+                        for (int i = 0; i < num_active; i++)
+                        {
+                            coarse_sizes[i] *= coarse_n;
+                            coarse_displs[i+1] *= coarse_n;
+                        }
+                        
+                        RAPtor_MPI_Allgatherv(A_coarse_lcl.data(), A_coarse_lcl.size(), RAPtor_MPI_DOUBLE,
+                                A_coarse.data(), coarse_sizes.data(), coarse_displs.data(), 
+                                RAPtor_MPI_DOUBLE, coarse_comm);
+
+                        LU_permute.resize(coarse_n);
+                        int info;
+                        dgetrf_(&coarse_n, &coarse_n, A_coarse.data(), &coarse_n, 
+                                LU_permute.data(), &info);
+
+                        for (int i = 0; i < num_active; i++)
+                        {
+                            coarse_sizes[i] /= coarse_n;
+                            coarse_displs[i+1] /= coarse_n;
+                        }
+                    }
+                }
+            }
+
+            // Relax over A with the selected smoother
+            template <typename VecType>
+            void relax(int level, VecType& x, VecType& b, VecType& tmp,
+                    bool tap_level)
+            {
+                ParCSRMatrix* A = levels[level]->A;
+                switch (relax_type)
+                {
+                    case Jacobi:
+                        jacobi(A, x, b, tmp, num_smooth_sweeps, relax_weight,
+                                tap_level);
+                        break;
+                    case SOR:
+                        sor(A, x, b, tmp, num_smooth_sweeps, relax_weight,
+                                tap_level);
+                        break;
+                    case SSOR:
+                        ssor(A, x, b, tmp, num_smooth_sweeps, relax_weight,
+                                tap_level);
+                        break;
+                    case L1Jacobi:
+                        l1_jacobi(A, x, b, tmp, num_smooth_sweeps, relax_weight,
+                                tap_level);
+                        break;
+                    case Chebyshev:
+                        chebyshev(A, x, b, tmp, levels[level]->rho, 
+                                chebyshev_degree, num_smooth_sweeps, 
+                                chebyshev_lower, chebyshev_upper, tap_level);
+                        break;
+                    default:
+                        sor(A, x, b, tmp, num_smooth_sweeps, relax_weight,
+                                tap_level);
+                        break;
+                }
+            }
+
+            // Work vectors of a level, matching the type of the vectors 
+            // being cycled.  Multi-vector work space is sized on first use.
+            ParVector& level_x(int level, ParVector& x)
+            {
+                return levels[level]->x;
+            }
+            ParVector& level_b(int level, ParVector& x)
+            {
+                return levels[level]->b;
+            }
+            ParVector& level_tmp(int level, ParVector& x)
+            {
+                return levels[level]->tmp;
+            }
+            ParMultiVector& level_x(int level, ParMultiVector& x)
+            {
+                return init_multi_vector(levels[level]->multi_x, 
+                        levels[level]->A, x.n_vecs);
+            }
+            ParMultiVector& level_b(int level, ParMultiVector& x)
+            {
+                return init_multi_vector(levels[level]->multi_b, 
+                        levels[level]->A, x.n_vecs);
+            }
+            ParMultiVector& level_tmp(int level, ParMultiVector& x)
+            {
+                return init_multi_vector(levels[level]->multi_tmp, 
+                        levels[level]->A, x.n_vecs);
+            }
+            ParMultiVector& init_multi_vector(ParMultiVector& v, ParCSRMatrix* A,
+                    int n_vecs)
+            {
+                if (v.n_vecs != n_vecs || v.local_n != A->local_num_rows
+                        || v.global_n != A->global_num_rows)
+                {
+                    v.resize(A->global_num_rows, A->local_num_rows, n_vecs);
+                }
+                return v;
+            }
+
+            // Direct solve on the coarsest level, which is duplicated 
+            // across all active processes
+            void coarse_solve(ParVector& x, ParVector& b)
+            {
+                int active_rank;
+                RAPtor_MPI_Comm_rank(coarse_comm, &active_rank);
+
+                char trans = 'N'; //No transpose
+                int nhrs = 1; // Number of right hand sides
+                int info; // result
+
+                std::vector<double> b_data(coarse_n);
+                RAPtor_MPI_Allgatherv(b.local.data(), b.local_n, RAPtor_MPI_DOUBLE, b_data.data(), 
+                        coarse_sizes.data(), coarse_displs.data(), 
+                        RAPtor_MPI_DOUBLE, coarse_comm);
+
+                if (coarse_solver == SparseCoarse)
+                {
+                    coarse_lu.solve(b_data.data());
+                }
+                else
+                {
+                    dgetrs_(&trans, &coarse_n, &nhrs, A_coarse.data(), &coarse_n, 
+                            LU_permute.data(), b_data.data(), &coarse_n, &info);
+                }
+                for (int i = 0; i < b.local_n; i++)
+                {
+                    x.local[i] = b_data[i + coarse_displs[active_rank]];
+                }
+            }
+
+            // All right-hand sides are gathered in one collective and solved
+            // with a single dgetrs call (column-major right-hand sides), or
+            // a single sparse triangular solve (right-hand sides by row)
+            void coarse_solve(ParMultiVector& x, ParMultiVector& b)
+            {
+                int active_rank, num_active;
+                RAPtor_MPI_Comm_rank(coarse_comm, &active_rank);
+                RAPtor_MPI_Comm_size(coarse_comm, &num_active);
+
+                char trans = 'N'; //No transpose
+                int nhrs = b.n_vecs; // Number of right hand sides
+                int info; // result
+
+                std::vector<int> sizes(num_active);
+                std::vector<int> displs(num_active+1);
+                for (int i = 0; i < num_active; i++)
+                {
+                    sizes[i] = coarse_sizes[i] * nhrs;
+                    displs[i] = coarse_displs[i] * nhrs;
+                }
+
+                std::vector<double> b_rows(coarse_n * nhrs);
+                std::vector<double> b_data(coarse_n * nhrs);
+                RAPtor_MPI_Allgatherv(b.local.data(), b.local_n * nhrs, RAPtor_MPI_DOUBLE, 
+                        b_rows.data(), sizes.data(), displs.data(), 
+                        RAPtor_MPI_DOUBLE, coarse_comm);
+
+                if (coarse_solver == SparseCoarse)
+                {
+                    coarse_lu.solve(b_rows.data(), nhrs);
+                    for (int i = 0; i < b.local_n; i++)
                     {
-                        coarse_sizes[i] *= coarse_n;
-                        coarse_displs[i+1] *= coarse_n;
+                        for (int v = 0; v < nhrs; v++)
+                        {
+                            x(i, v) = b_rows[(i + coarse_displs[active_rank])*nhrs + v];
+                        }
                     }
-                    
-                    RAPtor_MPI_Allgatherv(A_coarse_lcl.data(), A_coarse_lcl.size(), RAPtor_MPI_DOUBLE,
-                            A_coarse.data(), coarse_sizes.data(), coarse_displs.data(), 
-                            RAPtor_MPI_DOUBLE, coarse_comm);
+                    return;
+                }
 
-                    LU_permute.resize(coarse_n);
-                    int info;
-                    dgetrf_(&coarse_n, &coarse_n, A_coarse.data(), &coarse_n, 
-                            LU_permute.data(), &info);
+                for (int i = 0; i < coarse_n; i++)
+                {
+                    for (int v = 0; v < nhrs; v++)
+                    {
+                        b_data[v*coarse_n + i] = b_rows[i*nhrs + v];
+                    }
+                }
 
-                    for (int i = 0; i < num_active; i++)
+                dgetrs_(&trans, &coarse_n, &nhrs, A_coarse.data(), &coarse_n, 
+                        LU_permute.data(), b_data.data(), &coarse_n, &info);
+                for (int i = 0; i < b.local_n; i++)
+                {
+                    for (int v = 0; v < nhrs; v++)
                     {
-                        coarse_sizes[i] /= coarse_n;
-                        coarse_displs[i+1] /= coarse_n;
+                        x(i, v) = b_data[v*coarse_n + i + coarse_displs[active_rank]];
                     }
                 }
             }
 
-            void cycle(ParVector& x, ParVector& b, int level = 0)
+            /**************************************************************
+            *****   ParMultilevel Cycle
+            **************************************************************
+            ***** Performs a V-cycle starting at the given level.  With a
+            ***** ParMultiVector, the hierarchy is traversed once for all 
+            ***** right-hand sides: each SpMV, relaxation sweep and halo
+            ***** exchange is applied to the whole block.
+            **************************************************************/
+            template <typename VecType>
+            void cycle(VecType& x, VecType& b, int level = 0)
             {
                 if (solve_times)
                 {
@@ -341,32 +1371,34 @@ namespace raptor
 
                 ParCSRMatrix* A = levels[level]->A;
                 ParCSRMatrix* P = levels[level]->P;
-                ParVector& tmp = levels[level]->tmp;
                 bool tap_level = tap_amg >= 0 && tap_amg <= level;
 
-                if (level == num_levels - 1)
+                // Processes holding no rows (e.g. after agglomeration) have
+                // nothing to exchange on this or any coarser level, unless
+                // they forward node-aware messages
+                if (A->local_num_rows == 0 && !tap_level)
                 {
-                    if (A->local_num_rows)
+                    if (solve_times)
                     {
-                        int active_rank;
-                        RAPtor_MPI_Comm_rank(coarse_comm, &active_rank);
-
-                        char trans = 'N'; //No transpose
-                        int nhrs = 1; // Number of right hand sides
-                        int info; // result
-
-                        std::vector<double> b_data(coarse_n);
-                        RAPtor_MPI_Allgatherv(b.local.data(), b.local_n, RAPtor_MPI_DOUBLE, b_data.data(), 
-                                coarse_sizes.data(), coarse_displs.data(), 
-                                RAPtor_MPI_DOUBLE, coarse_comm);
+                        finalize_profile();
+                    }
+                    return;
+                }
 
-                        dgetrs_(&trans, &coarse_n, &nhrs, A_coarse.data(), &coarse_n, 
-                                LU_permute.data(), b_data.data(), &coarse_n, &info);
-                        for (int i = 0; i < b.local_n; i++)
+                if (level == num_levels - 1)
+                {
+                    if (coarse_solver == IterativeCoarse)
+                    {
+                        VecType& tmp = level_tmp(level, x);
+                        for (int i = 0; i < coarse_iterations; i++)
                         {
-                            x.local[i] = b_data[i + coarse_displs[active_rank]];
+                            relax(level, x, b, tmp, tap_level);
                         }
                     }
+                    else if (A->local_num_rows)
+                    {
+                        coarse_solve(x, b);
+                    }
 
                     if (solve_times)
                     {
@@ -380,33 +1412,18 @@ namespace raptor
                 }
                 else
                 {
-                    levels[level+1]->x.set_const_value(0.0);
+                    VecType& tmp = level_tmp(level, x);
+                    VecType& coarse_x = level_x(level+1, x);
+                    VecType& coarse_b = level_b(level+1, x);
+
+                    coarse_x.set_const_value(0.0);
                     
                     // Relax
-                    switch (relax_type)
-                    {
-                        case Jacobi:
-                            jacobi(A, x, b, tmp, num_smooth_sweeps, relax_weight,
-                                    tap_level);
-                            break;
-                        case SOR:
-                            sor(A, x, b, tmp, num_smooth_sweeps, relax_weight,
-                                    tap_level);
-                            break;
-                        case SSOR:
-                            ssor(A, x, b, tmp, num_smooth_sweeps, relax_weight,
-                                    tap_level);
-                            break;
-                        default:
-                            sor(A, x, b, tmp, num_smooth_sweeps, relax_weight,
-                                    tap_level);
-                            break;
-                    }
-
+                    relax(level, x, b, tmp, tap_level);
 
                     A->residual(x, b, tmp, tap_level);
 
-                    P->mult_T(tmp, levels[level+1]->b, tap_level);
+                    P->mult_T(tmp, coarse_b, tap_level);
 
 
                     if (solve_times)
@@ -418,34 +1435,17 @@ namespace raptor
                         solve_times[5*level + 3] += vec_t;
                         solve_times[5*level + 4] += mat_t;
                     }
-                    cycle(levels[level+1]->x, levels[level+1]->b, level+1);
+                    cycle(coarse_x, coarse_b, level+1);
                     if (solve_times)
                     {
                         init_profile();
                     }
 
 
-                    P->mult_append(levels[level+1]->x, x, tap_level);
-
-                    switch (relax_type)
-                    {
-                        case Jacobi:
-                            jacobi(A, x, b, tmp, num_smooth_sweeps, relax_weight,
-                                    tap_level);
-                            break;
-                        case SOR:
-                            sor(A, x, b, tmp, num_smooth_sweeps, relax_weight,
-                                    tap_level);
-                            break;
-                        case SSOR:
-                            ssor(A, x, b, tmp, num_smooth_sweeps, relax_weight,
-                                    tap_level);
-                            break;
-                        default:
-                            sor(A, x, b, tmp, num_smooth_sweeps, relax_weight,
-                                    tap_level);
-                            break;
-                     }
+                    P->mult_append(coarse_x, x, tap_level);
+
+                    relax(level, x, b, tmp, tap_level);
+
                     if (solve_times)
                     {
                         finalize_profile();
@@ -539,6 +1539,82 @@ namespace raptor
                 return iter;
             }
 
+            /**************************************************************
+            *****   ParMultilevel Solve (Multiple Right-Hand Sides)
+            **************************************************************
+            ***** Cycles on all right-hand sides together until the 
+            ***** relative residual of every vector is below solve_tol.
+            ***** Stored residuals hold the largest relative residual.
+            **************************************************************/
+            int solve(ParMultiVector& sol, ParMultiVector& rhs)
+            {
+                std::vector<double> b_norms;
+                std::vector<double> r_norms;
+                double r_norm;
+                int iter = 0;
+
+                rhs.norm(2, b_norms);
+
+                if (store_residuals)
+                {
+                    residuals.resize(max_iterations + 1);
+                }
+
+                if (track_times)
+                {
+                    if (!solve_times) solve_times = new double[5*num_levels]();
+                }
+
+                // Iterate until convergence or max iterations
+                ParMultiVector resid(rhs.global_n, rhs.local_n, rhs.n_vecs);
+                while (true)
+                {
+                    if (track_times)
+                    {
+                        init_profile();
+                    }
+
+                    levels[0]->A->residual(sol, rhs, resid);
+                    resid.norm(2, r_norms);
+                    r_norm = 0;
+                    for (int v = 0; v < rhs.n_vecs; v++)
+                    {
+                        if (fabs(b_norms[v]) > zero_tol)
+                        {
+                            r_norms[v] /= b_norms[v];
+                        }
+                        if (r_norms[v] > r_norm)
+                        {
+                            r_norm = r_norms[v];
+                        }
+                    }
+                    if (store_residuals)
+                    {
+                        residuals[iter] = r_norm;
+                    }
+
+                    if (track_times)
+                    {
+                        finalize_profile();
+                        solve_times[0] += total_t;
+                        solve_times[1] += collective_t;
+                        solve_times[2] += p2p_t;
+                        solve_times[3] += vec_t;
+                        solve_times[4] += mat_t;
+                    }
+
+                    if (r_norm <= solve_tol || iter >= max_iterations)
+                    {
+                        break;
+                    }
+
+                    cycle(sol, rhs, 0);
+                    iter++;
+                }
+
+                return iter;
+            }
+
             void print_hierarchy()
             {
                 int rank;
@@ -558,8 +1634,9 @@ namespace raptor
                     RAPtor_MPI_Reduce(&lcl_nnz, &nnz, 1, RAPtor_MPI_LONG, RAPtor_MPI_SUM, 0, RAPtor_MPI_COMM_WORLD);
                     if (rank == 0)
                     {
-                        printf("%d\t%d\t%d\t%lu\n", i, 
-                                Al->global_num_rows, Al->global_num_cols, nnz);
+                        printf("%d\t%" PRId64 "\t%" PRId64 "\t%lu\n", i, 
+                                (int64_t) Al->global_num_rows, 
+                                (int64_t) Al->global_num_cols, nnz);
                     }
                 }
             }
@@ -629,13 +1706,23 @@ namespace raptor
             relax_t relax_type;
 
             int num_smooth_sweeps;
+            int chebyshev_degree;
+            int spectral_radius_iterations;
             int max_coarse;
             int max_levels;
             int tap_amg;
             int max_iterations;
+            int agglomerate_rows;
+
+            coarse_solve_t coarse_solve_type;
+            int max_dense_coarse;
+            int max_sparse_coarse;
+            int coarse_iterations;
 
             double strong_threshold;
             double relax_weight;
+            double chebyshev_lower;
+            double chebyshev_upper;
             double sparsify_tol;
             double solve_tol;
 
@@ -653,7 +1740,9 @@ namespace raptor
             double* setup_times;
             double* solve_times;
 
+            coarse_solve_t coarse_solver;
             int coarse_n;
+            SparseLU coarse_lu;
             std::vector<double> A_coarse;
             std::vector<int> coarse_sizes;
             std::vector<int> coarse_displs;
@@ -4,6 +4,33 @@
 
 using namespace raptor;
 
+/**************************************************************
+*****   Sparsify
+**************************************************************
+***** Non-Galerkin coarse operator: removes entries of the
+***** Galerkin product Ac = P^T*A*P that lie outside the minimal
+***** sparsity pattern M = I^T*A*P + P^T*A*I and are smaller than
+***** theta times the largest off-diagonal entry in their row.
+***** Removed entries are lumped into the diagonal, so row sums
+***** of Ac are kept.  Ac is sorted with the diagonal first in
+***** each row, and unused off_proc columns are removed (updating
+***** Ac->comm, if formed).
+*****
+***** Parameters
+***** -------------
+***** A : ParCSRMatrix*
+*****    Fine matrix
+***** P : ParCSRMatrix*
+*****    Interpolation
+***** I : ParCSRMatrix*
+*****    Injection from the coarse points (same layout as P)
+***** AP : ParCSRMatrix*
+*****    Product A*P
+***** Ac : ParCSRMatrix*
+*****    Galerkin product, sparsified in place
+***** theta : double
+*****    Relative drop tolerance
+**************************************************************/
 void sparsify(ParCSRMatrix* A, ParCSRMatrix* P, ParCSRMatrix* I, 
         ParCSRMatrix* AP, ParCSRMatrix* Ac, const double theta)
 {
@@ -16,12 +43,6 @@ void sparsify(ParCSRMatrix* A, ParCSRMatrix* P, ParCSRMatrix* I,
     delete M1;
     delete M2;
 
-    int nnz;
-    int rank;
-    RAPtor_MPI_Comm_rank(RAPtor_MPI_COMM_WORLD, &rank);
-    RAPtor_MPI_Reduce(&M->local_nnz, &nnz, 1, RAPtor_MPI_INT, RAPtor_MPI_SUM, 0, RAPtor_MPI_COMM_WORLD);
-    if (rank == 0) printf("NNZ %d\n", nnz);
-
     int diag_pos, ctr_on, ctr_off;
     int start_on, start_off;
     int end_on, end_off;
@@ -83,7 +104,7 @@ void sparsify(ParCSRMatrix* A, ParCSRMatrix* P, ParCSRMatrix* I,
         // For each val in row, check if in M, or if greater than theta*row_max
         ctr_M = M->on_proc->idx1[i];
         end_M = M->on_proc->idx1[i+1];
-        if (M->on_proc->idx2[ctr_M] == i)
+        if (ctr_M < end_M && M->on_proc->idx2[ctr_M] == i)
         {
             ctr_M++;
         }
@@ -175,10 +196,13 @@ void sparsify(ParCSRMatrix* A, ParCSRMatrix* P, ParCSRMatrix* I,
         *it = off_proc_col_to_new[*it];
     }
 
-    // Update communicate package (only recv if off proc col exists)
+    // Communication package only receives remaining off_proc columns
     if (Ac->comm)
     {
-        Ac->comm->update(off_proc_col_exists);
+        ParComm* comm = Ac->comm;
+        Ac->comm = new ParComm(Ac->partition, Ac->off_proc_column_map,
+                Ac->on_proc_column_map, comm->key, comm->mpi_comm);
+        comm->delete_comm();
     }
 
     delete M;
@@ -0,0 +1,148 @@
+// Copyright (c) 2015-2017, RAPtor Developer Team
+// License: Simplified BSD, http://opensource.org/licenses/BSD-2-Clause
+
+#include "gtest/gtest.h"
+#include "raptor.hpp"
+
+using namespace raptor;
+
+
+int argc;
+char **argv;
+
+int main(int _argc, char** _argv)
+{
+    MPI_Init(&_argc, &_argv);
+
+    ::testing::InitGoogleTest(&_argc, _argv);
+    argc = _argc;
+    argv = _argv;
+    int temp=RUN_ALL_TESTS();
+    MPI_Finalize();
+    return temp;
+} // end of main() //
+
+int num_active(ParCSRMatrix* A)
+{
+    int active = A->local_num_rows > 0;
+    MPI_Allreduce(MPI_IN_PLACE, &active, 1, MPI_INT, MPI_SUM, MPI_COMM_WORLD);
+    return active;
+}
+
+long global_nnz(ParCSRMatrix* A)
+{
+    long nnz = A->local_nnz;
+    MPI_Allreduce(MPI_IN_PLACE, &nnz, 1, MPI_LONG, MPI_SUM, MPI_COMM_WORLD);
+    return nnz;
+}
+
+double row_sum_norm(ParCSRMatrix* A)
+{
+    ParVector x(A->global_num_rows, A->local_num_rows);
+    ParVector b(A->global_num_rows, A->local_num_rows);
+    x.set_const_value(1.0);
+    A->mult(x, b);
+    return b.norm(2);
+}
+
+void test_agglomerate(ParMultilevel* ml, ParMultilevel* ml_agg, ParCSRMatrix* A)
+{
+    int num_procs;
+    MPI_Comm_size(MPI_COMM_WORLD, &num_procs);
+
+    int iter;
+    ParVector x(A->global_num_rows, A->local_num_rows);
+    ParVector b(A->global_num_rows, A->local_num_rows);
+
+    ml->setup(A);
+    ml_agg->agglomerate_rows = 50;
+    ml_agg->setup(A);
+
+    // Find first agglomerated level.  Levels above it are unchanged, and
+    // it holds the same operator as without agglomeration, on fewer
+    // processes.
+    int agg_level = -1;
+    for (int i = 0; i < ml_agg->num_levels; i++)
+    {
+        if (ml_agg->levels[i]->agglomerated)
+        {
+            agg_level = i;
+            break;
+        }
+    }
+    if (num_procs == 1)
+    {
+        ASSERT_EQ(agg_level, -1);
+    }
+    else
+    {
+        ASSERT_GT(agg_level, 0);
+        ParCSRMatrix* Ac = ml->levels[agg_level]->A;
+        ParCSRMatrix* Ac_agg = ml_agg->levels[agg_level]->A;
+        ASSERT_LT(num_active(Ac_agg), num_active(Ac));
+        ASSERT_EQ(Ac->global_num_rows, Ac_agg->global_num_rows);
+        ASSERT_EQ(global_nnz(Ac), global_nnz(Ac_agg));
+        ASSERT_NEAR(row_sum_norm(Ac), row_sum_norm(Ac_agg), 1e-10);
+    }
+
+    x.set_const_value(1.0);
+    A->mult(x, b);
+    x.set_const_value(0.0);
+    iter = ml_agg->solve(x, b);
+    ASSERT_LT(iter, ml_agg->max_iterations);
+
+    // Resetup with new values reuses the agglomerated levels
+    ParCSRMatrix* A_scaled = A->copy();
+    for (int i = 0; i < A_scaled->on_proc->nnz; i++)
+    {
+        A_scaled->on_proc->vals[i] *= 2.0;
+    }
+    for (int i = 0; i < A_scaled->off_proc->nnz; i++)
+    {
+        A_scaled->off_proc->vals[i] *= 2.0;
+    }
+    int n_levels = ml_agg->num_levels;
+    CommPkg* comm = ml_agg->levels[n_levels-1]->A->comm;
+    ml_agg->resetup(A_scaled);
+    ASSERT_EQ(n_levels, ml_agg->num_levels);
+    ASSERT_EQ(comm, ml_agg->levels[n_levels-1]->A->comm);
+
+    x.set_const_value(1.0);
+    A_scaled->mult(x, b);
+    x.set_const_value(0.0);
+    iter = ml_agg->solve(x, b);
+    ASSERT_LT(iter, ml_agg->max_iterations);
+
+    delete A_scaled;
+}
+
+TEST(ParAgglomerateTest, TestsInMultilevel)
+{
+    int dim = 3;
+    int grid[3] = {10, 10, 10};
+
+    ParMultilevel* ml;
+    ParMultilevel* ml_agg;
+    ParCSRMatrix* A;
+
+    double* stencil = laplace_stencil_27pt();
+    A = par_stencil_grid(stencil, grid, dim);
+    delete[] stencil;
+
+    // Ruge-Stuben
+    ml = new ParRugeStubenSolver(0.25, Falgout, ModClassical, Classical, SOR);
+    ml_agg = new ParRugeStubenSolver(0.25, Falgout, ModClassical, Classical, SOR);
+    test_agglomerate(ml, ml_agg, A);
+    delete ml;
+    delete ml_agg;
+
+    // Smoothed Aggregation
+    ml = new ParSmoothedAggregationSolver(0.0);
+    ml_agg = new ParSmoothedAggregationSolver(0.0);
+    test_agglomerate(ml, ml_agg, A);
+    delete ml;
+    delete ml_agg;
+
+    delete A;
+
+} // end of TEST(ParAgglomerateTest, TestsInMultilevel) //
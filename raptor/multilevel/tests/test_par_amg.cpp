@@ -13,6 +13,11 @@ char **argv;
 int main(int _argc, char** _argv)
 {
     MPI_Init(&_argc, &_argv);
+
+#ifdef USING_OPENMP
+    // Compare against serial (single thread) results
+    omp_set_num_threads(1);
+#endif
     
     ::testing::InitGoogleTest(&_argc, _argv);
     argc = _argc;
@@ -78,7 +83,8 @@ TEST(ParAMGTest, TestsInMultilevel)
 	    MPI_Reduce(&lcl_nnz, &nnz, 1, MPI_LONG, MPI_SUM, 0, MPI_COMM_WORLD);
 	    if (rank == 0)
 	    {
-            printf("%d\t%d\t%d\t%lu\n", i, Al->global_num_rows, Al->global_num_cols, nnz);
+            printf("%d\t%" PRId64 "\t%" PRId64 "\t%lu\n", i, 
+                    (int64_t) Al->global_num_rows, (int64_t) Al->global_num_cols, nnz);
         }
     }
 
@@ -94,7 +100,8 @@ TEST(ParAMGTest, TestsInMultilevel)
 	    MPI_Reduce(&lcl_nnz, &nnz, 1, MPI_LONG, MPI_SUM, 0, MPI_COMM_WORLD);
 	    if (rank == 0)
 	    {
-            printf("%d\t%d\t%d\t%lu\n", i, Pl->global_num_rows, Pl->global_num_cols, nnz);
+            printf("%d\t%" PRId64 "\t%" PRId64 "\t%lu\n", i, 
+                    (int64_t) Pl->global_num_rows, (int64_t) Pl->global_num_cols, nnz);
 	    }
     }
     
@@ -0,0 +1,114 @@
+// Copyright (c) 2015-2017, RAPtor Developer Team
+// License: Simplified BSD, http://opensource.org/licenses/BSD-2-Clause
+
+#include "gtest/gtest.h"
+#include "raptor.hpp"
+
+using namespace raptor;
+
+
+int argc;
+char **argv;
+
+int main(int _argc, char** _argv)
+{
+    MPI_Init(&_argc, &_argv);
+
+    ::testing::InitGoogleTest(&_argc, _argv);
+    argc = _argc;
+    argv = _argv;
+    int temp=RUN_ALL_TESTS();
+    MPI_Finalize();
+    return temp;
+} // end of main() //
+
+int solve_ones(ParMultilevel* ml, ParCSRMatrix* A)
+{
+    ParVector x(A->global_num_rows, A->local_num_rows);
+    ParVector b(A->global_num_rows, A->local_num_rows);
+    x.set_const_value(1.0);
+    A->mult(x, b);
+    x.set_const_value(0.0);
+    return ml->solve(x, b);
+}
+
+TEST(ParCoarseSolveTest, TestsInMultilevel)
+{
+    int dim = 3;
+    int grid[3] = {10, 10, 10};
+    int n_vecs = 3;
+    int iter;
+
+    ParMultilevel* ml;
+    ParMultilevel* ml_sparse;
+    ParCSRMatrix* A;
+
+    double* stencil = laplace_stencil_27pt();
+    A = par_stencil_grid(stencil, grid, dim);
+    delete[] stencil;
+
+    // Single level: the coarse solve is exact
+    ml = new ParRugeStubenSolver(0.25, Falgout, ModClassical, Classical, SOR);
+    ml->max_coarse = A->global_num_rows;
+    ml->coarse_solve_type = SparseCoarse;
+    ml->setup(A);
+    ASSERT_EQ(ml->num_levels, 1);
+    ASSERT_EQ(ml->coarse_solver, SparseCoarse);
+    ASSERT_EQ(solve_ones(ml, A), 1);
+    ASSERT_LT(ml->get_residuals()[1], 1e-12);
+
+    ParMultiVector X(A->global_num_rows, A->local_num_rows, n_vecs);
+    ParMultiVector B(A->global_num_rows, A->local_num_rows, n_vecs);
+    for (int i = 0; i < A->local_num_rows; i++)
+    {
+        for (int v = 0; v < n_vecs; v++)
+        {
+            X(i, v) = 1.0 + ((A->local_row_map[i] * (v + 3)) % 7);
+        }
+    }
+    A->mult(X, B);
+    X.set_const_value(0.0);
+    ASSERT_EQ(ml->solve(X, B), 1);
+    ASSERT_LT(ml->get_residuals()[1], 1e-12);
+    delete ml;
+
+    // Sparse and dense LU give the same V-cycles
+    ml = new ParRugeStubenSolver(0.25, Falgout, ModClassical, Classical, SOR);
+    ml_sparse = new ParRugeStubenSolver(0.25, Falgout, ModClassical, Classical, SOR);
+    ml->max_coarse = 300;
+    ml_sparse->max_coarse = 300;
+    ml->coarse_solve_type = DenseCoarse;
+    ml_sparse->coarse_solve_type = SparseCoarse;
+    ml->setup(A);
+    ml_sparse->setup(A);
+    ASSERT_GT(ml->num_levels, 1);
+    iter = solve_ones(ml, A);
+    ASSERT_EQ(solve_ones(ml_sparse, A), iter);
+    for (int i = 0; i <= iter; i++)
+    {
+        ASSERT_NEAR(ml->get_residuals()[i], ml_sparse->get_residuals()[i],
+                1e-6 * ml->get_residuals()[i]);
+    }
+    delete ml_sparse;
+
+    // Relaxation on the distributed coarse matrix still converges
+    ml->coarse_solve_type = IterativeCoarse;
+    ml->resetup(A);
+    ASSERT_EQ(ml->coarse_solver, IterativeCoarse);
+    ASSERT_LT(solve_ones(ml, A), ml->max_iterations);
+
+    // Automatic selection by coarse size
+    ml->coarse_solve_type = AutoCoarse;
+    ml->resetup(A);
+    ASSERT_EQ(ml->coarse_solver, DenseCoarse);
+    ml->max_dense_coarse = 10;
+    ml->resetup(A);
+    ASSERT_EQ(ml->coarse_solver, SparseCoarse);
+    ml->max_sparse_coarse = 10;
+    ml->resetup(A);
+    ASSERT_EQ(ml->coarse_solver, IterativeCoarse);
+    delete ml;
+
+    delete A;
+
+} // end of TEST(ParCoarseSolveTest, TestsInMultilevel) //
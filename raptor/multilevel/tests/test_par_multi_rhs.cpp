@@ -0,0 +1,147 @@
+// Copyright (c) 2015-2017, RAPtor Developer Team
+// License: Simplified BSD, http://opensource.org/licenses/BSD-2-Clause
+
+#include "gtest/gtest.h"
+#include "raptor.hpp"
+
+using namespace raptor;
+
+
+int argc;
+char **argv;
+
+int main(int _argc, char** _argv)
+{
+    MPI_Init(&_argc, &_argv);
+
+    ::testing::InitGoogleTest(&_argc, _argv);
+    argc = _argc;
+    argv = _argv;
+    int temp=RUN_ALL_TESTS();
+    MPI_Finalize();
+    return temp;
+} // end of main() //
+
+// Each vector of X must match the corresponding single vector
+void compare_vecs(ParMultiVector& X, std::vector<ParVector>& x)
+{
+    for (int v = 0; v < X.n_vecs; v++)
+    {
+        for (int i = 0; i < X.local_n; i++)
+        {
+            ASSERT_NEAR(X(i, v), x[v][i], 1e-10 * (1.0 + fabs(x[v][i])));
+        }
+    }
+}
+
+void test_multi_rhs(ParMultilevel* ml, ParCSRMatrix* A, int n_vecs)
+{
+    ParMultiVector X(A->global_num_rows, A->local_num_rows, n_vecs);
+    ParMultiVector B(A->global_num_rows, A->local_num_rows, n_vecs);
+    ParMultiVector R(A->global_num_rows, A->local_num_rows, n_vecs);
+    std::vector<ParVector> x(n_vecs);
+    std::vector<ParVector> b(n_vecs);
+    ParVector r(A->global_num_rows, A->local_num_rows);
+    std::vector<double> res;
+
+    ml->setup(A);
+
+    // Right-hand sides with different values in each vector
+    for (int i = 0; i < A->local_num_rows; i++)
+    {
+        index_t row = A->local_row_map[i];
+        for (int v = 0; v < n_vecs; v++)
+        {
+            B(i, v) = 1.0 + ((row * (v + 3)) % 7) - v;
+        }
+    }
+    for (int v = 0; v < n_vecs; v++)
+    {
+        B.get_vector(v, b[v]);
+        x[v].resize(A->global_num_rows, A->local_num_rows);
+    }
+
+    // SpMM and transposed SpMM
+    A->mult(B, X);
+    for (int v = 0; v < n_vecs; v++)
+        A->mult(b[v], x[v]);
+    compare_vecs(X, x);
+
+    A->mult_T(B, X);
+    for (int v = 0; v < n_vecs; v++)
+        A->mult_T(b[v], x[v]);
+    compare_vecs(X, x);
+
+    A->residual(X, B, R);
+    for (int v = 0; v < n_vecs; v++)
+    {
+        A->residual(x[v], b[v], r);
+        x[v].copy(r);
+    }
+    compare_vecs(R, x);
+
+    // One V-cycle on the block matches a V-cycle on each vector
+    X.set_const_value(0.0);
+    ml->cycle(X, B);
+    for (int v = 0; v < n_vecs; v++)
+    {
+        x[v].set_const_value(0.0);
+        ml->cycle(x[v], b[v]);
+    }
+    compare_vecs(X, x);
+
+    // Multi-vector solve converges on every right-hand side
+    X.set_const_value(0.0);
+    int iter = ml->solve(X, B);
+    ASSERT_LT(iter, ml->max_iterations);
+    for (int v = 0; v < n_vecs; v++)
+    {
+        X.get_vector(v, x[v]);
+        A->residual(x[v], b[v], r);
+        ASSERT_LT(r.norm(2), ml->solve_tol * b[v].norm(2) * 1.01);
+    }
+
+    // Preconditioned CG on the block matches PCG on each vector
+    X.set_const_value(0.0);
+    PCG(A, ml, X, B, res);
+    for (int v = 0; v < n_vecs; v++)
+    {
+        std::vector<double> res_v;
+        x[v].set_const_value(0.0);
+        PCG(A, ml, x[v], b[v], res_v);
+    }
+    for (int v = 0; v < n_vecs; v++)
+    {
+        for (int i = 0; i < X.local_n; i++)
+        {
+            ASSERT_NEAR(X(i, v), x[v][i], 1e-6 * (1.0 + fabs(x[v][i])));
+        }
+    }
+}
+
+TEST(ParMultiRHSTest, TestsInMultilevel)
+{
+    int dim = 3;
+    int grid[3] = {10, 10, 10};
+    int n_vecs = 3;
+
+    ParMultilevel* ml;
+    ParCSRMatrix* A;
+
+    double* stencil = laplace_stencil_27pt();
+    A = par_stencil_grid(stencil, grid, dim);
+    delete[] stencil;
+
+    ml = new ParRugeStubenSolver(0.25, Falgout, ModClassical, Classical, SOR);
+    test_multi_rhs(ml, A, n_vecs);
+    delete ml;
+
+    ml = new ParSmoothedAggregationSolver(0.0);
+    ml->relax_type = Jacobi;
+    test_multi_rhs(ml, A, n_vecs);
+    delete ml;
+
+    delete A;
+
+} // end of TEST(ParMultiRHSTest, TestsInMultilevel) //
+
@@ -0,0 +1,149 @@
+// Copyright (c) 2015-2017, RAPtor Developer Team
+// License: Simplified BSD, http://opensource.org/licenses/BSD-2-Clause
+
+#include "gtest/gtest.h"
+#include "raptor.hpp"
+#include "tests/par_compare.hpp"
+
+using namespace raptor;
+
+
+int argc;
+char **argv;
+
+int main(int _argc, char** _argv)
+{
+    MPI_Init(&_argc, &_argv);
+
+    ::testing::InitGoogleTest(&_argc, _argv);
+    argc = _argc;
+    argv = _argv;
+    int temp=RUN_ALL_TESTS();
+    MPI_Finalize();
+    return temp;
+} // end of main() //
+
+// Same sparsity as A, with values scaled and diagonal shifted
+ParCSRMatrix* new_values(ParCSRMatrix* A, double scale, double shift)
+{
+    ParCSRMatrix* A_new = A->copy();
+    for (int i = 0; i < A_new->local_num_rows; i++)
+    {
+        int start = A_new->on_proc->idx1[i];
+        int end = A_new->on_proc->idx1[i+1];
+        for (int j = start; j < end; j++)
+        {
+            A_new->on_proc->vals[j] *= scale;
+            if (A_new->on_proc->idx2[j] == i)
+                A_new->on_proc->vals[j] += shift;
+        }
+        start = A_new->off_proc->idx1[i];
+        end = A_new->off_proc->idx1[i+1];
+        for (int j = start; j < end; j++)
+        {
+            A_new->off_proc->vals[j] *= scale;
+        }
+    }
+    return A_new;
+}
+
+// Compare P and coarse A on the first n_levels levels
+void compare_hierarchies(ParMultilevel* ml, ParMultilevel* ml_new, int n_levels)
+{
+    for (int i = 0; i < n_levels; i++)
+    {
+        compare(ml->levels[i]->P, ml_new->levels[i]->P);
+        compare(ml->levels[i+1]->A, ml_new->levels[i+1]->A);
+    }
+}
+
+void test_resetup(ParMultilevel* ml, ParMultilevel* ml_scaled, 
+        ParMultilevel* ml_shifted, ParCSRMatrix* A)
+{
+    int iter;
+    ParVector x(A->global_num_rows, A->local_num_rows);
+    ParVector b(A->global_num_rows, A->local_num_rows);
+
+    // Scaling A scales every Galerkin product but keeps the coarsening,
+    // so resetup should reproduce a full setup on every level
+    ParCSRMatrix* A_scaled = new_values(A, 2.0, 0.0);
+    ml->setup(A);
+    CommPkg* comm = ml->levels[1]->A->comm;
+    ml->resetup(A_scaled);
+    ml_scaled->setup(A_scaled);
+    ASSERT_EQ(ml->num_levels, ml_scaled->num_levels);
+    ASSERT_EQ(comm, ml->levels[1]->A->comm);
+    compare_hierarchies(ml, ml_scaled, ml->num_levels - 1);
+
+    // Later resetups only repeat the numeric phase of the Galerkin
+    // products formed by the first
+    ml->resetup(A);
+    ml->resetup(A_scaled);
+    ASSERT_EQ(ml->num_levels, ml_scaled->num_levels);
+    for (int i = 0; i < ml->num_levels - 1; i++)
+    {
+        ASSERT_TRUE(ml->levels[i]->Ac_plan != NULL);
+    }
+    compare_hierarchies(ml, ml_scaled, ml->num_levels - 1);
+
+    // Shifting the diagonal keeps the fine-level strength pattern, so the
+    // first level must match a full setup
+    ParCSRMatrix* A_shifted = new_values(A, 2.0, 1.0);
+    ml->resetup(A_shifted);
+    ml_shifted->setup(A_shifted);
+    compare_hierarchies(ml, ml_shifted, 1);
+
+    x.set_const_value(1.0);
+    A_shifted->mult(x, b);
+    x.set_const_value(0.0);
+    iter = ml->solve(x, b);
+    ASSERT_LT(iter, ml->max_iterations);
+
+    // Back to the original matrix
+    ml->resetup(A);
+    x.set_const_value(1.0);
+    A->mult(x, b);
+    x.set_const_value(0.0);
+    iter = ml->solve(x, b);
+    ASSERT_LT(iter, ml->max_iterations);
+
+    delete A_shifted;
+    delete A_scaled;
+}
+
+TEST(ParResetupTest, TestsInMultilevel)
+{
+    int dim = 3;
+    int grid[3] = {10, 10, 10};
+
+    ParMultilevel* ml;
+    ParMultilevel* ml_scaled;
+    ParMultilevel* ml_shifted;
+    ParCSRMatrix* A;
+
+    double* stencil = laplace_stencil_27pt();
+    A = par_stencil_grid(stencil, grid, dim);
+    delete[] stencil;
+
+    // Ruge-Stuben
+    ml = new ParRugeStubenSolver(0.25, Falgout, ModClassical, Classical, SOR);
+    ml_scaled = new ParRugeStubenSolver(0.25, Falgout, ModClassical, Classical, SOR);
+    ml_shifted = new ParRugeStubenSolver(0.25, Falgout, ModClassical, Classical, SOR);
+    test_resetup(ml, ml_scaled, ml_shifted, A);
+    delete ml;
+    delete ml_scaled;
+    delete ml_shifted;
+
+    // Smoothed Aggregation
+    ml = new ParSmoothedAggregationSolver(0.0);
+    ml_scaled = new ParSmoothedAggregationSolver(0.0);
+    ml_shifted = new ParSmoothedAggregationSolver(0.0);
+    test_resetup(ml, ml_scaled, ml_shifted, A);
+    delete ml;
+    delete ml_scaled;
+    delete ml_shifted;
+
+    delete A;
+
+} // end of TEST(ParResetupTest, TestsInMultilevel) //
+
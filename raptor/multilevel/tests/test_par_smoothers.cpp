@@ -0,0 +1,126 @@
+// Copyright (c) 2015-2017, RAPtor Developer Team
+// License: Simplified BSD, http://opensource.org/licenses/BSD-2-Clause
+
+#include "gtest/gtest.h"
+#include "raptor.hpp"
+
+using namespace raptor;
+
+
+int argc;
+char **argv;
+
+int main(int _argc, char** _argv)
+{
+    MPI_Init(&_argc, &_argv);
+
+    ::testing::InitGoogleTest(&_argc, _argv);
+    argc = _argc;
+    argv = _argv;
+    int temp=RUN_ALL_TESTS();
+    MPI_Finalize();
+    return temp;
+} // end of main() //
+
+int solve_ones(ParMultilevel* ml, ParCSRMatrix* A)
+{
+    ParVector x(A->global_num_rows, A->local_num_rows);
+    ParVector b(A->global_num_rows, A->local_num_rows);
+    x.set_const_value(1.0);
+    A->mult(x, b);
+    x.set_const_value(0.0);
+    return ml->solve(x, b);
+}
+
+int solve_multi(ParMultilevel* ml, ParCSRMatrix* A, int n_vecs)
+{
+    ParMultiVector X(A->global_num_rows, A->local_num_rows, n_vecs);
+    ParMultiVector B(A->global_num_rows, A->local_num_rows, n_vecs);
+    for (int i = 0; i < A->local_num_rows; i++)
+    {
+        for (int v = 0; v < n_vecs; v++)
+        {
+            X(i, v) = 1.0 + ((A->local_row_map[i] * (v + 3)) % 7);
+        }
+    }
+    A->mult(X, B);
+    X.set_const_value(0.0);
+    return ml->solve(X, B);
+}
+
+TEST(ParSmoothersTest, TestsInMultilevel)
+{
+    int grid_1d[1] = {30};
+    int dim = 3;
+    int grid[3] = {10, 10, 10};
+    int n_vecs = 3;
+    int iter;
+    double pi = 4.0 * atan(1.0);
+
+    ParMultilevel* ml;
+    ParCSRMatrix* A;
+
+    // Spectral radius of D^{-1}A for the 1D Laplacian is 1 + cos(pi/(n+1)),
+    // found exactly once the Krylov space spans the whole grid
+    double stencil_1d[3] = {-1.0, 2.0, -1.0};
+    A = par_stencil_grid(stencil_1d, grid_1d, 1);
+    ASSERT_NEAR(spectral_radius(A, 30), 1.0 + cos(pi / 31.0), 1e-8);
+    ASSERT_LE(spectral_radius(A, 10), 1.0 + cos(pi / 31.0) + 1e-10);
+    ASSERT_GT(spectral_radius(A, 10), 1.9);
+    delete A;
+
+    double* stencil = laplace_stencil_27pt();
+    A = par_stencil_grid(stencil, grid, dim);
+    delete[] stencil;
+
+    // Chebyshev: spectral radius cached on every level
+    ml = new ParRugeStubenSolver(0.25, Falgout, ModClassical, Classical, Chebyshev);
+    ml->setup(A);
+    for (int i = 0; i < ml->num_levels; i++)
+    {
+        ASSERT_GT(ml->levels[i]->rho, 0.0);
+        ASSERT_LT(ml->levels[i]->rho, 2.0);
+    }
+    iter = solve_ones(ml, A);
+    ASSERT_LT(iter, 20);
+    ASSERT_LT(solve_multi(ml, A, n_vecs), 20);
+
+    // Higher degree polynomials smooth more per cycle
+    ml->chebyshev_degree = 4;
+    ASSERT_LE(solve_ones(ml, A), iter);
+
+    // Estimates are refreshed by resetup
+    ParCSRMatrix* A_scaled = A->copy();
+    for (int i = 0; i < A_scaled->on_proc->nnz; i++)
+    {
+        A_scaled->on_proc->vals[i] *= 2.0;
+    }
+    for (int i = 0; i < A_scaled->off_proc->nnz; i++)
+    {
+        A_scaled->off_proc->vals[i] *= 2.0;
+    }
+    double rho = ml->levels[0]->rho;
+    ml->levels[0]->rho = 0.0;
+    ml->resetup(A_scaled);
+    ASSERT_NEAR(ml->levels[0]->rho, rho, 1e-10);
+    ASSERT_LT(solve_ones(ml, A_scaled), 20);
+    delete A_scaled;
+    delete ml;
+
+    // L1 Jacobi needs no weight
+    ml = new ParRugeStubenSolver(0.25, Falgout, ModClassical, Classical, L1Jacobi);
+    ml->setup(A);
+    ASSERT_LT(solve_ones(ml, A), ml->max_iterations);
+    ASSERT_LT(solve_multi(ml, A, n_vecs), ml->max_iterations);
+    delete ml;
+
+    // Smoothed aggregation with Chebyshev
+    ml = new ParSmoothedAggregationSolver(0.0, MIS, JacobiProlongation, Symmetric,
+            Chebyshev);
+    ml->setup(A);
+    ASSERT_LT(solve_ones(ml, A), ml->max_iterations);
+    delete ml;
+
+    delete A;
+
+} // end of TEST(ParSmoothersTest, TestsInMultilevel) //
@@ -112,10 +112,33 @@ TEST(ParSparsifyTest, TestsInMultilevel)
     I->off_proc->nnz = 0;
     I->finalize();
 
-    printf("%d, %d\n", Ac->off_proc_num_cols, Ac_rap->off_proc_num_cols);
+    ParCSRMatrix* Ac_gal = Ac->copy();
     sparsify(A, P, I, AP, Ac, 0.1);
-    printf("%d, %d\n", Ac->off_proc_num_cols, Ac_rap->off_proc_num_cols);
-    //compare(Ac, Ac_rap);
+
+    // Dropped entries are lumped into the diagonal
+    int nnz, nnz_gal;
+    double row_sum, row_sum_gal;
+    for (int i = 0; i < Ac->local_num_rows; i++)
+    {
+        ASSERT_EQ(Ac->on_proc->idx2[Ac->on_proc->idx1[i]], i);
+        row_sum = 0;
+        row_sum_gal = 0;
+        for (int j = Ac->on_proc->idx1[i]; j < Ac->on_proc->idx1[i+1]; j++)
+            row_sum += Ac->on_proc->vals[j];
+        for (int j = Ac->off_proc->idx1[i]; j < Ac->off_proc->idx1[i+1]; j++)
+            row_sum += Ac->off_proc->vals[j];
+        for (int j = Ac_gal->on_proc->idx1[i]; j < Ac_gal->on_proc->idx1[i+1]; j++)
+            row_sum_gal += Ac_gal->on_proc->vals[j];
+        for (int j = Ac_gal->off_proc->idx1[i]; j < Ac_gal->off_proc->idx1[i+1]; j++)
+            row_sum_gal += Ac_gal->off_proc->vals[j];
+        ASSERT_NEAR(row_sum, row_sum_gal, 1e-10);
+    }
+    ASSERT_LE(Ac->off_proc_num_cols, Ac_gal->off_proc_num_cols);
+    ASSERT_EQ(Ac->comm->recv_data->size_msgs, Ac->off_proc_num_cols);
+    MPI_Allreduce(&Ac->local_nnz, &nnz, 1, MPI_INT, MPI_SUM, MPI_COMM_WORLD);
+    MPI_Allreduce(&Ac_gal->local_nnz, &nnz_gal, 1, MPI_INT, MPI_SUM, MPI_COMM_WORLD);
+    ASSERT_LT(nnz, nnz_gal);
+    delete Ac_gal;
 
     delete AP;
     delete P;
@@ -125,5 +148,56 @@ TEST(ParSparsifyTest, TestsInMultilevel)
     delete S;
     delete A;
 
-} // end of TEST(ParAMGTest, TestsInMultilevel) //
+} // end of TEST(ParSparsifyTest, TestsInMultilevel) //
+
+TEST(ParSparsifySolverTest, TestsInMultilevel)
+{
+    int grid[3] = {20, 20, 20};
+    double* stencil = laplace_stencil_27pt();
+    ParCSRMatrix* A = par_stencil_grid(stencil, grid, 3);
+    delete[] stencil;
+
+    ParVector x(A->global_num_rows, A->local_num_rows);
+    ParVector b(A->global_num_rows, A->local_num_rows);
+    int iter, nnz, nnz_gal;
+
+    ParMultilevel* ml_gal = new ParRugeStubenSolver(0.25, Falgout, ModClassical, 
+            Classical, SOR);
+    ml_gal->setup(A);
+
+    ParMultilevel* ml = new ParRugeStubenSolver(0.25, Falgout, ModClassical, 
+            Classical, SOR);
+    ml->sparsify_tol = 0.1;
+    ml->setup(A);
+
+    // The first level matches, and the sparsified operator is smaller
+    compare(ml->levels[0]->P, ml_gal->levels[0]->P);
+    ASSERT_TRUE(ml->levels[0]->I != NULL);
+    ASSERT_TRUE(ml->levels[0]->AP != NULL);
+    ParCSRMatrix* Ac = ml->levels[1]->A;
+    ParCSRMatrix* Ac_gal = ml_gal->levels[1]->A;
+    ASSERT_EQ(Ac->global_num_rows, Ac_gal->global_num_rows);
+    MPI_Allreduce(&Ac->local_nnz, &nnz, 1, MPI_INT, MPI_SUM, MPI_COMM_WORLD);
+    MPI_Allreduce(&Ac_gal->local_nnz, &nnz_gal, 1, MPI_INT, MPI_SUM, MPI_COMM_WORLD);
+    ASSERT_LT(nnz, nnz_gal);
+    ASSERT_LE(Ac->off_proc_num_cols, Ac_gal->off_proc_num_cols);
+
+    x.set_const_value(1.0);
+    A->mult(x, b);
+    x.set_const_value(0.0);
+    iter = ml->solve(x, b);
+    ASSERT_LT(iter, ml->max_iterations);
+
+    // Resetup with the same matrix reproduces the hierarchy
+    CommPkg* comm = ml->levels[1]->A->comm;
+    ml->resetup(A);
+    ASSERT_EQ(comm, ml->levels[1]->A->comm);
+    x.set_const_value(0.0);
+    ASSERT_EQ(ml->solve(x, b), iter);
+
+    delete ml_gal;
+    delete ml;
+    delete A;
+
+} // end of TEST(ParSparsifySolverTest, TestsInMultilevel) //
 
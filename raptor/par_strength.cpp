@@ -45,12 +45,10 @@ ParCSRMatrix* classical_strength(ParCSRMatrix* A, double theta, bool tap_amg, in
     if (A->on_proc->nnz)
     {
         S->on_proc->idx2.resize(A->on_proc->nnz);
-        S->on_proc->vals.resize(A->on_proc->nnz);
     }
     if (A->off_proc->nnz)
     {
         S->off_proc->idx2.resize(A->off_proc->nnz);
-        S->off_proc->vals.resize(A->off_proc->nnz);
     }
 
     S->on_proc->idx1[0] = 0;
@@ -186,7 +184,6 @@ ParCSRMatrix* classical_strength(ParCSRMatrix* A, double theta, bool tap_amg, in
 
             // Always add diagonal
             S->on_proc->idx2[S->on_proc->nnz] = i;
-            S->on_proc->vals[S->on_proc->nnz] = diag;
             S->on_proc->nnz++;
 
             // Add all off-diagonal entries to strength
@@ -203,7 +200,6 @@ ParCSRMatrix* classical_strength(ParCSRMatrix* A, double theta, bool tap_amg, in
                         {
                             col = A->on_proc->idx2[j];
                             S->on_proc->idx2[S->on_proc->nnz] = col;
-                            S->on_proc->vals[S->on_proc->nnz] = val;
                             S->on_proc->nnz++;
                         }
                     }
@@ -214,7 +210,6 @@ ParCSRMatrix* classical_strength(ParCSRMatrix* A, double theta, bool tap_amg, in
                         {
                             col = A->off_proc->idx2[j];
                             S->off_proc->idx2[S->off_proc->nnz] = col;
-                            S->off_proc->vals[S->off_proc->nnz] = val;
                             S->off_proc->nnz++;
                         }
                     }
@@ -228,7 +223,6 @@ ParCSRMatrix* classical_strength(ParCSRMatrix* A, double theta, bool tap_amg, in
                         {
                             col = A->on_proc->idx2[j];
                             S->on_proc->idx2[S->on_proc->nnz] = col;
-                            S->on_proc->vals[S->on_proc->nnz] = val;
                             S->on_proc->nnz++;
                         }
                     }
@@ -239,7 +233,6 @@ ParCSRMatrix* classical_strength(ParCSRMatrix* A, double theta, bool tap_amg, in
                         {
                             col = A->off_proc->idx2[j];
                             S->off_proc->idx2[S->off_proc->nnz] = col;
-                            S->off_proc->vals[S->off_proc->nnz] = val;
                             S->off_proc->nnz++;
                         }
                     }
@@ -258,7 +251,6 @@ ParCSRMatrix* classical_strength(ParCSRMatrix* A, double theta, bool tap_amg, in
                             if (val > threshold)
                             {
                                 S->on_proc->idx2[S->on_proc->nnz] = col;
-                                S->on_proc->vals[S->on_proc->nnz] = val;
                                 S->on_proc->nnz++;
                             }
                         }
@@ -272,7 +264,6 @@ ParCSRMatrix* classical_strength(ParCSRMatrix* A, double theta, bool tap_amg, in
                             if (val > threshold)
                             {
                                 S->off_proc->idx2[S->off_proc->nnz] = col;
-                                S->off_proc->vals[S->off_proc->nnz] = val;
                                 S->off_proc->nnz++;
                             }
                         }
@@ -289,7 +280,6 @@ ParCSRMatrix* classical_strength(ParCSRMatrix* A, double theta, bool tap_amg, in
                             if (val < threshold)
                             {
                                 S->on_proc->idx2[S->on_proc->nnz] = col;
-                                S->on_proc->vals[S->on_proc->nnz] = val;
                                 S->on_proc->nnz++;
                             }
                         }
@@ -303,7 +293,6 @@ ParCSRMatrix* classical_strength(ParCSRMatrix* A, double theta, bool tap_amg, in
                             if (val < threshold)
                             {
                                 S->off_proc->idx2[S->off_proc->nnz] = col;
-                                S->off_proc->vals[S->off_proc->nnz] = val;
                                 S->off_proc->nnz++;
                             }
                         }
@@ -320,11 +309,6 @@ ParCSRMatrix* classical_strength(ParCSRMatrix* A, double theta, bool tap_amg, in
     S->off_proc->idx2.resize(S->off_proc->nnz);
     S->off_proc->idx2.shrink_to_fit();
 
-    S->on_proc->vals.resize(S->on_proc->nnz);
-    S->on_proc->vals.shrink_to_fit();
-    S->off_proc->vals.resize(S->off_proc->nnz);
-    S->off_proc->vals.shrink_to_fit();
-
     S->local_nnz = S->on_proc->nnz + S->off_proc->nnz;
 
     S->on_proc_column_map = A->get_on_proc_column_map();
@@ -377,13 +361,11 @@ ParCSRMatrix* symmetric_strength(ParCSRMatrix* A, double theta, bool tap_amg)
     if (A->on_proc->nnz)
     {
         S->on_proc->idx2.resize(A->on_proc->nnz);
-        S->on_proc->vals.resize(A->on_proc->nnz);
         S->on_proc->nnz = 0;
     }
     if (A->off_proc->nnz)
     {
         S->off_proc->idx2.resize(A->off_proc->nnz);
-        S->off_proc->vals.resize(A->off_proc->nnz);
         S->off_proc->nnz = 0;
     }
 
@@ -472,8 +454,8 @@ ParCSRMatrix* symmetric_strength(ParCSRMatrix* A, double theta, bool tap_amg)
 
             // Always add diagonal
             S->on_proc->idx2[S->on_proc->nnz] = i;
-            S->on_proc->vals[S->on_proc->nnz] = A->on_proc->vals[row_start_on++];
             S->on_proc->nnz++;
+            row_start_on++;
 
             // Add all off-diagonal entries to strength
             // if magnitude greater than equal to 
@@ -487,7 +469,6 @@ ParCSRMatrix* symmetric_strength(ParCSRMatrix* A, double theta, bool tap_amg)
                         || (!neg_diags[col] && val < row_scales[col]))
                 {
                     S->on_proc->idx2[S->on_proc->nnz] = col;
-                    S->on_proc->vals[S->on_proc->nnz] = val;
                     S->on_proc->nnz++;
                 }
             }
@@ -500,7 +481,6 @@ ParCSRMatrix* symmetric_strength(ParCSRMatrix* A, double theta, bool tap_amg)
                         || (!off_proc_neg_diags[col] && val < off_proc_row_scales[col]))
                 {
                     S->off_proc->idx2[S->off_proc->nnz] = col;
-                    S->off_proc->vals[S->off_proc->nnz] = val;
                     S->off_proc->nnz++;
                 }
             }                    
@@ -513,11 +493,6 @@ ParCSRMatrix* symmetric_strength(ParCSRMatrix* A, double theta, bool tap_amg)
     S->off_proc->idx2.resize(S->off_proc->nnz);
     S->off_proc->idx2.shrink_to_fit();
 
-    S->on_proc->vals.resize(S->on_proc->nnz);
-    S->on_proc->vals.shrink_to_fit();
-    S->off_proc->vals.resize(S->off_proc->nnz);
-    S->off_proc->vals.shrink_to_fit();
-
     S->local_nnz = S->on_proc->nnz + S->off_proc->nnz;
 
     S->on_proc_column_map = A->get_on_proc_column_map();
@@ -538,6 +513,9 @@ ParCSRMatrix* symmetric_strength(ParCSRMatrix* A, double theta, bool tap_amg)
 
 // Assumes ParCSRMatrix is previously sorted
 // TODO -- have ParCSRMatrix bool sorted (and sort if not previously)
+// Returns the sparsity pattern of strong connections only: S->on_proc and
+// S->off_proc hold no values (data_size() == 0), so consumers that need
+// a_ij read it from A
 ParCSRMatrix* ParCSRMatrix::strength(strength_t strength_type,
         double theta, bool tap_amg, int num_variables, int* variables)
 {
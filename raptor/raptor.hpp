@@ -6,6 +6,7 @@
 // Define types such as int and double sizes
 #include "core/types.hpp"
 #include "core/utilities.hpp"
+#include "core/int_map.hpp"
 
 // Data about topology and matrix partitions
 #ifndef NO_MPI
@@ -101,9 +102,13 @@
     #include "util/linalg/par_relax.hpp"
 #endif
 
+// Sparse direct solver
+#include "util/linalg/sparse_lu.hpp"
+
 // Repartitioning matrix methods
 #ifndef NO_MPI
 #include "util/linalg/repartition.hpp"
+#include "util/linalg/par_partitioner.hpp"
 #endif
 #ifdef USING_PTSCOTCH
     #include "util/linalg/external/ptscotch_wrapper.hpp"
@@ -45,7 +45,7 @@ void find_off_proc_weights(CommPkg* comm, const std::vector<int>& states,
 int find_off_proc_states(CommPkg* comm, const std::vector<int>& states,
         std::vector<int>& off_proc_states, bool first_pass = false);
 void find_off_proc_new_coarse(const ParCSRMatrix* S, CommPkg* comm,
-        const std::map<int, int>& global_to_local, const std::vector<int>& states,
+        const IntMap<index_t>& global_to_local, const std::vector<int>& states,
         const std::vector<int>& off_proc_states, const int* part_to_col,
         std::vector<int>& off_proc_col_ptr, std::vector<int>& off_proc_col_coarse,
         bool first_pass = false);
@@ -79,7 +79,8 @@ void split_rs(ParCSRMatrix* S, std::vector<int>& states,
 
     std::vector<int>& recvbuf = comm->communicate(states);
 
-    std::copy(recvbuf.begin(), recvbuf.end(), off_proc_states.begin());
+    std::copy(recvbuf.begin(), recvbuf.begin() + S->off_proc_num_cols, 
+            off_proc_states.begin());
 }
 
 void split_cljp(ParCSRMatrix* S, std::vector<int>& states, 
@@ -162,6 +163,147 @@ void split_hmis(ParCSRMatrix* S, std::vector<int>& states,
     pmis_main_loop(S, states, off_proc_states, tap_cf, rand_vals);
 }
 
+/**************************************************************
+*****   Split Aggressive
+**************************************************************
+***** Two-stage aggressive coarsening.  A first PMIS (or HMIS)
+***** splitting of S gives the points C1.  Two points of C1 are
+***** then connected if a path of at most two strong connections
+***** joins them, and a second splitting of this distance-two
+***** graph selects the final coarse points from C1.  Points of C1
+***** with no other C1 point within distance two remain coarse.
+*****
+***** Parameters
+***** -------------
+***** S : ParCSRMatrix*
+*****    Strength of connection matrix
+***** states : std::vector<int>&
+*****    Returns Selected for coarse points, Unselected for fine
+***** off_proc_states : std::vector<int>&
+*****    Returns states of the off_proc columns of S
+***** coarsen_type : coarsen_t
+*****    HMIS for both stages, otherwise PMIS
+**************************************************************/
+void split_aggressive(ParCSRMatrix* S, std::vector<int>& states,
+        std::vector<int>& off_proc_states, coarsen_t coarsen_type,
+        bool tap_cf, double* rand_vals)
+{
+    int start, end, ctr;
+    CommPkg* comm = S->comm;
+    if (tap_cf)
+    {
+        comm = S->tap_comm;
+    }
+
+    // First stage
+    if (coarsen_type == HMIS)
+    {
+        split_hmis(S, states, off_proc_states, tap_cf, rand_vals);
+    }
+    else
+    {
+        split_pmis(S, states, off_proc_states, tap_cf, rand_vals);
+    }
+
+    // Pattern of S with unit values and diagonal, so that products 
+    // count paths rather than cancel
+    ParCSRMatrix* S1 = S->copy();
+    S1->on_proc->idx2.clear();
+    S1->on_proc->vals.clear();
+    S1->on_proc->idx1[0] = 0;
+    for (int i = 0; i < S->local_num_rows; i++)
+    {
+        S1->on_proc->idx2.emplace_back(i);
+        S1->on_proc->vals.emplace_back(1.0);
+        start = S->on_proc->idx1[i];
+        end = S->on_proc->idx1[i+1];
+        for (int j = start; j < end; j++)
+        {
+            if (S->on_proc->idx2[j] == i) continue;
+            S1->on_proc->idx2.emplace_back(S->on_proc->idx2[j]);
+            S1->on_proc->vals.emplace_back(1.0);
+        }
+        S1->on_proc->idx1[i+1] = S1->on_proc->idx2.size();
+    }
+    S1->on_proc->nnz = S1->on_proc->idx2.size();
+    S1->off_proc->vals.assign(S1->off_proc->nnz, 1.0);
+    S1->local_nnz = S1->on_proc->nnz + S1->off_proc->nnz;
+
+    ParCSRMatrix* S2 = S1->mult(S1);
+    delete S1;
+
+    // Injection onto the first-stage coarse points
+    int n_coarse = 0;
+    for (int i = 0; i < S->local_num_rows; i++)
+    {
+        if (states[i] == Selected) n_coarse++;
+    }
+    index_t local_coarse = n_coarse;
+    index_t global_coarse;
+    RAPtor_MPI_Allreduce(&local_coarse, &global_coarse, 1, RAPtor_MPI_INDEX_T,
+            RAPtor_MPI_SUM, RAPtor_MPI_COMM_WORLD);
+    ParCSRMatrix* P = new ParCSRMatrix(S->partition, S->global_num_rows,
+            global_coarse, S->local_num_rows, n_coarse, 0);
+    std::vector<double> coarse_rand;
+    ctr = 0;
+    for (int i = 0; i < S->local_num_rows; i++)
+    {
+        if (states[i] == Selected)
+        {
+            P->on_proc->idx2.emplace_back(ctr++);
+            P->on_proc->vals.emplace_back(1.0);
+            P->on_proc_column_map.emplace_back(S->on_proc_column_map[i]);
+            if (rand_vals) coarse_rand.emplace_back(rand_vals[i]);
+        }
+        P->on_proc->idx1[i+1] = P->on_proc->idx2.size();
+        P->off_proc->idx1[i+1] = 0;
+    }
+    P->on_proc->nnz = P->on_proc->idx2.size();
+    P->local_nnz = P->on_proc->nnz;
+    P->local_row_map = S->get_local_row_map();
+    P->comm = new ParComm(P->partition, P->off_proc_column_map,
+            P->on_proc_column_map, S->comm->key, S->comm->mpi_comm);
+
+    // Distance-two strength among the first-stage coarse points
+    ParCSRMatrix* SC = S2->rap(P);
+    delete S2;
+    delete P;
+    SC->comm = new ParComm(SC->partition, SC->off_proc_column_map,
+            SC->on_proc_column_map, S->comm->key, S->comm->mpi_comm);
+
+    // Second stage
+    std::vector<int> coarse_states;
+    std::vector<int> off_proc_coarse_states;
+    double* coarse_rand_vals = rand_vals ? coarse_rand.data() : NULL;
+    if (coarsen_type == HMIS)
+    {
+        split_hmis(SC, coarse_states, off_proc_coarse_states, false,
+                coarse_rand_vals);
+    }
+    else
+    {
+        split_pmis(SC, coarse_states, off_proc_coarse_states, false,
+                coarse_rand_vals);
+    }
+    delete SC;
+
+    ctr = 0;
+    for (int i = 0; i < S->local_num_rows; i++)
+    {
+        if (states[i] == Selected)
+        {
+            if (coarse_states[ctr++] == Unselected)
+            {
+                states[i] = Unselected;
+            }
+        }
+    }
+
+    std::vector<int>& recvbuf = comm->communicate(states);
+    std::copy(recvbuf.begin(), recvbuf.begin() + S->off_proc_num_cols, 
+            off_proc_states.begin());
+}
+
 void set_initial_states(ParCSRMatrix* S, std::vector<int>& states)
 {
     if (S->local_num_rows == 0) return;
@@ -734,20 +876,12 @@ void update_off_proc_dist2_weights(const ParCSRMatrix* S,
     std::vector<int> off_indices;
     std::vector<int> on_proc_col_to_coarse;
     std::vector<int> off_proc_col_to_coarse;
-    std::map<int, int> map_to_local;
-    
     std::vector<int> c_dep_cache;
     if (S->off_proc_num_cols)
     {
         c_dep_cache.resize(S->off_proc_num_cols, Unassigned);
     }
 
-    // Map global off_proc columns to local indices
-    for (int i = 0; i < S->off_proc_num_cols; i++)
-    {
-        map_to_local[S->off_proc_column_map[i]] = i;
-    }
-
     // Map index i in on(/off)_proc_num_cols to coarse_list
     if (S->on_proc_num_cols)
     {
@@ -979,7 +1113,7 @@ int find_off_proc_states(CommPkg* comm,
 
 void find_off_proc_new_coarse(const ParCSRMatrix* S,
         CommPkg* comm,
-        const std::map<int, int>& global_to_local,
+        const IntMap<index_t>& global_to_local,
         const std::vector<int>& states,
         const std::vector<int>& off_proc_states,
         const int* part_to_col,
@@ -994,14 +1128,14 @@ void find_off_proc_new_coarse(const ParCSRMatrix* S,
     int proc, count, buf_ptr;
     int ctr;
     int tag = 2999;
-    int global_col;
+    index_t global_col;
     int n_sends = 0;
     int msg_avail;
     RAPtor_MPI_Status recv_status;
 
     std::vector<int> send_ptr;
-    std::vector<int> send_buffer;
-    std::vector<int> recv_buffer;
+    std::vector<index_t> send_buffer;
+    std::vector<index_t> recv_buffer;
 
     off_proc_col_coarse.clear();
     int off_proc_num_cols = off_proc_states.size();
@@ -1053,7 +1187,7 @@ void find_off_proc_new_coarse(const ParCSRMatrix* S,
             end = recv_mat->idx1[i+1];
             for (int j = start; j < end; j++)
             {
-                global_col = recv_mat->idx2[j];
+                global_col = recv_mat->global_idx2[j];
                 if (global_col >= S->partition->first_local_col 
                         && global_col <= S->partition->last_local_col)
                 {
@@ -1062,11 +1196,10 @@ void find_off_proc_new_coarse(const ParCSRMatrix* S,
                 }
                 else
                 {
-                    std::map<int, int>::const_iterator ptr = 
-                    global_to_local.find(global_col);
-                    if (ptr != global_to_local.end())
+                    idx = global_to_local.find(global_col);
+                    if (idx >= 0)
                     {
-                        off_proc_col_coarse.emplace_back(ptr->second + S->on_proc_num_cols);
+                        off_proc_col_coarse.emplace_back(idx + S->on_proc_num_cols);
                     }   
                 }
             }
@@ -1144,7 +1277,7 @@ void find_off_proc_new_coarse(const ParCSRMatrix* S,
             end = send_ptr[i+1];
             if (end - start)
             {
-                RAPtor_MPI_Isend(&(send_buffer[start]), end - start, RAPtor_MPI_INT, proc,
+                RAPtor_MPI_Isend(&(send_buffer[start]), end - start, RAPtor_MPI_INDEX_T, proc,
                         tag, RAPtor_MPI_COMM_WORLD, &(S->comm->send_data->requests[n_sends++]));
             }
         }
@@ -1169,13 +1302,13 @@ void find_off_proc_new_coarse(const ParCSRMatrix* S,
             if (msg_avail)
             {
                 RAPtor_MPI_Probe(proc, tag, RAPtor_MPI_COMM_WORLD, &recv_status);
-                RAPtor_MPI_Get_count(&recv_status, RAPtor_MPI_INT, &count);
+                RAPtor_MPI_Get_count(&recv_status, RAPtor_MPI_INDEX_T, &count);
 
                 if ((int) recv_buffer.size() < count)
                 {
                     recv_buffer.resize(count);
                 }
-                RAPtor_MPI_Recv(&recv_buffer[0], count, RAPtor_MPI_INT, proc, tag, RAPtor_MPI_COMM_WORLD,
+                RAPtor_MPI_Recv(&recv_buffer[0], count, RAPtor_MPI_INDEX_T, proc, tag, RAPtor_MPI_COMM_WORLD,
                         &recv_status);
             }
             ctr = 0;
@@ -1195,11 +1328,10 @@ void find_off_proc_new_coarse(const ParCSRMatrix* S,
                         }
                         else
                         {
-                            std::map<int, int>::const_iterator ptr = 
-                            global_to_local.find(global_col);
-                            if (ptr != global_to_local.end())
+                            idx = global_to_local.find(global_col);
+                            if (idx >= 0)
                             {
-                                off_proc_col_coarse.emplace_back(ptr->second + S->on_proc_num_cols);
+                                off_proc_col_coarse.emplace_back(idx + S->on_proc_num_cols);
                             }   
                         }
                     }
@@ -1451,7 +1583,7 @@ void cljp_main_loop(ParCSRMatrix* S,
     std::vector<int> off_proc_col_coarse;
     std::vector<int> off_proc_weight_updates;
     std::vector<int> off_proc_col_ptr;
-    std::map<int, int> global_to_local;
+    IntMap<index_t> global_to_local;
     std::vector<int> new_coarse_list;
     std::vector<int> off_new_coarse_list;
     std::vector<int> unassigned;
@@ -1498,9 +1630,10 @@ void cljp_main_loop(ParCSRMatrix* S,
     }
     off_proc_col_ptr.resize(S->off_proc_num_cols + 1);
 
+    global_to_local.reserve(S->off_proc_num_cols);
     for (int i = 0; i < S->off_proc_num_cols; i++)
     {
-        global_to_local[S->off_proc_column_map[i]] = i;
+        global_to_local.insert(S->off_proc_column_map[i], i);
     }
 
     initial_weights(S, comm, weights, rand_vals);
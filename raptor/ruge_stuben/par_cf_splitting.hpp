@@ -37,4 +37,8 @@ void split_pmis(ParCSRMatrix* S, std::vector<int>& states,
 void split_hmis(ParCSRMatrix* S, std::vector<int>& states,
         std::vector<int>& off_proc_states, bool tap_cf = false, 
         double* rand_vals = NULL);
+
+void split_aggressive(ParCSRMatrix* S, std::vector<int>& states,
+        std::vector<int>& off_proc_states, coarsen_t coarsen_type = PMIS,
+        bool tap_cf = false, double* rand_vals = NULL);
 #endif
@@ -23,6 +23,14 @@ ParCSRMatrix* mod_classical_interpolation(ParCSRMatrix* A,
 ParCSRMatrix* direct_interpolation(ParCSRMatrix* A,
         ParCSRMatrix* S, const std::vector<int>& states,
         const std::vector<int>& off_proc_states, bool tap_interp);
+ParCSRMatrix* multipass_interpolation(ParCSRMatrix* A,
+        ParCSRMatrix* S, const std::vector<int>& states,
+        const std::vector<int>& off_proc_states, const double filter_threshold,
+        bool tap_interp);
+int multipass_col(ParCSRMatrix* S, index_t global_col, int* on_proc_partition_to_col,
+        IntMap<index_t>& ext_to_col, std::vector<index_t>& ext_cols);
+void multipass_add(int col, double val, int row, std::vector<int>& marker,
+        std::vector<double>& sums, std::vector<int>& row_cols);
 
 
 
@@ -31,12 +39,13 @@ CSRMatrix* communicate(ParCSRMatrix* A, ParCSRMatrix* S, const std::vector<int>&
         const std::vector<int>& off_proc_states, CommPkg* comm)
 {
     int start, end, col;
-    int ctr_S, end_S, global_col;
+    int ctr_S, end_S;
+    index_t global_col;
     int sign;
     double diag, val;
 
     std::vector<int> rowptr(A->local_num_rows + 1);
-    std::vector<int> col_indices;
+    std::vector<index_t> col_indices;
     std::vector<double> values;
     if (A->local_nnz)
     {
@@ -148,7 +157,7 @@ CSRMatrix*  communicate(ParCSRMatrix* A, const std::vector<int>& states,
     double val;
 
     std::vector<int> rowptr(A->local_num_rows + 1);
-    std::vector<int> col_indices;
+    std::vector<index_t> col_indices;
     std::vector<double> values;
     if (A->local_nnz)
     {
@@ -309,7 +318,7 @@ ParCSRMatrix* extended_interpolation(ParCSRMatrix* A,
     int start_k, end_k;
     int col;
     int col_k, col_P;
-    int global_num_cols;
+    index_t global_num_cols;
     int on_proc_cols, off_proc_cols;
     int sign;
     int row_start_on, row_start_off;
@@ -326,9 +335,8 @@ ParCSRMatrix* extended_interpolation(ParCSRMatrix* A,
         mat_comm = A->tap_mat_comm;
     }
 
-    std::set<int> global_set;
-    std::map<int, int> global_to_local;
-    std::vector<int> off_proc_column_map;
+    IntMap<index_t> global_to_local;
+    std::vector<index_t> off_proc_column_map;
     std::vector<int> off_variables;
 
     CSRMatrix* recv_mat; // On Proc Block of Recvd A
@@ -354,7 +362,7 @@ ParCSRMatrix* extended_interpolation(ParCSRMatrix* A,
     // Communicate parallel matrix A (portion needed)
     recv_mat = communicate(A, S, states, off_proc_states, mat_comm);
 
-    int tmp_col;
+    index_t global_col, tmp_col;
     int* on_proc_partition_to_col = A->map_partition_to_local();
     
     std::vector<int> A_recv_on_ptr(recv_mat->n_rows + 1);
@@ -375,34 +383,38 @@ ParCSRMatrix* extended_interpolation(ParCSRMatrix* A,
     int S_recv_on_ctr = 0;
     int A_recv_off_ctr = 0;
     int S_recv_off_ctr = 0;
+
+    // Decoded global columns are kept in recv_mat->global_idx2, and
+    // on_proc columns are mapped to local columns in recv_mat->idx2
+    recv_mat->idx2.resize(recv_mat->nnz);
     for (int i = 0; i < recv_mat->n_rows; i++)
     {
         start = recv_mat->idx1[i];
         end = recv_mat->idx1[i+1];
         for (int j = start; j < end; j++)
         {
-            col = recv_mat->idx2[j];
-            val = recv_mat->vals[j];
+            global_col = recv_mat->global_idx2[j];
 
-            tmp_col = col;
-            if (col < 0) 
+            tmp_col = global_col;
+            if (global_col < 0) 
             {
-                col = (-col) - 1;
+                global_col = (-global_col) - 1;
             }
-            if (col >= A->partition->global_num_cols)
+            if (global_col >= A->partition->global_num_cols)
             {
-                col -= A->partition->global_num_cols;
-                if (col >= A->partition->first_local_col &&
-                        col <= A->partition->last_local_col)
+                global_col -= A->partition->global_num_cols;
+                if (global_col >= A->partition->first_local_col &&
+                        global_col <= A->partition->last_local_col)
                 {
                     // Only add to A (for +i)
-                    col = on_proc_partition_to_col[col - A->partition->first_local_row];
+                    recv_mat->idx2[j] = on_proc_partition_to_col[global_col 
+                        - A->partition->first_local_row];
                     A_recv_on_idx[A_recv_on_ctr++] = j;
                 }
             }
             // Otherwise, add every value to A (and neg values also to S)
-            else if (col < A->partition->first_local_col || 
-                    col > A->partition->last_local_col)
+            else if (global_col < A->partition->first_local_col || 
+                    global_col > A->partition->last_local_col)
             {
                 if (tmp_col < 0) // Only add to S if neg
                 {
@@ -412,14 +424,15 @@ ParCSRMatrix* extended_interpolation(ParCSRMatrix* A,
             }
             else
             {
-                col = on_proc_partition_to_col[col - A->partition->first_local_row];
+                recv_mat->idx2[j] = on_proc_partition_to_col[global_col 
+                    - A->partition->first_local_row];
                 if (tmp_col < 0) // Only add to S if neg
                 {
                     S_recv_on_idx[S_recv_on_ctr++] = j;
                 }
                 A_recv_on_idx[A_recv_on_ctr++] = j;
             }
-            recv_mat->idx2[j] = col;
+            recv_mat->global_idx2[j] = global_col;
         }
         A_recv_on_ptr[i+1] = A_recv_on_ctr;
         S_recv_on_ptr[i+1] = S_recv_on_ctr;
@@ -442,7 +455,7 @@ ParCSRMatrix* extended_interpolation(ParCSRMatrix* A,
     {
         if (off_proc_states[i] == Selected)
         {
-            global_set.insert(S->off_proc_column_map[i]);
+            off_proc_column_map.emplace_back(S->off_proc_column_map[i]);
         }
     }
     for (int i = 0; i < S->off_proc_num_cols; i++)
@@ -453,21 +466,31 @@ ParCSRMatrix* extended_interpolation(ParCSRMatrix* A,
             end = A_recv_off_ptr[i+1];
             for (int j = start; j < end; j++)
             {
-                global_set.insert(recv_mat->idx2[A_recv_off_idx[j]]);
+                off_proc_column_map.emplace_back(recv_mat->global_idx2[A_recv_off_idx[j]]);
             }
         }
     }
-    for (std::set<int>::iterator it = global_set.begin(); it != global_set.end(); ++it)
+    sort_unique(off_proc_column_map);
+    off_proc_cols = off_proc_column_map.size();
+    global_to_local.reserve(off_proc_cols);
+    for (int i = 0; i < off_proc_cols; i++)
     {
-        global_to_local[*it] = off_proc_column_map.size();
-        off_proc_column_map.push_back(*it);
+        global_to_local.insert(off_proc_column_map[i], i);
     }
-    off_proc_cols = off_proc_column_map.size();
 
-    for (std::vector<int>::iterator it = A_recv_off_idx.begin(); 
-            it != A_recv_off_idx.end(); ++it)
+    // Only rows of Unselected off_proc points are used below
+    for (int i = 0; i < S->off_proc_num_cols; i++)
     {
-        recv_mat->idx2[*it] = global_to_local[recv_mat->idx2[*it]];
+        if (off_proc_states[i] == Unselected)
+        {
+            start = A_recv_off_ptr[i];
+            end = A_recv_off_ptr[i+1];
+            for (int j = start; j < end; j++)
+            {
+                recv_mat->idx2[A_recv_off_idx[j]] = 
+                    global_to_local.find(recv_mat->global_idx2[A_recv_off_idx[j]]);
+            }
+        }
     }
 
     // Initialize P
@@ -491,8 +514,8 @@ ParCSRMatrix* extended_interpolation(ParCSRMatrix* A,
     }
     // Initialize AllReduce to determine global num cols
     RAPtor_MPI_Request reduce_request;
-    int reduce_buf = on_proc_cols;
-    RAPtor_MPI_Iallreduce(&(reduce_buf), &global_num_cols, 1, RAPtor_MPI_INT, RAPtor_MPI_SUM, 
+    index_t reduce_buf = on_proc_cols;
+    RAPtor_MPI_Iallreduce(&(reduce_buf), &global_num_cols, 1, RAPtor_MPI_INDEX_T, RAPtor_MPI_SUM, 
             RAPtor_MPI_COMM_WORLD, &reduce_request);
    
     ParCSRMatrix* P = new ParCSRMatrix(A->partition, A->global_num_rows, -1, 
@@ -619,7 +642,6 @@ ParCSRMatrix* extended_interpolation(ParCSRMatrix* A,
         for (int j = start; j < end; j++)
         {
             col = S->on_proc->idx2[j];
-            val = S->on_proc->vals[j];
             if (states[col] == Selected)
             {
                 if (pos[col] < row_start_on)
@@ -666,7 +688,6 @@ ParCSRMatrix* extended_interpolation(ParCSRMatrix* A,
         for (int j = start; j < end; j++)
         {
             col = S->off_proc->idx2[j];
-            val = S->off_proc->vals[j];
             if (off_proc_states[col] == Selected)
             {
                 col_P = off_proc_A_to_P[col];
@@ -1022,8 +1043,8 @@ ParCSRMatrix* mod_classical_interpolation(ParCSRMatrix* A,
     int end_S;
     int col, col_k;
     int ctr, idx;
-    int global_col, sign;
-    int global_num_cols;
+    int sign;
+    index_t global_col, global_num_cols;
     int row_start_on, row_start_off;
     double diag, val, val_k;
     double weak_sum, coarse_sum;
@@ -1085,7 +1106,8 @@ ParCSRMatrix* mod_classical_interpolation(ParCSRMatrix* A,
             off_proc_cols++;
         }
     }
-    RAPtor_MPI_Allreduce(&(on_proc_cols), &global_num_cols, 1, RAPtor_MPI_INT, RAPtor_MPI_SUM, RAPtor_MPI_COMM_WORLD);
+    index_t local_num_cols = on_proc_cols;
+    RAPtor_MPI_Allreduce(&(local_num_cols), &global_num_cols, 1, RAPtor_MPI_INDEX_T, RAPtor_MPI_SUM, RAPtor_MPI_COMM_WORLD);
    
     ParCSRMatrix* P = new ParCSRMatrix(A->partition, A->global_num_rows, global_num_cols, 
             A->local_num_rows, on_proc_cols, off_proc_cols);
@@ -1103,6 +1125,14 @@ ParCSRMatrix* mod_classical_interpolation(ParCSRMatrix* A,
     // Communicate parallel matrix A (Costly!)
     recv_mat = communicate(A, states, off_proc_states, mat_comm);
 
+    // Split recv_mat into on_proc and off_proc portions, mapping the
+    // global columns to local (off_proc cols not on rank are removed)
+    int* on_proc_partition_to_col = A->map_partition_to_local();
+    IntMap<index_t> global_to_local(A->off_proc_num_cols);
+    for (int i = 0; i < A->off_proc_num_cols; i++)
+    {
+        global_to_local.insert(A->off_proc_column_map[i], i);
+    }
     CSRMatrix* recv_on = new CSRMatrix(recv_mat->n_rows, -1, recv_mat->nnz);
     CSRMatrix* recv_off = new CSRMatrix(recv_mat->n_rows, -1, recv_mat->nnz);
     for (int i = 0; i < recv_mat->n_rows; i++)
@@ -1111,15 +1141,21 @@ ParCSRMatrix* mod_classical_interpolation(ParCSRMatrix* A,
         end = recv_mat->idx1[i+1];
         for (int j = start; j < end; j++)
         {
-            col = recv_mat->idx2[j];
-            if (col < A->partition->first_local_col || col > A->partition->last_local_col)
+            global_col = recv_mat->global_idx2[j];
+            if (global_col < A->partition->first_local_col 
+                    || global_col > A->partition->last_local_col)
             {
-                recv_off->idx2.push_back(col);
-                recv_off->vals.push_back(recv_mat->vals[j]);
+                idx = global_to_local.find(global_col);
+                if (idx >= 0)
+                {
+                    recv_off->idx2.push_back(idx);
+                    recv_off->vals.push_back(recv_mat->vals[j]);
+                }
             }
             else
             {
-                recv_on->idx2.push_back(col);
+                recv_on->idx2.push_back(on_proc_partition_to_col[global_col 
+                        - A->partition->first_local_row]);
                 recv_on->vals.push_back(recv_mat->vals[j]);
             }
         }
@@ -1128,49 +1164,11 @@ ParCSRMatrix* mod_classical_interpolation(ParCSRMatrix* A,
     }
     recv_on->nnz = recv_on->idx2.size();
     recv_off->nnz = recv_off->idx2.size();
-
-    delete recv_mat;
-
-    // Change on_proc_cols to local
     recv_on->n_cols = A->on_proc_num_cols;
-    int* on_proc_partition_to_col = A->map_partition_to_local();
-    for (std::vector<int>::iterator it = recv_on->idx2.begin();
-            it != recv_on->idx2.end(); ++it)
-    {
-        *it = on_proc_partition_to_col[*it - A->partition->first_local_row];
-    }
+    recv_off->n_cols = A->off_proc_num_cols;
     delete[] on_proc_partition_to_col;
 
-    // Change off_proc_cols to local (remove cols not on rank)
-    ctr = 0;
-    std::map<int, int> global_to_local;
-    for (std::vector<int>::iterator it = A->off_proc_column_map.begin();
-            it != A->off_proc_column_map.end(); ++it)
-    {
-        global_to_local[*it] = ctr++;
-    }
-    recv_off->n_cols = A->off_proc_num_cols;
-    ctr = 0;
-    start = recv_off->idx1[0];
-    for (int i = 0; i < recv_off->n_rows; i++)
-    {
-        end = recv_off->idx1[i+1];
-        for (int j = start; j < end; j++)
-        {
-            global_col = recv_off->idx2[j];
-            std::map<int, int>::iterator it = global_to_local.find(global_col);
-            if (it != global_to_local.end())
-            {
-                recv_off->idx2[ctr] = it->second;
-                recv_off->vals[ctr++] = recv_off->vals[j];
-            }
-        }
-        recv_off->idx1[i+1] = ctr;
-        start = end;
-    }
-    recv_off->nnz = ctr;
-    recv_off->idx2.resize(ctr);
-    recv_off->vals.resize(ctr);
+    delete recv_mat;
 
     // For each row, will calculate coarse sums and store 
     // strong connections in vector
@@ -1210,10 +1208,9 @@ ParCSRMatrix* mod_classical_interpolation(ParCSRMatrix* A,
             col = S->on_proc->idx2[j];
             if (states[col] == Selected)
             {
-                val = S->on_proc->vals[j];
                 pos[col] = P->on_proc->idx2.size();
                 P->on_proc->idx2.push_back(on_proc_col_to_new[col]);
-                P->on_proc->vals.push_back(val);
+                P->on_proc->vals.push_back(0.0);
             }
         }
         start = S->off_proc->idx1[i];
@@ -1223,11 +1220,10 @@ ParCSRMatrix* mod_classical_interpolation(ParCSRMatrix* A,
             col = S->off_proc->idx2[j];
             if (off_proc_states[col] == Selected)
             {
-                val = S->off_proc->vals[j];
                 off_proc_pos[col] = P->off_proc->idx2.size();
                 col_exists[col] = true;
                 P->off_proc->idx2.push_back(col);
-                P->off_proc->vals.push_back(val);
+                P->off_proc->vals.push_back(0.0);
             }
         }
 
@@ -1244,7 +1240,13 @@ ParCSRMatrix* mod_classical_interpolation(ParCSRMatrix* A,
             {
                 ctr++;
 
-                if (states[col] == Selected) continue;
+                // S holds no values, so take a_ij for strong coarse
+                // connections from A
+                if (states[col] == Selected)
+                {
+                    P->on_proc->vals[pos[col]] += val;
+                    continue;
+                }
 
                 // Find sum of all coarse points in row k (with sign NOT equal to diag)
                 coarse_sum = 0;
@@ -1345,7 +1347,11 @@ ParCSRMatrix* mod_classical_interpolation(ParCSRMatrix* A,
             {
                 ctr++;
 
-                if (off_proc_states[col] == Selected) continue;
+                if (off_proc_states[col] == Selected)
+                {
+                    P->off_proc->vals[off_proc_pos[col]] += val;
+                    continue;
+                }
 
                 // Strong connection... create 
                 coarse_sum = 0;
@@ -1477,7 +1483,7 @@ ParCSRMatrix* direct_interpolation(ParCSRMatrix* A,
         bool tap_interp)
 {
     int start, end, col;
-    int global_num_cols;
+    index_t global_num_cols;
     int ctr;
     double sum_strong_pos, sum_strong_neg;
     double sum_all_pos, sum_all_neg;
@@ -1556,7 +1562,8 @@ ParCSRMatrix* direct_interpolation(ParCSRMatrix* A,
             off_proc_cols++;
         }
     }
-    RAPtor_MPI_Allreduce(&(on_proc_cols), &global_num_cols, 1, RAPtor_MPI_INT, RAPtor_MPI_SUM, RAPtor_MPI_COMM_WORLD);
+    index_t local_num_cols = on_proc_cols;
+    RAPtor_MPI_Allreduce(&(local_num_cols), &global_num_cols, 1, RAPtor_MPI_INDEX_T, RAPtor_MPI_SUM, RAPtor_MPI_COMM_WORLD);
    
     ParCSRMatrix* P = new ParCSRMatrix(S->partition, S->global_num_rows, global_num_cols, 
             S->local_num_rows, on_proc_cols, off_proc_cols);
@@ -1773,3 +1780,488 @@ ParCSRMatrix* direct_interpolation(ParCSRMatrix* A,
 
     return P;
 }
+
+
+// Column of multipass P for global_col : the on_proc column of S
+// if local, and otherwise n_on + j for ext_cols[j] (added if new)
+int multipass_col(ParCSRMatrix* S, index_t global_col, int* on_proc_partition_to_col,
+        IntMap<index_t>& ext_to_col, std::vector<index_t>& ext_cols)
+{
+    if (global_col >= S->partition->first_local_col
+            && global_col <= S->partition->last_local_col)
+    {
+        return on_proc_partition_to_col[global_col - S->partition->first_local_col];
+    }
+    int new_col = S->on_proc_num_cols + ext_cols.size();
+    int col = ext_to_col.insert(global_col, new_col);
+    if (col == new_col)
+    {
+        ext_cols.emplace_back(global_col);
+    }
+    return col;
+}
+
+// Adds val to column col of the row being accumulated, marking
+// columns with the row (marker) and listing them in row_cols
+void multipass_add(int col, double val, int row, std::vector<int>& marker,
+        std::vector<double>& sums, std::vector<int>& row_cols)
+{
+    if (marker[col] != row)
+    {
+        marker[col] = row;
+        sums[col] = val;
+        row_cols.emplace_back(col);
+    }
+    else
+    {
+        sums[col] += val;
+    }
+}
+
+/**************************************************************
+*****   Multipass Interpolation
+**************************************************************
+***** Interpolation for splittings in which fine points can be
+***** far from any coarse point, as after aggressive coarsening.
+***** Fine points strongly connected to a coarse point form pass
+***** 1, and interpolate directly from them.  Fine points in
+***** pass k are strongly connected to a point of an earlier
+***** pass, and use the direct interpolation formula with those
+***** points in place of coarse points, substituting the rows of
+***** P already formed for them.  Rows of P are exchanged before
+***** each pass after the first.  Entries are then truncated as
+***** in filter_interp.
+*****
+***** Parameters
+***** -------------
+***** A : ParCSRMatrix*
+*****    Matrix being coarsened
+***** S : ParCSRMatrix*
+*****    Strength of connection matrix
+***** states : std::vector<int>&
+*****    Coarse points have state 1
+***** off_proc_states : std::vector<int>&
+*****    States of the off_proc columns of S
+***** filter_threshold : double
+*****    Entries below filter_threshold times the largest in each
+*****    row are dropped (0 keeps all)
+**************************************************************/
+ParCSRMatrix* multipass_interpolation(ParCSRMatrix* A,
+        ParCSRMatrix* S, const std::vector<int>& states,
+        const std::vector<int>& off_proc_states, const double filter_threshold,
+        bool tap_interp)
+{
+    int start, end, row_end, col, ctr;
+    int pass, num_new, global_num_new;
+    index_t global_col, global_num_cols;
+    double sum_strong_pos, sum_strong_neg;
+    double sum_all_pos, sum_all_neg;
+    double val, alpha, beta, diag, coeff;
+
+    CommPkg* comm = S->comm;
+    if (tap_interp)
+    {
+        comm = S->tap_comm;
+    }
+
+    A->sort();
+    S->sort();
+    A->on_proc->move_diag();
+    S->on_proc->move_diag();
+
+    // Copy entries of A into sparsity pattern of S (the columns of each
+    // row of S are a subset of those of A, in the same order, so the
+    // search for each stops at the end of the row of A)
+    std::vector<double> sa_on(S->on_proc->nnz);
+    std::vector<double> sa_off(S->off_proc->nnz);
+    for (int i = 0; i < A->local_num_rows; i++)
+    {
+        start = S->on_proc->idx1[i];
+        end = S->on_proc->idx1[i+1];
+        ctr = A->on_proc->idx1[i];
+        row_end = A->on_proc->idx1[i+1];
+        for (int j = start; j < end; j++)
+        {
+            global_col = S->on_proc_column_map[S->on_proc->idx2[j]];
+            while (ctr < row_end 
+                    && A->on_proc_column_map[A->on_proc->idx2[ctr]] != global_col)
+            {
+                ctr++;
+            }
+            sa_on[j] = ctr < row_end ? A->on_proc->vals[ctr] : 0.0;
+        }
+
+        start = S->off_proc->idx1[i];
+        end = S->off_proc->idx1[i+1];
+        ctr = A->off_proc->idx1[i];
+        row_end = A->off_proc->idx1[i+1];
+        for (int j = start; j < end; j++)
+        {
+            global_col = S->off_proc_column_map[S->off_proc->idx2[j]];
+            while (ctr < row_end 
+                    && A->off_proc_column_map[A->off_proc->idx2[ctr]] != global_col)
+            {
+                ctr++;
+            }
+            sa_off[j] = ctr < row_end ? A->off_proc->vals[ctr] : 0.0;
+        }
+    }
+
+    // Assign each fine point the pass in which it is interpolated
+    // (coarse points are pass 0, unreachable points stay -1)
+    std::vector<int> passes(S->local_num_rows, -1);
+    for (int i = 0; i < S->local_num_rows; i++)
+    {
+        if (states[i] == 1) passes[i] = 0;
+    }
+    std::vector<int> off_proc_passes(S->off_proc_num_cols, -1);
+    for (int i = 0; i < S->off_proc_num_cols; i++)
+    {
+        if (off_proc_states[i] == 1) off_proc_passes[i] = 0;
+    }
+    int num_passes = 1;
+    while (true)
+    {
+        num_new = 0;
+        for (int i = 0; i < S->local_num_rows; i++)
+        {
+            if (passes[i] >= 0) continue;
+
+            start = S->on_proc->idx1[i];
+            end = S->on_proc->idx1[i+1];
+            for (int j = start; j < end; j++)
+            {
+                pass = passes[S->on_proc->idx2[j]];
+                if (pass >= 0 && pass < num_passes)
+                {
+                    passes[i] = num_passes;
+                    break;
+                }
+            }
+            if (passes[i] >= 0)
+            {
+                num_new++;
+                continue;
+            }
+            start = S->off_proc->idx1[i];
+            end = S->off_proc->idx1[i+1];
+            for (int j = start; j < end; j++)
+            {
+                pass = off_proc_passes[S->off_proc->idx2[j]];
+                if (pass >= 0 && pass < num_passes)
+                {
+                    passes[i] = num_passes;
+                    num_new++;
+                    break;
+                }
+            }
+        }
+
+        RAPtor_MPI_Allreduce(&num_new, &global_num_new, 1, RAPtor_MPI_INT,
+                RAPtor_MPI_SUM, RAPtor_MPI_COMM_WORLD);
+        if (global_num_new == 0) break;
+
+        std::vector<int>& recvbuf = comm->communicate(passes);
+        std::copy(recvbuf.begin(), recvbuf.begin() + S->off_proc_num_cols,
+                off_proc_passes.begin());
+        num_passes++;
+    }
+
+    // Rows of P, formed pass by pass.  Columns of P are numbered as
+    // the on_proc columns of S [0, n_on), then n_on + j for the
+    // off_proc global column ext_cols[j].  Row i is held contiguously
+    // in pass_cols/pass_vals, starting at pass_ptr[i].
+    int n_on = S->on_proc_num_cols;
+    int* on_proc_partition_to_col = S->map_partition_to_local();
+    std::vector<index_t> ext_cols;
+    IntMap<index_t> ext_to_col;
+    std::vector<int> pass_ptr(S->local_num_rows, 0);
+    std::vector<int> pass_size(S->local_num_rows, 0);
+    std::vector<int> pass_cols;
+    std::vector<double> pass_vals;
+    for (int i = 0; i < S->local_num_rows; i++)
+    {
+        if (passes[i] == 0)
+        {
+            pass_ptr[i] = pass_cols.size();
+            pass_size[i] = 1;
+            pass_cols.emplace_back(i);
+            pass_vals.emplace_back(1.0);
+        }
+    }
+
+    // Columns of P for coarse off_proc columns of S
+    std::vector<int> off_proc_to_col(S->off_proc_num_cols, -1);
+    for (int i = 0; i < S->off_proc_num_cols; i++)
+    {
+        if (off_proc_passes[i] == 0)
+        {
+            off_proc_to_col[i] = multipass_col(S, S->off_proc_column_map[i],
+                    on_proc_partition_to_col, ext_to_col, ext_cols);
+        }
+    }
+
+    // Sparse accumulator for one row of P
+    std::vector<int> marker;
+    std::vector<double> sums;
+    std::vector<int> row_cols;
+
+    // Rows of P for off_proc columns of S, with their columns of P
+    std::vector<int> send_ptr(S->local_num_rows + 1);
+    std::vector<index_t> send_cols;
+    std::vector<double> send_vals;
+    std::vector<int> recv_cols;
+    CSRMatrix* recv_P = NULL;
+
+    for (int k = 1; k < num_passes; k++)
+    {
+        if (k > 1)
+        {
+            send_cols.clear();
+            send_vals.clear();
+            send_ptr[0] = 0;
+            for (int i = 0; i < S->local_num_rows; i++)
+            {
+                start = pass_ptr[i];
+                end = start + pass_size[i];
+                for (int l = start; l < end; l++)
+                {
+                    col = pass_cols[l];
+                    if (col < n_on) send_cols.emplace_back(S->on_proc_column_map[col]);
+                    else send_cols.emplace_back(ext_cols[col - n_on]);
+                    send_vals.emplace_back(pass_vals[l]);
+                }
+                send_ptr[i+1] = send_cols.size();
+            }
+            delete recv_P;
+            recv_P = comm->communicate(send_ptr, send_cols, send_vals);
+
+            recv_cols.resize(recv_P->idx1[recv_P->n_rows]);
+            for (int l = 0; l < recv_P->idx1[recv_P->n_rows]; l++)
+            {
+                recv_cols[l] = multipass_col(S, recv_P->global_idx2[l],
+                        on_proc_partition_to_col, ext_to_col, ext_cols);
+            }
+        }
+        marker.resize(n_on + ext_cols.size(), -1);
+        sums.resize(n_on + ext_cols.size());
+
+        for (int i = 0; i < S->local_num_rows; i++)
+        {
+            if (passes[i] != k) continue;
+
+            sum_strong_pos = 0;
+            sum_strong_neg = 0;
+            sum_all_pos = 0;
+            sum_all_neg = 0;
+
+            start = S->on_proc->idx1[i];
+            end = S->on_proc->idx1[i+1];
+            for (int j = start; j < end; j++)
+            {
+                col = S->on_proc->idx2[j];
+                if (col == i || passes[col] < 0 || passes[col] >= k) continue;
+                if (sa_on[j] < 0) sum_strong_neg += sa_on[j];
+                else sum_strong_pos += sa_on[j];
+            }
+            start = S->off_proc->idx1[i];
+            end = S->off_proc->idx1[i+1];
+            for (int j = start; j < end; j++)
+            {
+                col = S->off_proc->idx2[j];
+                if (off_proc_passes[col] < 0 || off_proc_passes[col] >= k) continue;
+                if (sa_off[j] < 0) sum_strong_neg += sa_off[j];
+                else sum_strong_pos += sa_off[j];
+            }
+
+            start = A->on_proc->idx1[i];
+            end = A->on_proc->idx1[i+1];
+            diag = A->on_proc->vals[start]; // Diag stored first
+            for (int j = start + 1; j < end; j++)
+            {
+                val = A->on_proc->vals[j];
+                if (val < 0) sum_all_neg += val;
+                else sum_all_pos += val;
+            }
+            start = A->off_proc->idx1[i];
+            end = A->off_proc->idx1[i+1];
+            for (int j = start; j < end; j++)
+            {
+                val = A->off_proc->vals[j];
+                if (val < 0) sum_all_neg += val;
+                else sum_all_pos += val;
+            }
+
+            alpha = sum_strong_neg ? sum_all_neg / sum_strong_neg : 0.0;
+            if (sum_strong_pos == 0)
+            {
+                diag += sum_all_pos;
+                beta = 0;
+            }
+            else
+            {
+                beta = sum_all_pos / sum_strong_pos;
+            }
+
+            // Row i is the weighted sum of the rows of its interpolatory set
+            row_cols.clear();
+            start = S->on_proc->idx1[i];
+            end = S->on_proc->idx1[i+1];
+            for (int j = start; j < end; j++)
+            {
+                col = S->on_proc->idx2[j];
+                if (col == i || passes[col] < 0 || passes[col] >= k) continue;
+                coeff = -(sa_on[j] < 0 ? alpha : beta) * sa_on[j] / diag;
+                row_end = pass_ptr[col] + pass_size[col];
+                for (int l = pass_ptr[col]; l < row_end; l++)
+                {
+                    multipass_add(pass_cols[l], coeff * pass_vals[l], i,
+                            marker, sums, row_cols);
+                }
+            }
+            start = S->off_proc->idx1[i];
+            end = S->off_proc->idx1[i+1];
+            for (int j = start; j < end; j++)
+            {
+                col = S->off_proc->idx2[j];
+                if (off_proc_passes[col] < 0 || off_proc_passes[col] >= k) continue;
+                coeff = -(sa_off[j] < 0 ? alpha : beta) * sa_off[j] / diag;
+                if (off_proc_passes[col] == 0)
+                {
+                    multipass_add(off_proc_to_col[col], coeff, i, marker, sums, row_cols);
+                }
+                else
+                {
+                    for (int l = recv_P->idx1[col]; l < recv_P->idx1[col+1]; l++)
+                    {
+                        multipass_add(recv_cols[l], coeff * recv_P->vals[l], i,
+                                marker, sums, row_cols);
+                    }
+                }
+            }
+
+            pass_ptr[i] = pass_cols.size();
+            pass_size[i] = row_cols.size();
+            for (std::vector<int>::iterator it = row_cols.begin(); 
+                    it != row_cols.end(); ++it)
+            {
+                pass_cols.emplace_back(*it);
+                pass_vals.emplace_back(sums[*it]);
+            }
+        }
+    }
+    delete recv_P;
+    delete[] on_proc_partition_to_col;
+
+    // Coarse points on this process become the on_proc columns of P,
+    // and the off_proc columns used by rows of P are sorted
+    int on_proc_cols = 0;
+    std::vector<int> on_proc_col_to_new(S->on_proc_num_cols, -1);
+    for (int i = 0; i < S->on_proc_num_cols; i++)
+    {
+        if (states[i] == 1)
+        {
+            on_proc_col_to_new[i] = on_proc_cols++;
+        }
+    }
+    std::vector<int> ext_to_new(ext_cols.size(), -1);
+    for (int i = 0; i < S->local_num_rows; i++)
+    {
+        end = pass_ptr[i] + pass_size[i];
+        for (int l = pass_ptr[i]; l < end; l++)
+        {
+            if (pass_cols[l] >= n_on) ext_to_new[pass_cols[l] - n_on] = 1;
+        }
+    }
+    std::vector<index_t> off_proc_column_map;
+    for (int i = 0; i < (int) ext_cols.size(); i++)
+    {
+        if (ext_to_new[i] > 0) off_proc_column_map.emplace_back(ext_cols[i]);
+    }
+    std::sort(off_proc_column_map.begin(), off_proc_column_map.end());
+    for (int i = 0; i < (int) ext_cols.size(); i++)
+    {
+        if (ext_to_new[i] < 0) continue;
+        ext_to_new[i] = std::lower_bound(off_proc_column_map.begin(),
+                off_proc_column_map.end(), ext_cols[i]) - off_proc_column_map.begin();
+    }
+
+    index_t local_num_cols = on_proc_cols;
+    RAPtor_MPI_Allreduce(&(local_num_cols), &global_num_cols, 1, RAPtor_MPI_INDEX_T,
+            RAPtor_MPI_SUM, RAPtor_MPI_COMM_WORLD);
+    ParCSRMatrix* P = new ParCSRMatrix(S->partition, S->global_num_rows, global_num_cols, 
+            S->local_num_rows, on_proc_cols, off_proc_column_map.size());
+    for (int i = 0; i < S->on_proc_num_cols; i++)
+    {
+        if (states[i] == 1)
+        {
+            P->on_proc_column_map.emplace_back(S->on_proc_column_map[i]);
+        }
+    }
+    P->off_proc_column_map.swap(off_proc_column_map);
+    P->local_row_map = S->get_local_row_map();
+
+    for (int i = 0; i < S->local_num_rows; i++)
+    {
+        end = pass_ptr[i] + pass_size[i];
+        for (int l = pass_ptr[i]; l < end; l++)
+        {
+            col = pass_cols[l];
+            if (col < n_on)
+            {
+                P->on_proc->idx2.emplace_back(on_proc_col_to_new[col]);
+                P->on_proc->vals.emplace_back(pass_vals[l]);
+            }
+            else
+            {
+                P->off_proc->idx2.emplace_back(ext_to_new[col - n_on]);
+                P->off_proc->vals.emplace_back(pass_vals[l]);
+            }
+        }
+        P->on_proc->idx1[i+1] = P->on_proc->idx2.size();
+        P->off_proc->idx1[i+1] = P->off_proc->idx2.size();
+    }
+    P->on_proc->nnz = P->on_proc->idx2.size();
+    P->off_proc->nnz = P->off_proc->idx2.size();
+    P->local_nnz = P->on_proc->nnz + P->off_proc->nnz;
+
+    filter_interp(P, filter_threshold);
+
+    // Remove off_proc columns emptied by the filter
+    std::vector<int> off_proc_col_to_new(P->off_proc_column_map.size(), -1);
+    for (std::vector<int>::iterator it = P->off_proc->idx2.begin();
+            it != P->off_proc->idx2.end(); ++it)
+    {
+        off_proc_col_to_new[*it] = 1;
+    }
+    ctr = 0;
+    for (int i = 0; i < (int) P->off_proc_column_map.size(); i++)
+    {
+        if (off_proc_col_to_new[i] < 0) continue;
+        off_proc_col_to_new[i] = ctr;
+        P->off_proc_column_map[ctr++] = P->off_proc_column_map[i];
+    }
+    P->off_proc_column_map.resize(ctr);
+    for (std::vector<int>::iterator it = P->off_proc->idx2.begin();
+            it != P->off_proc->idx2.end(); ++it)
+    {
+        *it = off_proc_col_to_new[*it];
+    }
+
+    P->off_proc_num_cols = P->off_proc_column_map.size();
+    P->on_proc_num_cols = P->on_proc_column_map.size();
+    P->off_proc->n_cols = P->off_proc_num_cols;
+    P->on_proc->n_cols = P->on_proc_num_cols;
+
+    if (tap_interp)
+    {
+        P->init_tap_communicators(S->comm->mpi_comm);
+    }
+    else
+    {
+        P->comm = new ParComm(P->partition, P->off_proc_column_map,
+                P->on_proc_column_map, S->comm->key, S->comm->mpi_comm);
+    }
+
+    return P;
+}
@@ -24,4 +24,9 @@ ParCSRMatrix* extended_interpolation(ParCSRMatrix* A,
         const double filter_threshold = 0.3,
         bool tap_amg = false, int num_variables = 1, int* variables = NULL);
 
+ParCSRMatrix* multipass_interpolation(ParCSRMatrix* A,
+        ParCSRMatrix* S, const std::vector<int>& states,
+        const std::vector<int>& off_proc_states,
+        const double filter_threshold = 0.0, bool tap_amg = false);
+
 #endif
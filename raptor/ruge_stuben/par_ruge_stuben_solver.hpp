@@ -22,6 +22,7 @@ namespace raptor
             variables = NULL;
             num_variables = 1;
             interp_filter = 0.3; // Only used in HMIS/PMIS
+            num_aggressive_levels = 0;
         }
 
         ~ParRugeStubenSolver()
@@ -41,6 +42,19 @@ namespace raptor
             if (num_variables > 1) delete[] variables;
             variables = NULL;
         }
+
+        void resetup(ParCSRMatrix* Af)
+        {
+            if (num_variables > 1 && variables == NULL) 
+            {
+                form_variable_list(Af, num_variables);
+            }
+
+            resetup_helper(Af);
+
+            if (num_variables > 1) delete[] variables;
+            variables = NULL;
+        }
        
         void form_variable_list(const ParCSRMatrix* A, const int num_var)
         {
@@ -61,7 +75,6 @@ namespace raptor
             ParCSRMatrix* A = levels[level_ctr]->A;
             ParCSRMatrix* S;
             ParCSRMatrix* P = NULL;
-            ParCSRMatrix* AP;
 
             std::vector<int> states;
             std::vector<int> off_proc_states;
@@ -71,7 +84,12 @@ namespace raptor
                     num_variables, variables);
 
             // Form CF Splitting
-            switch (coarsen_type)
+            if (level_ctr < num_aggressive_levels)
+            {
+                split_aggressive(S, states, off_proc_states, coarsen_type,
+                        tap_level, weights);
+            }
+            else switch (coarsen_type)
             {
                 case RS:
                     if (level_ctr < 3) 
@@ -107,45 +125,20 @@ namespace raptor
             }
 
             // Form modified classical interpolation
-            switch (interp_type)
-            {
-                case Direct:
-                    P = direct_interpolation(A, S, states, off_proc_states, 
-                            tap_level);
-                    break;
-                case ModClassical:
-                    P = mod_classical_interpolation(A, S, states, off_proc_states, 
-                            tap_level, num_variables, variables);
-                    break;
-                case Extended:
-                    P = extended_interpolation(A, S, states, off_proc_states, 
-                            interp_filter, tap_level, num_variables, variables);
-                    break;
-                default:
-                    P = direct_interpolation(A, S, states, off_proc_states, 
-                            tap_level);
-                    break;
-            }
+            P = form_interpolation(level_ctr, A, S, states, off_proc_states, 
+                    tap_level);
             levels[level_ctr]->P = P;
-
-            if (num_variables > 1)
+            if (sparsify_tol > 0)
             {
-                int ctr = 0;
-                for (int i = 0; i < A->local_num_rows; i++)
-                {
-                    if (states[i] == 1)
-                    {
-                        variables[ctr++] = variables[i];
-                    }
-                }
+                levels[level_ctr]->I = form_injection(P, states);
             }
 
+            update_variables(A->local_num_rows, states);
+
             // Form coarse grid operator
+            A = form_coarse_operator(level_ctr, tap_level);
             levels.emplace_back(new ParLevel());
 
-            AP = A->mult(levels[level_ctr]->P, tap_level);
-            A = AP->mult_T(P, tap_level);
-
             A->sort();
             A->on_proc->move_diag();
 
@@ -164,14 +157,115 @@ namespace raptor
                 levels[level_ctr]->A->init_tap_communicators(RAPtor_MPI_COMM_WORLD);
             }
 
-            delete AP;
-            delete S;
+
+            // Keep splitting for resetup
+            levels[level_ctr-1]->S = S;
+            levels[level_ctr-1]->states.swap(states);
+            levels[level_ctr-1]->off_proc_states.swap(off_proc_states);
         }    
 
+        bool reextend_level(int level)
+        {
+            bool tap_level = tap_amg >= 0 && tap_amg <= level;
+
+            ParCSRMatrix* A = levels[level]->A;
+            ParCSRMatrix* S = levels[level]->S;
+            ParCSRMatrix* P;
+
+            // Strength pattern is kept (S holds no values, so A's new
+            // values are read directly by interpolation)
+            P = form_interpolation(level, A, S, levels[level]->states, 
+                    levels[level]->off_proc_states, tap_level);
+            int n_coarse = P->on_proc_num_cols;
+            P = agglomerate_interpolation(level, P);
+
+            if (!reform_coarse_operator(level, P, tap_level, true))
+            {
+                return false;
+            }
+
+            update_variables(A->local_num_rows, levels[level]->states);
+            if (levels[level+1]->agglomerated)
+            {
+                agglomerate_row_data(n_coarse, levels[level+1]->A->local_num_rows);
+            }
+
+            return true;
+        }
+
+        ParCSRMatrix* form_interpolation(int level, ParCSRMatrix* A, 
+                ParCSRMatrix* S, std::vector<int>& states, 
+                std::vector<int>& off_proc_states, bool tap_level)
+        {
+            // Fine points of aggressive levels can be beyond distance two
+            // of the coarse points
+            if (level < num_aggressive_levels)
+            {
+                return multipass_interpolation(A, S, states, off_proc_states,
+                        interp_filter, tap_level);
+            }
+
+            switch (interp_type)
+            {
+                case Direct:
+                    return direct_interpolation(A, S, states, off_proc_states, 
+                            tap_level);
+                case ModClassical:
+                    return mod_classical_interpolation(A, S, states, off_proc_states, 
+                            tap_level, num_variables, variables);
+                case Extended:
+                    return extended_interpolation(A, S, states, off_proc_states, 
+                            interp_filter, tap_level, num_variables, variables);
+                case Multipass:
+                    return multipass_interpolation(A, S, states, off_proc_states,
+                            interp_filter, tap_level);
+                default:
+                    return direct_interpolation(A, S, states, off_proc_states, 
+                            tap_level);
+            }
+        }
+
+        // Restrict variable list to coarse points
+        void update_variables(int local_num_rows, const std::vector<int>& states)
+        {
+            if (num_variables <= 1) return;
+
+            int ctr = 0;
+            for (int i = 0; i < local_num_rows; i++)
+            {
+                if (states[i] == 1)
+                {
+                    variables[ctr++] = variables[i];
+                }
+            }
+        }
+
+        // Variables of coarse rows move with agglomerated rows
+        void agglomerate_row_data(int local_n, int agg_local_n)
+        {
+            if (num_variables <= 1) return;
+
+            std::vector<int> vars(local_n);
+            std::copy(variables, variables + local_n, vars.begin());
+            redistribute_rows(vars, local_n, agg_local_n, 1, RAPtor_MPI_INT);
+
+            delete[] variables;
+            variables = NULL;
+            if (agg_local_n)
+            {
+                variables = new int[agg_local_n];
+                std::copy(vars.begin(), vars.end(), variables);
+            }
+        }
+
         coarsen_t coarsen_type;
         interp_t interp_type;
         double interp_filter;
 
+        // The first num_aggressive_levels levels are coarsened with
+        // split_aggressive and multipass interpolation
+        int num_aggressive_levels;
+
         int* variables;
 
     };
@@ -13,6 +13,12 @@ using namespace raptor;
 int main(int argc, char** argv)
 {
     MPI_Init(&argc, &argv);
+
+#ifdef USING_OPENMP
+    // Compare against serial (single thread) results
+    omp_set_num_threads(1);
+#endif
+
     ::testing::InitGoogleTest(&argc, argv);
     int temp = RUN_ALL_TESTS();
     MPI_Finalize();
@@ -42,6 +42,14 @@ TEST(TestParRAP, TestsInRuge_Stuben)
     Ac = AP->mult_T(P_csc);
     Ac_rap = readParMatrix(A1_fn);
     compare(Ac, Ac_rap);
+    delete Ac;
+
+    // Fused product, without forming AP
+    Ac = A->rap(P);
+    compare(Ac, Ac_rap);
+    delete Ac;
+    Ac = A->rap(P, true);
+    compare(Ac, Ac_rap);
     delete Ac_rap;
     delete Ac;
     delete P_csc;
@@ -57,6 +65,14 @@ TEST(TestParRAP, TestsInRuge_Stuben)
     Ac = AP->mult_T(P_csc);
     Ac_rap = readParMatrix(A2_fn);
     compare(Ac, Ac_rap);
+    delete Ac;
+
+    // Fused product, without forming AP
+    Ac = A->rap(P);
+    compare(Ac, Ac_rap);
+    delete Ac;
+    Ac = A->rap(P, true);
+    compare(Ac, Ac_rap);
     delete Ac_rap;
     delete Ac;
     delete P_csc;
@@ -0,0 +1,76 @@
+// Copyright (c) 2015-2017, RAPtor Developer Team
+// License: Simplified BSD, http://opensource.org/licenses/BSD-2-Clause
+
+#include "gtest/gtest.h"
+#include "raptor.hpp"
+#include "tests/par_compare.hpp"
+
+using namespace raptor;
+int main(int argc, char** argv)
+{
+    MPI_Init(&argc, &argv);
+    ::testing::InitGoogleTest(&argc, argv);
+    int temp = RUN_ALL_TESTS();
+    MPI_Finalize();
+    return temp;
+} // end of main() //
+
+void scale_values(ParCSRMatrix* A, double scale)
+{
+    for (int i = 0; i < A->on_proc->nnz; i++)
+    {
+        A->on_proc->vals[i] *= scale;
+    }
+    for (int i = 0; i < A->off_proc->nnz; i++)
+    {
+        A->off_proc->vals[i] *= scale;
+    }
+}
+
+void test_plan(const char* A_fn, const char* P_fn, const char* Ac_fn)
+{
+    ParCSRMatrix* A = readParMatrix(A_fn);
+    ParCSRMatrix* P = readParMatrix(P_fn);
+    ParCSRMatrix* Ac_rap = readParMatrix(Ac_fn);
+    ParSpGEMMPlan AP_plan;
+    ParSpGEMMPlan Ac_plan;
+
+    // Symbolic products hold the patterns of mult and mult_T
+    ParCSRMatrix* AP = A->mult(P);
+    ParCSRMatrix* AP_plan_mat = AP_plan.symbolic(A, P);
+    AP_plan.numeric(A, P, AP_plan_mat);
+    compare(AP, AP_plan_mat);
+
+    ParCSRMatrix* Ac = Ac_plan.symbolic_T(AP_plan_mat, P);
+    Ac_plan.numeric(AP_plan_mat, P, Ac);
+    compare(Ac_rap, Ac);
+
+    // Numeric phase only, for new values of A and P (rows of Ac are
+    // sorted by compare, which the numeric phase allows)
+    scale_values(A, 2.0);
+    scale_values(P, 3.0);
+    scale_values(Ac_rap, 18.0);
+    AP_plan.numeric(A, P, AP_plan_mat);
+    Ac_plan.numeric(AP_plan_mat, P, Ac);
+    compare(Ac_rap, Ac);
+
+    delete Ac;
+    delete AP_plan_mat;
+    delete AP;
+    delete Ac_rap;
+    delete P;
+    delete A;
+}
+
+TEST(TestParRAPPlan, TestsInRuge_Stuben)
+{ 
+    const char* A0_fn = "../../../../test_data/rss_A0.pm";
+    const char* A1_fn = "../../../../test_data/rss_A1.pm";
+    const char* A2_fn = "../../../../test_data/rss_A2.pm";
+    const char* P0_fn = "../../../../test_data/rss_P0.pm";
+    const char* P1_fn = "../../../../test_data/rss_P1.pm";
+
+    test_plan(A0_fn, P0_fn, A1_fn);
+    test_plan(A1_fn, P1_fn, A2_fn);
+
+} // end of TEST(TestParRAPPlan, TestsInRuge_Stuben) //
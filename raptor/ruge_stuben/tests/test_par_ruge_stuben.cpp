@@ -128,3 +128,44 @@ TEST(TestParRugeStuben, TestsInRuge_Stuben)
     delete A;
 
 } // end of TEST(TestParRugeStuben, TestsInRuge_Stuben) //
+
+TEST(TestParAggressiveRugeStuben, TestsInRuge_Stuben)
+{
+    int grid[3] = {20, 20, 20};
+    double* stencil = laplace_stencil_27pt();
+    ParCSRMatrix* A = par_stencil_grid(stencil, grid, 3);
+    delete[] stencil;
+
+    ParVector x(A->global_num_rows, A->local_num_rows);
+    ParVector b(A->global_num_rows, A->local_num_rows);
+    int iter;
+
+    ParRugeStubenSolver* ml = new ParRugeStubenSolver(0.25, PMIS, Extended,
+            Classical, SOR);
+    ml->setup(A);
+    int standard_rows = ml->levels[1]->A->global_num_rows;
+    delete ml;
+
+    // First level coarsened aggressively, interpolated with multipass
+    ml = new ParRugeStubenSolver(0.25, PMIS, Extended, Classical, SOR);
+    ml->num_aggressive_levels = 1;
+    ml->setup(A);
+    ASSERT_GT(ml->levels[1]->A->global_num_rows, 0);
+    ASSERT_LT(ml->levels[1]->A->global_num_rows, standard_rows);
+    ASSERT_EQ(ml->levels[0]->P->global_num_cols, ml->levels[1]->A->global_num_rows);
+
+    x.set_const_value(1.0);
+    A->mult(x, b);
+    x.set_const_value(0.0);
+    iter = ml->solve(x, b);
+    ASSERT_LT(iter, ml->max_iterations);
+
+    // Reusing the aggressive splitting
+    ml->resetup(A);
+    x.set_const_value(0.0);
+    ASSERT_EQ(ml->solve(x, b), iter);
+
+    delete ml;
+    delete A;
+
+} // end of TEST(TestParAggressiveRugeStuben, TestsInRuge_Stuben) //
@@ -42,6 +42,16 @@ TEST(ParStrengthTest, TestsInTests)
     S_rap = A->strength(Classical, 0.25);
     remove_empty_cols(S_rap);
     compare_pattern(S, S_rap);
+
+    // Strength holds only the sparsity pattern, and copies keep it so
+    ASSERT_EQ(S_rap->on_proc->data_size(), 0);
+    ASSERT_EQ(S_rap->off_proc->data_size(), 0);
+    ParCSRMatrix* S_copy = S_rap->copy();
+    ASSERT_EQ(S_copy->on_proc->data_size(), 0);
+    ASSERT_EQ(S_copy->off_proc->data_size(), 0);
+    compare_pattern(S, S_copy);
+    delete S_copy;
+
     delete A;
     delete S;
     delete S_rap;
@@ -61,6 +71,8 @@ TEST(ParStrengthTest, TestsInTests)
     S_rap = A->strength(Symmetric, 0.25);
     remove_empty_cols(S_rap);
     compare_pattern(S, S_rap);
+    ASSERT_EQ(S_rap->on_proc->data_size(), 0);
+    ASSERT_EQ(S_rap->off_proc->data_size(), 0);
     delete A;
     delete S;
     delete S_rap;
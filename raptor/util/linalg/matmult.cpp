@@ -5,18 +5,16 @@ using namespace raptor;
 // Declare Private Methods
 std::vector<double>& form_new(const CSRMatrix* A, const CSRMatrix* B, 
         CSRMatrix** C_ptr, std::vector<double>& A_vals);
-std::vector<double*>& form_new(const CSRMatrix* A, const CSRMatrix* B, 
-        CSRMatrix** C_ptr, std::vector<double*>& A_vals);
+BlockArray& form_new(const CSRMatrix* A, const CSRMatrix* B, 
+        CSRMatrix** C_ptr, BlockArray& A_vals);
 std::vector<double>& form_new(const CSCMatrix* A, const CSRMatrix* B,
         CSRMatrix** C_ptr, std::vector<double>& A_vals);
-std::vector<double*>& form_new(const CSCMatrix* A, const CSRMatrix* B,
-        CSRMatrix** C_ptr, std::vector<double*>& A_vals);
+BlockArray& form_new(const CSCMatrix* A, const CSRMatrix* B,
+        CSRMatrix** C_ptr, BlockArray& A_vals);
 void init_sums(std::vector<double>& sums, int size, int b_size);
-void init_sums(std::vector<double*>& sums, int size, int b_size);
-void zero_sum(double* sum, int b_size);
-void zero_sum(double** sum, int b_size);
-void finalize_sums(std::vector<double>& sums);
-void finalize_sums(std::vector<double*>& sums);
+void init_sums(BlockArray& sums, int size, int b_size);
+void zero_sum(std::vector<double>& sums, int j);
+void zero_sum(BlockArray& sums, int j);
 
 
 std::vector<double>& form_new(const CSRMatrix* A, const CSRMatrix* B, 
@@ -26,8 +24,8 @@ std::vector<double>& form_new(const CSRMatrix* A, const CSRMatrix* B,
     *C_ptr = C;
     return C->vals;
 }
-std::vector<double*>& form_new(const CSRMatrix* A, const CSRMatrix* B, 
-        CSRMatrix** C_ptr, std::vector<double*>& A_vals)
+BlockArray& form_new(const CSRMatrix* A, const CSRMatrix* B, 
+        CSRMatrix** C_ptr, BlockArray& A_vals)
 {
     BSRMatrix* C = new BSRMatrix(A->n_rows, B->n_cols, 
             A->b_rows, B->b_cols);
@@ -41,8 +39,8 @@ std::vector<double>& form_new(const CSCMatrix* A, const CSRMatrix* B,
     *C_ptr = C;
     return C->vals;
 }
-std::vector<double*>& form_new(const CSCMatrix* A, const CSRMatrix* B,
-        CSRMatrix** C_ptr, std::vector<double*>& A_vals)
+BlockArray& form_new(const CSCMatrix* A, const CSRMatrix* B,
+        CSRMatrix** C_ptr, BlockArray& A_vals)
 {
     BSRMatrix* C = new BSRMatrix(A->n_cols, B->n_cols,
             A->b_cols, B->b_cols);
@@ -54,51 +52,141 @@ void init_sums(std::vector<double>& sums, int size, int b_size)
 {
     sums.resize(size, 0);
 }
-void init_sums(std::vector<double*>& sums, int size, int b_size)
+void init_sums(BlockArray& sums, int size, int b_size)
 {
-    for (int i = 0; i < size; i++)
-    {
-        sums.emplace_back(new double[b_size]);
-        for (int j = 0; j < b_size; j++)
-            sums[i][j] = 0.0;
-    }
+    sums.set_block_size(b_size);
+    sums.resize(size);
 }
 
-void zero_sum(double* sum, int b_size)
+void zero_sum(std::vector<double>& sums, int j)
 {
-    *sum = 0;
+    sums[j] = 0;
 }
-void zero_sum(double** sum, int b_size)
+void zero_sum(BlockArray& sums, int j)
 {
-    (*sum) = new double[b_size];
-    for (int i = 0; i < b_size; i++)
-        (*sum)[i] = 0;
+    sums.zero(j);
 }
 
-void finalize_sums(std::vector<double>& sums)
+/**************************************************************
+*****   Value Multiplication Kernels
+**************************************************************
+***** Accumulate sum += val * addl_val for single values, or
+***** for blocks, where val is (nr x n_inner) and addl_val is
+***** (n_inner x nc), all stored row-wise.  The transpose
+***** kernels use val^T, with val stored as (n_inner x nr).
+***** Square blocks of size 2, 3, 4, and 6 have their
+***** dimensions fixed at compile time so the block loops are
+***** fully unrolled; other sizes use the general kernels.
+**************************************************************/
+struct ScalarMult
 {
-    return;
-}
-void finalize_sums(std::vector<double*>& sums)
+    void operator()(double val, double addl_val, double& sum) const
+    {
+        sum += (val * addl_val);
+    }
+};
+
+template <int N>
+struct FixedBlockMult
 {
-    for (std::vector<double*>::iterator it = sums.begin();
-            it != sums.end(); ++it)
-        delete[] *it;
-}
+    void operator()(const double* val, const double* addl_val, double* sum) const
+    {
+        for (int i = 0; i < N; i++)
+        {
+            for (int j = 0; j < N; j++)
+            {
+                double s = 0;
+                for (int k = 0; k < N; k++)
+                {
+                    s += val[i*N + k] * addl_val[k*N + j];
+                }
+                sum[i*N + j] += s;
+            }
+        }
+    }
+};
+
+template <int N>
+struct FixedBlockMultT
+{
+    void operator()(const double* val, const double* addl_val, double* sum) const
+    {
+        for (int i = 0; i < N; i++)
+        {
+            for (int j = 0; j < N; j++)
+            {
+                double s = 0;
+                for (int k = 0; k < N; k++)
+                {
+                    s += val[k*N + i] * addl_val[k*N + j];
+                }
+                sum[i*N + j] += s;
+            }
+        }
+    }
+};
+
+struct BlockMult
+{
+    BlockMult(int _nr, int _nc, int _n_inner)
+        : nr(_nr), nc(_nc), n_inner(_n_inner) {}
+
+    void operator()(const double* val, const double* addl_val, double* sum) const
+    {
+        for (int i = 0; i < nr; i++) // Go through b_rows of A
+        { 
+            for (int j = 0; j < nc; j++) // Go through b_cols of B
+            {
+                double s = 0;
+                for (int k = 0; k < n_inner; k++) // Go through b_cols of A (== b_rows of B)
+                {
+                    s += val[i*n_inner + k] * addl_val[k*nc + j];
+                }
+                sum[i*nc + j] += s;
+            }
+        }
+    }
+
+    int nr, nc, n_inner;
+};
+
+struct BlockMultT
+{
+    BlockMultT(int _nr, int _nc, int _n_inner)
+        : nr(_nr), nc(_nc), n_inner(_n_inner) {}
 
-template <typename T>
+    void operator()(const double* val, const double* addl_val, double* sum) const
+    {
+        for (int i = 0; i < nr; i++) // Go through b_cols of A
+        { 
+            for (int j = 0; j < nc; j++) // Go through b_cols of B
+            {
+                double s = 0;
+                for (int k = 0; k < n_inner; k++) // Go through b_rows of A (== b_rows of B)
+                {
+                    s += val[k*nr + i] * addl_val[k*nc + j];
+                }
+                sum[i*nc + j] += s;
+            }
+        }
+    }
+
+    int nr, nc, n_inner;
+};
+
+template <typename VecType, typename MultFunc>
 CSRMatrix* spgemm_helper(const CSRMatrix* A, const CSRMatrix* B, 
-        std::vector<T>& A_vals, std::vector<T>& B_vals,
+        VecType& A_vals, VecType& B_vals, MultFunc mult_vals,
         int* B_to_C = NULL)
 {
-    std::vector<int> next(B->n_cols, -1);
-    std::vector<T> sums;
-    init_sums(sums, B->n_cols, B->b_size);
-
     CSRMatrix* C = NULL;
-    std::vector<T>& C_vals = form_new(A, B, &C, A_vals);
+    VecType& C_vals = form_new(A, B, &C, A_vals);
     C->reserve_size(1.5*A->nnz);
 
+    std::vector<int> next(B->n_cols, -1);
+    VecType sums;
+    init_sums(sums, B->n_cols, C->b_size);
+
     C->idx1[0] = 0;
     for (int i = 0; i < A->n_rows; i++)
     {
@@ -109,14 +197,13 @@ CSRMatrix* spgemm_helper(const CSRMatrix* A, const CSRMatrix* B,
         for (int j = row_start_A; j < row_end_A; j++)
         {
             int col_A = A->idx2[j];
-            T val_A = A_vals[j];
+            auto val_A = A_vals[j];
             int row_start_B = B->idx1[col_A];
             int row_end_B = B->idx1[col_A+1];
             for (int k = row_start_B; k < row_end_B; k++)
             {
                 int col_B = B->idx2[k];
-                A->mult_vals(val_A, B_vals[k], &sums[col_B],
-                        A->b_rows, B->b_cols, A->b_cols);
+                mult_vals(val_A, B_vals[k], sums[col_B]);
                 if (next[col_B] == -1)
                 {
                     next[col_B] = head;
@@ -127,7 +214,7 @@ CSRMatrix* spgemm_helper(const CSRMatrix* A, const CSRMatrix* B,
         }
         for (int j = 0; j < length; j++)
         {
-            double val = A->abs_val(sums[head]);
+            double val = C->abs_val(sums[head]);
             if (val > zero_tol)
             {
                 if (B_to_C) 
@@ -143,29 +230,27 @@ CSRMatrix* spgemm_helper(const CSRMatrix* A, const CSRMatrix* B,
             int tmp = head;
             head = next[head];
             next[tmp] = -1;
-            zero_sum(&sums[tmp], A->b_size);
+            zero_sum(sums, tmp);
         }
         C->idx1[i+1] = C->idx2.size();
     }
     C->nnz = C->idx2.size();
 
-    finalize_sums(sums);
-
     return C;
 }
 
-template <typename T>
+template <typename VecType, typename MultFunc>
 CSRMatrix* spgemm_T_helper(const CSCMatrix* A, const CSRMatrix* B,
-        std::vector<T>& A_vals, std::vector<T>& B_vals,
+        VecType& A_vals, VecType& B_vals, MultFunc mult_T_vals,
         int* C_map = NULL)
 {
     CSRMatrix* C;
-    std::vector<T>& C_vals = form_new(A, B, &C, A_vals);
+    VecType& C_vals = form_new(A, B, &C, A_vals);
     C->reserve_size(1.5*B->nnz);
 
     std::vector<int> next(B->n_cols, -1); 
-    std::vector<T> sums;
-    init_sums(sums, B->n_cols, A->b_size);
+    VecType sums;
+    init_sums(sums, B->n_cols, C->b_size);
 
     C->idx1[0] = 0;
     for (int i = 0; i < A->n_cols; i++)
@@ -177,14 +262,13 @@ CSRMatrix* spgemm_T_helper(const CSCMatrix* A, const CSRMatrix* B,
         for (int j = row_start_AT; j < row_end_AT; j++)
         {
             int col_AT = A->idx2[j];
-            T val_AT = A_vals[j];
+            auto val_AT = A_vals[j];
             int row_start = B->idx1[col_AT];
             int row_end = B->idx1[col_AT+1];
             for (int k = row_start; k < row_end; k++)
             {
                 int col = B->idx2[k];
-                A->mult_T_vals(val_AT, B_vals[k], &sums[col],
-                        A->b_cols, B->b_cols, A->b_rows);
+                mult_T_vals(val_AT, B_vals[k], sums[col]);
                 if (next[col] == -1)
                 {
                     next[col] = head;
@@ -195,7 +279,7 @@ CSRMatrix* spgemm_T_helper(const CSCMatrix* A, const CSRMatrix* B,
         }
         for (int j = 0; j < length; j++)
         {
-            if (A->abs_val(sums[head]) > zero_tol)
+            if (C->abs_val(sums[head]) > zero_tol)
             {
                 if (C_map)
                 {
@@ -210,17 +294,69 @@ CSRMatrix* spgemm_T_helper(const CSCMatrix* A, const CSRMatrix* B,
             int tmp = head;
             head = next[head];
             next[tmp] = -1;
-            zero_sum(&sums[tmp], A->b_size);
+            zero_sum(sums, tmp);
         }
         C->idx1[i+1] = C->idx2.size();
     }
     C->nnz = C->idx2.size();
 
-    finalize_sums(sums);
-
     return C;
 }
 
+CSRMatrix* spgemm_helper(const CSRMatrix* A, const CSRMatrix* B,
+        std::vector<double>& A_vals, std::vector<double>& B_vals,
+        int* B_to_C = NULL)
+{
+    return spgemm_helper(A, B, A_vals, B_vals, ScalarMult(), B_to_C);
+}
+CSRMatrix* spgemm_helper(const CSRMatrix* A, const CSRMatrix* B,
+        BlockArray& A_vals, BlockArray& B_vals, int* B_to_C = NULL)
+{
+    if (A->b_rows == A->b_cols && A->b_cols == B->b_cols)
+    {
+        switch (A->b_rows)
+        {
+            case 2: return spgemm_helper(A, B, A_vals, B_vals, 
+                            FixedBlockMult<2>(), B_to_C);
+            case 3: return spgemm_helper(A, B, A_vals, B_vals, 
+                            FixedBlockMult<3>(), B_to_C);
+            case 4: return spgemm_helper(A, B, A_vals, B_vals, 
+                            FixedBlockMult<4>(), B_to_C);
+            case 6: return spgemm_helper(A, B, A_vals, B_vals, 
+                            FixedBlockMult<6>(), B_to_C);
+        }
+    }
+    return spgemm_helper(A, B, A_vals, B_vals, 
+            BlockMult(A->b_rows, B->b_cols, A->b_cols), B_to_C);
+}
+
+CSRMatrix* spgemm_T_helper(const CSCMatrix* A, const CSRMatrix* B,
+        std::vector<double>& A_vals, std::vector<double>& B_vals,
+        int* C_map = NULL)
+{
+    return spgemm_T_helper(A, B, A_vals, B_vals, ScalarMult(), C_map);
+}
+CSRMatrix* spgemm_T_helper(const CSCMatrix* A, const CSRMatrix* B,
+        BlockArray& A_vals, BlockArray& B_vals, int* C_map = NULL)
+{
+    if (A->b_rows == A->b_cols && A->b_cols == B->b_cols)
+    {
+        switch (A->b_rows)
+        {
+            case 2: return spgemm_T_helper(A, B, A_vals, B_vals, 
+                            FixedBlockMultT<2>(), C_map);
+            case 3: return spgemm_T_helper(A, B, A_vals, B_vals, 
+                            FixedBlockMultT<3>(), C_map);
+            case 4: return spgemm_T_helper(A, B, A_vals, B_vals, 
+                            FixedBlockMultT<4>(), C_map);
+            case 6: return spgemm_T_helper(A, B, A_vals, B_vals, 
+                            FixedBlockMultT<6>(), C_map);
+        }
+    }
+    return spgemm_T_helper(A, B, A_vals, B_vals, 
+            BlockMultT(A->b_cols, B->b_cols, A->b_rows), C_map);
+}
+
 
 CSRMatrix* Matrix::mult(CSRMatrix* B, int* B_to_C)
 {
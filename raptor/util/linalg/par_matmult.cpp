@@ -178,7 +178,7 @@ ParCSRMatrix* ParCSRMatrix::mult_T(ParCSCMatrix* A, bool tap)
     CSRMatrix* Ctmp = mult_T_partial(A);
     std::vector<char> send_buffer;
 
-    A->comm->init_mat_comm_T(send_buffer, Ctmp->idx1, Ctmp->idx2, 
+    A->comm->init_mat_comm_T(send_buffer, Ctmp->idx1, Ctmp->global_idx2, 
             Ctmp->vals);
 
     CSRMatrix* C_on_on = on_proc->mult_T((CSCMatrix*) A->on_proc);
@@ -212,7 +212,7 @@ ParCSRMatrix* ParCSRMatrix::tap_mult_T(ParCSCMatrix* A)
     CSRMatrix* Ctmp = mult_T_partial(A);
     std::vector<char> send_buffer;
 
-    A->tap_mat_comm->init_mat_comm_T(send_buffer, Ctmp->idx1, Ctmp->idx2, 
+    A->tap_mat_comm->init_mat_comm_T(send_buffer, Ctmp->idx1, Ctmp->global_idx2, 
             Ctmp->vals);
 
     CSRMatrix* C_on_on = on_proc->mult_T((CSCMatrix*) A->on_proc);
@@ -258,9 +258,10 @@ void ParCSRMatrix::mult_helper(ParCSRMatrix* B, ParCSRMatrix* C,
 
     // Declare Variables
     int row_start, row_end;
-    int global_col;
+    index_t global_col;
             
-    // Split recv_mat into on and off proc portions
+    // Split recv_mat into on and off proc portions (recv_off keeps
+    // global columns until they are mapped to C)
     CSRMatrix* recv_on = new CSRMatrix(recv_mat->n_rows, -1);
     CSRMatrix* recv_off = new CSRMatrix(recv_mat->n_rows, -1);
 
@@ -273,11 +274,11 @@ void ParCSRMatrix::mult_helper(ParCSRMatrix* B, ParCSRMatrix* C,
         row_end = recv_mat->idx1[i+1];
         for (int j = row_start; j < row_end; j++)
         {
-            global_col = recv_mat->idx2[j];
+            global_col = recv_mat->global_idx2[j];
             if (global_col < B->partition->first_local_col ||
                     global_col > B->partition->last_local_col)
             {
-                recv_off->idx2.emplace_back(global_col);
+                recv_off->global_idx2.emplace_back(global_col);
                 recv_off->vals.emplace_back(recv_mat->vals[j]);
             }
             else
@@ -288,48 +289,40 @@ void ParCSRMatrix::mult_helper(ParCSRMatrix* B, ParCSRMatrix* C,
             }
         }
         recv_on->idx1[i+1] = recv_on->idx2.size();
-        recv_off->idx1[i+1] = recv_off->idx2.size();
+        recv_off->idx1[i+1] = recv_off->global_idx2.size();
     }
     recv_on->nnz = recv_on->idx2.size();
-    recv_off->nnz = recv_off->idx2.size();
+    recv_off->nnz = recv_off->global_idx2.size();
     delete[] part_to_col;
 
     // Calculate global_to_C and B_to_C column maps
-    std::map<int, int> global_to_C;
     std::vector<int> B_to_C(B->off_proc_num_cols);
 
-    std::copy(recv_off->idx2.begin(), recv_off->idx2.end(),
+    std::copy(recv_off->global_idx2.begin(), recv_off->global_idx2.end(),
             std::back_inserter(C->off_proc_column_map));
-    for (std::vector<int>::iterator it = B->off_proc_column_map.begin();
+    for (std::vector<index_t>::iterator it = B->off_proc_column_map.begin();
             it != B->off_proc_column_map.end(); ++it)
     {
         C->off_proc_column_map.emplace_back(*it);
     }
-    std::sort(C->off_proc_column_map.begin(), C->off_proc_column_map.end());
+    sort_unique(C->off_proc_column_map);
+    C->off_proc_num_cols = C->off_proc_column_map.size();
 
-    int prev_col = -1;
-    C->off_proc_num_cols = 0;
-    for (std::vector<int>::iterator it = C->off_proc_column_map.begin();
-            it != C->off_proc_column_map.end(); ++it)
+    IntMap<index_t> global_to_C(C->off_proc_num_cols);
+    for (int i = 0; i < C->off_proc_num_cols; i++)
     {
-        if (*it != prev_col)
-        {
-            global_to_C[*it] = C->off_proc_num_cols;
-            C->off_proc_column_map[C->off_proc_num_cols++] = *it;
-            prev_col = *it;
-        }
+        global_to_C.insert(C->off_proc_column_map[i], i);
     }
-    C->off_proc_column_map.resize(C->off_proc_num_cols);
 
     for (int i = 0; i < B->off_proc_num_cols; i++)
     {
         global_col = B->off_proc_column_map[i];
-        B_to_C[i] = global_to_C[global_col];
+        B_to_C[i] = global_to_C.find(global_col);
     }
-    for (std::vector<int>::iterator it = recv_off->idx2.begin(); 
-            it != recv_off->idx2.end(); ++it)
+    recv_off->idx2.resize(recv_off->nnz);
+    for (int j = 0; j < recv_off->nnz; j++)
     {
-        *it = global_to_C[*it];
+        recv_off->idx2[j] = global_to_C.find(recv_off->global_idx2[j]);
     }
 
     for (std::vector<int>::iterator it = C_on_off->idx2.begin();
@@ -361,11 +354,35 @@ void ParCSRMatrix::mult_helper(ParCSRMatrix* B, ParCSRMatrix* C,
     C->local_nnz = C->on_proc->nnz + C->off_proc->nnz;
 }
 
+// Rows of C for off_proc columns of A_off, with the global columns
+// of C held in Ctmp->global_idx2 (sorted within each row)
 CSRMatrix* ParCSRMatrix::mult_T_partial(CSCMatrix* A_off)
 {
-    CSRMatrix* C_off_on = on_proc->mult_T(A_off, on_proc_column_map.data());
-    CSRMatrix* C_off_off = off_proc->mult_T(A_off, off_proc_column_map.data());
-    CSRMatrix* Ctmp = C_off_on->add(C_off_off, false);
+    std::vector<int> perm;
+
+    CSRMatrix* C_off_on = on_proc->mult_T(A_off);
+    CSRMatrix* C_off_off = off_proc->mult_T(A_off);
+    CSRMatrix* Ctmp = new CSRMatrix(C_off_on->n_rows, -1);
+    Ctmp->global_idx2.reserve(C_off_on->nnz + C_off_off->nnz);
+    Ctmp->vals.reserve(C_off_on->nnz + C_off_off->nnz);
+
+    Ctmp->idx1[0] = 0;
+    for (int i = 0; i < Ctmp->n_rows; i++)
+    {
+        for (int j = C_off_on->idx1[i]; j < C_off_on->idx1[i+1]; j++)
+        {
+            Ctmp->global_idx2.emplace_back(on_proc_column_map[C_off_on->idx2[j]]);
+            Ctmp->vals.emplace_back(C_off_on->vals[j]);
+        }
+        for (int j = C_off_off->idx1[i]; j < C_off_off->idx1[i+1]; j++)
+        {
+            Ctmp->global_idx2.emplace_back(off_proc_column_map[C_off_off->idx2[j]]);
+            Ctmp->vals.emplace_back(C_off_off->vals[j]);
+        }
+        Ctmp->idx1[i+1] = Ctmp->global_idx2.size();
+        vec_sort(Ctmp->global_idx2, Ctmp->vals, Ctmp->idx1[i], Ctmp->idx1[i+1], perm);
+    }
+    Ctmp->nnz = Ctmp->global_idx2.size();
 
     delete C_off_on;
     delete C_off_off;
@@ -385,12 +402,14 @@ void ParCSRMatrix::mult_T_combine(ParCSCMatrix* P, ParCSRMatrix* C, CSRMatrix* r
 { 
     int start, end, ctr;
     int col, col_C;
+    index_t global_col;
 
     std::vector<double> sums;
     std::vector<int> next;
 
-    // Split recv_mat into recv_on and recv_off
-    // Split recv_mat into on and off proc portions
+    // Split recv_mat into on and off proc portions (recv_off keeps
+    // global columns until they are mapped to C)
+    int* part_to_col = map_partition_to_local();
     CSRMatrix* recv_on = new CSRMatrix(recv_mat->n_rows, -1);
     CSRMatrix* recv_off = new CSRMatrix(recv_mat->n_rows, -1);
     for (int i = 0; i < recv_mat->n_rows; i++)
@@ -399,24 +418,26 @@ void ParCSRMatrix::mult_T_combine(ParCSCMatrix* P, ParCSRMatrix* C, CSRMatrix* r
         end = recv_mat->idx1[i+1];
         for (int j = start; j < end; j++)
         {
-            col = recv_mat->idx2[j];
-            if (col < partition->first_local_col
-                    || col > partition->last_local_col)
+            global_col = recv_mat->global_idx2[j];
+            if (global_col < partition->first_local_col
+                    || global_col > partition->last_local_col)
             {
-                recv_off->idx2.emplace_back(col);
+                recv_off->global_idx2.emplace_back(global_col);
                 recv_off->vals.emplace_back(recv_mat->vals[j]);
             }
             else
             {
-                recv_on->idx2.emplace_back(col);
+                recv_on->idx2.emplace_back(part_to_col[global_col 
+                        - partition->first_local_col]);
                 recv_on->vals.emplace_back(recv_mat->vals[j]);
             }
         }
         recv_on->idx1[i+1] = recv_on->idx2.size();
-        recv_off->idx1[i+1] = recv_off->idx2.size();
+        recv_off->idx1[i+1] = recv_off->global_idx2.size();
     }
     recv_on->nnz = recv_on->idx2.size();
-    recv_off->nnz = recv_off->idx2.size();
+    recv_off->nnz = recv_off->global_idx2.size();
+    delete[] part_to_col;
 
 
     // Set dimensions of C
@@ -435,15 +456,6 @@ void ParCSRMatrix::mult_T_combine(ParCSCMatrix* P, ParCSRMatrix* C, CSRMatrix* r
     C->local_row_map = P->get_on_proc_column_map();
     C->on_proc_num_cols = C->on_proc_column_map.size();
 
-    // Update recv_on columns (to match local cols)
-    int* part_to_col = map_partition_to_local();
-    for (std::vector<int>::iterator it = recv_on->idx2.begin();
-            it != recv_on->idx2.end(); ++it)
-    {
-        *it = part_to_col[(*it - partition->first_local_col)];
-    }
-    delete[] part_to_col;
-
     // Multiply on_proc    
     recv_on->n_cols = C->on_proc_num_cols;
     C_on_on->add_append(recv_on, (CSRMatrix*) C->on_proc);
@@ -452,51 +464,40 @@ void ParCSRMatrix::mult_T_combine(ParCSCMatrix* P, ParCSRMatrix* C, CSRMatrix* r
      * Form off_proc
      ******************************/
     // Calculate global_to_C and map_to_C column maps
-    std::map<int, int> global_to_C;
     std::vector<int> map_to_C;
     if (off_proc_num_cols)
     {
         map_to_C.reserve(off_proc_num_cols);
     }
 
-    // Create set of global columns in B_off_proc and recv_mat
-    std::set<int> C_col_set;
-    for (std::vector<int>::iterator it = recv_off->idx2.begin(); 
-            it != recv_off->idx2.end(); ++it)
-    {
-        C_col_set.insert(*it);
-    }
-    for (std::vector<int>::iterator it = off_proc_column_map.begin(); 
-            it != off_proc_column_map.end(); ++it)
-    {
-        C_col_set.insert(*it);
-    }
+    // Sorted global columns in B_off_proc and recv_mat
+    C->off_proc_column_map.reserve(recv_off->nnz + off_proc_num_cols);
+    std::copy(recv_off->global_idx2.begin(), recv_off->global_idx2.end(),
+            std::back_inserter(C->off_proc_column_map));
+    std::copy(off_proc_column_map.begin(), off_proc_column_map.end(),
+            std::back_inserter(C->off_proc_column_map));
+    sort_unique(C->off_proc_column_map);
+    C->off_proc_num_cols = C->off_proc_column_map.size();
 
-    C->off_proc_num_cols = C_col_set.size();
-    if (C->off_proc_num_cols)
+    IntMap<index_t> global_to_C(C->off_proc_num_cols);
+    for (int i = 0; i < C->off_proc_num_cols; i++)
     {
-        C->off_proc_column_map.reserve(C->off_proc_num_cols);
-    }
-    for (std::set<int>::iterator it = C_col_set.begin(); 
-            it != C_col_set.end(); ++it)
-    {
-        global_to_C[*it] = C->off_proc_column_map.size();
-        C->off_proc_column_map.emplace_back(*it);
+        global_to_C.insert(C->off_proc_column_map[i], i);
     }
 
     // Map local off_proc_cols to C->off_proc_column_map
-    for (std::vector<int>::iterator it = off_proc_column_map.begin();
+    for (std::vector<index_t>::iterator it = off_proc_column_map.begin();
             it != off_proc_column_map.end(); ++it)
     {
-        col_C = global_to_C[*it];
+        col_C = global_to_C.find(*it);
         map_to_C.emplace_back(col_C);
     }
 
     // Update recvd cols from global_col to local col in C
-    for (std::vector<int>::iterator it = recv_off->idx2.begin();
-            it != recv_off->idx2.end(); ++it)
+    recv_off->idx2.resize(recv_off->nnz);
+    for (int j = 0; j < recv_off->nnz; j++)
     {
-        *it = global_to_C[*it];
+        recv_off->idx2[j] = global_to_C.find(recv_off->global_idx2[j]);
     }
 
     recv_off->n_cols = C->off_proc_num_cols;
@@ -561,3 +562,1217 @@ void ParCSRMatrix::mult_T_combine(ParCSCMatrix* P, ParCSRMatrix* C, CSRMatrix* r
     delete recv_off;
 }
 
+
+/**************************************************************
+*****   Transpose Pattern
+**************************************************************
+***** Forms the transposed pattern of a CSR matrix with n_cols
+***** columns, keeping the position of each entry in A
+**************************************************************/
+void transpose_pattern(const CSRMatrix* A, int n_cols, std::vector<int>& ptr,
+        std::vector<int>& rows, std::vector<int>& pos)
+{
+    int nnz = A->idx1[A->n_rows];
+
+    ptr.assign(n_cols + 1, 0);
+    for (int j = 0; j < nnz; j++)
+    {
+        ptr[A->idx2[j] + 1]++;
+    }
+    for (int i = 0; i < n_cols; i++)
+    {
+        ptr[i+1] += ptr[i];
+    }
+
+    rows.resize(nnz);
+    pos.resize(nnz);
+    std::vector<int> next(ptr.begin(), ptr.end() - 1);
+    for (int i = 0; i < A->n_rows; i++)
+    {
+        for (int j = A->idx1[i]; j < A->idx1[i+1]; j++)
+        {
+            int k = next[A->idx2[j]]++;
+            rows[k] = i;
+            pos[k] = j;
+        }
+    }
+}
+
+// Communicates global indices over the messages of comm.  The int
+// buffers of comm would truncate index_t, so the messages are sent
+// directly as RAPtor_MPI_INDEX_T
+void communicate_global(ParComm* comm, const std::vector<index_t>& values,
+        std::vector<index_t>& recv_values)
+{
+    int start, end;
+    NonContigData* send_data = comm->send_data;
+    CommData* recv_data = comm->recv_data;
+    std::vector<index_t> send_buffer(send_data->size_msgs);
+    recv_values.resize(recv_data->size_msgs);
+
+    for (int i = 0; i < send_data->num_msgs; i++)
+    {
+        start = send_data->indptr[i];
+        end = send_data->indptr[i+1];
+        for (int j = start; j < end; j++)
+        {
+            send_buffer[j] = values[send_data->indices[j]];
+        }
+        RAPtor_MPI_Isend(&(send_buffer[start]), end - start, RAPtor_MPI_INDEX_T,
+                send_data->procs[i], comm->key, comm->mpi_comm,
+                &(send_data->requests[i]));
+    }
+    for (int i = 0; i < recv_data->num_msgs; i++)
+    {
+        start = recv_data->indptr[i];
+        end = recv_data->indptr[i+1];
+        RAPtor_MPI_Irecv(&(recv_values[start]), end - start, RAPtor_MPI_INDEX_T,
+                recv_data->procs[i], comm->key, comm->mpi_comm,
+                &(recv_data->requests[i]));
+    }
+    if (send_data->num_msgs)
+    {
+        RAPtor_MPI_Waitall(send_data->num_msgs, send_data->requests.data(),
+                RAPtor_MPI_STATUSES_IGNORE);
+    }
+    if (recv_data->num_msgs)
+    {
+        RAPtor_MPI_Waitall(recv_data->num_msgs, recv_data->requests.data(),
+                RAPtor_MPI_STATUSES_IGNORE);
+    }
+}
+
+/**************************************************************
+*****   ParSpGEMMPlan Symbolic
+**************************************************************
+***** Forms the plan for C = A*B.  Sizes and global columns of
+***** the rows of B needed by off_proc columns of A are
+***** communicated once, and the pattern of C is formed in two
+***** passes (counting, then filling storage of exact size).
+*****
+***** Parameters
+***** -------------
+***** A : ParCSRMatrix*
+*****    Matrix on the left of the product
+***** B : ParCSRMatrix*
+*****    Matrix on the right of the product
+*****
+***** Returns
+***** -------------
+***** ParCSRMatrix* : pattern of A*B, with all values zero
+**************************************************************/
+ParCSRMatrix* ParSpGEMMPlan::symbolic(ParCSRMatrix* A, ParCSRMatrix* B)
+{
+    int start, end, row;
+    index_t global_col;
+    std::vector<int> msg_idx;
+
+    transpose = false;
+
+    if (A->comm == NULL)
+    {
+        A->comm = new ParComm(A->partition, A->off_proc_column_map,
+                A->on_proc_column_map);
+    }
+    ParComm* comm = A->comm;
+
+    // Rows of B, with on_proc entries of each row before off_proc
+    std::vector<int> row_sizes(B->local_num_rows);
+    B_ptr.resize(B->local_num_rows + 1);
+    B_ptr[0] = 0;
+    for (int i = 0; i < B->local_num_rows; i++)
+    {
+        row_sizes[i] = (B->on_proc->idx1[i+1] - B->on_proc->idx1[i])
+            + (B->off_proc->idx1[i+1] - B->off_proc->idx1[i]);
+        B_ptr[i+1] = B_ptr[i] + row_sizes[i];
+    }
+    B_vals.resize(B_ptr[B->local_num_rows]);
+
+    // Sizes of the rows of B needed by off_proc columns of A
+    std::vector<int>& recv_sizes = comm->communicate(row_sizes);
+    recv_ptr.resize(A->off_proc_num_cols + 1);
+    recv_ptr[0] = 0;
+    for (int i = 0; i < A->off_proc_num_cols; i++)
+    {
+        recv_ptr[i+1] = recv_ptr[i] + recv_sizes[i];
+    }
+
+    // Communicator for the values of these rows
+    delete val_comm;
+    val_comm = new ParComm(A->partition, comm->key, comm->mpi_comm);
+    for (int i = 0; i < comm->send_data->num_msgs; i++)
+    {
+        msg_idx.clear();
+        start = comm->send_data->indptr[i];
+        end = comm->send_data->indptr[i+1];
+        for (int j = start; j < end; j++)
+        {
+            row = comm->send_data->indices[j];
+            for (int k = B_ptr[row]; k < B_ptr[row+1]; k++)
+            {
+                msg_idx.emplace_back(k);
+            }
+        }
+        val_comm->send_data->add_msg(comm->send_data->procs[i], msg_idx.size(),
+                msg_idx.data());
+    }
+    for (int i = 0; i < comm->recv_data->num_msgs; i++)
+    {
+        start = comm->recv_data->indptr[i];
+        end = comm->recv_data->indptr[i+1];
+        val_comm->recv_data->add_msg(comm->recv_data->procs[i],
+                recv_ptr[end] - recv_ptr[start]);
+    }
+    val_comm->send_data->finalize();
+    val_comm->recv_data->finalize();
+
+    // Global columns of the rows of B
+    std::vector<index_t> global_cols(B_ptr[B->local_num_rows]);
+    for (int i = 0; i < B->local_num_rows; i++)
+    {
+        row = B_ptr[i];
+        for (int j = B->on_proc->idx1[i]; j < B->on_proc->idx1[i+1]; j++)
+        {
+            global_cols[row++] = B->on_proc_column_map[B->on_proc->idx2[j]];
+        }
+        for (int j = B->off_proc->idx1[i]; j < B->off_proc->idx1[i+1]; j++)
+        {
+            global_cols[row++] = B->off_proc_column_map[B->off_proc->idx2[j]];
+        }
+    }
+    std::vector<index_t> recv_global;
+    communicate_global(val_comm, global_cols, recv_global);
+
+    // Off_proc columns of C : union of those of B and those received
+    ParCSRMatrix* C = init_matrix(A, B);
+    C->global_num_rows = A->global_num_rows;
+    C->global_num_cols = B->global_num_cols;
+    C->local_num_rows = A->local_num_rows;
+    C->on_proc_column_map = B->get_on_proc_column_map();
+    C->local_row_map = A->get_local_row_map();
+    C->on_proc_num_cols = C->on_proc_column_map.size();
+
+    index_t first_col = B->partition->first_local_col;
+    index_t last_col = B->partition->last_local_col;
+    C->off_proc_column_map = B->off_proc_column_map;
+    for (int i = 0; i < recv_ptr[A->off_proc_num_cols]; i++)
+    {
+        global_col = recv_global[i];
+        if (global_col < first_col || global_col > last_col)
+        {
+            C->off_proc_column_map.emplace_back(global_col);
+        }
+    }
+    std::sort(C->off_proc_column_map.begin(), C->off_proc_column_map.end());
+    C->off_proc_column_map.erase(std::unique(C->off_proc_column_map.begin(),
+                C->off_proc_column_map.end()), C->off_proc_column_map.end());
+    C->off_proc_num_cols = C->off_proc_column_map.size();
+    n_on = C->on_proc_num_cols;
+
+    // Columns of C for each entry of B
+    std::vector<int> B_to_C(B->off_proc_num_cols);
+    for (int i = 0; i < B->off_proc_num_cols; i++)
+    {
+        B_to_C[i] = n_on + (std::lower_bound(C->off_proc_column_map.begin(),
+                    C->off_proc_column_map.end(), B->off_proc_column_map[i])
+                - C->off_proc_column_map.begin());
+    }
+    B_cols.resize(B_ptr[B->local_num_rows]);
+    for (int i = 0; i < B->local_num_rows; i++)
+    {
+        row = B_ptr[i];
+        for (int j = B->on_proc->idx1[i]; j < B->on_proc->idx1[i+1]; j++)
+        {
+            B_cols[row++] = B->on_proc->idx2[j];
+        }
+        for (int j = B->off_proc->idx1[i]; j < B->off_proc->idx1[i+1]; j++)
+        {
+            B_cols[row++] = B_to_C[B->off_proc->idx2[j]];
+        }
+    }
+
+    // Columns of C for each received entry
+    int* part_to_col = B->map_partition_to_local();
+    recv_cols.resize(recv_ptr[A->off_proc_num_cols]);
+    for (int i = 0; i < recv_ptr[A->off_proc_num_cols]; i++)
+    {
+        global_col = recv_global[i];
+        if (global_col < first_col || global_col > last_col)
+        {
+            recv_cols[i] = n_on + (std::lower_bound(C->off_proc_column_map.begin(),
+                        C->off_proc_column_map.end(), global_col)
+                    - C->off_proc_column_map.begin());
+        }
+        else
+        {
+            recv_cols[i] = part_to_col[global_col - first_col];
+        }
+    }
+    delete[] part_to_col;
+
+    form_pattern(A, C);
+
+    return C;
+}
+
+/**************************************************************
+*****   ParSpGEMMPlan Symbolic Transpose
+**************************************************************
+***** Forms the plan for C = P^T*A.  Rows of P_off^T*A belong to
+***** the owners of off_proc columns of P.  Their sizes and
+***** global columns are communicated once, and the pattern of
+***** C is formed in two passes (counting, then filling storage
+***** of exact size).
+*****
+***** Parameters
+***** -------------
+***** A : ParCSRMatrix*
+*****    Matrix on the right of the product
+***** P : ParCSRMatrix*
+*****    Matrix transposed on the left of the product
+*****
+***** Returns
+***** -------------
+***** ParCSRMatrix* : pattern of P^T*A, with all values zero
+**************************************************************/
+ParCSRMatrix* ParSpGEMMPlan::symbolic_T(ParCSRMatrix* A, ParCSRMatrix* P)
+{
+    int start, end, ctr, row, size;
+    index_t global_col;
+    std::vector<int> msg_idx;
+    std::vector<int> cols;
+
+    transpose = true;
+
+    if (P->comm == NULL)
+    {
+        P->comm = new ParComm(P->partition, P->off_proc_column_map,
+                P->on_proc_column_map);
+    }
+    ParComm* comm = P->comm;
+
+    n_inner_on = A->on_proc_num_cols;
+    int n_inner = A->on_proc_num_cols + A->off_proc_num_cols;
+    int n_send_rows = P->off_proc_num_cols;
+
+    transpose_pattern((CSRMatrix*) P->on_proc, P->on_proc_num_cols, PT_on_ptr,
+            PT_on_rows, PT_on_pos);
+    transpose_pattern((CSRMatrix*) P->off_proc, P->off_proc_num_cols, PT_off_ptr,
+            PT_off_rows, PT_off_pos);
+
+    // Pattern of P_off^T*A, with columns of A
+    pos.assign(n_inner, -1);
+    send_ptr.resize(n_send_rows + 1);
+    send_ptr[0] = 0;
+    for (int i = 0; i < n_send_rows; i++)
+    {
+        cols.clear();
+        for (int j = PT_off_ptr[i]; j < PT_off_ptr[i+1]; j++)
+        {
+            row = PT_off_rows[j];
+            for (int k = A->on_proc->idx1[row]; k < A->on_proc->idx1[row+1]; k++)
+            {
+                if (pos[A->on_proc->idx2[k]] != i)
+                {
+                    pos[A->on_proc->idx2[k]] = i;
+                    cols.emplace_back(A->on_proc->idx2[k]);
+                }
+            }
+            for (int k = A->off_proc->idx1[row]; k < A->off_proc->idx1[row+1]; k++)
+            {
+                if (pos[n_inner_on + A->off_proc->idx2[k]] != i)
+                {
+                    pos[n_inner_on + A->off_proc->idx2[k]] = i;
+                    cols.emplace_back(n_inner_on + A->off_proc->idx2[k]);
+                }
+            }
+        }
+        send_ptr[i+1] = send_ptr[i] + cols.size();
+    }
+    send_cols.resize(send_ptr[n_send_rows]);
+    send_vals.resize(send_ptr[n_send_rows]);
+    std::fill(pos.begin(), pos.end(), -1);
+    for (int i = 0; i < n_send_rows; i++)
+    {
+        ctr = send_ptr[i];
+        for (int j = PT_off_ptr[i]; j < PT_off_ptr[i+1]; j++)
+        {
+            row = PT_off_rows[j];
+            for (int k = A->on_proc->idx1[row]; k < A->on_proc->idx1[row+1]; k++)
+            {
+                if (pos[A->on_proc->idx2[k]] != i)
+                {
+                    pos[A->on_proc->idx2[k]] = i;
+                    send_cols[ctr++] = A->on_proc->idx2[k];
+                }
+            }
+            for (int k = A->off_proc->idx1[row]; k < A->off_proc->idx1[row+1]; k++)
+            {
+                if (pos[n_inner_on + A->off_proc->idx2[k]] != i)
+                {
+                    pos[n_inner_on + A->off_proc->idx2[k]] = i;
+                    send_cols[ctr++] = n_inner_on + A->off_proc->idx2[k];
+                }
+            }
+        }
+        std::sort(send_cols.begin() + send_ptr[i], send_cols.begin() + ctr);
+    }
+
+    // Sizes of rows sent to owners of off_proc columns of P
+    std::vector<int> send_sizes(n_send_rows);
+    for (int i = 0; i < n_send_rows; i++)
+    {
+        send_sizes[i] = send_ptr[i+1] - send_ptr[i];
+    }
+    ParComm size_comm(P->partition, comm->key, comm->mpi_comm);
+    for (int i = 0; i < comm->recv_data->num_msgs; i++)
+    {
+        start = comm->recv_data->indptr[i];
+        end = comm->recv_data->indptr[i+1];
+        msg_idx.resize(end - start);
+        std::iota(msg_idx.begin(), msg_idx.end(), start);
+        size_comm.send_data->add_msg(comm->recv_data->procs[i], end - start,
+                msg_idx.data());
+    }
+    for (int i = 0; i < comm->send_data->num_msgs; i++)
+    {
+        start = comm->send_data->indptr[i];
+        end = comm->send_data->indptr[i+1];
+        size_comm.recv_data->add_msg(comm->send_data->procs[i], end - start);
+    }
+    size_comm.send_data->finalize();
+    size_comm.recv_data->finalize();
+    std::vector<int>& recv_sizes_buf = size_comm.communicate(send_sizes);
+    std::vector<int> recv_sizes(recv_sizes_buf.begin(), recv_sizes_buf.begin() 
+            + comm->send_data->size_msgs);
+
+    // Communicator for the values of these rows
+    delete val_comm;
+    val_comm = new ParComm(P->partition, comm->key, comm->mpi_comm);
+    for (int i = 0; i < comm->recv_data->num_msgs; i++)
+    {
+        start = send_ptr[comm->recv_data->indptr[i]];
+        end = send_ptr[comm->recv_data->indptr[i+1]];
+        msg_idx.resize(end - start);
+        std::iota(msg_idx.begin(), msg_idx.end(), start);
+        val_comm->send_data->add_msg(comm->recv_data->procs[i], end - start,
+                msg_idx.data());
+    }
+    for (int i = 0; i < comm->send_data->num_msgs; i++)
+    {
+        size = 0;
+        for (int j = comm->send_data->indptr[i]; j < comm->send_data->indptr[i+1]; j++)
+        {
+            size += recv_sizes[j];
+        }
+        val_comm->recv_data->add_msg(comm->send_data->procs[i], size);
+    }
+    val_comm->send_data->finalize();
+    val_comm->recv_data->finalize();
+
+    // Global columns of rows sent
+    std::vector<index_t> global_cols(send_ptr[n_send_rows]);
+    for (int i = 0; i < send_ptr[n_send_rows]; i++)
+    {
+        if (send_cols[i] < n_inner_on)
+        {
+            global_cols[i] = A->on_proc_column_map[send_cols[i]];
+        }
+        else
+        {
+            global_cols[i] = A->off_proc_column_map[send_cols[i] - n_inner_on];
+        }
+    }
+    std::vector<index_t> recv_global;
+    communicate_global(val_comm, global_cols, recv_global);
+    int n_recv = val_comm->recv_data->size_msgs;
+
+    // Initialize C, with rows of the local columns of P
+    ParCSRMatrix* C = init_matrix(A, P);
+    C->global_num_rows = P->global_num_cols;
+    C->global_num_cols = A->global_num_cols;
+    C->local_num_rows = P->on_proc_num_cols;
+    C->on_proc_column_map = A->get_on_proc_column_map();
+    C->local_row_map = P->get_on_proc_column_map();
+    C->on_proc_num_cols = C->on_proc_column_map.size();
+    n_on = C->on_proc_num_cols;
+
+    // Off_proc columns of C : those of A in rows with on_proc entries
+    // of P, and those received
+    index_t first_col = A->partition->first_local_col;
+    index_t last_col = A->partition->last_local_col;
+    std::vector<int> used(A->off_proc_num_cols, 0);
+    for (int i = 0; i < A->local_num_rows; i++)
+    {
+        if (P->on_proc->idx1[i+1] == P->on_proc->idx1[i]) continue;
+        for (int j = A->off_proc->idx1[i]; j < A->off_proc->idx1[i+1]; j++)
+        {
+            used[A->off_proc->idx2[j]] = 1;
+        }
+    }
+    C->off_proc_column_map.clear();
+    for (int i = 0; i < A->off_proc_num_cols; i++)
+    {
+        if (used[i])
+        {
+            C->off_proc_column_map.emplace_back(A->off_proc_column_map[i]);
+        }
+    }
+    for (int i = 0; i < n_recv; i++)
+    {
+        global_col = recv_global[i];
+        if (global_col < first_col || global_col > last_col)
+        {
+            C->off_proc_column_map.emplace_back(global_col);
+        }
+    }
+    std::sort(C->off_proc_column_map.begin(), C->off_proc_column_map.end());
+    C->off_proc_column_map.erase(std::unique(C->off_proc_column_map.begin(),
+                C->off_proc_column_map.end()), C->off_proc_column_map.end());
+    C->off_proc_num_cols = C->off_proc_column_map.size();
+
+    A_off_to_C.resize(A->off_proc_num_cols);
+    for (int i = 0; i < A->off_proc_num_cols; i++)
+    {
+        if (used[i])
+        {
+            A_off_to_C[i] = n_on + (std::lower_bound(C->off_proc_column_map.begin(),
+                        C->off_proc_column_map.end(), A->off_proc_column_map[i])
+                    - C->off_proc_column_map.begin());
+        }
+        else
+        {
+            A_off_to_C[i] = -1;
+        }
+    }
+
+    // Group received entries by local row of C
+    NonContigData* send_data = comm->send_data;
+    recv_ptr.assign(C->local_num_rows + 1, 0);
+    for (int i = 0; i < send_data->size_msgs; i++)
+    {
+        recv_ptr[send_data->indices[i] + 1] += recv_sizes[i];
+    }
+    for (int i = 0; i < C->local_num_rows; i++)
+    {
+        recv_ptr[i+1] += recv_ptr[i];
+    }
+    recv_idx.resize(n_recv);
+    recv_cols.resize(n_recv);
+    std::vector<int> next(recv_ptr.begin(), recv_ptr.end() - 1);
+    int* part_to_col = A->map_partition_to_local();
+    ctr = 0;
+    for (int i = 0; i < send_data->size_msgs; i++)
+    {
+        row = send_data->indices[i];
+        for (int j = 0; j < recv_sizes[i]; j++)
+        {
+            int k = next[row]++;
+            global_col = recv_global[ctr];
+            recv_idx[k] = ctr++;
+            if (global_col < first_col || global_col > last_col)
+            {
+                recv_cols[k] = n_on + (std::lower_bound(C->off_proc_column_map.begin(),
+                            C->off_proc_column_map.end(), global_col)
+                        - C->off_proc_column_map.begin());
+            }
+            else
+            {
+                recv_cols[k] = part_to_col[global_col - first_col];
+            }
+        }
+    }
+    delete[] part_to_col;
+
+    form_pattern(A, C);
+
+    if ((int) pos.size() < n_inner)
+    {
+        pos.resize(n_inner);
+    }
+
+    return C;
+}
+
+/**************************************************************
+*****   ParSpGEMMPlan Add Row Columns
+**************************************************************
+***** Appends the columns of row 'row' of the product to cols,
+***** skipping those already marked with this row in pos
+**************************************************************/
+void ParSpGEMMPlan::add_row_cols(ParCSRMatrix* A, int row, int mark,
+        std::vector<int>& cols)
+{
+    int col, r;
+
+    if (transpose)
+    {
+        for (int j = PT_on_ptr[row]; j < PT_on_ptr[row+1]; j++)
+        {
+            r = PT_on_rows[j];
+            for (int k = A->on_proc->idx1[r]; k < A->on_proc->idx1[r+1]; k++)
+            {
+                col = A->on_proc->idx2[k];
+                if (pos[col] != mark)
+                {
+                    pos[col] = mark;
+                    cols.emplace_back(col);
+                }
+            }
+            for (int k = A->off_proc->idx1[r]; k < A->off_proc->idx1[r+1]; k++)
+            {
+                col = A_off_to_C[A->off_proc->idx2[k]];
+                if (pos[col] != mark)
+                {
+                    pos[col] = mark;
+                    cols.emplace_back(col);
+                }
+            }
+        }
+        for (int j = recv_ptr[row]; j < recv_ptr[row+1]; j++)
+        {
+            col = recv_cols[j];
+            if (pos[col] != mark)
+            {
+                pos[col] = mark;
+                cols.emplace_back(col);
+            }
+        }
+    }
+    else
+    {
+        for (int j = A->on_proc->idx1[row]; j < A->on_proc->idx1[row+1]; j++)
+        {
+            r = A->on_proc->idx2[j];
+            for (int k = B_ptr[r]; k < B_ptr[r+1]; k++)
+            {
+                col = B_cols[k];
+                if (pos[col] != mark)
+                {
+                    pos[col] = mark;
+                    cols.emplace_back(col);
+                }
+            }
+        }
+        for (int j = A->off_proc->idx1[row]; j < A->off_proc->idx1[row+1]; j++)
+        {
+            r = A->off_proc->idx2[j];
+            for (int k = recv_ptr[r]; k < recv_ptr[r+1]; k++)
+            {
+                col = recv_cols[k];
+                if (pos[col] != mark)
+                {
+                    pos[col] = mark;
+                    cols.emplace_back(col);
+                }
+            }
+        }
+    }
+}
+
+/**************************************************************
+*****   ParSpGEMMPlan Form Pattern
+**************************************************************
+***** Forms the pattern of C, once the column maps of C are set.
+***** Row sizes are counted first, so that C->on_proc and
+***** C->off_proc are allocated once with their exact sizes.
+***** Columns within each row are sorted.
+**************************************************************/
+void ParSpGEMMPlan::form_pattern(ParCSRMatrix* A, ParCSRMatrix* C)
+{
+    int on_ctr, off_ctr;
+    int n_rows = C->local_num_rows;
+    std::vector<int> cols;
+
+    CSRMatrix* C_on = (CSRMatrix*) C->on_proc;
+    CSRMatrix* C_off = (CSRMatrix*) C->off_proc;
+
+    pos.assign(n_on + C->off_proc_num_cols, -1);
+    C_on->idx1.resize(n_rows + 1);
+    C_off->idx1.resize(n_rows + 1);
+    C_on->idx1[0] = 0;
+    C_off->idx1[0] = 0;
+    for (int i = 0; i < n_rows; i++)
+    {
+        cols.clear();
+        add_row_cols(A, i, i, cols);
+        on_ctr = 0;
+        for (std::vector<int>::iterator it = cols.begin(); it != cols.end(); ++it)
+        {
+            if (*it < n_on) on_ctr++;
+        }
+        C_on->idx1[i+1] = C_on->idx1[i] + on_ctr;
+        C_off->idx1[i+1] = C_off->idx1[i] + (cols.size() - on_ctr);
+    }
+
+    C_on->n_rows = n_rows;
+    C_on->n_cols = n_on;
+    C_on->nnz = C_on->idx1[n_rows];
+    C_on->idx2.resize(C_on->nnz);
+    C_on->vals.assign(C_on->nnz, 0.0);
+    C_off->n_rows = n_rows;
+    C_off->n_cols = C->off_proc_num_cols;
+    C_off->nnz = C_off->idx1[n_rows];
+    C_off->idx2.resize(C_off->nnz);
+    C_off->vals.assign(C_off->nnz, 0.0);
+
+    std::fill(pos.begin(), pos.end(), -1);
+    for (int i = 0; i < n_rows; i++)
+    {
+        cols.clear();
+        add_row_cols(A, i, i, cols);
+        std::sort(cols.begin(), cols.end());
+        on_ctr = C_on->idx1[i];
+        off_ctr = C_off->idx1[i];
+        for (std::vector<int>::iterator it = cols.begin(); it != cols.end(); ++it)
+        {
+            if (*it < n_on) C_on->idx2[on_ctr++] = *it;
+            else C_off->idx2[off_ctr++] = *it - n_on;
+        }
+    }
+
+    C->local_nnz = C_on->nnz + C_off->nnz;
+}
+
+/**************************************************************
+*****   ParSpGEMMPlan Scatter Row
+**************************************************************
+***** Sets the values of row 'row' of C to zero, and stores the
+***** position of each of its columns in pos
+**************************************************************/
+void ParSpGEMMPlan::scatter_row(ParCSRMatrix* C, int row)
+{
+    for (int j = C->on_proc->idx1[row]; j < C->on_proc->idx1[row+1]; j++)
+    {
+        pos[C->on_proc->idx2[j]] = j;
+        C->on_proc->vals[j] = 0.0;
+    }
+    for (int j = C->off_proc->idx1[row]; j < C->off_proc->idx1[row+1]; j++)
+    {
+        pos[n_on + C->off_proc->idx2[j]] = j;
+        C->off_proc->vals[j] = 0.0;
+    }
+}
+
+/**************************************************************
+*****   ParSpGEMMPlan Numeric
+**************************************************************
+***** Recomputes the values of C = A*B (or C = B^T*A for plans
+***** formed by symbolic_T).  Only values are communicated, and
+***** no storage is allocated.
+*****
+***** Parameters
+***** -------------
+***** A : ParCSRMatrix*
+*****    Matrix with the pattern of A in the symbolic phase
+***** B : ParCSRMatrix*
+*****    Matrix with the pattern of B (or P) in the symbolic phase
+***** C : ParCSRMatrix*
+*****    Matrix with the pattern returned by the symbolic phase,
+*****    whose values are overwritten
+**************************************************************/
+void ParSpGEMMPlan::numeric(ParCSRMatrix* A, ParCSRMatrix* B, ParCSRMatrix* C)
+{
+    int ctr, r, col;
+    double val;
+
+    if (transpose)
+    {
+        numeric_T(A, B, C);
+        return;
+    }
+
+    // Values of the rows of B, on_proc entries of each row first
+    ctr = 0;
+    for (int i = 0; i < B->local_num_rows; i++)
+    {
+        for (int j = B->on_proc->idx1[i]; j < B->on_proc->idx1[i+1]; j++)
+        {
+            B_vals[ctr++] = B->on_proc->vals[j];
+        }
+        for (int j = B->off_proc->idx1[i]; j < B->off_proc->idx1[i+1]; j++)
+        {
+            B_vals[ctr++] = B->off_proc->vals[j];
+        }
+    }
+    std::vector<double>& recv_vals = val_comm->communicate(B_vals);
+
+    std::vector<double>& C_on_vals = C->on_proc->vals;
+    std::vector<double>& C_off_vals = C->off_proc->vals;
+    for (int i = 0; i < C->local_num_rows; i++)
+    {
+        scatter_row(C, i);
+        for (int j = A->on_proc->idx1[i]; j < A->on_proc->idx1[i+1]; j++)
+        {
+            r = A->on_proc->idx2[j];
+            val = A->on_proc->vals[j];
+            for (int k = B_ptr[r]; k < B_ptr[r+1]; k++)
+            {
+                col = B_cols[k];
+                if (col < n_on) C_on_vals[pos[col]] += val * B_vals[k];
+                else C_off_vals[pos[col]] += val * B_vals[k];
+            }
+        }
+        for (int j = A->off_proc->idx1[i]; j < A->off_proc->idx1[i+1]; j++)
+        {
+            r = A->off_proc->idx2[j];
+            val = A->off_proc->vals[j];
+            for (int k = recv_ptr[r]; k < recv_ptr[r+1]; k++)
+            {
+                col = recv_cols[k];
+                if (col < n_on) C_on_vals[pos[col]] += val * recv_vals[k];
+                else C_off_vals[pos[col]] += val * recv_vals[k];
+            }
+        }
+    }
+}
+
+void ParSpGEMMPlan::numeric_T(ParCSRMatrix* A, ParCSRMatrix* P, ParCSRMatrix* C)
+{
+    int r, col;
+    double val;
+
+    // Values of P_off^T*A, with columns of A
+    for (int i = 0; i < P->off_proc_num_cols; i++)
+    {
+        for (int j = send_ptr[i]; j < send_ptr[i+1]; j++)
+        {
+            pos[send_cols[j]] = j;
+            send_vals[j] = 0.0;
+        }
+        for (int j = PT_off_ptr[i]; j < PT_off_ptr[i+1]; j++)
+        {
+            r = PT_off_rows[j];
+            val = P->off_proc->vals[PT_off_pos[j]];
+            for (int k = A->on_proc->idx1[r]; k < A->on_proc->idx1[r+1]; k++)
+            {
+                send_vals[pos[A->on_proc->idx2[k]]] += val * A->on_proc->vals[k];
+            }
+            for (int k = A->off_proc->idx1[r]; k < A->off_proc->idx1[r+1]; k++)
+            {
+                send_vals[pos[n_inner_on + A->off_proc->idx2[k]]] 
+                    += val * A->off_proc->vals[k];
+            }
+        }
+    }
+    std::vector<double>& recv_vals = val_comm->communicate(send_vals);
+
+    // Add P_on^T*A and received values to each row of C
+    std::vector<double>& C_on_vals = C->on_proc->vals;
+    std::vector<double>& C_off_vals = C->off_proc->vals;
+    for (int i = 0; i < C->local_num_rows; i++)
+    {
+        scatter_row(C, i);
+        for (int j = PT_on_ptr[i]; j < PT_on_ptr[i+1]; j++)
+        {
+            r = PT_on_rows[j];
+            val = P->on_proc->vals[PT_on_pos[j]];
+            for (int k = A->on_proc->idx1[r]; k < A->on_proc->idx1[r+1]; k++)
+            {
+                C_on_vals[pos[A->on_proc->idx2[k]]] += val * A->on_proc->vals[k];
+            }
+            for (int k = A->off_proc->idx1[r]; k < A->off_proc->idx1[r+1]; k++)
+            {
+                col = A_off_to_C[A->off_proc->idx2[k]];
+                C_off_vals[pos[col]] += val * A->off_proc->vals[k];
+            }
+        }
+        for (int j = recv_ptr[i]; j < recv_ptr[i+1]; j++)
+        {
+            col = recv_cols[j];
+            if (col < n_on) C_on_vals[pos[col]] += recv_vals[recv_idx[j]];
+            else C_off_vals[pos[col]] += recv_vals[recv_idx[j]];
+        }
+    }
+}
+
+/**************************************************************
+*****   Add RAP Row
+**************************************************************
+***** Adds sum_j w_j * (A*P)_{r_j} to a sparse accumulator, for
+***** fine rows r_j = rows[j] and weights w_j = P_vals[pos[j]].
+***** Rows of P are taken from P_ext, which holds local rows of P
+***** followed by the rows received for each off_proc column of
+***** A.  Columns first added to the accumulator (marked with
+***** 'mark' in marker) are appended to cols.
+**************************************************************/
+void add_rap_row(const ParCSRMatrix* A, const int* rows, const int* pos, int n,
+        const std::vector<double>& P_vals, const std::vector<int>& Pe_ptr,
+        const std::vector<int>& Pe_cols, const std::vector<double>& Pe_vals,
+        int mark, std::vector<int>& marker, std::vector<double>& sums,
+        std::vector<int>& cols)
+{
+    int r, row, col;
+    double weight, val;
+
+    for (int j = 0; j < n; j++)
+    {
+        r = rows[j];
+        weight = P_vals[pos[j]];
+        for (int k = A->on_proc->idx1[r]; k < A->on_proc->idx1[r+1]; k++)
+        {
+            row = A->on_proc->idx2[k];
+            val = weight * A->on_proc->vals[k];
+            for (int t = Pe_ptr[row]; t < Pe_ptr[row+1]; t++)
+            {
+                col = Pe_cols[t];
+                if (marker[col] != mark)
+                {
+                    marker[col] = mark;
+                    sums[col] = 0.0;
+                    cols.emplace_back(col);
+                }
+                sums[col] += val * Pe_vals[t];
+            }
+        }
+        for (int k = A->off_proc->idx1[r]; k < A->off_proc->idx1[r+1]; k++)
+        {
+            row = A->local_num_rows + A->off_proc->idx2[k];
+            val = weight * A->off_proc->vals[k];
+            for (int t = Pe_ptr[row]; t < Pe_ptr[row+1]; t++)
+            {
+                col = Pe_cols[t];
+                if (marker[col] != mark)
+                {
+                    marker[col] = mark;
+                    sums[col] = 0.0;
+                    cols.emplace_back(col);
+                }
+                sums[col] += val * Pe_vals[t];
+            }
+        }
+    }
+}
+
+/**************************************************************
+*****   ParCSRMatrix Galerkin Product
+**************************************************************
+***** Forms the coarse operator P^T*A*P row by row, without
+***** forming A*P.  Each row c of the product is
+***** sum_i P_ic * (A_i * P), so only a sparse accumulator for
+***** one row is held at a time.  Rows of P needed by off_proc
+***** columns of A are exchanged once.  Rows for off_proc
+***** columns of P are formed first and sent to their owners,
+***** and the local rows are formed while they are in transit.
+*****
+***** Parameters
+***** -------------
+***** P : ParCSRMatrix*
+*****    Interpolation, with rows matching those of A
+***** tap : bool
+*****    Use node-aware communication for both exchanges
+*****
+***** Returns
+***** -------------
+***** ParCSRMatrix* : P^T*A*P, distributed as the columns of P
+**************************************************************/
+ParCSRMatrix* ParCSRMatrix::rap(ParCSRMatrix* P, bool tap)
+{
+    int start, end, ctr, col;
+    index_t global_col;
+    double val;
+    std::vector<char> send_buffer;
+    std::vector<char> send_buffer_T;
+    std::vector<int> cols;
+
+    CommPkg* A_comm;
+    CommPkg* P_comm;
+    if (tap)
+    {
+        if (tap_mat_comm == NULL)
+        {
+            tap_mat_comm = new TAPComm(partition, off_proc_column_map,
+                    on_proc_column_map, false);
+        }
+        if (P->tap_mat_comm == NULL)
+        {
+            P->tap_mat_comm = new TAPComm(P->partition, P->off_proc_column_map,
+                    P->on_proc_column_map, false);
+        }
+        A_comm = tap_mat_comm;
+        P_comm = P->tap_mat_comm;
+    }
+    else
+    {
+        if (comm == NULL)
+        {
+            comm = new ParComm(partition, off_proc_column_map, on_proc_column_map);
+        }
+        if (P->comm == NULL)
+        {
+            P->comm = new ParComm(P->partition, P->off_proc_column_map,
+                    P->on_proc_column_map);
+        }
+        A_comm = comm;
+        P_comm = P->comm;
+    }
+
+    // Rows of P needed by off_proc columns of A
+    A_comm->init_par_mat_comm(P, send_buffer);
+
+    // Transposed patterns of P, formed while rows of P are in transit
+    std::vector<int> PT_on_ptr, PT_on_rows, PT_on_pos;
+    std::vector<int> PT_off_ptr, PT_off_rows, PT_off_pos;
+    transpose_pattern((CSRMatrix*) P->on_proc, P->on_proc_num_cols, PT_on_ptr,
+            PT_on_rows, PT_on_pos);
+    transpose_pattern((CSRMatrix*) P->off_proc, P->off_proc_num_cols, PT_off_ptr,
+            PT_off_rows, PT_off_pos);
+
+    CSRMatrix* recv_mat = A_comm->complete_mat_comm();
+
+    // Columns of P : [0, n_on) for on_proc columns, and n_on + j for
+    // ext_cols[j], the sorted off_proc columns of P and received rows
+    int n_on = P->on_proc_num_cols;
+    index_t first_col = P->partition->first_local_col;
+    index_t last_col = P->partition->last_local_col;
+    std::vector<index_t> ext_cols(P->off_proc_column_map);
+    for (int j = 0; j < recv_mat->idx1[recv_mat->n_rows]; j++)
+    {
+        global_col = recv_mat->global_idx2[j];
+        if (global_col < first_col || global_col > last_col)
+        {
+            ext_cols.emplace_back(global_col);
+        }
+    }
+    std::sort(ext_cols.begin(), ext_cols.end());
+    ext_cols.erase(std::unique(ext_cols.begin(), ext_cols.end()), ext_cols.end());
+    int n_ext = n_on + ext_cols.size();
+
+    // Local rows of P, followed by received rows
+    std::vector<int> P_to_ext(P->off_proc_num_cols);
+    for (int i = 0; i < P->off_proc_num_cols; i++)
+    {
+        P_to_ext[i] = n_on + (std::lower_bound(ext_cols.begin(), ext_cols.end(),
+                    P->off_proc_column_map[i]) - ext_cols.begin());
+    }
+    int n_ext_rows = local_num_rows + recv_mat->n_rows;
+    int ext_nnz = P->on_proc->nnz + P->off_proc->nnz 
+        + recv_mat->idx1[recv_mat->n_rows];
+    std::vector<int> Pe_ptr(n_ext_rows + 1);
+    std::vector<int> Pe_cols(ext_nnz);
+    std::vector<double> Pe_vals(ext_nnz);
+    ctr = 0;
+    Pe_ptr[0] = 0;
+    for (int i = 0; i < local_num_rows; i++)
+    {
+        for (int j = P->on_proc->idx1[i]; j < P->on_proc->idx1[i+1]; j++)
+        {
+            Pe_cols[ctr] = P->on_proc->idx2[j];
+            Pe_vals[ctr++] = P->on_proc->vals[j];
+        }
+        for (int j = P->off_proc->idx1[i]; j < P->off_proc->idx1[i+1]; j++)
+        {
+            Pe_cols[ctr] = P_to_ext[P->off_proc->idx2[j]];
+            Pe_vals[ctr++] = P->off_proc->vals[j];
+        }
+        Pe_ptr[i+1] = ctr;
+    }
+    int* part_to_col = P->map_partition_to_local();
+    for (int i = 0; i < recv_mat->n_rows; i++)
+    {
+        for (int j = recv_mat->idx1[i]; j < recv_mat->idx1[i+1]; j++)
+        {
+            global_col = recv_mat->global_idx2[j];
+            if (global_col < first_col || global_col > last_col)
+            {
+                Pe_cols[ctr] = n_on + (std::lower_bound(ext_cols.begin(),
+                            ext_cols.end(), global_col) - ext_cols.begin());
+            }
+            else
+            {
+                Pe_cols[ctr] = part_to_col[global_col - first_col];
+            }
+            Pe_vals[ctr++] = recv_mat->vals[j];
+        }
+        Pe_ptr[local_num_rows + i + 1] = ctr;
+    }
+    delete recv_mat;
+
+    std::vector<int> marker(n_ext, -1);
+    std::vector<double> sums(n_ext);
+
+    // Rows for off_proc columns of P, sent to their owners
+    std::vector<int> send_ptr(P->off_proc_num_cols + 1);
+    std::vector<index_t> send_cols;
+    std::vector<double> send_vals;
+    send_ptr[0] = 0;
+    for (int i = 0; i < P->off_proc_num_cols; i++)
+    {
+        cols.clear();
+        start = PT_off_ptr[i];
+        end = PT_off_ptr[i+1];
+        add_rap_row(this, &(PT_off_rows[start]), &(PT_off_pos[start]), end - start,
+                P->off_proc->vals, Pe_ptr, Pe_cols, Pe_vals, i, marker, sums, cols);
+        for (std::vector<int>::iterator it = cols.begin(); it != cols.end(); ++it)
+        {
+            if (*it < n_on) global_col = P->on_proc_column_map[*it];
+            else global_col = ext_cols[*it - n_on];
+            send_cols.emplace_back(global_col);
+            send_vals.emplace_back(sums[*it]);
+        }
+        send_ptr[i+1] = send_cols.size();
+    }
+    P_comm->init_mat_comm_T(send_buffer_T, send_ptr, send_cols, send_vals);
+
+    // Local rows, formed while the rows above are in transit
+    std::fill(marker.begin(), marker.end(), -1);
+    std::vector<int> loc_ptr(P->on_proc_num_cols + 1);
+    std::vector<int> loc_cols;
+    std::vector<double> loc_vals;
+    loc_ptr[0] = 0;
+    for (int i = 0; i < P->on_proc_num_cols; i++)
+    {
+        cols.clear();
+        start = PT_on_ptr[i];
+        end = PT_on_ptr[i+1];
+        add_rap_row(this, &(PT_on_rows[start]), &(PT_on_pos[start]), end - start,
+                P->on_proc->vals, Pe_ptr, Pe_cols, Pe_vals, i, marker, sums, cols);
+        for (std::vector<int>::iterator it = cols.begin(); it != cols.end(); ++it)
+        {
+            loc_cols.emplace_back(*it);
+            loc_vals.emplace_back(sums[*it]);
+        }
+        loc_ptr[i+1] = loc_cols.size();
+    }
+
+    CSRMatrix* recv_T = P_comm->complete_mat_comm_T(P->on_proc_num_cols);
+    int recv_nnz = recv_T->idx1[recv_T->n_rows];
+
+    // Initialize C (matrix to be returned), distributed as P
+    ParCSRMatrix* C = new ParCSRMatrix(P->partition);
+    C->global_num_rows = P->global_num_cols;
+    C->global_num_cols = P->global_num_cols;
+    C->local_num_rows = P->on_proc_num_cols;
+    C->on_proc_column_map = P->get_on_proc_column_map();
+    C->local_row_map = P->get_on_proc_column_map();
+    C->on_proc_num_cols = C->on_proc_column_map.size();
+
+    // Off_proc columns of local rows and received rows
+    std::vector<index_t> all_cols(ext_cols);
+    for (int j = 0; j < recv_nnz; j++)
+    {
+        global_col = recv_T->global_idx2[j];
+        if (global_col < first_col || global_col > last_col)
+        {
+            all_cols.emplace_back(global_col);
+        }
+    }
+    std::sort(all_cols.begin(), all_cols.end());
+    all_cols.erase(std::unique(all_cols.begin(), all_cols.end()), all_cols.end());
+    int n_all = n_on + all_cols.size();
+
+    std::vector<int> ext_to_all(n_ext);
+    for (int i = 0; i < n_on; i++)
+    {
+        ext_to_all[i] = i;
+    }
+    for (int i = n_on; i < n_ext; i++)
+    {
+        ext_to_all[i] = n_on + (std::lower_bound(all_cols.begin(), all_cols.end(),
+                    ext_cols[i - n_on]) - all_cols.begin());
+    }
+    recv_T->idx2.resize(recv_nnz);
+    for (int j = 0; j < recv_nnz; j++)
+    {
+        global_col = recv_T->global_idx2[j];
+        if (global_col < first_col || global_col > last_col)
+        {
+            recv_T->idx2[j] = n_on + (std::lower_bound(all_cols.begin(),
+                        all_cols.end(), global_col) - all_cols.begin());
+        }
+        else
+        {
+            recv_T->idx2[j] = part_to_col[global_col - first_col];
+        }
+    }
+    delete[] part_to_col;
+
+    // Add received rows to local rows, splitting into on_proc and off_proc
+    CSRMatrix* C_on = (CSRMatrix*) C->on_proc;
+    CSRMatrix* C_off = (CSRMatrix*) C->off_proc;
+    C_on->idx1.resize(C->local_num_rows + 1);
+    C_off->idx1.resize(C->local_num_rows + 1);
+    C_on->idx2.clear();
+    C_on->vals.clear();
+    C_off->idx2.clear();
+    C_off->vals.clear();
+    C_on->idx2.reserve(loc_cols.size() + recv_nnz);
+    C_on->vals.reserve(loc_cols.size() + recv_nnz);
+    C_on->idx1[0] = 0;
+    C_off->idx1[0] = 0;
+    marker.assign(n_all, -1);
+    sums.resize(n_all);
+    std::vector<int> used(n_all - n_on, 0);
+    for (int i = 0; i < C->local_num_rows; i++)
+    {
+        cols.clear();
+        for (int j = loc_ptr[i]; j < loc_ptr[i+1]; j++)
+        {
+            col = ext_to_all[loc_cols[j]];
+            marker[col] = i;
+            sums[col] = loc_vals[j];
+            cols.emplace_back(col);
+        }
+        for (int j = recv_T->idx1[i]; j < recv_T->idx1[i+1]; j++)
+        {
+            col = recv_T->idx2[j];
+            if (marker[col] != i)
+            {
+                marker[col] = i;
+                sums[col] = 0.0;
+                cols.emplace_back(col);
+            }
+            sums[col] += recv_T->vals[j];
+        }
+        for (std::vector<int>::iterator it = cols.begin(); it != cols.end(); ++it)
+        {
+            val = sums[*it];
+            if (fabs(val) <= zero_tol) continue;
+            if (*it < n_on)
+            {
+                C_on->idx2.emplace_back(*it);
+                C_on->vals.emplace_back(val);
+            }
+            else
+            {
+                used[*it - n_on] = 1;
+                C_off->idx2.emplace_back(*it - n_on);
+                C_off->vals.emplace_back(val);
+            }
+        }
+        C_on->idx1[i+1] = C_on->idx2.size();
+        C_off->idx1[i+1] = C_off->idx2.size();
+    }
+    delete recv_T;
+
+    // Condense off_proc columns to those holding nonzeros
+    C->off_proc_column_map.clear();
+    for (int i = 0; i < n_all - n_on; i++)
+    {
+        if (used[i])
+        {
+            used[i] = C->off_proc_column_map.size();
+            C->off_proc_column_map.emplace_back(all_cols[i]);
+        }
+        else
+        {
+            used[i] = -1;
+        }
+    }
+    for (std::vector<int>::iterator it = C_off->idx2.begin(); 
+            it != C_off->idx2.end(); ++it)
+    {
+        *it = used[*it];
+    }
+    C->off_proc_num_cols = C->off_proc_column_map.size();
+
+    C_on->n_rows = C->local_num_rows;
+    C_on->n_cols = C->on_proc_num_cols;
+    C_on->nnz = C_on->idx2.size();
+    C_off->n_rows = C->local_num_rows;
+    C_off->n_cols = C->off_proc_num_cols;
+    C_off->nnz = C_off->idx2.size();
+    C->local_nnz = C_on->nnz + C_off->nnz;
+
+    return C;
+}
@@ -0,0 +1,457 @@
+// Copyright (c) 2015-2017, RAPtor Developer Team
+// License: Simplified BSD, http://opensource.org/licenses/BSD-2-Clause
+#include "par_partitioner.hpp"
+
+// Number of nonzeros in each local row of A
+void row_nnz(ParCSRMatrix* A, std::vector<double>& weights)
+{
+    weights.resize(A->local_num_rows);
+    for (int i = 0; i < A->local_num_rows; i++)
+    {
+        weights[i] = (A->on_proc->idx1[i+1] - A->on_proc->idx1[i])
+            + (A->off_proc->idx1[i+1] - A->off_proc->idx1[i]);
+    }
+}
+
+int* nnz_balanced_partition(ParCSRMatrix* A)
+{
+    int rank, num_procs;
+    RAPtor_MPI_Comm_rank(RAPtor_MPI_COMM_WORLD, &rank);
+    RAPtor_MPI_Comm_size(RAPtor_MPI_COMM_WORLD, &num_procs);
+
+    int* partition = new int[A->local_num_rows];
+    std::vector<double> weights;
+    row_nnz(A, weights);
+
+    // Nonzeros in the rows held by earlier processes
+    double local_nnz = A->local_nnz;
+    std::vector<double> proc_nnz(num_procs);
+    RAPtor_MPI_Allgather(&local_nnz, 1, RAPtor_MPI_DOUBLE, proc_nnz.data(), 1,
+            RAPtor_MPI_DOUBLE, RAPtor_MPI_COMM_WORLD);
+    double first_nnz = 0;
+    double total_nnz = 0;
+    for (int i = 0; i < num_procs; i++)
+    {
+        if (i < rank) first_nnz += proc_nnz[i];
+        total_nnz += proc_nnz[i];
+    }
+
+    // Each row goes to the chunk holding its middle nonzero
+    int part;
+    double pos = first_nnz;
+    for (int i = 0; i < A->local_num_rows; i++)
+    {
+        part = (pos + 0.5 * weights[i]) * num_procs / total_nnz;
+        if (part >= num_procs) part = num_procs - 1;
+        partition[i] = part;
+        pos += weights[i];
+    }
+
+    return partition;
+}
+
+int* rcb_partition(ParCSRMatrix* A, int dim, double* coords)
+{
+    int rank, num_procs;
+    RAPtor_MPI_Comm_rank(RAPtor_MPI_COMM_WORLD, &rank);
+    RAPtor_MPI_Comm_size(RAPtor_MPI_COMM_WORLD, &num_procs);
+
+    int n = A->local_num_rows;
+    int r, d, split_d;
+    double coord, target;
+    std::vector<double> weights;
+    row_nnz(A, weights);
+
+    // Every row belongs to a range [lo, hi) of parts, halved at each
+    // level.  The ranges are the same on all processes, so only their
+    // bounding boxes and weights are reduced.
+    std::vector<int> lo(n, 0);
+    std::vector<int> hi(n, num_procs);
+    std::vector<int> range_lo(1, 0);
+    std::vector<int> range_hi(1, num_procs);
+    std::vector<int> part_to_range(num_procs);
+    std::vector<double> box_min, box_max;
+    std::vector<double> range_w, target_w;
+    std::vector<double> cut_lo, cut_hi, cut;
+    std::vector<double> w_lo, w_hi, w_cut;
+    std::vector<int> dims;
+
+    while (range_lo.size())
+    {
+        int n_ranges = range_lo.size();
+        std::fill(part_to_range.begin(), part_to_range.end(), -1);
+        for (r = 0; r < n_ranges; r++)
+        {
+            part_to_range[range_lo[r]] = r;
+        }
+
+        // Bounding box and weight of each range
+        box_min.assign(n_ranges * dim, DBL_MAX);
+        box_max.assign(n_ranges * dim, -DBL_MAX);
+        range_w.assign(n_ranges, 0.0);
+        for (int i = 0; i < n; i++)
+        {
+            if (hi[i] - lo[i] < 2) continue;
+            r = part_to_range[lo[i]];
+            range_w[r] += weights[i];
+            for (d = 0; d < dim; d++)
+            {
+                coord = coords[i*dim + d];
+                if (coord < box_min[r*dim + d]) box_min[r*dim + d] = coord;
+                if (coord > box_max[r*dim + d]) box_max[r*dim + d] = coord;
+            }
+        }
+        RAPtor_MPI_Allreduce(RAPtor_MPI_IN_PLACE, box_min.data(), n_ranges * dim,
+                RAPtor_MPI_DOUBLE, RAPtor_MPI_MIN, RAPtor_MPI_COMM_WORLD);
+        RAPtor_MPI_Allreduce(RAPtor_MPI_IN_PLACE, box_max.data(), n_ranges * dim,
+                RAPtor_MPI_DOUBLE, RAPtor_MPI_MAX, RAPtor_MPI_COMM_WORLD);
+        RAPtor_MPI_Allreduce(RAPtor_MPI_IN_PLACE, range_w.data(), n_ranges,
+                RAPtor_MPI_DOUBLE, RAPtor_MPI_SUM, RAPtor_MPI_COMM_WORLD);
+
+        // Cut each range along its longest side, so that the lower half
+        // of its parts receives its share of the weight
+        dims.resize(n_ranges);
+        target_w.resize(n_ranges);
+        cut_lo.resize(n_ranges);
+        cut_hi.resize(n_ranges);
+        w_lo.assign(n_ranges, 0.0);
+        w_hi.resize(n_ranges);
+        for (r = 0; r < n_ranges; r++)
+        {
+            split_d = 0;
+            for (d = 1; d < dim; d++)
+            {
+                if (box_max[r*dim + d] - box_min[r*dim + d] >
+                        box_max[r*dim + split_d] - box_min[r*dim + split_d])
+                {
+                    split_d = d;
+                }
+            }
+            dims[r] = split_d;
+            int mid = (range_lo[r] + range_hi[r]) / 2;
+            target_w[r] = range_w[r] * (mid - range_lo[r]) / (range_hi[r] - range_lo[r]);
+            cut_lo[r] = box_min[r*dim + split_d];
+            cut_hi[r] = box_max[r*dim + split_d];
+            w_hi[r] = range_w[r];
+        }
+
+        // Bisection on the cut, where rows with coordinate below the
+        // cut go to the lower half (w_lo, w_hi are the weights below
+        // cut_lo and cut_hi)
+        cut.resize(n_ranges);
+        for (int iter = 0; iter < 50; iter++)
+        {
+            for (r = 0; r < n_ranges; r++)
+            {
+                cut[r] = 0.5 * (cut_lo[r] + cut_hi[r]);
+            }
+            w_cut.assign(n_ranges, 0.0);
+            for (int i = 0; i < n; i++)
+            {
+                if (hi[i] - lo[i] < 2) continue;
+                r = part_to_range[lo[i]];
+                if (coords[i*dim + dims[r]] < cut[r])
+                {
+                    w_cut[r] += weights[i];
+                }
+            }
+            RAPtor_MPI_Allreduce(RAPtor_MPI_IN_PLACE, w_cut.data(), n_ranges,
+                    RAPtor_MPI_DOUBLE, RAPtor_MPI_SUM, RAPtor_MPI_COMM_WORLD);
+            for (r = 0; r < n_ranges; r++)
+            {
+                if (w_cut[r] < target_w[r])
+                {
+                    cut_lo[r] = cut[r];
+                    w_lo[r] = w_cut[r];
+                }
+                else
+                {
+                    cut_hi[r] = cut[r];
+                    w_hi[r] = w_cut[r];
+                }
+            }
+        }
+
+        // Keep whichever final cut is closer to the target weight
+        for (r = 0; r < n_ranges; r++)
+        {
+            target = target_w[r];
+            cut[r] = (target - w_lo[r] < w_hi[r] - target) ? cut_lo[r] : cut_hi[r];
+        }
+        for (int i = 0; i < n; i++)
+        {
+            if (hi[i] - lo[i] < 2) continue;
+            r = part_to_range[lo[i]];
+            int mid = (lo[i] + hi[i]) / 2;
+            if (coords[i*dim + dims[r]] < cut[r])
+            {
+                hi[i] = mid;
+            }
+            else
+            {
+                lo[i] = mid;
+            }
+        }
+
+        // Ranges of more than one part are split again
+        std::vector<int> next_lo, next_hi;
+        for (r = 0; r < n_ranges; r++)
+        {
+            int mid = (range_lo[r] + range_hi[r]) / 2;
+            if (mid - range_lo[r] > 1)
+            {
+                next_lo.emplace_back(range_lo[r]);
+                next_hi.emplace_back(mid);
+            }
+            if (range_hi[r] - mid > 1)
+            {
+                next_lo.emplace_back(mid);
+                next_hi.emplace_back(range_hi[r]);
+            }
+        }
+        range_lo.swap(next_lo);
+        range_hi.swap(next_hi);
+    }
+
+    int* partition = new int[n];
+    for (int i = 0; i < n; i++)
+    {
+        partition[i] = lo[i];
+    }
+
+    return partition;
+}
+
+// Sums each process's weight change (dw) to the parts in parts on their
+// owners (part p is owned by process p), and returns each part's weight
+// and the number of processes that sent to it.  Messages go only to the
+// owners of parts in parts and back, never to all processes.
+void exchange_part_weights(const std::vector<int>& parts, std::vector<double>& dw,
+        double& own_w, std::vector<double>& part_w, std::vector<int>& part_n)
+{
+    int n_parts = parts.size();
+    int key = 7654;
+    std::vector<RAPtor_MPI_Request> send_requests(n_parts);
+    std::vector<double> recv_dw;
+    NonContigData recv_data;
+
+    // Changes go to the owners of the parts, which count their senders
+    for (int k = 0; k < n_parts; k++)
+    {
+        RAPtor_MPI_Issend(&(dw[k]), 1, RAPtor_MPI_DOUBLE, parts[k], key,
+                RAPtor_MPI_COMM_WORLD, &(send_requests[k]));
+    }
+    recv_data.nbx_recv(key, RAPtor_MPI_COMM_WORLD, n_parts, send_requests.data(),
+            recv_dw, RAPtor_MPI_DOUBLE);
+    for (int i = 0; i < recv_data.num_msgs; i++)
+    {
+        own_w += recv_dw[i];
+    }
+
+    // Owners return the weight and sender count of their part
+    key++;
+    double own_msg[2] = {own_w, (double) recv_data.num_msgs};
+    std::vector<RAPtor_MPI_Request> reply_requests(recv_data.num_msgs);
+    for (int i = 0; i < recv_data.num_msgs; i++)
+    {
+        RAPtor_MPI_Isend(own_msg, 2, RAPtor_MPI_DOUBLE, recv_data.procs[i], key,
+                RAPtor_MPI_COMM_WORLD, &(reply_requests[i]));
+    }
+    double msg[2];
+    part_w.resize(n_parts);
+    part_n.resize(n_parts);
+    for (int k = 0; k < n_parts; k++)
+    {
+        RAPtor_MPI_Recv(msg, 2, RAPtor_MPI_DOUBLE, parts[k], key,
+                RAPtor_MPI_COMM_WORLD, RAPtor_MPI_STATUS_IGNORE);
+        part_w[k] = msg[0];
+        part_n[k] = msg[1];
+    }
+    RAPtor_MPI_Waitall(reply_requests.size(), reply_requests.data(),
+            RAPtor_MPI_STATUSES_IGNORE);
+}
+
+void label_propagation_refine(ParCSRMatrix* A, int* partition, int n_iter,
+        double imbalance)
+{
+    int rank, num_procs;
+    RAPtor_MPI_Comm_rank(RAPtor_MPI_COMM_WORLD, &rank);
+    RAPtor_MPI_Comm_size(RAPtor_MPI_COMM_WORLD, &num_procs);
+
+    int start, end, col;
+    int k, best_k, best_count;
+    int num_moved, prev_moved = -1;
+    double own_w = 0;
+    std::vector<double> weights;
+    std::vector<int> off_parts(A->off_proc_num_cols);
+
+    // Parts are held only for the local rows and their neighbors: parts
+    // lists them, and row_k / off_k give the position of each row's part
+    IntMap<int> part_to_k;
+    std::vector<int> parts, prev_parts;
+    std::vector<int> row_k(A->local_num_rows);
+    std::vector<int> off_k(A->off_proc_num_cols);
+    std::vector<double> dw, prev_dw;
+    std::vector<double> part_w, allowance;
+    std::vector<int> part_n;
+    std::vector<int> counts;
+    std::vector<int> nbr_k;
+
+    row_nnz(A, weights);
+    double local_w = 0;
+    for (int i = 0; i < A->local_num_rows; i++)
+    {
+        local_w += weights[i];
+    }
+    double total_w;
+    RAPtor_MPI_Allreduce(&local_w, &total_w, 1, RAPtor_MPI_DOUBLE, RAPtor_MPI_SUM,
+            RAPtor_MPI_COMM_WORLD);
+    double max_w = imbalance * total_w / num_procs;
+
+    // The first exchange adds the weight of the local rows to each part
+    for (int i = 0; i < A->local_num_rows; i++)
+    {
+        k = part_to_k.insert(partition[i], prev_parts.size());
+        if (k == (int) prev_parts.size())
+        {
+            prev_parts.emplace_back(partition[i]);
+            prev_dw.emplace_back(0.0);
+        }
+        prev_dw[k] += weights[i];
+    }
+
+    for (int iter = 0; iter < n_iter; iter++)
+    {
+        std::vector<int>& recvbuf = A->comm->communicate(partition);
+        std::copy(recvbuf.begin(), recvbuf.begin() + A->off_proc_num_cols,
+                off_parts.begin());
+
+        // Parts of local rows and neighbors (the only parts rows can
+        // move to), and parts changed by the previous iteration
+        part_to_k.clear();
+        parts.clear();
+        dw.clear();
+        for (int i = 0; i < (int) prev_parts.size(); i++)
+        {
+            if (prev_dw[i] == 0.0) continue;
+            part_to_k.insert(prev_parts[i], parts.size());
+            parts.emplace_back(prev_parts[i]);
+            dw.emplace_back(prev_dw[i]);
+        }
+        for (int i = 0; i < A->local_num_rows; i++)
+        {
+            k = part_to_k.insert(partition[i], parts.size());
+            if (k == (int) parts.size())
+            {
+                parts.emplace_back(partition[i]);
+                dw.emplace_back(0.0);
+            }
+            row_k[i] = k;
+        }
+        for (int i = 0; i < A->off_proc_num_cols; i++)
+        {
+            k = part_to_k.insert(off_parts[i], parts.size());
+            if (k == (int) parts.size())
+            {
+                parts.emplace_back(off_parts[i]);
+                dw.emplace_back(0.0);
+            }
+            off_k[i] = k;
+        }
+        exchange_part_weights(parts, dw, own_w, part_w, part_n);
+
+        // Rows move only to higher parts on even iterations and lower
+        // parts on odd ones, so neighbors do not swap back and forth.
+        // Each process may add at most its share of a part's room,
+        // split among the processes that hold the part.
+        int n_parts = parts.size();
+        allowance.resize(n_parts);
+        for (k = 0; k < n_parts; k++)
+        {
+            allowance[k] = (max_w - part_w[k]) / part_n[k];
+        }
+        std::fill(dw.begin(), dw.end(), 0.0);
+        counts.assign(n_parts, 0);
+
+        num_moved = 0;
+        for (int i = 0; i < A->local_num_rows; i++)
+        {
+            k = row_k[i];
+
+            // Count the parts of the neighbors of row i
+            start = A->on_proc->idx1[i];
+            end = A->on_proc->idx1[i+1];
+            for (int j = start; j < end; j++)
+            {
+                col = A->on_proc->idx2[j];
+                if (col == i) continue;
+                if (counts[row_k[col]]++ == 0)
+                {
+                    nbr_k.emplace_back(row_k[col]);
+                }
+            }
+            start = A->off_proc->idx1[i];
+            end = A->off_proc->idx1[i+1];
+            for (int j = start; j < end; j++)
+            {
+                col = A->off_proc->idx2[j];
+                if (counts[off_k[col]]++ == 0)
+                {
+                    nbr_k.emplace_back(off_k[col]);
+                }
+            }
+
+            best_k = k;
+            best_count = counts[k];
+            for (std::vector<int>::iterator it = nbr_k.begin();
+                    it != nbr_k.end(); ++it)
+            {
+                if (counts[*it] > best_count
+                        && (iter % 2 == 0 ? parts[*it] > parts[k] : parts[*it] < parts[k])
+                        && dw[*it] + weights[i] <= allowance[*it])
+                {
+                    best_k = *it;
+                    best_count = counts[*it];
+                }
+                counts[*it] = 0;
+            }
+            nbr_k.clear();
+
+            if (best_k != k)
+            {
+                dw[best_k] += weights[i];
+                dw[k] -= weights[i];
+                partition[i] = parts[best_k];
+                row_k[i] = best_k;
+                num_moved++;
+            }
+        }
+        prev_parts.swap(parts);
+        prev_dw.swap(dw);
+
+        RAPtor_MPI_Allreduce(RAPtor_MPI_IN_PLACE, &num_moved, 1, RAPtor_MPI_INT,
+                RAPtor_MPI_SUM, RAPtor_MPI_COMM_WORLD);
+        if (num_moved == 0 && prev_moved == 0) break;
+        prev_moved = num_moved;
+    }
+}
+
+ParCSRMatrix* rebalance_matrix(ParCSRMatrix* A, std::vector<int>& new_local_rows,
+        int dim, double* coords)
+{
+    int* partition;
+    if (dim)
+    {
+        partition = rcb_partition(A, dim, coords);
+    }
+    else
+    {
+        partition = nnz_balanced_partition(A);
+    }
+    label_propagation_refine(A, partition);
+
+    ParCSRMatrix* A_part = repartition_matrix(A, partition, new_local_rows);
+    delete[] partition;
+
+    return A_part;
+}
@@ -0,0 +1,50 @@
+// Copyright (c) 2015-2017, RAPtor Developer Team
+// License: Simplified BSD, http://opensource.org/licenses/BSD-2-Clause
+//
+#ifndef RAPTOR_UTIL_PAR_PARTITIONER_HPP
+#define RAPTOR_UTIL_PAR_PARTITIONER_HPP
+
+#include "core/types.hpp"
+#include "core/mpi_types.hpp"
+#include "core/par_matrix.hpp"
+#include <cfloat>
+#include "repartition.hpp"
+
+using namespace raptor;
+
+/**************************************************************
+ *****   Native Partitioners
+ **************************************************************
+ ***** Distributed partitioners that need no external library.
+ ***** Each returns (or refines) an array of local_num_rows
+ ***** process ids, in the form taken by repartition_matrix
+ ***** (and returned by parmetis_partition / ptscotch_partition).
+ ***** Rows are weighted by their number of nonzeros.
+ *****
+ ***** nnz_balanced_partition(A)
+ *****    Splits the global row order into num_procs contiguous
+ *****    chunks of (nearly) equal nnz
+ ***** rcb_partition(A, dim, coords)
+ *****    Recursive coordinate bisection of the rows, where row i
+ *****    is at coords[i*dim : (i+1)*dim]
+ ***** label_propagation_refine(A, partition, n_iter, imbalance)
+ *****    Reduces the edge cut of a balanced partition by moving
+ *****    rows to the part most of their neighbors belong to,
+ *****    keeping every part below imbalance * average nnz.
+ *****    Runs at most n_iter sweeps, each communicating the
+ *****    partition to neighbors and part weights with the owners
+ *****    of neighboring parts (no num_procs-sized exchange)
+ ***** rebalance_matrix(A, new_local_rows, dim, coords)
+ *****    Pre-solve step: partitions A (by RCB if coordinates are
+ *****    given, otherwise by nnz), refines the partition with
+ *****    label propagation, and returns the repartitioned matrix
+ **************************************************************/
+int* nnz_balanced_partition(ParCSRMatrix* A);
+int* rcb_partition(ParCSRMatrix* A, int dim, double* coords);
+void label_propagation_refine(ParCSRMatrix* A, int* partition, int n_iter = 10,
+        double imbalance = 1.05);
+ParCSRMatrix* rebalance_matrix(ParCSRMatrix* A, std::vector<int>& new_local_rows,
+        int dim = 0, double* coords = NULL);
+
+#endif
+
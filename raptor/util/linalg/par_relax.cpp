@@ -2,20 +2,24 @@
 // License: Simplified BSD, http://opensource.org/licenses/BSD-2-Clause
 
 #include "core/types.hpp"
+#include "core/utilities.hpp"
 #include "util/linalg/par_relax.hpp"
 #include "core/par_matrix.hpp"
 
 // Declare Private Methods
 void SOR_forward(ParCSRMatrix* A, ParVector& x, const ParVector& y, 
-        const std::vector<double>& dist_x, double omega);
+        const ParVector& x_prev, const double* dist_x, double omega,
+        int first_row, int last_row, const int* rows, int n_rows);
 void SOR_backward(ParCSRMatrix* A, ParVector& x, const ParVector& y,
-        const std::vector<double>& dist_x, double omega);
-void jacobi_helper(ParCSRMatrix* A, ParVector& x, ParVector& b, ParVector& tmp, 
-        int num_sweeps, double omega, CommPkg* comm);
-void sor_helper(ParCSRMatrix* A, ParVector& x, ParVector& b, ParVector& tmp, 
-        int num_sweeps, double omega, CommPkg* comm);
-void ssor_helper(ParCSRMatrix* A, ParVector& x, ParVector& b, ParVector& tmp, 
-        int num_sweeps, double omega, CommPkg* comm);
+        const ParVector& x_prev, const double* dist_x, double omega,
+        int first_row, int last_row, const int* rows, int n_rows);
+void SOR_forward(ParCSRMatrix* A, ParMultiVector& x, const ParMultiVector& y, 
+        const ParMultiVector& x_prev, const double* dist_x, double omega, 
+        int first_row, int last_row, const int* rows, int n_rows);
+void SOR_backward(ParCSRMatrix* A, ParMultiVector& x, const ParMultiVector& y,
+        const ParMultiVector& x_prev, const double* dist_x, double omega, 
+        int first_row, int last_row, const int* rows, int n_rows);
+CommPkg* relax_comm(ParCSRMatrix* A, bool tap);
 
 
 
@@ -27,6 +31,12 @@ void ssor_helper(ParCSRMatrix* A, ParVector& x, ParVector& b, ParVector& tmp,
  ***** The tmp array is used as a place-holder, but the result
  ***** is returned put in the x-vector. 
  *****
+ ***** Only the listed rows, all within [first_row, last_row), 
+ ***** are relaxed.  On_proc columns within this range use the 
+ ***** current values of x (Gauss-Seidel) while all other 
+ ***** on_proc columns use x_prev (Jacobi), so that threads can
+ ***** each relax a block of rows.
+ *****
  ***** Parameters
  ***** -------------
  ***** A : Matrix*
@@ -35,65 +45,80 @@ void ssor_helper(ParCSRMatrix* A, ParVector& x, ParVector& b, ParVector& tmp,
  *****    Vector to be relaxed, will contain result
  ***** y : data_t*
  *****    Right hand side vector
- ***** tmp: data_t*
- *****    Vector needed for inner steps
+ ***** x_prev : data_t*
+ *****    Values of x at start of sweep (may alias x when a 
+ *****    single block covers all rows)
  ***** dist_x : data_t*
  *****    Vector of distant x-values recvd from other processes
+ *****    (NULL when only interior rows are relaxed)
+ ***** first_row : int
+ *****    First row of the block
+ ***** last_row : int
+ *****    One past the last row of the block
+ ***** rows : int*
+ *****    Rows to be relaxed, in increasing order
+ ***** n_rows : int
+ *****    Number of rows to be relaxed
  **************************************************************/
 void SOR_forward(ParCSRMatrix* A, ParVector& x, const ParVector& y, 
-        const std::vector<double>& dist_x, double omega)
+        const ParVector& x_prev, const double* dist_x, double omega,
+        int first_row, int last_row, const int* rows, int n_rows)
 {
-    int start_on, end_on;
-    int start_off, end_off;
-    int col;
+    int start, end;
+    int row, col;
     double diag;
     double row_sum;
 
-    start_on = 0;
-    start_off = 0;
-    for (int i = 0; i < A->local_num_rows; i++)
+    for (int i = 0; i < n_rows; i++)
     {
+        row = rows[i];
         row_sum = 0;
-        end_on = A->on_proc->idx1[i+1];
-        if (A->on_proc->idx2[start_on] == i)
+        start = A->on_proc->idx1[row];
+        end = A->on_proc->idx1[row+1];
+        if (start < end && A->on_proc->idx2[start] == row)
         {
-            diag = A->on_proc->vals[start_on];
-            start_on++;
+            diag = A->on_proc->vals[start];
+            start++;
         }        
         else continue;
-        for (int j = start_on; j < end_on; j++)
+        for (int j = start; j < end; j++)
         {
             col = A->on_proc->idx2[j];
-            row_sum += A->on_proc->vals[j] * x[col];
+            if (col >= first_row && col < last_row)
+                row_sum += A->on_proc->vals[j] * x[col];
+            else
+                row_sum += A->on_proc->vals[j] * x_prev[col];
         }
-        start_on = end_on;
 
-        end_off = A->off_proc->idx1[i+1];
-        for (int j = start_off; j < end_off; j++)
+        start = A->off_proc->idx1[row];
+        end = A->off_proc->idx1[row+1];
+        for (int j = start; j < end; j++)
         {
             col = A->off_proc->idx2[j];
             row_sum += A->off_proc->vals[j] * dist_x[col];
         }
-        start_off = end_off;
 
-//        x[i] = ((1.0 - omega)*x[i]) + (omega*((y[i] - row_sum) / diag));
-        x[i] = (x[i] + omega * (y[i] - x[i] - row_sum)) / diag;
+//        x[row] = ((1.0 - omega)*x[row]) + (omega*((y[row] - row_sum) / diag));
+        x[row] = (x[row] + omega * (y[row] - x[row] - row_sum)) / diag;
     }
 }
 
 void SOR_backward(ParCSRMatrix* A, ParVector& x, const ParVector& y,
-        const std::vector<double>& dist_x, double omega)
+        const ParVector& x_prev, const double* dist_x, double omega,
+        int first_row, int last_row, const int* rows, int n_rows)
 {
-    int start, end, col;
+    int start, end;
+    int row, col;
     double diag;
     double row_sum;
 
-    for (int i = A->local_num_rows - 1; i >= 0; i--)
+    for (int i = n_rows - 1; i >= 0; i--)
     {
+        row = rows[i];
         row_sum = 0;
-        start = A->on_proc->idx1[i];
-        end = A->on_proc->idx1[i+1];
-        if (A->on_proc->idx2[start] == i)
+        start = A->on_proc->idx1[row];
+        end = A->on_proc->idx1[row+1];
+        if (start < end && A->on_proc->idx2[start] == row)
         {
             diag = A->on_proc->vals[start];
             start++;
@@ -102,170 +127,656 @@ void SOR_backward(ParCSRMatrix* A, ParVector& x, const ParVector& y,
         for (int j = start; j < end; j++)
         {
             col = A->on_proc->idx2[j];
-            row_sum += A->on_proc->vals[j] * x[col];
+            if (col >= first_row && col < last_row)
+                row_sum += A->on_proc->vals[j] * x[col];
+            else
+                row_sum += A->on_proc->vals[j] * x_prev[col];
         }
 
-        start = A->off_proc->idx1[i];
-        end = A->off_proc->idx1[i+1];
+        start = A->off_proc->idx1[row];
+        end = A->off_proc->idx1[row+1];
         for (int j = start; j < end; j++)
         {
             col = A->off_proc->idx2[j];
             row_sum += A->off_proc->vals[j] * dist_x[col];
         }
 
-        x[i] = ((1.0 - omega)*x[i]) + (omega*((y[i] - row_sum) / diag));
+        x[row] = ((1.0 - omega)*x[row]) + (omega*((y[row] - row_sum) / diag));
     }
 }
 
-void jacobi_helper(ParCSRMatrix* A, ParVector& x, ParVector& b, ParVector& tmp, 
-        int num_sweeps, double omega, CommPkg* comm)
+/**************************************************************
+ *****   Multi-Vector Hybrid Gauss-Seidel / Jacobi Kernels
+ **************************************************************
+ ***** Same sweeps as above, applied to every vector of a 
+ ***** row-major ParMultiVector, so that each row of A is read
+ ***** once per sweep for all n_vecs right-hand sides
+ **************************************************************/
+void SOR_forward(ParCSRMatrix* A, ParMultiVector& x, const ParMultiVector& y, 
+        const ParMultiVector& x_prev, const double* dist_x, double omega, 
+        int first_row, int last_row, const int* rows, int n_rows)
+{
+    int start, end;
+    int row, col;
+    int n_vecs = x.n_vecs;
+    double diag, val;
+    std::vector<double> row_sum(n_vecs);
+
+    for (int i = 0; i < n_rows; i++)
+    {
+        row = rows[i];
+        start = A->on_proc->idx1[row];
+        end = A->on_proc->idx1[row+1];
+        if (start < end && A->on_proc->idx2[start] == row)
+        {
+            diag = A->on_proc->vals[start];
+            start++;
+        }        
+        else continue;
+        std::fill(row_sum.begin(), row_sum.end(), 0.0);
+        for (int j = start; j < end; j++)
+        {
+            col = A->on_proc->idx2[j];
+            val = A->on_proc->vals[j];
+            const ParMultiVector& x_col = (col >= first_row && col < last_row) ? x : x_prev;
+            for (int v = 0; v < n_vecs; v++)
+                row_sum[v] += val * x_col(col, v);
+        }
+
+        start = A->off_proc->idx1[row];
+        end = A->off_proc->idx1[row+1];
+        for (int j = start; j < end; j++)
+        {
+            col = A->off_proc->idx2[j] * n_vecs;
+            val = A->off_proc->vals[j];
+            for (int v = 0; v < n_vecs; v++)
+                row_sum[v] += val * dist_x[col + v];
+        }
+
+        for (int v = 0; v < n_vecs; v++)
+            x(row, v) = (x(row, v) + omega * (y(row, v) - x(row, v) - row_sum[v])) / diag;
+    }
+}
+
+void SOR_backward(ParCSRMatrix* A, ParMultiVector& x, const ParMultiVector& y,
+        const ParMultiVector& x_prev, const double* dist_x, double omega, 
+        int first_row, int last_row, const int* rows, int n_rows)
+{
+    int start, end;
+    int row, col;
+    int n_vecs = x.n_vecs;
+    double diag, val;
+    std::vector<double> row_sum(n_vecs);
+
+    for (int i = n_rows - 1; i >= 0; i--)
+    {
+        row = rows[i];
+        start = A->on_proc->idx1[row];
+        end = A->on_proc->idx1[row+1];
+        if (start < end && A->on_proc->idx2[start] == row)
+        {
+            diag = A->on_proc->vals[start];
+            start++;
+        }        
+        else continue;
+        std::fill(row_sum.begin(), row_sum.end(), 0.0);
+        for (int j = start; j < end; j++)
+        {
+            col = A->on_proc->idx2[j];
+            val = A->on_proc->vals[j];
+            const ParMultiVector& x_col = (col >= first_row && col < last_row) ? x : x_prev;
+            for (int v = 0; v < n_vecs; v++)
+                row_sum[v] += val * x_col(col, v);
+        }
+
+        start = A->off_proc->idx1[row];
+        end = A->off_proc->idx1[row+1];
+        for (int j = start; j < end; j++)
+        {
+            col = A->off_proc->idx2[j] * n_vecs;
+            val = A->off_proc->vals[j];
+            for (int v = 0; v < n_vecs; v++)
+                row_sum[v] += val * dist_x[col + v];
+        }
+
+        for (int v = 0; v < n_vecs; v++)
+            x(row, v) = ((1.0 - omega)*x(row, v)) + (omega*((y(row, v) - row_sum[v]) / diag));
+    }
+}
+
+void jacobi_rows(ParCSRMatrix* A, ParMultiVector& x, ParMultiVector& b, 
+        ParMultiVector& tmp, const double* dist_x, double omega, 
+        const int* rows, int n_rows)
+{
+    int start, end;
+    int row, col;
+    int n_vecs = x.n_vecs;
+    double diag, val;
+    std::vector<double> row_sum(n_vecs);
+
+    for (int i = 0; i < n_rows; i++)
+    {    
+        row = rows[i];
+        start = A->on_proc->idx1[row];
+        end = A->on_proc->idx1[row+1];
+        if (start == end)
+            continue;
+
+        diag = A->on_proc->vals[start++];
+
+        std::fill(row_sum.begin(), row_sum.end(), 0.0);
+        for (int j = start; j < end; j++)
+        {
+            col = A->on_proc->idx2[j];
+            val = A->on_proc->vals[j];
+            for (int v = 0; v < n_vecs; v++)
+                row_sum[v] += val * tmp(col, v);
+        }
+
+        start = A->off_proc->idx1[row];
+        end = A->off_proc->idx1[row+1];
+        for (int j = start; j < end; j++)
+        {
+            col = A->off_proc->idx2[j] * n_vecs;
+            val = A->off_proc->vals[j];
+            for (int v = 0; v < n_vecs; v++)
+                row_sum[v] += val * dist_x[col + v];
+        }
+
+        if (fabs(diag) > zero_tol)
+        {
+            for (int v = 0; v < n_vecs; v++)
+                x(row, v) = ((1.0 - omega)*tmp(row, v)) + (omega*((b(row, v) - row_sum[v]) / diag));
+        }
+    }
+}
+
+// Copy rows [first_row, last_row) of x into tmp
+void copy_rows(ParVector& tmp, ParVector& x, int first_row, int last_row)
+{
+    for (int i = first_row; i < last_row; i++)
+    {
+        tmp[i] = x[i];
+    }
+}
+
+void copy_rows(ParMultiVector& tmp, ParMultiVector& x, int first_row, int last_row)
+{
+    std::copy(x.local.values.begin() + first_row * x.n_vecs, 
+            x.local.values.begin() + last_row * x.n_vecs,
+            tmp.local.values.begin() + first_row * x.n_vecs);
+}
+
+void jacobi_rows(ParCSRMatrix* A, ParVector& x, ParVector& b, ParVector& tmp,
+        const double* dist_x, double omega, const int* rows, int n_rows)
+{
+    int start, end;
+    int row, col;
+    double diag, row_sum;
+
+    for (int i = 0; i < n_rows; i++)
+    {    
+        row = rows[i];
+        row_sum = 0;
+
+        start = A->on_proc->idx1[row];
+        end = A->on_proc->idx1[row+1];
+        if (start == end)
+            continue;
+
+        diag = A->on_proc->vals[start++];
+
+        for (int j = start; j < end; j++)
+        {
+            col = A->on_proc->idx2[j];
+            row_sum += A->on_proc->vals[j] * tmp[col];
+        }
+
+        start = A->off_proc->idx1[row];
+        end = A->off_proc->idx1[row+1];
+        for (int j = start; j < end; j++)
+        {
+            col = A->off_proc->idx2[j];
+            row_sum += A->off_proc->vals[j] * dist_x[col];
+        }
+
+        if (fabs(diag) > zero_tol)
+        {
+            x[row] = ((1.0 - omega)*tmp[row]) + (omega*((b[row] - row_sum) / diag));
+        }
+    }
+}
+
+// Completes the halo exchange started with comm->init_comm(x)
+std::vector<double>& complete_halo(CommPkg* comm, ParVector& x)
+{
+    return comm->complete_comm<double>();
+}
+std::vector<double>& complete_halo(CommPkg* comm, ParMultiVector& x)
+{
+    return comm->complete_comm<double>(x.n_vecs);
+}
+
+// Positions [first, last) of the sorted row list that fall within
+// [first_row, last_row)
+void row_range(const std::vector<int>& rows, int first_row, int last_row,
+        int& first, int& last)
+{
+    first = std::lower_bound(rows.begin(), rows.end(), first_row) - rows.begin();
+    last = std::lower_bound(rows.begin() + first, rows.end(), last_row) - rows.begin();
+}
+
+// Sorts A, moves its diagonal to the front of each row, and splits
+// rows into interior and boundary if not yet done
+void init_relax(ParCSRMatrix* A)
 {
     A->on_proc->sort();
     A->off_proc->sort();
     A->on_proc->move_diag();
-  
-    int start, end, col;
-    double diag, row_sum;
+    if ((int)(A->interior_rows.size() + A->boundary_rows.size()) != A->local_num_rows)
+    {
+        A->split_rows();
+    }
+}
+
+/**************************************************************
+ *****   Jacobi Sweep
+ **************************************************************
+ ***** Starts the halo exchange, relaxes interior rows while
+ ***** messages are in flight, and relaxes boundary rows once
+ ***** the exchange is complete.  Every row uses the values of
+ ***** x from the start of the sweep (stored in tmp), so the
+ ***** result does not depend on this ordering.
+ **************************************************************/
+template <typename VecType>
+void jacobi_sweep(ParCSRMatrix* A, VecType& x, VecType& b, VecType& tmp,
+        double omega, CommPkg* comm)
+{
+    const std::vector<int>& interior = A->interior_rows;
+    const std::vector<int>& boundary = A->boundary_rows;
 
+    comm->init_comm(x);
+
+#ifdef USING_OPENMP
+    std::vector<double>* dist_x = NULL;
+#pragma omp parallel if (A->on_proc->nnz > omp_nnz_threshold)
+    {
+        int first_row, last_row;
+        int first_int, last_int, first_bdry, last_bdry;
+        nnz_balanced_rows(A->on_proc->idx1, A->local_num_rows, 
+                omp_get_num_threads(), omp_get_thread_num(), 
+                first_row, last_row);
+        row_range(interior, first_row, last_row, first_int, last_int);
+        row_range(boundary, first_row, last_row, first_bdry, last_bdry);
+
+        copy_rows(tmp, x, first_row, last_row);
+#pragma omp barrier
+        jacobi_rows(A, x, b, tmp, NULL, omega, interior.data() + first_int,
+                last_int - first_int);
+
+        // MPI is only called from the master thread
+#pragma omp master
+        dist_x = &complete_halo(comm, x);
+#pragma omp barrier
+
+        jacobi_rows(A, x, b, tmp, dist_x->data(), omega, 
+                boundary.data() + first_bdry, last_bdry - first_bdry);
+    }
+#else
+    copy_rows(tmp, x, 0, A->local_num_rows);
+    jacobi_rows(A, x, b, tmp, NULL, omega, interior.data(), interior.size());
+    std::vector<double>& dist_x = complete_halo(comm, x);
+    jacobi_rows(A, x, b, tmp, dist_x.data(), omega, boundary.data(), 
+            boundary.size());
+#endif
+}
+
+template <typename VecType>
+void jacobi_helper(ParCSRMatrix* A, VecType& x, VecType& b, VecType& tmp, 
+        int num_sweeps, double omega, CommPkg* comm)
+{
+    init_relax(A);
+  
     for (int iter = 0; iter < num_sweeps; iter++)
     {
-        comm->communicate(x);
-        std::vector<double>& dist_x = comm->get_buffer<double>();
-        for (int i = 0; i < A->local_num_rows; i++)
-        {
-            tmp[i] = x[i];
-        }
+        jacobi_sweep(A, x, b, tmp, omega, comm);
+    }
+}
 
-        for (int i = 0; i < A->local_num_rows; i++)
-        {    
-            row_sum = 0;
+/**************************************************************
+ *****   Hybrid SOR Sweep
+ **************************************************************
+ ***** Performs a single forward and optional backward hybrid 
+ ***** SOR sweep.  The forward sweep relaxes interior rows while
+ ***** the halo exchange is in flight, and boundary rows once it
+ ***** completes.  The backward sweep visits rows in exactly the
+ ***** reverse order, so SSOR remains symmetric.
+ *****
+ ***** When threaded, each thread relaxes a nnz-balanced block of
+ ***** rows with Gauss-Seidel, using values of x from the start
+ ***** of the sweep (stored in tmp) for rows owned by other 
+ ***** threads (block Jacobi between threads).
+ **************************************************************/
+template <typename VecType>
+void hybrid_sor_sweep(ParCSRMatrix* A, VecType& x, VecType& b, VecType& tmp,
+        double omega, bool backward, CommPkg* comm)
+{
+    const std::vector<int>& interior = A->interior_rows;
+    const std::vector<int>& boundary = A->boundary_rows;
 
-      
-            start = A->on_proc->idx1[i];
-            end = A->on_proc->idx1[i+1];
-            if (start == end)
-                continue;
+    comm->init_comm(x);
 
-            diag = A->on_proc->vals[start++];
+#ifdef USING_OPENMP
+    std::vector<double>* dist_x = NULL;
+#pragma omp parallel if (A->on_proc->nnz > omp_nnz_threshold)
+    {
+        int n_threads = omp_get_num_threads();
+        int first_row, last_row;
+        int first_int, last_int, first_bdry, last_bdry;
+        nnz_balanced_rows(A->on_proc->idx1, A->local_num_rows, 
+                n_threads, omp_get_thread_num(), first_row, last_row);
+        row_range(interior, first_row, last_row, first_int, last_int);
+        row_range(boundary, first_row, last_row, first_bdry, last_bdry);
+
+        if (n_threads > 1)
+        {
+            copy_rows(tmp, x, first_row, last_row);
+#pragma omp barrier
+        }
+        SOR_forward(A, x, b, tmp, NULL, omega, first_row, last_row, 
+                interior.data() + first_int, last_int - first_int);
 
-            for (int j = start; j < end; j++)
-            {
-                col = A->on_proc->idx2[j];
-                row_sum += A->on_proc->vals[j] * tmp[col];
-            }
+        // MPI is only called from the master thread
+#pragma omp master
+        dist_x = &complete_halo(comm, x);
+#pragma omp barrier
 
-            start = A->off_proc->idx1[i];
-            end = A->off_proc->idx1[i+1];
-            for (int j = start; j < end; j++)
-            {
-                col = A->off_proc->idx2[j];
-                row_sum += A->off_proc->vals[j] * dist_x[col];
-            }
+        SOR_forward(A, x, b, tmp, dist_x->data(), omega, first_row, last_row, 
+                boundary.data() + first_bdry, last_bdry - first_bdry);
 
-            if (fabs(diag) > zero_tol)
+        if (backward)
+        {
+            if (n_threads > 1)
             {
-                x[i] = ((1.0 - omega)*tmp[i]) + (omega*((b[i] - row_sum) / diag));
+#pragma omp barrier
+                copy_rows(tmp, x, first_row, last_row);
+#pragma omp barrier
             }
+            SOR_backward(A, x, b, tmp, dist_x->data(), omega, first_row, 
+                    last_row, boundary.data() + first_bdry, last_bdry - first_bdry);
+            SOR_backward(A, x, b, tmp, NULL, omega, first_row, last_row, 
+                    interior.data() + first_int, last_int - first_int);
         }
     }
+#else
+    int n = A->local_num_rows;
+    SOR_forward(A, x, b, x, NULL, omega, 0, n, interior.data(), interior.size());
+    std::vector<double>& dist_x = complete_halo(comm, x);
+    SOR_forward(A, x, b, x, dist_x.data(), omega, 0, n, boundary.data(), 
+            boundary.size());
+    if (backward)
+    {
+        SOR_backward(A, x, b, x, dist_x.data(), omega, 0, n, boundary.data(),
+                boundary.size());
+        SOR_backward(A, x, b, x, NULL, omega, 0, n, interior.data(), 
+                interior.size());
+    }
+#endif
 }
 
-void sor_helper(ParCSRMatrix* A, ParVector& x, ParVector& b, ParVector& tmp, 
+template <typename VecType>
+void sor_helper(ParCSRMatrix* A, VecType& x, VecType& b, VecType& tmp, 
         int num_sweeps, double omega, CommPkg* comm)
 {
-    A->on_proc->sort();
-    A->off_proc->sort();
-    A->on_proc->move_diag();
+    init_relax(A);
 
     for (int iter = 0; iter < num_sweeps; iter++)
     {
-        comm->communicate(x);
-        SOR_forward(A, x, b, comm->get_buffer<double>(), omega);
+        hybrid_sor_sweep(A, x, b, tmp, omega, false, comm);
     }
 }
 
-
-void ssor_helper(ParCSRMatrix* A, ParVector& x, ParVector& b, ParVector& tmp, 
+template <typename VecType>
+void ssor_helper(ParCSRMatrix* A, VecType& x, VecType& b, VecType& tmp, 
         int num_sweeps, double omega, CommPkg* comm)
 {
-    A->on_proc->sort();
-    A->off_proc->sort();
-    A->on_proc->move_diag();
+    init_relax(A);
 
     for (int iter = 0; iter < num_sweeps; iter++)
     {
-        comm->communicate(x);
-        SOR_forward(A, x, b, comm->get_buffer<double>(), omega);
-        SOR_backward(A, x, b, comm->get_buffer<double>(), omega);
+        hybrid_sor_sweep(A, x, b, tmp, omega, true, comm);
     }
 }
 
+// Local values of a vector, and number of values stored per row
+double* vec_data(ParVector& x)
+{
+    return x.local.values.data();
+}
+double* vec_data(ParMultiVector& x)
+{
+    return x.local.values.data();
+}
+int vec_stride(ParVector& x)
+{
+    return 1;
+}
+int vec_stride(ParMultiVector& x)
+{
+    return x.n_vecs;
+}
+
 /**************************************************************
- *****  Relaxation Method 
+ *****   Scaled Residual Rows
  **************************************************************
- ***** Performs jacobi along the diagonal block of the matrix
+ ***** Computes z = S^{-1}(b - A*x) for the listed rows, where S
+ ***** is the diagonal of A, or with l1 set, the l1 norm of each
+ ***** row of A.  Both are accumulated while the row is read for
+ ***** the residual, so no separate scaling vector is stored.
+ ***** Rows with a zero scaling are left at zero.
  *****
  ***** Parameters
  ***** -------------
- ***** l: Level*
- *****    Level in hierarchy to be relaxed
- ***** num_sweeps : int
- *****    Number of relaxation sweeps to perform
+ ***** A : ParCSRMatrix*
+ *****    Matrix, with the diagonal first in each on_proc row
+ ***** x, b, z : double*
+ *****    Local values of x, b and the result (stride per row)
+ ***** dist_x : double*
+ *****    Values of x recvd from other processes (NULL when only
+ *****    interior rows are listed)
+ ***** stride : int
+ *****    Number of vectors interleaved by row
+ ***** l1 : bool
+ *****    Scale by l1 row norms rather than the diagonal
+ ***** rows : int*
+ *****    Rows to be computed
+ ***** n_rows : int
+ *****    Number of rows to be computed
  **************************************************************/
-void jacobi(ParCSRMatrix* A, ParVector& x, ParVector& b, ParVector& tmp, 
-        int num_sweeps, double omega, bool tap)
+void scaled_residual_rows(ParCSRMatrix* A, const double* x, const double* b,
+        double* z, const double* dist_x, int stride, bool l1, 
+        const int* rows, int n_rows)
 {
-    CommPkg* comm;
-    if (tap)
+    int start, end;
+    int row, col;
+    double val, scale;
+    double* z_row;
+
+    for (int i = 0; i < n_rows; i++)
     {
-        if (!A->tap_comm) 
+        row = rows[i];
+        z_row = z + row * stride;
+        for (int v = 0; v < stride; v++)
+            z_row[v] = b[row * stride + v];
+
+        start = A->on_proc->idx1[row];
+        end = A->on_proc->idx1[row+1];
+        if (start == end)
         {
-            A->tap_comm = new TAPComm(A->partition, A->off_proc_column_map,
-                    A->on_proc_column_map);
+            for (int v = 0; v < stride; v++)
+                z_row[v] = 0.0;
+            continue;
         }
-        comm = A->tap_comm;
-    }
-    else
-    {
-        if (!A->comm) 
+
+        scale = l1 ? 0.0 : A->on_proc->vals[start];
+        for (int j = start; j < end; j++)
         {
-            A->comm = new ParComm(A->partition, A->off_proc_column_map,
-                    A->on_proc_column_map);
+            col = A->on_proc->idx2[j] * stride;
+            val = A->on_proc->vals[j];
+            for (int v = 0; v < stride; v++)
+                z_row[v] -= val * x[col + v];
+            if (l1) scale += fabs(val);
+        }
+
+        start = A->off_proc->idx1[row];
+        end = A->off_proc->idx1[row+1];
+        for (int j = start; j < end; j++)
+        {
+            col = A->off_proc->idx2[j] * stride;
+            val = A->off_proc->vals[j];
+            for (int v = 0; v < stride; v++)
+                z_row[v] -= val * dist_x[col + v];
+            if (l1) scale += fabs(val);
+        }
+
+        if (fabs(scale) > zero_tol)
+        {
+            for (int v = 0; v < stride; v++)
+                z_row[v] /= scale;
+        }
+        else
+        {
+            for (int v = 0; v < stride; v++)
+                z_row[v] = 0.0;
         }
-        comm = A->comm;
     }
+}
 
-    jacobi_helper(A, x, b, tmp, num_sweeps, omega, comm);
+/**************************************************************
+ *****   Scaled Residual
+ **************************************************************
+ ***** Computes z = S^{-1}(b - A*x) (see scaled_residual_rows),
+ ***** with the interior rows computed while the halo exchange
+ ***** of x is in flight.  This is the only kernel needed by the
+ ***** polynomial smoothers below.
+ **************************************************************/
+template <typename VecType>
+void scaled_residual(ParCSRMatrix* A, VecType& x, VecType& b, VecType& z,
+        bool l1, CommPkg* comm)
+{
+    const std::vector<int>& interior = A->interior_rows;
+    const std::vector<int>& boundary = A->boundary_rows;
+    int stride = vec_stride(x);
+
+    comm->init_comm(x);
+    scaled_residual_rows(A, vec_data(x), vec_data(b), vec_data(z), NULL, 
+            stride, l1, interior.data(), interior.size());
+    std::vector<double>& dist_x = complete_halo(comm, x);
+    scaled_residual_rows(A, vec_data(x), vec_data(b), vec_data(z), 
+            dist_x.data(), stride, l1, boundary.data(), boundary.size());
 }
-void sor(ParCSRMatrix* A, ParVector& x, ParVector& b, ParVector& tmp, 
-        int num_sweeps, double omega, bool tap)
+
+/**************************************************************
+ *****   L1 Jacobi Relaxation
+ **************************************************************
+ ***** x += omega * D_l1^{-1}(b - A*x), where D_l1 holds the l1
+ ***** norm of each row of A.  Unlike hybrid Gauss-Seidel, this
+ ***** converges for any SPD matrix and partition, without a 
+ ***** weight, as D_l1 - A/2 is positive definite.
+ **************************************************************/
+template <typename VecType>
+void l1_jacobi_helper(ParCSRMatrix* A, VecType& x, VecType& b, VecType& tmp, 
+        int num_sweeps, double omega, CommPkg* comm)
 {
-    CommPkg* comm;
-    if (tap)
+    init_relax(A);
+
+    int n = A->local_num_rows * vec_stride(x);
+    double* x_data = vec_data(x);
+    double* z_data = vec_data(tmp);
+
+    for (int iter = 0; iter < num_sweeps; iter++)
     {
-        if (!A->tap_comm) 
+        scaled_residual(A, x, b, tmp, true, comm);
+        for (int i = 0; i < n; i++)
         {
-            A->tap_comm = new TAPComm(A->partition, A->off_proc_column_map,
-                    A->on_proc_column_map);
+            x_data[i] += omega * z_data[i];
         }
-        comm = A->tap_comm;
     }
-    else
+}
+
+/**************************************************************
+ *****   Chebyshev Relaxation
+ **************************************************************
+ ***** Applies a Chebyshev polynomial in D^{-1}A of the given 
+ ***** degree, damping the eigenvalues in [lower*rho, upper*rho],
+ ***** with the three-term recurrence (Saad, Alg. 12.1):
+ *****    d_0 = z_0 / theta
+ *****    d_k = rho_k*rho_{k-1}*d_{k-1} + (2*rho_k/delta)*z_k
+ ***** where z_k = D^{-1}(b - A*x_k) and x_{k+1} = x_k + d_k.  
+ ***** Each step costs one SpMV, overlapped with its halo 
+ ***** exchange, and no inner products.
+ *****
+ ***** Parameters
+ ***** -------------
+ ***** rho : double
+ *****    Estimate of the spectral radius of D^{-1}A
+ *****    (see spectral_radius)
+ ***** degree : int
+ *****    Degree of the polynomial (number of SpMVs per sweep)
+ ***** lower, upper : double
+ *****    Fractions of rho bounding the damped interval.  Upper is
+ *****    above one, as the estimate approaches rho from below.
+ **************************************************************/
+template <typename VecType>
+void chebyshev_helper(ParCSRMatrix* A, VecType& x, VecType& b, VecType& tmp, 
+        double rho, int degree, int num_sweeps, double lower, double upper,
+        CommPkg* comm)
+{
+    if (rho <= 0)
+    {
+        printf("Chebyshev relaxation requires a spectral radius estimate.\n");
+        exit(-1);
+    }
+
+    init_relax(A);
+
+    int n = A->local_num_rows * vec_stride(x);
+    double* x_data = vec_data(x);
+    double* z_data = vec_data(tmp);
+    std::vector<double> d(n);
+
+    double theta = 0.5 * (upper + lower) * rho;
+    double delta = 0.5 * (upper - lower) * rho;
+    double sigma = theta / delta;
+    double rho_old, rho_new;
+
+    for (int iter = 0; iter < num_sweeps; iter++)
     {
-        if (!A->comm) 
+        scaled_residual(A, x, b, tmp, false, comm);
+        for (int i = 0; i < n; i++)
         {
-            A->comm = new ParComm(A->partition, A->off_proc_column_map,
-                    A->on_proc_column_map);
+            d[i] = z_data[i] / theta;
+            x_data[i] += d[i];
         }
-        comm = A->comm;
-    }
 
-    sor_helper(A, x, b, tmp, num_sweeps, omega, comm);
+        rho_old = 1.0 / sigma;
+        for (int k = 1; k < degree; k++)
+        {
+            rho_new = 1.0 / (2.0 * sigma - rho_old);
+            scaled_residual(A, x, b, tmp, false, comm);
+            for (int i = 0; i < n; i++)
+            {
+                d[i] = rho_new * rho_old * d[i] + (2.0 * rho_new / delta) * z_data[i];
+                x_data[i] += d[i];
+            }
+            rho_old = rho_new;
+        }
+    }
 }
-void ssor(ParCSRMatrix* A, ParVector& x, ParVector& b, ParVector& tmp, 
-        int num_sweeps, double omega, bool tap)
+
+// Returns the (standard or node-aware) communicator used for relaxation
+CommPkg* relax_comm(ParCSRMatrix* A, bool tap)
 {
-    CommPkg* comm;
     if (tap)
     {
         if (!A->tap_comm) 
@@ -273,24 +784,178 @@ void ssor(ParCSRMatrix* A, ParVector& x, ParVector& b, ParVector& tmp,
             A->tap_comm = new TAPComm(A->partition, A->off_proc_column_map,
                     A->on_proc_column_map);
         }
-        comm = A->tap_comm;
+        return A->tap_comm;
     }
-    else
+
+    if (!A->comm) 
     {
-        if (!A->comm) 
-        {
-            A->comm = new ParComm(A->partition, A->off_proc_column_map,
-                    A->on_proc_column_map);
-        }
-        comm = A->comm;
+        A->comm = new ParComm(A->partition, A->off_proc_column_map,
+                A->on_proc_column_map);
     }
+    return A->comm;
+}
+
+/**************************************************************
+ *****  Relaxation Method 
+ **************************************************************
+ ***** Performs jacobi along the diagonal block of the matrix
+ *****
+ ***** Parameters
+ ***** -------------
+ ***** l: Level*
+ *****    Level in hierarchy to be relaxed
+ ***** num_sweeps : int
+ *****    Number of relaxation sweeps to perform
+ **************************************************************/
+void jacobi(ParCSRMatrix* A, ParVector& x, ParVector& b, ParVector& tmp, 
+        int num_sweeps, double omega, bool tap)
+{
+    jacobi_helper(A, x, b, tmp, num_sweeps, omega, relax_comm(A, tap));
+}
+void sor(ParCSRMatrix* A, ParVector& x, ParVector& b, ParVector& tmp, 
+        int num_sweeps, double omega, bool tap)
+{
+    sor_helper(A, x, b, tmp, num_sweeps, omega, relax_comm(A, tap));
+}
+void ssor(ParCSRMatrix* A, ParVector& x, ParVector& b, ParVector& tmp, 
+        int num_sweeps, double omega, bool tap)
+{
+    ssor_helper(A, x, b, tmp, num_sweeps, omega, relax_comm(A, tap));
+}
 
-    ssor_helper(A, x, b, tmp, num_sweeps, omega, comm);
+// Multi-vector versions: every sweep communicates all n_vecs values of
+// each row in one message per neighbor and relaxes all vectors together
+void jacobi(ParCSRMatrix* A, ParMultiVector& x, ParMultiVector& b, 
+        ParMultiVector& tmp, int num_sweeps, double omega, bool tap)
+{
+    jacobi_helper(A, x, b, tmp, num_sweeps, omega, relax_comm(A, tap));
+}
+void sor(ParCSRMatrix* A, ParMultiVector& x, ParMultiVector& b, 
+        ParMultiVector& tmp, int num_sweeps, double omega, bool tap)
+{
+    sor_helper(A, x, b, tmp, num_sweeps, omega, relax_comm(A, tap));
+}
+void ssor(ParCSRMatrix* A, ParMultiVector& x, ParMultiVector& b, 
+        ParMultiVector& tmp, int num_sweeps, double omega, bool tap)
+{
+    ssor_helper(A, x, b, tmp, num_sweeps, omega, relax_comm(A, tap));
+}
+
+void l1_jacobi(ParCSRMatrix* A, ParVector& x, ParVector& b, ParVector& tmp, 
+        int num_sweeps, double omega, bool tap)
+{
+    l1_jacobi_helper(A, x, b, tmp, num_sweeps, omega, relax_comm(A, tap));
+}
+void chebyshev(ParCSRMatrix* A, ParVector& x, ParVector& b, ParVector& tmp, 
+        double rho, int degree, int num_sweeps, double lower, double upper,
+        bool tap)
+{
+    chebyshev_helper(A, x, b, tmp, rho, degree, num_sweeps, lower, upper,
+            relax_comm(A, tap));
+}
+void l1_jacobi(ParCSRMatrix* A, ParMultiVector& x, ParMultiVector& b, 
+        ParMultiVector& tmp, int num_sweeps, double omega, bool tap)
+{
+    l1_jacobi_helper(A, x, b, tmp, num_sweeps, omega, relax_comm(A, tap));
 }
+void chebyshev(ParCSRMatrix* A, ParMultiVector& x, ParMultiVector& b, 
+        ParMultiVector& tmp, double rho, int degree, int num_sweeps, 
+        double lower, double upper, bool tap)
+{
+    chebyshev_helper(A, x, b, tmp, rho, degree, num_sweeps, lower, upper,
+            relax_comm(A, tap));
+}
+
+/**************************************************************
+ *****   Spectral Radius Estimate
+ **************************************************************
+ ***** Estimates the spectral radius of D^{-1}A with Lanczos 
+ ***** iterations on the symmetric D^{-1/2} A D^{-1/2}, returning
+ ***** the largest eigenvalue of the resulting tridiagonal matrix.
+ ***** The starting vector depends only on the global row, so the
+ ***** estimate does not change with the number of processes.
+ ***** Called by every process, as each iteration reduces over
+ ***** MPI_COMM_WORLD.
+ *****
+ ***** Parameters
+ ***** -------------
+ ***** A : ParCSRMatrix*
+ *****    Symmetric matrix with positive diagonal
+ ***** num_iterations : int
+ *****    Maximum number of Lanczos iterations
+ **************************************************************/
+double spectral_radius(ParCSRMatrix* A, int num_iterations)
+{
+    if (num_iterations < 1 || A->global_num_rows == 0)
+    {
+        return 0.0;
+    }
+
+    init_relax(A);
+
+    int n = A->local_num_rows;
+    int start, end;
+    double alpha, beta;
+    std::vector<double> alphas;
+    std::vector<double> betas;
 
+    std::vector<double> inv_sqrt_diag(n, 0.0);
+    for (int i = 0; i < n; i++)
+    {
+        start = A->on_proc->idx1[i];
+        end = A->on_proc->idx1[i+1];
+        if (start < end && A->on_proc->vals[start] > zero_tol)
+        {
+            inv_sqrt_diag[i] = 1.0 / sqrt(A->on_proc->vals[start]);
+        }
+    }
 
+    ParVector v(A->global_num_rows, n);
+    ParVector v_prev(A->global_num_rows, n);
+    ParVector w(A->global_num_rows, n);
+    ParVector Aw(A->global_num_rows, n);
+    for (int i = 0; i < n; i++)
+    {
+        v[i] = 1.0 + ((long) A->local_row_map[i] * 7919 % 1009) / 1009.0;
+    }
+    v.scale(1.0 / v.norm(2));
+    v_prev.set_const_value(0.0);
 
+    beta = 0.0;
+    for (int iter = 0; iter < num_iterations; iter++)
+    {
+        // w = D^{-1/2} A D^{-1/2} v - beta * v_prev
+        for (int i = 0; i < n; i++)
+        {
+            w[i] = inv_sqrt_diag[i] * v[i];
+        }
+        A->mult(w, Aw);
+        for (int i = 0; i < n; i++)
+        {
+            w[i] = inv_sqrt_diag[i] * Aw[i] - beta * v_prev[i];
+        }
 
+        alpha = w.inner_product(v);
+        w.axpy(v, -alpha);
+        alphas.emplace_back(alpha);
 
+        beta = w.norm(2);
+        if (beta < zero_tol * fabs(alpha) || iter == num_iterations - 1)
+        {
+            break;
+        }
+        betas.emplace_back(beta);
+        v_prev.copy(v);
+        for (int i = 0; i < n; i++)
+        {
+            v[i] = w[i] / beta;
+        }
+    }
 
+    int k = alphas.size();
+    int info;
+    betas.resize(k);
+    dsterf_(&k, alphas.data(), betas.data(), &info);
 
+    return alphas[k-1];
+}
@@ -18,6 +18,29 @@ void sor(ParCSRMatrix* A, ParVector& x, ParVector& b, ParVector& tmp,
         int num_sweeps = 1, double omega = 1.0, bool tap = false);
 void ssor(ParCSRMatrix* A, ParVector& x, ParVector& b, ParVector& tmp, 
         int num_sweeps = 1, double omega = 1.0, bool tap = false);
+void jacobi(ParCSRMatrix* A, ParMultiVector& x, ParMultiVector& b, 
+        ParMultiVector& tmp, int num_sweeps = 1, double omega = 1.0, 
+        bool tap = false);
+void sor(ParCSRMatrix* A, ParMultiVector& x, ParMultiVector& b, 
+        ParMultiVector& tmp, int num_sweeps = 1, double omega = 1.0, 
+        bool tap = false);
+void ssor(ParCSRMatrix* A, ParMultiVector& x, ParMultiVector& b, 
+        ParMultiVector& tmp, int num_sweeps = 1, double omega = 1.0, 
+        bool tap = false);
+
+void l1_jacobi(ParCSRMatrix* A, ParVector& x, ParVector& b, ParVector& tmp, 
+        int num_sweeps = 1, double omega = 1.0, bool tap = false);
+void chebyshev(ParCSRMatrix* A, ParVector& x, ParVector& b, ParVector& tmp, 
+        double rho, int degree = 2, int num_sweeps = 1, double lower = 0.3, 
+        double upper = 1.1, bool tap = false);
+void l1_jacobi(ParCSRMatrix* A, ParMultiVector& x, ParMultiVector& b, 
+        ParMultiVector& tmp, int num_sweeps = 1, double omega = 1.0, 
+        bool tap = false);
+void chebyshev(ParCSRMatrix* A, ParMultiVector& x, ParMultiVector& b, 
+        ParMultiVector& tmp, double rho, int degree = 2, int num_sweeps = 1, 
+        double lower = 0.3, double upper = 1.1, bool tap = false);
+
+double spectral_radius(ParCSRMatrix* A, int num_iterations = 10);
 
 
 
@@ -280,6 +280,137 @@ void ParMatrix::tap_residual(ParVector& x, ParVector& b, ParVector& r)
 }
 
 
+/**************************************************************
+ *****   Parallel Sparse Matrix-Multivector Multiplication
+ **************************************************************
+ ***** Performs b = A*X for a block of vectors stored row-major.
+ ***** All n_vecs values of each communicated row are packed into 
+ ***** a single message per neighbor, and each nonzero of the local
+ ***** blocks is applied to every vector in one pass.  Requires
+ ***** on_proc and off_proc to be stored in CSR format.
+ **************************************************************/
+CommPkg* multivector_comm(ParMatrix* A, bool tap)
+{
+    if (A->on_proc->format() != CSR || A->off_proc->format() != CSR)
+    {
+        printf("Error.  ParMultiVector products require CSR matrices.\n");
+        exit(-1);
+    }
+
+    if (tap)
+    {
+        if (A->tap_comm == NULL)
+        {
+            A->tap_comm = new TAPComm(A->partition, A->off_proc_column_map, 
+                    A->on_proc_column_map);
+        }
+        return A->tap_comm;
+    }
+
+    if (A->comm == NULL)
+    {
+        A->comm = new ParComm(A->partition, A->off_proc_column_map, 
+                A->on_proc_column_map);
+    }
+    return A->comm;
+}
+
+void ParMatrix::mult(ParMultiVector& x, ParMultiVector& b, bool tap)
+{
+    CommPkg* comm_pkg = multivector_comm(this, tap);
+    CSRMatrix* A_on = (CSRMatrix*) on_proc;
+    CSRMatrix* A_off = (CSRMatrix*) off_proc;
+    int n_vecs = x.n_vecs;
+
+    comm_pkg->init_comm(x);
+
+    if (local_num_rows)
+    {
+        A_on->spmm(x.local.values.data(), b.local.values.data(), n_vecs);
+    }
+
+    std::vector<double>& x_tmp = comm_pkg->complete_comm<double>(n_vecs);
+
+    if (off_proc_num_cols)
+    {
+        A_off->spmm_append(x_tmp.data(), b.local.values.data(), n_vecs);
+    }
+}
+
+void ParMatrix::mult_append(ParMultiVector& x, ParMultiVector& b, bool tap)
+{
+    CommPkg* comm_pkg = multivector_comm(this, tap);
+    CSRMatrix* A_on = (CSRMatrix*) on_proc;
+    CSRMatrix* A_off = (CSRMatrix*) off_proc;
+    int n_vecs = x.n_vecs;
+
+    comm_pkg->init_comm(x);
+
+    if (local_num_rows)
+    {
+        A_on->spmm_append(x.local.values.data(), b.local.values.data(), n_vecs);
+    }
+
+    std::vector<double>& x_tmp = comm_pkg->complete_comm<double>(n_vecs);
+
+    if (off_proc_num_cols)
+    {
+        A_off->spmm_append(x_tmp.data(), b.local.values.data(), n_vecs);
+    }
+}
+
+void ParMatrix::mult_T(ParMultiVector& x, ParMultiVector& b, bool tap)
+{
+    CommPkg* comm_pkg = multivector_comm(this, tap);
+    CSRMatrix* A_on = (CSRMatrix*) on_proc;
+    CSRMatrix* A_off = (CSRMatrix*) off_proc;
+    int n_vecs = x.n_vecs;
+
+    std::vector<double>& x_tmp = comm_pkg->get_buffer<double>();
+    if ((int)x_tmp.size() < off_proc_num_cols * n_vecs)
+        x_tmp.resize(off_proc_num_cols * n_vecs);
+    std::fill(x_tmp.begin(), x_tmp.begin() + off_proc_num_cols * n_vecs, 0.0);
+
+    A_off->spmm_append_T(x.local.values.data(), x_tmp.data(), n_vecs);
+
+    comm_pkg->init_comm_T(x_tmp, n_vecs);
+
+    std::fill(b.local.values.begin(), b.local.values.end(), 0.0);
+    if (local_num_rows)
+    {
+        A_on->spmm_append_T(x.local.values.data(), b.local.values.data(), n_vecs);
+    }
+
+    comm_pkg->complete_comm_T<double>(b.local.values, n_vecs);
+}
+
+void ParMatrix::residual(ParMultiVector& x, ParMultiVector& b, 
+        ParMultiVector& r, bool tap)
+{
+    CommPkg* comm_pkg = multivector_comm(this, tap);
+    CSRMatrix* A_on = (CSRMatrix*) on_proc;
+    CSRMatrix* A_off = (CSRMatrix*) off_proc;
+    int n_vecs = x.n_vecs;
+
+    comm_pkg->init_comm(x);
+
+    std::copy(b.local.values.begin(), b.local.values.end(), 
+            r.local.values.begin());
+
+    if (local_num_rows)
+    {
+        A_on->spmm_append_neg(x.local.values.data(), r.local.values.data(), 
+                n_vecs);
+    }
+
+    std::vector<double>& x_tmp = comm_pkg->complete_comm<double>(n_vecs);
+
+    if (off_proc_num_cols)
+    {
+        A_off->spmm_append_neg(x_tmp.data(), r.local.values.data(), n_vecs);
+    }
+}
+
 void ParCOOMatrix::mult(ParVector& x, ParVector& b, bool tap)
 {
     ParMatrix::mult(x, b, tap);
@@ -340,3 +471,13 @@ void ParCSCMatrix::tap_mult_T(ParVector& x, ParVector& b)
     ParMatrix::tap_mult_T(x, b);
 }
 
+void ParCSRMatrix::mult(ParMultiVector& x, ParMultiVector& b, bool tap)
+{
+    ParMatrix::mult(x, b, tap);
+}
+
+void ParCSRMatrix::mult_T(ParMultiVector& x, ParMultiVector& b, bool tap)
+{
+    ParMatrix::mult_T(x, b, tap);
+}
+
@@ -8,17 +8,9 @@ void make_contiguous(ParCSRMatrix* A, std::vector<int>& off_proc_part_map)
     RAPtor_MPI_Comm_rank(RAPtor_MPI_COMM_WORLD, &rank);
     RAPtor_MPI_Comm_size(RAPtor_MPI_COMM_WORLD, &num_procs);
 
-    std::map<int, int> global_to_local;
     std::vector<int> proc_num_cols(num_procs);
     std::vector<int> recvvec;
 
-    int ctr = 0;
-    for (std::vector<int>::const_iterator it = A->off_proc_column_map.begin();  
-            it != A->off_proc_column_map.end(); ++it)
-    {
-        global_to_local[*it] = ctr++;
-    }
-
     // Find how many columns are local to each process
     RAPtor_MPI_Allgather(&(A->on_proc_num_cols), 1, RAPtor_MPI_INT, proc_num_cols.data(), 1, RAPtor_MPI_INT,
             RAPtor_MPI_COMM_WORLD);
@@ -42,12 +34,14 @@ void make_contiguous(ParCSRMatrix* A, std::vector<int>& off_proc_part_map)
     A->comm = new ParComm(A->partition->topology, A->off_proc_column_map,
             off_proc_part_map, A->local_row_map);
 
+    std::vector<int> new_cols(A->local_num_rows);
     for (int i = 0; i < A->local_num_rows; i++)
     {
         A->on_proc_column_map[i] = A->partition->first_local_col + i;
+        new_cols[i] = A->on_proc_column_map[i];
     }
     A->local_row_map = A->get_on_proc_column_map();
-    recvvec = A->comm->communicate(A->local_row_map);
+    recvvec = A->comm->communicate(new_cols);
     for (int i = 0; i < A->off_proc_num_cols; i++)
         A->off_proc_column_map[i] = recvvec[i];
 
@@ -73,7 +67,7 @@ ParCSRMatrix* repartition_matrix(ParCSRMatrix* A, int* partition, std::vector<in
     int row_start, row_end, row_size;
     int num_sends, num_recvs;
     int proc_idx, idx, ctr, prev_ctr;
-    int row, col, global_row, global_col;
+    int row, col, local_col, global_row, global_col;
     int count, first_row;
     int recv_size;
     double val;
@@ -101,7 +95,8 @@ ParCSRMatrix* repartition_matrix(ParCSRMatrix* A, int* partition, std::vector<in
 
     std::vector<int> off_parts(A->off_proc_num_cols);
     std::vector<int>& recvvec = A->comm->communicate(partition);
-    std::copy(recvvec.begin(), recvvec.end(), off_parts.begin());
+    std::copy(recvvec.begin(), recvvec.begin() + A->off_proc_num_cols, 
+            off_parts.begin());
 
     num_sends = 0;
     for (int i = 0; i < A->local_num_rows; i++)
@@ -242,7 +237,7 @@ ParCSRMatrix* repartition_matrix(ParCSRMatrix* A, int* partition, std::vector<in
                 MPI_COMM_WORLD, &(send_requests[i]));
     }
 
-    std::map<int,int> off_proc_to_local;
+    IntMap<int> off_proc_to_local;
     std::vector<int> off_col_to_global;
     std::vector<int> off_col_parts;
     recv_size = 0;
@@ -284,9 +279,9 @@ ParCSRMatrix* repartition_matrix(ParCSRMatrix* A, int* partition, std::vector<in
             MPI_Unpack(recv_buffer.data(), count, &ctr, &global_col, 1, MPI_INT,
                     MPI_COMM_WORLD);
             MPI_Unpack(recv_buffer.data(), count, &ctr, &part, 1, MPI_INT, MPI_COMM_WORLD);
-            if (off_proc_to_local.find(global_col) == off_proc_to_local.end())
+            if (off_proc_to_local.insert(global_col, off_col_to_global.size())
+                    == (int) off_col_to_global.size())
             {
-                off_proc_to_local[global_col] = off_col_to_global.size();
                 off_col_to_global.push_back(global_col);
                 off_col_parts.push_back(part);
             }
@@ -320,11 +315,12 @@ ParCSRMatrix* repartition_matrix(ParCSRMatrix* A, int* partition, std::vector<in
                     return off_col_to_global[i] < off_col_to_global[j];
                 return off_col_parts[i] < off_col_parts[j];
             });
+    off_proc_to_local.clear();
     for (int i = 0; i < A_part->off_proc_num_cols; i++)
     {
         col = off_col_order[i];
         global_col = off_col_to_global[col];
-        off_proc_to_local[global_col] = i;
+        off_proc_to_local.insert(global_col, i);
         A_part->off_proc_column_map[i] = global_col;
         off_proc_part_map[i] = off_col_parts[col];
     }
@@ -338,12 +334,12 @@ ParCSRMatrix* repartition_matrix(ParCSRMatrix* A, int* partition, std::vector<in
             {
                 return recv_rows[i] < recv_rows[j];
             });
-    std::map<int, int> on_proc_to_local;
+    IntMap<int> on_proc_to_local(num_rows);
     for(int i = 0; i < num_rows; i++)
     {
         row = row_order[i];
         global_row = recv_rows[row];
-        on_proc_to_local[global_row] = i;
+        on_proc_to_local.insert(global_row, i);
         A_part->on_proc_column_map[i] = global_row;
     }
     A_part->local_row_map = A_part->get_on_proc_column_map();
@@ -361,14 +357,15 @@ ParCSRMatrix* repartition_matrix(ParCSRMatrix* A, int* partition, std::vector<in
             col = recv_cols[j];
             val = recv_vals[j];
 
-            if (on_proc_to_local.find(col) != on_proc_to_local.end())
+            local_col = on_proc_to_local.find(col);
+            if (local_col >= 0)
             {
-                A_part->on_proc->idx2.push_back(on_proc_to_local[col]);
+                A_part->on_proc->idx2.push_back(local_col);
                 A_part->on_proc->vals.push_back(val);
             }
             else
             {
-                A_part->off_proc->idx2.push_back(off_proc_to_local[col]);
+                A_part->off_proc->idx2.push_back(off_proc_to_local.find(col));
                 A_part->off_proc->vals.push_back(val);
             }
         }
@@ -0,0 +1,266 @@
+// Copyright (c) 2015-2017, RAPtor Developer Team
+// License: Simplified BSD, http://opensource.org/licenses/BSD-2-Clause
+#include "sparse_lu.hpp"
+#include <queue>
+
+using namespace raptor;
+
+/**************************************************************
+*****   Form Ordering
+**************************************************************
+***** Reverse Cuthill-McKee ordering of the symmetrized graph
+***** of A.  Each connected component is traversed breadth
+***** first from its vertex of lowest degree, visiting
+***** neighbors in order of increasing degree.
+**************************************************************/
+void SparseLU::form_ordering(const CSRMatrix* A)
+{
+    int start, end, col, head;
+    std::vector<int> degree(n, 0);
+    std::vector<int> adj_ptr(n+1);
+    std::vector<int> adj;
+    std::vector<int> visited(n, 0);
+    std::vector<int> nodes(n);
+    std::vector<int> neighbors;
+
+    for (int i = 0; i < n; i++)
+    {
+        start = A->idx1[i];
+        end = A->idx1[i+1];
+        for (int j = start; j < end; j++)
+        {
+            col = A->idx2[j];
+            if (col == i) continue;
+            degree[i]++;
+            degree[col]++;
+        }
+    }
+    adj_ptr[0] = 0;
+    for (int i = 0; i < n; i++)
+    {
+        adj_ptr[i+1] = adj_ptr[i] + degree[i];
+    }
+    adj.resize(adj_ptr[n]);
+    std::fill(degree.begin(), degree.end(), 0);
+    for (int i = 0; i < n; i++)
+    {
+        start = A->idx1[i];
+        end = A->idx1[i+1];
+        for (int j = start; j < end; j++)
+        {
+            col = A->idx2[j];
+            if (col == i) continue;
+            adj[adj_ptr[i] + degree[i]++] = col;
+            adj[adj_ptr[col] + degree[col]++] = i;
+        }
+    }
+
+    std::iota(nodes.begin(), nodes.end(), 0);
+    std::stable_sort(nodes.begin(), nodes.end(),
+            [&](const int i, const int j)
+            {
+                return degree[i] < degree[j];
+            });
+
+    perm.clear();
+    perm.reserve(n);
+    head = 0;
+    for (std::vector<int>::iterator it = nodes.begin(); it != nodes.end(); ++it)
+    {
+        if (visited[*it]) continue;
+
+        visited[*it] = 1;
+        perm.emplace_back(*it);
+        while (head < (int) perm.size())
+        {
+            int vertex = perm[head++];
+            neighbors.clear();
+            for (int j = adj_ptr[vertex]; j < adj_ptr[vertex+1]; j++)
+            {
+                col = adj[j];
+                if (!visited[col])
+                {
+                    visited[col] = 1;
+                    neighbors.emplace_back(col);
+                }
+            }
+            std::stable_sort(neighbors.begin(), neighbors.end(),
+                    [&](const int i, const int j)
+                    {
+                        return degree[i] < degree[j];
+                    });
+            perm.insert(perm.end(), neighbors.begin(), neighbors.end());
+        }
+    }
+    std::reverse(perm.begin(), perm.end());
+}
+
+/**************************************************************
+*****   Factor
+**************************************************************
+***** Row-by-row (IKJ) elimination of the permuted matrix.
+***** Row i is scattered into a dense work row, and the rows of
+***** U above it are subtracted in increasing column order.  Fill
+***** below the diagonal is added to a heap of columns still to
+***** be eliminated.
+*****
+***** Parameters
+***** -------------
+***** A : CSRMatrix*
+*****    Square matrix to be factored
+**************************************************************/
+void SparseLU::factor(const CSRMatrix* A)
+{
+    int row, start, end, col, k;
+    double l_val;
+
+    n = A->n_rows;
+    form_ordering(A);
+
+    std::vector<int> iperm(n);
+    for (int i = 0; i < n; i++)
+    {
+        iperm[perm[i]] = i;
+    }
+
+    L_idx1.resize(n+1);
+    U_idx1.resize(n+1);
+    L_idx2.clear();
+    L_vals.clear();
+    U_idx2.clear();
+    U_vals.clear();
+    U_diag.resize(n);
+    L_idx1[0] = 0;
+    U_idx1[0] = 0;
+
+    std::vector<double> work(n, 0.0);
+    std::vector<int> marker(n, -1);
+    std::vector<int> upper;
+    std::priority_queue<int, std::vector<int>, std::greater<int> > lower;
+
+    for (int i = 0; i < n; i++)
+    {
+        // Scatter row i of the permuted matrix
+        work[i] = 0.0;
+        marker[i] = i;
+        row = perm[i];
+        start = A->idx1[row];
+        end = A->idx1[row+1];
+        for (int j = start; j < end; j++)
+        {
+            col = iperm[A->idx2[j]];
+            if (marker[col] != i)
+            {
+                marker[col] = i;
+                work[col] = 0.0;
+                if (col < i) lower.push(col);
+                else upper.emplace_back(col);
+            }
+            work[col] += A->vals[j];
+        }
+
+        // Eliminate entries below the diagonal
+        while (!lower.empty())
+        {
+            k = lower.top();
+            lower.pop();
+
+            l_val = work[k] / U_diag[k];
+            L_idx2.emplace_back(k);
+            L_vals.emplace_back(l_val);
+
+            start = U_idx1[k];
+            end = U_idx1[k+1];
+            for (int j = start; j < end; j++)
+            {
+                col = U_idx2[j];
+                if (marker[col] != i)
+                {
+                    marker[col] = i;
+                    work[col] = 0.0;
+                    if (col < i) lower.push(col);
+                    else if (col > i) upper.emplace_back(col);
+                }
+                work[col] -= l_val * U_vals[j];
+            }
+        }
+        L_idx1[i+1] = L_idx2.size();
+
+        U_diag[i] = work[i];
+        for (std::vector<int>::iterator it = upper.begin(); it != upper.end(); ++it)
+        {
+            U_idx2.emplace_back(*it);
+            U_vals.emplace_back(work[*it]);
+        }
+        U_idx1[i+1] = U_idx2.size();
+        upper.clear();
+    }
+}
+
+/**************************************************************
+*****   Solve
+**************************************************************
+***** Forward and backward substitution with the factors,
+***** applied to every right-hand side of each row at once
+*****
+***** Parameters
+***** -------------
+***** x : double*
+*****    Right-hand sides on input, solutions on output
+***** n_vecs : int
+*****    Number of right-hand sides, interleaved by row
+**************************************************************/
+void SparseLU::solve(double* x, int n_vecs) const
+{
+    int start, end;
+    double val;
+    std::vector<double> y((std::size_t) n * n_vecs);
+
+    for (int i = 0; i < n; i++)
+    {
+        for (int v = 0; v < n_vecs; v++)
+        {
+            y[i*n_vecs + v] = x[perm[i]*n_vecs + v];
+        }
+    }
+
+    for (int i = 0; i < n; i++)
+    {
+        start = L_idx1[i];
+        end = L_idx1[i+1];
+        for (int j = start; j < end; j++)
+        {
+            val = L_vals[j];
+            for (int v = 0; v < n_vecs; v++)
+            {
+                y[i*n_vecs + v] -= val * y[L_idx2[j]*n_vecs + v];
+            }
+        }
+    }
+
+    for (int i = n - 1; i >= 0; i--)
+    {
+        start = U_idx1[i];
+        end = U_idx1[i+1];
+        for (int j = start; j < end; j++)
+        {
+            val = U_vals[j];
+            for (int v = 0; v < n_vecs; v++)
+            {
+                y[i*n_vecs + v] -= val * y[U_idx2[j]*n_vecs + v];
+            }
+        }
+        for (int v = 0; v < n_vecs; v++)
+        {
+            y[i*n_vecs + v] /= U_diag[i];
+        }
+    }
+
+    for (int i = 0; i < n; i++)
+    {
+        for (int v = 0; v < n_vecs; v++)
+        {
+            x[perm[i]*n_vecs + v] = y[i*n_vecs + v];
+        }
+    }
+}
@@ -0,0 +1,73 @@
+// Copyright (c) 2015-2017, RAPtor Developer Team
+// License: Simplified BSD, http://opensource.org/licenses/BSD-2-Clause
+#ifndef RAPTOR_UTILS_LINALG_SPARSE_LU_HPP
+#define RAPTOR_UTILS_LINALG_SPARSE_LU_HPP
+
+#include "core/types.hpp"
+#include "core/matrix.hpp"
+
+/**************************************************************
+ *****   SparseLU Class
+ **************************************************************
+ ***** Sparse LU factorization of a square CSR matrix, used as
+ ***** a direct coarse-grid solver.  Rows and columns are first
+ ***** permuted with reverse Cuthill-McKee to limit fill, and
+ ***** elimination is performed row by row without pivoting,
+ ***** which suits the diagonally dominant and symmetric
+ ***** positive definite coarse operators formed by AMG.
+ *****
+ ***** Attributes
+ ***** -------------
+ ***** n : int
+ *****    Dimension of the factored matrix
+ ***** perm : std::vector<int>
+ *****    Fill-reducing ordering (row perm[i] of A is row i of L*U)
+ ***** L_idx1, L_idx2, L_vals
+ *****    Strictly lower triangular factor (unit diagonal), in CSR
+ ***** U_idx1, U_idx2, U_vals
+ *****    Strictly upper triangular factor, in CSR
+ ***** U_diag : std::vector<double>
+ *****    Diagonal of the upper triangular factor
+ *****
+ ***** Methods
+ ***** -------
+ ***** factor(A)
+ *****    Computes the factorization of A
+ ***** solve(x, n_vecs)
+ *****    Overwrites x with the solution of A*x = x.  With n_vecs
+ *****    right-hand sides, value v of row i is x[i*n_vecs + v].
+ **************************************************************/
+namespace raptor
+{
+    class SparseLU
+    {
+      public:
+        SparseLU()
+        {
+            n = 0;
+        }
+
+        void factor(const CSRMatrix* A);
+        void solve(double* x, int n_vecs = 1) const;
+
+        int nnz() const
+        {
+            return L_idx2.size() + U_idx2.size() + n;
+        }
+
+        int n;
+        std::vector<int> perm;
+        std::vector<int> L_idx1;
+        std::vector<int> L_idx2;
+        std::vector<double> L_vals;
+        std::vector<int> U_idx1;
+        std::vector<int> U_idx2;
+        std::vector<double> U_vals;
+        std::vector<double> U_diag;
+
+      private:
+        void form_ordering(const CSRMatrix* A);
+    };
+}
+
+#endif
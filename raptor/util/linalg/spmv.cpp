@@ -2,6 +2,7 @@
 // License: Simplified BSD, http://opensource.org/licenses/BSD-2-Clause
 
 #include "core/matrix.hpp"
+#include "core/utilities.hpp"
 
 using namespace raptor;
 
@@ -10,11 +11,12 @@ void CSR_spmv(const CSRMatrix* A, const double* x, double* b);
 void CSR_residual(const CSRMatrix* A, const double* x, 
         const double* b, double* r);
 void CSR_append(const CSRMatrix* A, const double* x, double* b);
+void CSR_append_neg(const CSRMatrix* A, const double* x, double* b);
 void BSR_spmv(const BSRMatrix* A, const double* x, double* b);
 
 // COOMatrix SpMV Methods (or BCOO)
-template <typename T>
-void COO_append(const COOMatrix* A, const std::vector<T>& vals,
+template <typename VecType>
+void COO_append(const COOMatrix* A, const VecType& vals,
         const double* x, double* b)
 {
     for (int i = 0; i < A->nnz; i++)
@@ -22,8 +24,8 @@ void COO_append(const COOMatrix* A, const std::vector<T>& vals,
         A->append(A->idx1[i], A->idx2[i], b, x, vals[i]);
     }
 }
-template <typename T>
-void COO_append_T(const COOMatrix* A, const std::vector<T>& vals,
+template <typename VecType>
+void COO_append_T(const COOMatrix* A, const VecType& vals,
         const double* x, double* b)
 {
     for (int i = 0; i < A->nnz; i++)
@@ -31,8 +33,8 @@ void COO_append_T(const COOMatrix* A, const std::vector<T>& vals,
         A->append_T(A->idx2[i], A->idx1[i], b, x, vals[i]);
     }
 }
-template <typename T>
-void COO_append_neg(const COOMatrix* A, const std::vector<T>& vals,
+template <typename VecType>
+void COO_append_neg(const COOMatrix* A, const VecType& vals,
         const double* x, double* b)
 {
     for (int i = 0; i < A->nnz; i++)
@@ -40,8 +42,8 @@ void COO_append_neg(const COOMatrix* A, const std::vector<T>& vals,
         A->append_neg(A->idx1[i], A->idx2[i], b, x, vals[i]);
     }
 }
-template <typename T>
-void COO_append_neg_T(const COOMatrix* A, const std::vector<T>& vals,
+template <typename VecType>
+void COO_append_neg_T(const COOMatrix* A, const VecType& vals,
         const double* x, double* b)
 {
     for (int i = 0; i < A->nnz; i++)
@@ -56,11 +58,14 @@ void COO_append_neg_T(const COOMatrix* A, const std::vector<T>& vals,
 
 // CSRMatrix SpMV Methods (or BSR)
 // Optimized CSR and BSR standard SpMVs
-void CSR_spmv(const CSRMatrix* A, const double* x, double* b)
+// Each kernel operates on rows [first_row, last_row), so that the rows
+// can be divided among threads when compiled with OpenMP
+void CSR_spmv_rows(const CSRMatrix* A, const double* x, double* b,
+        int first_row, int last_row)
 {
     int start, end;
     double val;
-    for (int i = 0; i < A->n_rows; i++)
+    for (int i = first_row; i < last_row; i++)
     {
         start = A->idx1[i];
         end = A->idx1[i+1];
@@ -73,12 +78,12 @@ void CSR_spmv(const CSRMatrix* A, const double* x, double* b)
     }
 }
 
-void CSR_residual(const CSRMatrix* A, const double* x, 
-        const double* b, double* r)
+void CSR_residual_rows(const CSRMatrix* A, const double* x, 
+        const double* b, double* r, int first_row, int last_row)
 {
     int start, end;
     double val;
-    for (int i = 0; i < A->n_rows; i++)
+    for (int i = first_row; i < last_row; i++)
     {
         start = A->idx1[i];
         end = A->idx1[i+1];
@@ -91,12 +96,12 @@ void CSR_residual(const CSRMatrix* A, const double* x,
     }
 }
 
-
-void CSR_append(const CSRMatrix* A, const double* x, double* b)
+void CSR_append_rows(const CSRMatrix* A, const double* x, double* b,
+        int first_row, int last_row)
 {
     int start, end;
     double val;
-    for (int i = 0; i < A->n_rows; i++)
+    for (int i = first_row; i < last_row; i++)
     {
         start = A->idx1[i];
         end = A->idx1[i+1];
@@ -109,8 +114,172 @@ void CSR_append(const CSRMatrix* A, const double* x, double* b)
     }
 }
 
-template <typename T>
-void BSR_append(const CSRMatrix* A, const std::vector<T>& vals,
+void CSR_append_neg_rows(const CSRMatrix* A, const double* x, double* b,
+        int first_row, int last_row)
+{
+    int start, end;
+    double val;
+    for (int i = first_row; i < last_row; i++)
+    {
+        start = A->idx1[i];
+        end = A->idx1[i+1];
+        val = 0;
+        for (int j = start; j < end; j++)
+        {
+            val += A->vals[j] * x[A->idx2[j]];
+        }
+        b[i] -= val;
+    }
+}
+
+void CSR_spmv(const CSRMatrix* A, const double* x, double* b)
+{
+    if (A->n_rows == 0) return;
+#ifdef USING_OPENMP
+#pragma omp parallel if (A->idx1[A->n_rows] > omp_nnz_threshold)
+    {
+        int first_row, last_row;
+        nnz_balanced_rows(A->idx1, A->n_rows, omp_get_num_threads(),
+                omp_get_thread_num(), first_row, last_row);
+        CSR_spmv_rows(A, x, b, first_row, last_row);
+    }
+#else
+    CSR_spmv_rows(A, x, b, 0, A->n_rows);
+#endif
+}
+
+void CSR_residual(const CSRMatrix* A, const double* x, 
+        const double* b, double* r)
+{
+    if (A->n_rows == 0) return;
+#ifdef USING_OPENMP
+#pragma omp parallel if (A->idx1[A->n_rows] > omp_nnz_threshold)
+    {
+        int first_row, last_row;
+        nnz_balanced_rows(A->idx1, A->n_rows, omp_get_num_threads(),
+                omp_get_thread_num(), first_row, last_row);
+        CSR_residual_rows(A, x, b, r, first_row, last_row);
+    }
+#else
+    CSR_residual_rows(A, x, b, r, 0, A->n_rows);
+#endif
+}
+
+void CSR_append(const CSRMatrix* A, const double* x, double* b)
+{
+    if (A->n_rows == 0) return;
+#ifdef USING_OPENMP
+#pragma omp parallel if (A->idx1[A->n_rows] > omp_nnz_threshold)
+    {
+        int first_row, last_row;
+        nnz_balanced_rows(A->idx1, A->n_rows, omp_get_num_threads(),
+                omp_get_thread_num(), first_row, last_row);
+        CSR_append_rows(A, x, b, first_row, last_row);
+    }
+#else
+    CSR_append_rows(A, x, b, 0, A->n_rows);
+#endif
+}
+
+void CSR_append_neg(const CSRMatrix* A, const double* x, double* b)
+{
+    if (A->n_rows == 0) return;
+#ifdef USING_OPENMP
+#pragma omp parallel if (A->idx1[A->n_rows] > omp_nnz_threshold)
+    {
+        int first_row, last_row;
+        nnz_balanced_rows(A->idx1, A->n_rows, omp_get_num_threads(),
+                omp_get_thread_num(), first_row, last_row);
+        CSR_append_neg_rows(A, x, b, first_row, last_row);
+    }
+#else
+    CSR_append_neg_rows(A, x, b, 0, A->n_rows);
+#endif
+}
+
+// CSRMatrix SpMM Methods
+// x and r hold n_vecs values per row (row-major), so each nonzero of A 
+// is loaded once and applied to every vector in the block
+// Computes r = b + alpha*A*x over rows [first_row, last_row), 
+// with b == NULL treated as zero (b may alias r)
+void CSR_spmm_rows(const CSRMatrix* A, const double* x, const double* b, 
+        double* r, int n_vecs, double alpha, int first_row, int last_row)
+{
+    int start, end;
+    double val;
+    const double* x_row;
+    double* r_row;
+    for (int i = first_row; i < last_row; i++)
+    {
+        r_row = &r[i*n_vecs];
+        if (b == NULL)
+        {
+            for (int v = 0; v < n_vecs; v++)
+                r_row[v] = 0;
+        }
+        else if (b != r)
+        {
+            for (int v = 0; v < n_vecs; v++)
+                r_row[v] = b[i*n_vecs + v];
+        }
+
+        start = A->idx1[i];
+        end = A->idx1[i+1];
+        for (int j = start; j < end; j++)
+        {
+            val = alpha * A->vals[j];
+            x_row = &x[A->idx2[j]*n_vecs];
+            for (int v = 0; v < n_vecs; v++)
+            {
+                r_row[v] += val * x_row[v];
+            }
+        }
+    }
+}
+
+void CSR_spmm(const CSRMatrix* A, const double* x, const double* b, 
+        double* r, int n_vecs, double alpha)
+{
+    if (A->n_rows == 0) return;
+#ifdef USING_OPENMP
+#pragma omp parallel if (A->idx1[A->n_rows] * n_vecs > omp_nnz_threshold)
+    {
+        int first_row, last_row;
+        nnz_balanced_rows(A->idx1, A->n_rows, omp_get_num_threads(),
+                omp_get_thread_num(), first_row, last_row);
+        CSR_spmm_rows(A, x, b, r, n_vecs, alpha, first_row, last_row);
+    }
+#else
+    CSR_spmm_rows(A, x, b, r, n_vecs, alpha, 0, A->n_rows);
+#endif
+}
+
+void CSR_spmm_append_T(const CSRMatrix* A, const double* x, double* b, 
+        int n_vecs)
+{
+    int start, end;
+    double val;
+    const double* x_row;
+    double* b_row;
+    for (int i = 0; i < A->n_rows; i++)
+    {
+        start = A->idx1[i];
+        end = A->idx1[i+1];
+        x_row = &x[i*n_vecs];
+        for (int j = start; j < end; j++)
+        {
+            val = A->vals[j];
+            b_row = &b[A->idx2[j]*n_vecs];
+            for (int v = 0; v < n_vecs; v++)
+            {
+                b_row[v] += val * x_row[v];
+            }
+        }
+    }
+}
+
+template <typename VecType>
+void BSR_append(const CSRMatrix* A, const VecType& vals,
         const double* x, double* b)
 {
     int start, end;
@@ -130,7 +299,7 @@ void BSR_spmv(const BSRMatrix* A, const double* x, double* b)
     int start, end, idx;
     int first_row, first_col;
     double val;
-    double* block_val;
+    const double* block_val;
     for (int i = 0; i < A->n_rows; i++)
     {
         start = A->idx1[i];
@@ -153,8 +322,112 @@ void BSR_spmv(const BSRMatrix* A, const double* x, double* b)
         }
     }
 }
-template <typename T>
-void CSR_append_T(const CSRMatrix* A, const std::vector<T>& vals,
+
+// Fixed-size BSR kernels for square (N x N) blocks.  Block values
+// are contiguous, so block j starts at block_vals.data() + j*N*N.
+// b = b_init + alpha*A*x (b_init == NULL is treated as zero, and
+// may alias b)
+template <int N>
+void BSR_fixed_spmv(const BSRMatrix* A, const double* x, const double* b_init,
+        double* b, double alpha)
+{
+    const double* vals = A->block_vals.data();
+    for (int i = 0; i < A->n_rows; i++)
+    {
+        double sum[N];
+        for (int row = 0; row < N; row++)
+            sum[row] = 0.0;
+
+        int start = A->idx1[i];
+        int end = A->idx1[i+1];
+        for (int j = start; j < end; j++)
+        {
+            const double* block_val = &vals[j*N*N];
+            const double* x_block = &x[A->idx2[j]*N];
+            for (int row = 0; row < N; row++)
+            {
+                for (int col = 0; col < N; col++)
+                {
+                    sum[row] += block_val[row*N + col] * x_block[col];
+                }
+            }
+        }
+
+        double* b_block = &b[i*N];
+        if (b_init)
+        {
+            const double* b_init_block = &b_init[i*N];
+            for (int row = 0; row < N; row++)
+                b_block[row] = b_init_block[row] + alpha * sum[row];
+        }
+        else
+        {
+            for (int row = 0; row < N; row++)
+                b_block[row] = alpha * sum[row];
+        }
+    }
+}
+
+// b += alpha*A^T*x for square (N x N) blocks
+template <int N>
+void BSR_fixed_append_T(const BSRMatrix* A, const double* x, double* b,
+        double alpha)
+{
+    const double* vals = A->block_vals.data();
+    for (int i = 0; i < A->n_rows; i++)
+    {
+        double x_block[N];
+        for (int row = 0; row < N; row++)
+            x_block[row] = alpha * x[i*N + row];
+
+        int start = A->idx1[i];
+        int end = A->idx1[i+1];
+        for (int j = start; j < end; j++)
+        {
+            const double* block_val = &vals[j*N*N];
+            double* b_block = &b[A->idx2[j]*N];
+            for (int row = 0; row < N; row++)
+            {
+                for (int col = 0; col < N; col++)
+                {
+                    b_block[col] += block_val[row*N + col] * x_block[row];
+                }
+            }
+        }
+    }
+}
+
+// Dispatch to the fixed-size kernel matching A's block size.  Returns
+// false (without touching b) if A's blocks have no fixed-size kernel
+bool BSR_fixed_spmv(const BSRMatrix* A, const double* x, const double* b_init,
+        double* b, double alpha)
+{
+    if (A->b_rows != A->b_cols) return false;
+    switch (A->b_rows)
+    {
+        case 2: BSR_fixed_spmv<2>(A, x, b_init, b, alpha); return true;
+        case 3: BSR_fixed_spmv<3>(A, x, b_init, b, alpha); return true;
+        case 4: BSR_fixed_spmv<4>(A, x, b_init, b, alpha); return true;
+        case 6: BSR_fixed_spmv<6>(A, x, b_init, b, alpha); return true;
+    }
+    return false;
+}
+bool BSR_fixed_append_T(const BSRMatrix* A, const double* x, double* b,
+        double alpha)
+{
+    if (A->b_rows != A->b_cols) return false;
+    switch (A->b_rows)
+    {
+        case 2: BSR_fixed_append_T<2>(A, x, b, alpha); return true;
+        case 3: BSR_fixed_append_T<3>(A, x, b, alpha); return true;
+        case 4: BSR_fixed_append_T<4>(A, x, b, alpha); return true;
+        case 6: BSR_fixed_append_T<6>(A, x, b, alpha); return true;
+    }
+    return false;
+}
+
+template <typename VecType>
+void CSR_append_T(const CSRMatrix* A, const VecType& vals,
         const double* x, double* b)
 {
     int start, end;
@@ -168,8 +441,8 @@ void CSR_append_T(const CSRMatrix* A, const std::vector<T>& vals,
         }
     }
 }
-template <typename T>
-void CSR_append_neg(const CSRMatrix* A, const std::vector<T>& vals,
+template <typename VecType>
+void CSR_append_neg(const CSRMatrix* A, const VecType& vals,
         const double* x, double* b)
 {
     int start, end;
@@ -183,8 +456,8 @@ void CSR_append_neg(const CSRMatrix* A, const std::vector<T>& vals,
         }
     }
 }
-template <typename T>
-void CSR_append_neg_T(const CSRMatrix* A, const std::vector<T>& vals,
+template <typename VecType>
+void CSR_append_neg_T(const CSRMatrix* A, const VecType& vals,
         const double* x, double* b)
 {
     int start, end;
@@ -202,8 +475,8 @@ void CSR_append_neg_T(const CSRMatrix* A, const std::vector<T>& vals,
 
 
 // CSCMatrix SpMV Methods (or BSC)
-template <typename T>
-void CSC_append(const CSCMatrix* A, const std::vector<T>& vals,
+template <typename VecType>
+void CSC_append(const CSCMatrix* A, const VecType& vals,
         const double* x, double* b)
 {
     int start, end;
@@ -217,8 +490,8 @@ void CSC_append(const CSCMatrix* A, const std::vector<T>& vals,
         }
     }
 }
-template <typename T>
-void CSC_append_T(const CSCMatrix* A, const std::vector<T>& vals,
+template <typename VecType>
+void CSC_append_T(const CSCMatrix* A, const VecType& vals,
         const double* x, double* b)
 {
     int start, end;
@@ -232,8 +505,8 @@ void CSC_append_T(const CSCMatrix* A, const std::vector<T>& vals,
         }
     }
 }
-template <typename T>
-void CSC_append_neg(const CSCMatrix* A, const std::vector<T>& vals,
+template <typename VecType>
+void CSC_append_neg(const CSCMatrix* A, const VecType& vals,
         const double* x, double* b)
 {
     int start, end;
@@ -247,8 +520,8 @@ void CSC_append_neg(const CSCMatrix* A, const std::vector<T>& vals,
         }
     }
 }
-template <typename T>
-void CSC_append_neg_T(const CSCMatrix* A, const std::vector<T>& vals,
+template <typename VecType>
+void CSC_append_neg_T(const CSCMatrix* A, const VecType& vals,
         const double* x, double* b)
 {
     int start, end;
@@ -337,7 +610,7 @@ void CSRMatrix::spmv_append_T(const double* x, double* b) const
 }
 void CSRMatrix::spmv_append_neg(const double* x, double* b) const
 {
-    CSR_append_neg(this, vals, x, b);
+    CSR_append_neg(this, x, b);
 }
 void CSRMatrix::spmv_append_neg_T(const double* x, double* b) const
 {
@@ -347,28 +620,57 @@ void CSRMatrix::spmv_residual(const double* x, const double* b, double* r) const
 {
     CSR_residual(this, x, b, r);
 }
+void CSRMatrix::spmm(const double* x, double* b, int n_vecs) const
+{
+    CSR_spmm(this, x, NULL, b, n_vecs, 1.0);
+}
+void CSRMatrix::spmm_append(const double* x, double* b, int n_vecs) const
+{
+    CSR_spmm(this, x, b, b, n_vecs, 1.0);
+}
+void CSRMatrix::spmm_append_T(const double* x, double* b, int n_vecs) const
+{
+    CSR_spmm_append_T(this, x, b, n_vecs);
+}
+void CSRMatrix::spmm_append_neg(const double* x, double* b, int n_vecs) const
+{
+    CSR_spmm(this, x, b, b, n_vecs, -1.0);
+}
+void CSRMatrix::spmm_residual(const double* x, const double* b, double* r, 
+        int n_vecs) const
+{
+    CSR_spmm(this, x, b, r, n_vecs, -1.0);
+}
 void BSRMatrix::spmv(const double* x, double* b) const
 {
-    BSR_spmv(this, x, b);
+    if (!BSR_fixed_spmv(this, x, NULL, b, 1.0))
+        BSR_spmv(this, x, b);
 }
 void BSRMatrix::spmv_append(const double* x,double* b) const
 {
-    BSR_append(this, block_vals, x, b);
+    if (!BSR_fixed_spmv(this, x, b, b, 1.0))
+        BSR_append(this, block_vals, x, b);
 }
 void BSRMatrix::spmv_append_T(const double* x,double* b) const
 {
-    CSR_append_T(this, block_vals, x, b);
+    if (!BSR_fixed_append_T(this, x, b, 1.0))
+        CSR_append_T(this, block_vals, x, b);
 }
 void BSRMatrix::spmv_append_neg(const double* x,double* b) const
 {
-    CSR_append_neg(this, block_vals, x, b);
+    if (!BSR_fixed_spmv(this, x, b, b, -1.0))
+        CSR_append_neg(this, block_vals, x, b);
 }
 void BSRMatrix::spmv_append_neg_T(const double* x,double* b) const
 {
-    CSR_append_neg_T(this, block_vals, x, b);
+    if (!BSR_fixed_append_T(this, x, b, -1.0))
+        CSR_append_neg_T(this, block_vals, x, b);
 }
 void BSRMatrix::spmv_residual(const double* x, const double* b, double* r) const
 {
+    if (BSR_fixed_spmv(this, x, b, r, -1.0))
+        return;
+
     for (int i = 0; i < n_rows * b_rows; i++)
         r[i] = b[i];
     CSR_append_neg(this, block_vals, x, r);
@@ -0,0 +1,124 @@
+// Copyright (c) 2015-2017, RAPtor Developer Team
+// License: Simplified BSD, http://opensource.org/licenses/BSD-2-Clause
+#include "gtest/gtest.h"
+#include "raptor.hpp"
+
+using namespace raptor;
+
+int main(int argc, char** argv)
+{
+    MPI_Init(&argc, &argv);
+    ::testing::InitGoogleTest(&argc, argv);
+    int temp=RUN_ALL_TESTS();
+    MPI_Finalize();
+    return temp;
+} // end of main() //
+
+// Relaxes A x = b from x = 0, returning the residual norm after each sweep
+std::vector<double> relax_residuals(ParCSRMatrix* A, ParVector& b,
+        bool symmetric, int num_sweeps)
+{
+    ParVector x(A->global_num_rows, A->local_num_rows);
+    ParVector tmp(A->global_num_rows, A->local_num_rows);
+    ParVector r(A->global_num_rows, A->local_num_rows);
+    std::vector<double> norms;
+
+    x.set_const_value(0.0);
+    A->residual(x, b, r);
+    norms.emplace_back(r.norm(2));
+    for (int i = 0; i < num_sweeps; i++)
+    {
+        if (symmetric) ssor(A, x, b, tmp);
+        else sor(A, x, b, tmp);
+        A->residual(x, b, r);
+        norms.emplace_back(r.norm(2));
+    }
+
+    return norms;
+}
+
+TEST(OMPKernelsTest, TestsInUtil)
+{
+    int max_threads = 4;
+    int n_vecs = 3;
+    int num_sweeps = 10;
+    int grid[3] = {20, 20, 20};
+    double* stencil = laplace_stencil_27pt();
+
+    // Threaded CSR kernels divide rows among threads, so each row is
+    // computed exactly as in the serial kernel
+    CSRMatrix* A = stencil_grid(stencil, grid, 3);
+    ASSERT_GT(A->nnz, omp_nnz_threshold);
+
+    int n = A->n_rows;
+    std::vector<double> x(n), b(n);
+    std::vector<double> X(n * n_vecs), B(n * n_vecs);
+    for (int i = 0; i < n; i++)
+    {
+        x[i] = sin(i);
+        b[i] = cos(i);
+    }
+    for (int i = 0; i < n * n_vecs; i++)
+    {
+        X[i] = sin(i);
+        B[i] = cos(i);
+    }
+
+    std::vector<double> Ax(n), r(n);
+    std::vector<double> AX(n * n_vecs), R(n * n_vecs);
+    omp_set_num_threads(1);
+    A->spmv(x.data(), Ax.data());
+    A->spmv_residual(x.data(), b.data(), r.data());
+    A->spmm(X.data(), AX.data(), n_vecs);
+    A->spmm_residual(X.data(), B.data(), R.data(), n_vecs);
+
+    std::vector<double> Ax_t(n), r_t(n);
+    std::vector<double> AX_t(n * n_vecs), R_t(n * n_vecs);
+    for (int t = 2; t <= max_threads; t++)
+    {
+        omp_set_num_threads(t);
+        A->spmv(x.data(), Ax_t.data());
+        A->spmv_residual(x.data(), b.data(), r_t.data());
+        A->spmm(X.data(), AX_t.data(), n_vecs);
+        A->spmm_residual(X.data(), B.data(), R_t.data(), n_vecs);
+        for (int i = 0; i < n; i++)
+        {
+            ASSERT_EQ(Ax_t[i], Ax[i]);
+            ASSERT_EQ(r_t[i], r[i]);
+        }
+        for (int i = 0; i < n * n_vecs; i++)
+        {
+            ASSERT_EQ(AX_t[i], AX[i]);
+            ASSERT_EQ(R_t[i], R[i]);
+        }
+    }
+    delete A;
+
+    // Hybrid SOR / SSOR (Gauss-Seidel within each thread's rows) still
+    // reduces the residual with every sweep
+    ParCSRMatrix* A_par = par_stencil_grid(stencil, grid, 3);
+    ParVector b_par(A_par->global_num_rows, A_par->local_num_rows);
+    b_par.set_const_value(1.0);
+
+    omp_set_num_threads(1);
+    std::vector<double> sor_serial = relax_residuals(A_par, b_par, false, num_sweeps);
+    std::vector<double> ssor_serial = relax_residuals(A_par, b_par, true, num_sweeps);
+    for (int t = 2; t <= max_threads; t++)
+    {
+        omp_set_num_threads(t);
+        std::vector<double> sor_norms = relax_residuals(A_par, b_par, false, num_sweeps);
+        std::vector<double> ssor_norms = relax_residuals(A_par, b_par, true, num_sweeps);
+        for (int i = 1; i <= num_sweeps; i++)
+        {
+            ASSERT_LT(sor_norms[i], sor_norms[i-1]);
+            ASSERT_LT(ssor_norms[i], ssor_norms[i-1]);
+        }
+        ASSERT_LT(sor_norms[num_sweeps], 2.0 * sor_serial[num_sweeps]);
+        ASSERT_LT(ssor_norms[num_sweeps], 2.0 * ssor_serial[num_sweeps]);
+    }
+
+    delete A_par;
+    delete[] stencil;
+
+} // end of TEST(OMPKernelsTest, TestsInUtil) //
+
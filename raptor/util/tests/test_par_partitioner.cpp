@@ -0,0 +1,119 @@
+// Copyright (c) 2015-2017, RAPtor Developer Team
+// License: Simplified BSD, http://opensource.org/licenses/BSD-2-Clause
+
+#include "gtest/gtest.h"
+#include "raptor.hpp"
+
+using namespace raptor;
+
+int main(int argc, char** argv)
+{
+    MPI_Init(&argc, &argv);
+
+    ::testing::InitGoogleTest(&argc, argv);
+    int temp = RUN_ALL_TESTS();
+    MPI_Finalize();
+    return temp;
+} // end of main() //
+
+// Largest local nnz over the average local nnz
+double nnz_imbalance(ParCSRMatrix* A)
+{
+    int num_procs;
+    MPI_Comm_size(MPI_COMM_WORLD, &num_procs);
+
+    int max_nnz, total_nnz;
+    MPI_Allreduce(&A->local_nnz, &max_nnz, 1, MPI_INT, MPI_MAX, MPI_COMM_WORLD);
+    MPI_Allreduce(&A->local_nnz, &total_nnz, 1, MPI_INT, MPI_SUM, MPI_COMM_WORLD);
+    return ((double) max_nnz) * num_procs / total_nnz;
+}
+
+// Global number of off-process nonzeros
+int edge_cut(ParCSRMatrix* A)
+{
+    int cut = A->off_proc->nnz;
+    MPI_Allreduce(MPI_IN_PLACE, &cut, 1, MPI_INT, MPI_SUM, MPI_COMM_WORLD);
+    return cut;
+}
+
+TEST(Partitioner, TestsInUtil)
+{
+    int rank, num_procs;
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &num_procs);
+
+    int grid[3] = {16, 16, 16};
+    double* stencil = laplace_stencil_27pt();
+    std::vector<int> new_local_rows;
+    std::vector<int> skew_rows;
+    ParCSRMatrix* A = par_stencil_grid(stencil, grid, 3);
+
+    // Skew the rows, so low ranks hold far more nonzeros
+    int* proc_part = new int[A->local_num_rows];
+    for (int i = 0; i < A->local_num_rows; i++)
+    {
+        double pos = ((double) A->local_row_map[i]) / A->global_num_rows;
+        proc_part[i] = num_procs * pos * pos;
+    }
+    ParCSRMatrix* A_skew = repartition_matrix(A, proc_part, skew_rows);
+    delete[] proc_part;
+
+    // Rebalance by nnz, and by RCB on the grid coordinates
+    ParCSRMatrix* A_bal = rebalance_matrix(A_skew, new_local_rows);
+    ASSERT_LE(nnz_imbalance(A_bal), 1.1);
+
+    // Rows of A_bal are rows new_local_rows of A_skew
+    ParVector x_skew(A_skew->global_num_rows, A_skew->local_num_rows);
+    ParVector b_skew(A_skew->global_num_rows, A_skew->local_num_rows);
+    ParVector x_bal(A_bal->global_num_rows, A_bal->local_num_rows);
+    ParVector b_bal(A_bal->global_num_rows, A_bal->local_num_rows);
+    for (int i = 0; i < A_skew->local_num_rows; i++)
+    {
+        x_skew[i] = sin(A_skew->local_row_map[i]);
+    }
+    for (int i = 0; i < A_bal->local_num_rows; i++)
+    {
+        x_bal[i] = sin(new_local_rows[i]);
+    }
+    A_skew->mult(x_skew, b_skew);
+    A_bal->mult(x_bal, b_bal);
+
+    std::vector<int> sizes(num_procs);
+    std::vector<int> displs(num_procs+1);
+    MPI_Allgather(&A_skew->local_num_rows, 1, MPI_INT, sizes.data(), 1, MPI_INT,
+            MPI_COMM_WORLD);
+    displs[0] = 0;
+    for (int i = 0; i < num_procs; i++)
+    {
+        displs[i+1] = displs[i] + sizes[i];
+    }
+    std::vector<double> b_all(A_skew->global_num_rows);
+    MPI_Allgatherv(b_skew.local.data(), A_skew->local_num_rows, MPI_DOUBLE,
+            b_all.data(), sizes.data(), displs.data(), MPI_DOUBLE, MPI_COMM_WORLD);
+    for (int i = 0; i < A_bal->local_num_rows; i++)
+    {
+        ASSERT_NEAR(b_bal[i], b_all[new_local_rows[i]], 1e-10);
+    }
+    delete A_bal;
+
+    // RCB of the grid should cut no more edges than the slabs of the
+    // standard partition
+    std::vector<double> coords(A->local_num_rows * 3);
+    for (int i = 0; i < A->local_num_rows; i++)
+    {
+        int row = A->local_row_map[i];
+        coords[i*3] = row / (grid[1] * grid[2]);
+        coords[i*3+1] = (row / grid[2]) % grid[1];
+        coords[i*3+2] = row % grid[2];
+    }
+    A_bal = rebalance_matrix(A, new_local_rows, 3, coords.data());
+    ASSERT_LE(nnz_imbalance(A_bal), 1.1);
+    ASSERT_LE(edge_cut(A_bal), edge_cut(A));
+
+    delete A_bal;
+    delete A_skew;
+    delete A;
+    delete[] stencil;
+
+} // end of TEST(Partitioner, TestsInUtil) //
+
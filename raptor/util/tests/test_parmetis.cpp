@@ -32,7 +32,8 @@ TEST(Repartition, TestsInUtil)
 
     const char* filename = "../../../../test_data/random.pm";
     ParCSRMatrix* A_orig = readParMatrix(filename);
-    printf("A_orig %d, %d\n", A_orig->global_num_rows, A_orig->global_num_cols);
+    printf("A_orig %" PRId64 ", %" PRId64 "\n", (int64_t) A_orig->global_num_rows, 
+            (int64_t) A_orig->global_num_cols);
     ParVector x_orig(A_orig->global_num_rows, A_orig->local_num_rows);
     ParVector b_orig(A_orig->global_num_rows, A_orig->local_num_rows);
     x_orig.set_const_value(1.0);